@@ -38,28 +38,21 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     initWelcomeScreenConnections();
     LOG_DEBUG("MainWindow: Welcome screen connections initialized");
 
-    // 在所有组件初始化完成后应用初始主题
-    QString defaultTheme =
-        (STYLE.currentTheme() == Theme::Light) ? "light" : "dark";
-    
-    LOG_DEBUG("MainWindow: Constructor completed, scheduling initial theme application");
-    
-    // 延迟应用主题，确保窗口完全准备好，并强制应用到MainWindow
-    QTimer::singleShot(0, this, [this, defaultTheme]() {
-        LOG_DEBUG("MainWindow: Applying initial theme: {}", defaultTheme.toStdString());
-        
-        // 应用主题
-        loadAndApplyTheme(defaultTheme);
-        
+    LOG_DEBUG("MainWindow: Constructor completed, scheduling stylesheet application");
+
+    // 延迟应用样式表，确保窗口完全准备好。样式表只在这里设置一次：
+    // 其中的颜色都由调色板解析，之后切换主题只替换调色板
+    QTimer::singleShot(0, this, [this]() {
+        loadAndApplyStyleSheet();
+
         // 额外检查：如果主窗口样式表仍然为空，使用备用方法
         if (this->styleSheet().isEmpty()) {
-            LOG_WARNING("MainWindow: StyleSheet is empty after loadAndApplyTheme, forcing fallback theme application");
-            QString fallbackStyleSheet = STYLE.getApplicationStyleSheet();
-            STYLE.forceApplyTheme(this, fallbackStyleSheet);
+            LOG_WARNING("MainWindow: StyleSheet is empty after loadAndApplyStyleSheet, forcing fallback stylesheet");
+            STYLE.forceApplyTheme(this, STYLE.getApplicationStyleSheet());
         }
-        
-        LOG_DEBUG("MainWindow: Theme application completed ({}), stylesheet length: {}", 
-                  defaultTheme.toStdString(), this->styleSheet().length());
+
+        LOG_DEBUG("MainWindow: Stylesheet application completed, length: {}",
+                  this->styleSheet().length());
     });
 
     // 启动异步初始化以避免阻塞UI
@@ -162,6 +155,7 @@ void MainWindow::initModel() {
     documentModel = new DocumentModel(renderModel);
     pageModel = new PageModel(renderModel);
     recentFilesManager = new RecentFilesManager(this);
+    bookmarkModel = new BookmarkModel(this);
 }
 
 void MainWindow::initController() {
@@ -195,12 +189,6 @@ void MainWindow::initWelcomeScreen() {
 }
 
 void MainWindow::initConnection() {
-    // 监听 StyleManager 的主题变更信号，确保从任何地方切换主题都能立即生效
-    connect(&StyleManager::instance(), &StyleManager::themeChanged, this, [this](Theme theme) {
-        QString themeStr = (theme == Theme::Dark) ? "dark" : "light";
-        loadAndApplyTheme(themeStr);
-    });
-
     connect(menuBar, &MenuBar::onExecuted, documentController,
             &DocumentController::execute);
     connect(menuBar, &MenuBar::onExecuted, this,
@@ -239,6 +227,11 @@ void MainWindow::initConnection() {
     connect(sideBar, &SideBar::pageDoubleClicked, this,
             &MainWindow::onThumbnailPageDoubleClicked);
 
+    // 缩略图多选的批量书签写入书签模型，并在侧边栏书签页显示
+    sideBar->setBookmarkModel(bookmarkModel);
+    connect(sideBar, &SideBar::pagesBookmarkRequested, this,
+            &MainWindow::onPagesBookmarkRequested);
+
     // 连接分隔器信号
     connect(mainSplitter, &QSplitter::splitterMoved, this,
             &MainWindow::onSplitterMoved);
@@ -250,6 +243,15 @@ void MainWindow::initConnection() {
     // 连接ViewWidget的目录模型变化信号
     connect(viewWidget, &ViewWidget::currentOutlineModelChanged, this,
             &MainWindow::onOutlineModelChanged);
+
+    // 打开流水线进入缩略图阶段时再为侧边栏设置文档
+    connect(viewWidget, &ViewWidget::documentOpenPhaseStarted, this,
+            [this](int index, DocumentOpenPipeline::Phase phase) {
+                if (phase == DocumentOpenPipeline::VisibleThumbnails &&
+                    index == documentModel->getCurrentDocumentIndex()) {
+                    onCurrentDocumentChangedForOutline(index);
+                }
+            });
     
     // 连接页面变化信号以更新目录高亮
     connect(viewWidget, &ViewWidget::currentViewerPageChanged, this,
@@ -401,8 +403,10 @@ void MainWindow::onSplitterMoved(int pos, int index) {
 }
 
 void MainWindow::onCurrentDocumentChangedForOutline(int index) {
-    // 设置缩略图文档
-    if (documentModel && index >= 0) {
+    // 设置缩略图文档；刚打开的文档要等打开流水线进入缩略图阶段
+    if (documentModel && index >= 0 &&
+        viewWidget->isOpenPhaseReached(
+            index, DocumentOpenPipeline::VisibleThumbnails)) {
         std::shared_ptr<Poppler::Document> sharedDoc =
             documentModel->getDocument(index);
         if (sharedDoc) {
@@ -423,6 +427,27 @@ void MainWindow::onThumbnailPageClicked(int pageNumber) {
     }
 }
 
+void MainWindow::onPagesBookmarkRequested(const QList<int>& pageNumbers) {
+    const QString filePath =
+        documentModel ? documentModel->getCurrentFilePath() : QString();
+    if (filePath.isEmpty()) {
+        return;
+    }
+
+    int added = 0;
+    for (int pageNumber : pageNumbers) {
+        // 已有书签的页面不重复添加
+        if (!bookmarkModel->hasBookmarkForPage(filePath, pageNumber) &&
+            bookmarkModel->addBookmark(Bookmark(filePath, pageNumber))) {
+            ++added;
+        }
+    }
+
+    if (statusBar) {
+        statusBar->setMessage(QString("已为 %1 个页面添加书签").arg(added));
+    }
+}
+
 void MainWindow::onThumbnailPageDoubleClicked(int pageNumber) {
     // 缩略图双击可以有不同的行为，比如放大显示
     onThumbnailPageClicked(pageNumber);
@@ -506,25 +531,17 @@ void MainWindow::onOpenRecentFileRequested(const QString& filePath) {
 }
 
 // function
-void MainWindow::loadAndApplyTheme(const QString& theme) {
-    // 防止重复应用相同主题
-    if (m_currentAppliedTheme == theme) {
-        LOG_DEBUG("Theme {} is already applied, skipping redundant application",
-                  theme.toStdString());
-        return;
-    }
-
+void MainWindow::loadAndApplyStyleSheet() {
     // 尝试从外部样式文件加载 - 支持多种部署场景
     QStringList possiblePaths = {
         // 开发环境：相对于可执行文件的assets目录
-        QString("%1/../assets/styles/%2.qss")
-            .arg(qApp->applicationDirPath(), theme),
+        QString("%1/../assets/styles/app.qss").arg(qApp->applicationDirPath()),
         // 部署环境：可执行文件同级的styles目录
-        QString("%1/styles/%2.qss").arg(qApp->applicationDirPath(), theme),
+        QString("%1/styles/app.qss").arg(qApp->applicationDirPath()),
         // 备选：相对于工作目录的assets目录
-        QString("assets/styles/%2.qss").arg(theme),
+        QString("assets/styles/app.qss"),
         // 备选：当前目录的styles子目录
-        QString("styles/%2.qss").arg(theme)};
+        QString("styles/app.qss")};
 
     QString selectedPath;
     for (const QString& candidatePath : possiblePaths) {
@@ -542,15 +559,14 @@ void MainWindow::loadAndApplyTheme(const QString& theme) {
     if (!selectedPath.isEmpty()) {
         QFile file(selectedPath);
         if (file.open(QFile::ReadOnly)) {
-            QString styleSheet = QLatin1String(file.readAll());
+            QString styleSheet = QString::fromUtf8(file.readAll());
             file.close();
 
             if (!styleSheet.isEmpty()) {
                 // 通过StyleManager应用样式表，让其统一管理
                 STYLE.applyThemeStyleSheet(styleSheet);
-                m_currentAppliedTheme = theme;
-                LOG_DEBUG("Applied external theme: {} from {} via StyleManager",
-                          theme.toStdString(), selectedPath.toStdString());
+                LOG_DEBUG("Applied external stylesheet from {}",
+                          selectedPath.toStdString());
                 return;
             } else {
                 LOG_WARNING("QSS file is empty: {}",
@@ -563,17 +579,12 @@ void MainWindow::loadAndApplyTheme(const QString& theme) {
     }
 
     // 外部文件不可用时，使用StyleManager作为备选方案
-    LOG_WARNING("No external theme file found for theme: {}",
-                theme.toStdString());
+    LOG_WARNING("No external stylesheet found");
     LOG_DEBUG("Attempted paths: [{}]", possiblePaths.join(", ").toStdString());
-    LOG_DEBUG("Falling back to StyleManager for theme: {}",
-              theme.toStdString());
-
-    // 使用StyleManager生成并应用默认样式
-    QString fallbackStyleSheet = STYLE.getApplicationStyleSheet();
-    STYLE.applyThemeStyleSheet(fallbackStyleSheet);
-    m_currentAppliedTheme = theme;
-    LOG_DEBUG("Applied fallback theme: {} via StyleManager", theme.toStdString());
+
+    // StyleManager生成的样式表同样只引用调色板颜色
+    STYLE.applyThemeStyleSheet(STYLE.getApplicationStyleSheet());
+    LOG_DEBUG("Applied fallback stylesheet via StyleManager");
 }
 
 void MainWindow::initWelcomeScreenConnections() {
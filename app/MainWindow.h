@@ -8,6 +8,7 @@
 #include "controller/tool.hpp"
 #include "managers/RecentFilesManager.h"
 #include "managers/StyleManager.h"
+#include "model/BookmarkModel.h"
 #include "model/DocumentModel.h"
 #include "model/PageModel.h"
 #include "model/RenderModel.h"
@@ -28,7 +29,6 @@ public:
     ~MainWindow() noexcept;
 
 private slots:
-    void loadAndApplyTheme(const QString& theme);
     void onDocumentOperationCompleted(ActionMap action, bool success);
     void onSideBarVisibilityChanged(bool visible);
     void onSplitterMoved(int pos, int index);
@@ -38,6 +38,7 @@ private slots:
     void onPageJumpRequested(int pageNumber);
     void onThumbnailPageClicked(int pageNumber);
     void onThumbnailPageDoubleClicked(int pageNumber);
+    void onPagesBookmarkRequested(const QList<int>& pageNumbers);
     void onPDFActionRequested(ActionMap action);
     void onThemeToggleRequested();
     void onOpenRecentFileRequested(const QString& filePath);
@@ -65,6 +66,8 @@ private:
     void initConnection();
     void initWelcomeScreen();
     void initWelcomeScreenConnections();
+    // 启动时加载并应用一次应用样式表，之后切换主题只替换调色板
+    void loadAndApplyStyleSheet();
     
     // 目录相关的辅助函数
     void setupOutlineConnections();
@@ -92,9 +95,7 @@ private:
     RenderModel* renderModel;
 
     RecentFilesManager* recentFilesManager;
-
-    // Theme state tracking
-    QString m_currentAppliedTheme;
+    BookmarkModel* bookmarkModel;
 
 signals:
     void pdfViewerActionRequested(ActionMap action);
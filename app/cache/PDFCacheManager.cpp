@@ -14,9 +14,12 @@ qint64 CacheItem::calculateSize() const {
         case CacheItemType::RenderedPage:
         case CacheItemType::Thumbnail:
         case CacheItemType::PageImage: {
-            if (data.canConvert<QPixmap>()) {
-                QPixmap pixmap = data.value<QPixmap>();
-                size += pixmap.width() * pixmap.height() * 4;  // 32-bit ARGB
+            // Rendered pages are stored as depth-reduced images when
+            // possible; count the bytes actually held
+            if (data.typeId() == QMetaType::QImage) {
+                size += CompactRaster::imageBytes(data.value<QImage>());
+            } else if (data.canConvert<QPixmap>()) {
+                size += CompactRaster::pixmapBytes(data.value<QPixmap>());
             }
             break;
         }
@@ -203,11 +206,20 @@ void PDFCacheManager::clear() {
     LOG_DEBUG("PDFCacheManager: Cache cleared");
 }
 
-bool PDFCacheManager::cacheRenderedPage(int pageNumber, const QPixmap& pixmap,
+bool PDFCacheManager::cacheRenderedPage(int pageNumber,
+                                        const CompactRaster& raster,
                                         double scaleFactor) {
+    if (raster.isNull()) {
+        return false;
+    }
     QString key =
         generateKey(pageNumber, CacheItemType::RenderedPage, scaleFactor);
-    return insert(key, pixmap, CacheItemType::RenderedPage,
+    // Grayscale and black-and-white pages are kept at 8 or 1 bit per pixel
+    const QVariant value =
+        raster.depth() == CompactRaster::Depth::Color
+            ? QVariant(QPixmap::fromImage(raster.image()))
+            : QVariant(raster.image());
+    return insert(key, value, CacheItemType::RenderedPage,
                   CachePriority::Normal, pageNumber);
 }
 
@@ -215,7 +227,13 @@ QPixmap PDFCacheManager::getRenderedPage(int pageNumber, double scaleFactor) {
     QString key =
         generateKey(pageNumber, CacheItemType::RenderedPage, scaleFactor);
     QVariant result = get(key);
-    return result.canConvert<QPixmap>() ? result.value<QPixmap>() : QPixmap();
+    if (result.typeId() == QMetaType::QPixmap) {
+        return result.value<QPixmap>();  // Colour pages: shared, no copy
+    }
+    // Only grayscale and black-and-white pages are expanded on a hit
+    return result.typeId() == QMetaType::QImage
+               ? QPixmap::fromImage(result.value<QImage>())
+               : QPixmap();
 }
 
 bool PDFCacheManager::cacheThumbnail(int pageNumber, const QPixmap& thumbnail) {
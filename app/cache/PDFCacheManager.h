@@ -13,6 +13,7 @@
 #include <QThread>
 #include <QThreadPool>
 #include <QTimer>
+#include "ui/viewer/CompactRaster.h"
 
 /**
  * Cache item types
@@ -143,7 +144,10 @@ public:
     void clear();
 
     // Specialized cache operations
-    bool cacheRenderedPage(int pageNumber, const QPixmap& pixmap,
+    // The raster is classified where the page was rendered; grayscale and
+    // black-and-white pages stay compact, colour pages become a pixmap
+    // (GUI thread only)
+    bool cacheRenderedPage(int pageNumber, const CompactRaster& raster,
                            double scaleFactor);
     QPixmap getRenderedPage(int pageNumber, double scaleFactor);
 
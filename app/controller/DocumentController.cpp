@@ -116,6 +116,10 @@ void DocumentController::initializeCommandMap() {
          [this](QWidget* ctx) {
              emit viewModeChangeRequested(1);  // ContinuousScroll
          }},
+        {ActionMap::setReflowMode,
+         [this](QWidget* ctx) {
+             emit viewModeChangeRequested(2);  // Reflow
+         }},
         // 页面导航操作
         {ActionMap::firstPage,
          [this](QWidget* ctx) {
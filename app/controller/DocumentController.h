@@ -53,7 +53,8 @@ signals:
     void sideBarToggleRequested();
     void sideBarShowRequested();
     void sideBarHideRequested();
-    void viewModeChangeRequested(int mode);  // 0=SinglePage, 1=ContinuousScroll
+    void viewModeChangeRequested(
+        int mode);  // 0=SinglePage, 1=ContinuousScroll, 2=Reflow
     void pdfActionRequested(ActionMap action);
     void themeToggleRequested();
 };
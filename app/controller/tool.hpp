@@ -20,6 +20,7 @@ enum ActionMap {
     // 查看模式相关操作
     setSinglePageMode,
     setContinuousScrollMode,
+    setReflowMode,
     // 页面导航操作
     firstPage,
     previousPage,
@@ -1,11 +1,188 @@
 #include <config.h>
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
 #include "MainWindow.h"
+#include "utils/CjkTokenizer.h"
+#include "utils/DocumentAnalyzer.h"
+#include "utils/DocumentBundle.h"
+#include "utils/DocumentFingerprint.h"
 #include "utils/LoggingConfig.h"
 #include "utils/LoggingMacros.h"
 #include "utils/LoggingManager.h"
 
+namespace {
+
+// Batch runs on cluster nodes have no display and no main window
+bool isBatchInvocation(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        const QByteArray argument(argv[i]);
+        if (argument.startsWith("--batch-manifest") ||
+            argument.startsWith("--merge-shards") ||
+            argument.startsWith("--build-bundle")) {
+            return true;
+        }
+    }
+    return false;
+}
+
+DocumentAnalyzer::AnalysisTypes parseAnalysisTypes(const QString& value) {
+    DocumentAnalyzer::AnalysisTypes types;
+    for (const QString& name : value.split(',', Qt::SkipEmptyParts)) {
+        const QString type = name.trimmed().toLower();
+        if (type == "full") {
+            types |= DocumentAnalyzer::FullAnalysis;
+        } else if (type == "basic") {
+            types |= DocumentAnalyzer::BasicAnalysis;
+        } else if (type == "text") {
+            types |= DocumentAnalyzer::TextAnalysis;
+        } else if (type == "images") {
+            types |= DocumentAnalyzer::ImageAnalysis;
+        } else if (type == "structure") {
+            types |= DocumentAnalyzer::StructureAnalysis;
+        } else if (type == "security") {
+            types |= DocumentAnalyzer::SecurityAnalysis;
+        } else if (type == "quality") {
+            types |= DocumentAnalyzer::QualityAnalysis;
+        } else if (type == "accessibility") {
+            types |= DocumentAnalyzer::AccessibilityAnalysis;
+        } else {
+            LOG_WARNING("Unknown analysis type: {}", type.toStdString());
+        }
+    }
+    return types;
+}
+
+int runBatch(const QStringList& arguments) {
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Headless sharded document analysis and bundle building");
+    parser.addHelpOption();
+
+    const QCommandLineOption manifestOption(
+        "batch-manifest", "Analyze the PDFs listed in <file>, one per line.",
+        "file");
+    const QCommandLineOption shardOption(
+        "shard", "Process shard <i/N> of the manifest, i counted from 1.",
+        "i/N", "1/1");
+    const QCommandLineOption outputOption(
+        "output", "Shared directory for shard results.", "dir");
+    const QCommandLineOption analysisOption(
+        "analysis",
+        "Comma-separated analyses: basic, text, images, structure, "
+        "security, quality, accessibility or full.",
+        "types", "full");
+    const QCommandLineOption mergeOption(
+        "merge-shards", "Merge the finished shard results in <dir>.", "dir");
+    const QCommandLineOption shardCountOption(
+        "shard-count", "Number of shards to merge.", "N");
+    const QCommandLineOption reportOption(
+        "report", "Merged report path (default <dir>/report.json).", "file");
+    const QCommandLineOption bundleOption(
+        "build-bundle",
+        "Precompute a bundle for <pdf>; written next to it as "
+        "<pdf>.readium unless --bundle-dir is given. Repeatable.",
+        "pdf");
+    const QCommandLineOption bundleDirOption(
+        "bundle-dir",
+        "Write bundles to <dir>/<fingerprint>.readium, the layout of the "
+        "viewer's bundle cache.",
+        "dir");
+    const QCommandLineOption thumbnailOption(
+        "thumbnail-size", "Longest thumbnail edge in pixels, 0 for none.",
+        "px", "256");
+    parser.addOptions({manifestOption, shardOption, outputOption,
+                       analysisOption, mergeOption, shardCountOption,
+                       reportOption, bundleOption, bundleDirOption,
+                       thumbnailOption});
+    parser.process(arguments);
+
+    if (parser.isSet(bundleOption)) {
+        DocumentBundle::BuildOptions options;
+        options.thumbnailEdge =
+            qMax(0, parser.value(thumbnailOption).toInt());
+        int failures = 0;
+        for (const QString& pdfPath : parser.values(bundleOption)) {
+            QString bundlePath = DocumentBundle::sidecarPath(pdfPath);
+            if (parser.isSet(bundleDirOption)) {
+                const QString fingerprint =
+                    DocumentFingerprint::instance().fingerprint(pdfPath);
+                if (fingerprint.isEmpty()) {
+                    LOG_ERROR("Cannot read {}", pdfPath.toStdString());
+                    ++failures;
+                    continue;
+                }
+                bundlePath =
+                    QDir(parser.value(bundleDirOption))
+                        .filePath(fingerprint +
+                                  QLatin1String(DocumentBundle::FILE_SUFFIX));
+            }
+            if (!DocumentBundle::build(pdfPath, bundlePath, options)) {
+                LOG_ERROR("Failed to build bundle for {}",
+                          pdfPath.toStdString());
+                ++failures;
+            }
+        }
+        return failures == 0 ? 0 : 1;
+    }
+
+    DocumentAnalyzer analyzer;
+
+    if (parser.isSet(mergeOption)) {
+        const QString directory = parser.value(mergeOption);
+        bool ok = false;
+        const int shardCount = parser.value(shardCountOption).toInt(&ok);
+        if (!ok || shardCount < 1) {
+            LOG_ERROR("--merge-shards needs --shard-count N");
+            return 2;
+        }
+        const QString report =
+            parser.isSet(reportOption)
+                ? parser.value(reportOption)
+                : QDir(directory).filePath("report.json");
+        if (!analyzer.mergeShardResults(directory, shardCount, report)) {
+            return 1;
+        }
+        LOG_INFO("Merged {} shards into {}", shardCount, report.toStdString());
+        return 0;
+    }
+
+    const QStringList shard = parser.value(shardOption).split('/');
+    bool indexOk = false;
+    bool countOk = false;
+    const int shardIndex =
+        shard.size() == 2 ? shard.at(0).toInt(&indexOk) : 0;
+    const int shardCount =
+        shard.size() == 2 ? shard.at(1).toInt(&countOk) : 0;
+    if (!indexOk || !countOk || shardCount < 1 || shardIndex < 1 ||
+        shardIndex > shardCount) {
+        LOG_ERROR("Invalid --shard value, expected i/N with 1 <= i <= N");
+        return 2;
+    }
+    if (!parser.isSet(outputOption)) {
+        LOG_ERROR("--batch-manifest needs --output <dir>");
+        return 2;
+    }
+
+    DocumentAnalyzer::BatchAnalysisSettings settings;
+    settings.analysisTypes = parseAnalysisTypes(parser.value(analysisOption));
+    settings.generateReport = false;
+    analyzer.setAnalysisSettings(settings);
+
+    return analyzer.runShard(parser.value(manifestOption), shardIndex - 1,
+                             shardCount, parser.value(outputOption))
+               ? 0
+               : 1;
+}
+
+}  // namespace
+
 int main(int argc, char** argv) {
+    const bool batchMode = isBatchInvocation(argc, argv);
+    if (batchMode && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication app(argc, argv);
 
     // Initialize logging system
@@ -39,6 +216,16 @@ int main(int argc, char** argv) {
 
     LOG_DEBUG("Application metadata configured");
 
+    if (batchMode) {
+        const int result = runBatch(QApplication::arguments());
+        LoggingManager::instance().shutdown();
+        return result;
+    }
+
+    // CJK whole-word search and word counts segment with this dictionary;
+    // building it while the window comes up keeps it off the GUI thread
+    CjkTokenizer::preloadDictionary();
+
     try {
         MainWindow w;
         w.show();
@@ -0,0 +1,175 @@
+#include "RecentFilePreviewProvider.h"
+#include <poppler-qt6.h>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QStandardPaths>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <memory>
+#include "utils/Logger.h"
+
+RecentFilePreviewProvider::RecentFilePreviewProvider(QObject* parent)
+    : QObject(parent),
+      m_renderPool(new QThreadPool(this)),
+      m_previewSize(48, 64),
+      m_memoryCache(MEMORY_CACHE_ENTRIES) {
+    m_renderPool->setMaxThreadCount(RENDER_THREADS);
+}
+
+RecentFilePreviewProvider::~RecentFilePreviewProvider() {
+    m_renderPool->clear();
+    m_renderPool->waitForDone();
+}
+
+QImage RecentFilePreviewProvider::cachedPreview(
+    const QString& filePath) const {
+    QImage* preview = m_memoryCache.object(filePath);
+    return preview ? *preview : QImage();
+}
+
+void RecentFilePreviewProvider::requestPreview(const QString& filePath) {
+    if (filePath.isEmpty() || m_pendingRequests.contains(filePath)) {
+        return;
+    }
+
+    QImage cached = cachedPreview(filePath);
+    if (!cached.isNull()) {
+        emit previewReady(filePath, cached);
+        return;
+    }
+
+    m_pendingRequests.insert(filePath);
+    const QSize size = m_previewSize;
+
+    QFuture<QImage> future = QtConcurrent::run(
+        m_renderPool, [this, filePath, size]() {
+            return loadOrRenderPreview(filePath, size);
+        });
+
+    auto* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this,
+            [this, watcher, filePath]() {
+                QImage preview = watcher->result();
+                watcher->deleteLater();
+                m_pendingRequests.remove(filePath);
+
+                if (preview.isNull()) {
+                    return;
+                }
+
+                m_memoryCache.insert(filePath, new QImage(preview));
+                emit previewReady(filePath, preview);
+            });
+    watcher->setFuture(future);
+}
+
+void RecentFilePreviewProvider::invalidate(const QString& filePath) {
+    // 磁盘缓存键包含文件大小与修改时间，文件变化后自然失效
+    m_memoryCache.remove(filePath);
+}
+
+void RecentFilePreviewProvider::setPreviewSize(const QSize& size) {
+    if (m_previewSize == size || size.isEmpty()) {
+        return;
+    }
+
+    m_previewSize = size;
+    m_memoryCache.clear();
+}
+
+QString RecentFilePreviewProvider::cacheDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+           "/recent_previews";
+}
+
+QImage RecentFilePreviewProvider::loadOrRenderPreview(const QString& filePath,
+                                                      const QSize& size) {
+    const QString key = cacheKey(filePath, size);
+    if (key.isEmpty()) {
+        return QImage();
+    }
+
+    const QString cachePath = QDir(cacheDirectory()).filePath(key + ".png");
+    QImage preview(cachePath);
+    if (!preview.isNull()) {
+        return preview;
+    }
+
+    preview = renderFirstPage(filePath, size);
+    if (preview.isNull()) {
+        return preview;
+    }
+
+    QMutexLocker locker(&m_diskCacheMutex);
+    if (QDir().mkpath(cacheDirectory()) && preview.save(cachePath, "PNG")) {
+        pruneDiskCache();
+    } else {
+        Logger::instance().warning("[managers] Failed to cache preview: {}",
+                                   cachePath.toStdString());
+    }
+
+    return preview;
+}
+
+QImage RecentFilePreviewProvider::renderFirstPage(const QString& filePath,
+                                                  const QSize& size) {
+    // 每个任务使用独立的文档实例，Poppler文档不能跨线程共享
+    std::unique_ptr<Poppler::Document> document(
+        Poppler::Document::load(filePath));
+    if (!document || document->isLocked() || document->numPages() < 1) {
+        return QImage();
+    }
+
+    std::unique_ptr<Poppler::Page> page(document->page(0));
+    if (!page) {
+        return QImage();
+    }
+
+    const QSizeF pageSize = page->pageSizeF();
+    if (pageSize.isEmpty()) {
+        return QImage();
+    }
+
+    // 按目标尺寸计算DPI，只渲染需要的像素
+    const double scale = std::min(size.width() / pageSize.width(),
+                                  size.height() / pageSize.height());
+    const double dpi = std::max(1.0, 72.0 * scale);
+
+    QImage image = page->renderToImage(dpi, dpi);
+    if (image.isNull()) {
+        return image;
+    }
+
+    return image.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+        .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+QString RecentFilePreviewProvider::cacheKey(const QString& filePath,
+                                            const QSize& size) {
+    QFileInfo info(filePath);
+    if (!info.exists() || !info.isFile()) {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+    hash.addData(QByteArray::number(size.width()) + 'x' +
+                 QByteArray::number(size.height()));
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+void RecentFilePreviewProvider::pruneDiskCache() {
+    // 调用时已持有 m_diskCacheMutex
+    QDir dir(cacheDirectory());
+    QFileInfoList entries =
+        dir.entryInfoList(QStringList() << "*.png", QDir::Files, QDir::Time);
+    for (int i = DISK_CACHE_ENTRIES; i < entries.size(); ++i) {
+        QFile::remove(entries[i].absoluteFilePath());
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <QCache>
+#include <QImage>
+#include <QMutex>
+#include <QObject>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+/**
+ * 最近文件预览图提供者
+ * 在后台渲染文档首页缩略图，并缓存到内存和磁盘；
+ * 再次显示欢迎界面时直接从磁盘缓存读取，无需重新打开文档
+ */
+class RecentFilePreviewProvider : public QObject {
+    Q_OBJECT
+
+public:
+    explicit RecentFilePreviewProvider(QObject* parent = nullptr);
+    ~RecentFilePreviewProvider();
+
+    // 预览请求：已缓存时立即返回，否则在后台生成并通过 previewReady 通知
+    QImage cachedPreview(const QString& filePath) const;
+    void requestPreview(const QString& filePath);
+    void invalidate(const QString& filePath);
+
+    void setPreviewSize(const QSize& size);
+    QSize previewSize() const { return m_previewSize; }
+
+    static QString cacheDirectory();
+
+signals:
+    void previewReady(const QString& filePath, const QImage& preview);
+
+private:
+    QImage loadOrRenderPreview(const QString& filePath, const QSize& size);
+    static QImage renderFirstPage(const QString& filePath, const QSize& size);
+    static QString cacheKey(const QString& filePath, const QSize& size);
+    void pruneDiskCache();
+
+    QThreadPool* m_renderPool;
+    QSize m_previewSize;
+
+    // 仅在GUI线程访问
+    QCache<QString, QImage> m_memoryCache;
+    QSet<QString> m_pendingRequests;
+
+    QMutex m_diskCacheMutex;
+
+    static const int MEMORY_CACHE_ENTRIES = 32;
+    static const int DISK_CACHE_ENTRIES = 128;
+    static const int RENDER_THREADS = 2;
+};
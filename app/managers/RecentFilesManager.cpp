@@ -1,15 +1,19 @@
 #include "RecentFilesManager.h"
+#include <QDataStream>
 #include <QDir>
 #include <QFileInfo>
 #include <QList>
 #include <QMutexLocker>
 #include <QObject>
 #include <QSettings>
+#include <QStandardPaths>
 #include <QString>
 #include <QStringList>
 #include <QTimer>
+#include <QtConcurrent/QtConcurrent>
 #include <QtCore/QObject>
 #include <algorithm>
+#include "utils/KeyedRecordStore.h"
 #include "utils/Logger.h"
 
 const QString RecentFilesManager::SETTINGS_GROUP = "recentFiles";
@@ -19,9 +23,16 @@ const QString RecentFilesManager::SETTINGS_FILES_KEY = "files";
 RecentFilesManager::RecentFilesManager(QObject* parent)
     : QObject(parent),
       m_settings(nullptr),
-      m_maxRecentFiles(DEFAULT_MAX_RECENT_FILES) {
+      m_maxRecentFiles(DEFAULT_MAX_RECENT_FILES),
+      m_validationPool(new QThreadPool()) {
+    qRegisterMetaType<RecentFileInfo::Availability>();
+    m_validationPool->setMaxThreadCount(VALIDATION_THREADS);
+
     // 初始化设置
     m_settings = new QSettings("SAST", "Readium-RecentFiles", this);
+    m_store = std::make_unique<KeyedRecordStore>(
+        QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation))
+            .filePath("recent-files.db"));
 
     // 加载配置 (不执行文件清理以避免阻塞)
     loadSettingsWithoutCleanup();
@@ -30,7 +41,19 @@ RecentFilesManager::RecentFilesManager(QObject* parent)
         "RecentFilesManager: Initialized with max files: {}", m_maxRecentFiles);
 }
 
-RecentFilesManager::~RecentFilesManager() { saveSettings(); }
+RecentFilesManager::~RecentFilesManager() {
+    saveSettings();
+
+    // 卡在不可达网络路径上的校验线程无法中断；此时放弃线程池而不是阻塞退出
+    m_validationPool->clear();
+    if (m_validationPool->waitForDone(VALIDATION_TIMEOUT_MS)) {
+        delete m_validationPool;
+    } else {
+        Logger::instance().warning(
+            "[managers] Abandoning {} stalled recent file validations",
+            m_validationPool->activeThreadCount());
+    }
+}
 
 void RecentFilesManager::addRecentFile(const QString& filePath) {
     if (filePath.isEmpty()) {
@@ -58,13 +81,11 @@ void RecentFilesManager::addRecentFile(const QString& filePath) {
 
     // 添加到列表开头
     m_recentFiles.prepend(newFile);
+    storeFileInfo(newFile);
 
     // 强制执行最大数量限制
     enforceMaxSize();
 
-    // 保存设置
-    saveSettings();
-
     emit recentFileAdded(filePath);
     emit recentFilesChanged();
 
@@ -81,7 +102,8 @@ QStringList RecentFilesManager::getRecentFilePaths() const {
     QMutexLocker locker(&m_mutex);
     QStringList paths;
     for (const RecentFileInfo& info : m_recentFiles) {
-        if (info.isValid()) {
+        // 使用后台校验结果，避免在调用线程上访问文件系统
+        if (info.availability != RecentFileInfo::Availability::Missing) {
             paths.append(info.filePath);
         }
     }
@@ -96,7 +118,7 @@ void RecentFilesManager::clearRecentFiles() {
     }
 
     m_recentFiles.clear();
-    saveSettings();
+    m_store->clear();
 
     emit recentFilesCleared();
     emit recentFilesChanged();
@@ -114,7 +136,7 @@ void RecentFilesManager::removeRecentFile(const QString& filePath) {
 
     if (it != m_recentFiles.end()) {
         m_recentFiles.erase(it);
-        saveSettings();
+        m_store->remove(filePath.toUtf8(), QByteArray());
 
         emit recentFileRemoved(filePath);
         emit recentFilesChanged();
@@ -161,25 +183,100 @@ int RecentFilesManager::getRecentFilesCount() const {
 }
 
 void RecentFilesManager::cleanupInvalidFiles() {
-    QMutexLocker locker(&m_mutex);
+    // 校验在后台进行，确认不存在的文件在结果返回时移除
+    validateFilesAsync(getRecentFilePaths());
+}
 
-    bool changed = false;
-    auto it = m_recentFiles.begin();
-    while (it != m_recentFiles.end()) {
-        if (!it->isValid()) {
-            Logger::instance().debug("[managers] Removing invalid file: {}",
-                                     it->filePath.toStdString());
-            it = m_recentFiles.erase(it);
-            changed = true;
-        } else {
-            ++it;
+void RecentFilesManager::validateFilesAsync(const QStringList& filePaths) {
+    for (const QString& filePath : filePaths) {
+        if (filePath.isEmpty() || m_pendingValidations.contains(filePath)) {
+            continue;
         }
+
+        auto* watcher = new QFutureWatcher<qint64>(this);
+        m_pendingValidations.insert(filePath, watcher);
+
+        connect(watcher, &QFutureWatcher<qint64>::finished, this,
+                [this, filePath, watcher]() {
+                    if (m_pendingValidations.value(filePath) == watcher) {
+                        m_pendingValidations.remove(filePath);
+                    }
+                    watcher->deleteLater();
+                    onValidationFinished(filePath, watcher->result());
+                });
+
+        // 超时后先标记为不可达；迟到的结果仍会更新状态
+        QTimer::singleShot(VALIDATION_TIMEOUT_MS, watcher,
+                           [this, filePath]() {
+                               onValidationTimeout(filePath);
+                           });
+
+        watcher->setFuture(
+            QtConcurrent::run(m_validationPool, [filePath]() -> qint64 {
+                QFileInfo info(filePath);
+                return (info.exists() && info.isFile()) ? info.size() : -1;
+            }));
     }
+}
 
-    if (changed) {
-        saveSettings();
-        emit recentFilesChanged();
+RecentFileInfo::Availability RecentFilesManager::availability(
+    const QString& filePath) const {
+    QMutexLocker locker(&m_mutex);
+    for (const RecentFileInfo& info : m_recentFiles) {
+        if (info.filePath == filePath) {
+            return info.availability;
+        }
     }
+    return RecentFileInfo::Availability::Unknown;
+}
+
+void RecentFilesManager::onValidationFinished(const QString& filePath,
+                                              qint64 fileSize) {
+    if (fileSize >= 0) {
+        setAvailability(filePath, RecentFileInfo::Availability::Available,
+                        fileSize);
+        return;
+    }
+
+    Logger::instance().debug("[managers] Removing invalid file: {}",
+                             filePath.toStdString());
+    setAvailability(filePath, RecentFileInfo::Availability::Missing);
+    removeRecentFile(filePath);
+}
+
+void RecentFilesManager::onValidationTimeout(const QString& filePath) {
+    if (availability(filePath) != RecentFileInfo::Availability::Unknown) {
+        return;
+    }
+
+    Logger::instance().warning(
+        "[managers] Validation timed out after {} ms: {}",
+        VALIDATION_TIMEOUT_MS, filePath.toStdString());
+    setAvailability(filePath, RecentFileInfo::Availability::Unreachable);
+}
+
+void RecentFilesManager::setAvailability(
+    const QString& filePath, RecentFileInfo::Availability availability,
+    qint64 fileSize) {
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = std::find_if(m_recentFiles.begin(), m_recentFiles.end(),
+                               [&filePath](const RecentFileInfo& info) {
+                                   return info.filePath == filePath;
+                               });
+        if (it == m_recentFiles.end()) {
+            return;
+        }
+        if (fileSize >= 0) {
+            it->fileSize = fileSize;
+        }
+        if (it->availability == availability) {
+            return;
+        }
+        it->availability = availability;
+    }
+
+    emit fileAvailabilityChanged(filePath, availability);
 }
 
 void RecentFilesManager::initializeAsync() {
@@ -225,42 +322,110 @@ void RecentFilesManager::loadSettingsWithoutCleanup() {
 
     QMutexLocker locker(&m_mutex);
 
-    m_settings->beginGroup(SETTINGS_GROUP);
-
     // 加载最大文件数量
+    m_settings->beginGroup(SETTINGS_GROUP);
     m_maxRecentFiles =
         m_settings->value(SETTINGS_MAX_FILES_KEY, DEFAULT_MAX_RECENT_FILES)
             .toInt();
+    m_settings->endGroup();
 
-    // 加载文件列表
-    int size = m_settings->beginReadArray(SETTINGS_FILES_KEY);
     m_recentFiles.clear();
-    m_recentFiles.reserve(size);
+    if (!m_store->open()) {
+        Logger::instance().warning(
+            "[managers] Cannot open recent files store: {}",
+            m_store->snapshotPath().toStdString());
+        return;
+    }
+
+    // 旧版本保存在 QSettings 中，首次启动时迁移
+    if (m_store->count() == 0) {
+        importLegacySettings();
+    }
+
+    // 加载文件列表
+    const QList<KeyedRecordStore::Record> records = m_store->records();
+    m_recentFiles.reserve(records.size());
+
+    for (const KeyedRecordStore::Record& record : records) {
+        QVariantMap data;
+        QDataStream in(record.payload);
+        in.setVersion(QDataStream::Qt_6_0);
+        in >> data;
+
+        RecentFileInfo info = variantToFileInfo(data);
+        if (!info.filePath.isEmpty() && !info.fileName.isEmpty()) {
+            m_recentFiles.append(info);
+        } else {
+            Logger::instance().warning(
+                "[managers] Dropping invalid recent file entry: {}",
+                QString::fromUtf8(record.key).toStdString());
+            m_store->remove(record.key, record.id);
+        }
+    }
+
+    // 存储按路径排序，列表按打开时间排序
+    std::sort(m_recentFiles.begin(), m_recentFiles.end(),
+              [](const RecentFileInfo& a, const RecentFileInfo& b) {
+                  return a.lastOpened > b.lastOpened;
+              });
+    enforceMaxSize();
 
-    int validCount = 0;
+    Logger::instance().debug(
+        "[managers] Loaded {} valid recent files out of {} total entries "
+        "(without cleanup)",
+        m_recentFiles.size(), records.size());
+}
+
+void RecentFilesManager::importLegacySettings() {
+    // 注意：调用此方法时应该已经加锁
+    m_settings->beginGroup(SETTINGS_GROUP);
+
+    int size = m_settings->beginReadArray(SETTINGS_FILES_KEY);
+    QList<KeyedRecordStore::Record> records;
+    records.reserve(size);
     for (int i = 0; i < size; ++i) {
         m_settings->setArrayIndex(i);
         QVariantMap data = m_settings->value("fileInfo").toMap();
-        if (!data.isEmpty()) {
-            RecentFileInfo info = variantToFileInfo(data);
-            // Only add valid file info (variantToFileInfo now validates data)
-            if (!info.filePath.isEmpty() && !info.fileName.isEmpty()) {
-                m_recentFiles.append(info);
-                validCount++;
-            } else {
-                Logger::instance().warning(
-                    "[managers] Skipping invalid file entry at index {}", i);
-            }
+        if (data.isEmpty()) {
+            continue;
         }
-    }
 
+        RecentFileInfo info = variantToFileInfo(data);
+        if (!info.filePath.isEmpty() && !info.fileName.isEmpty()) {
+            records.append(
+                {info.filePath.toUtf8(), QByteArray(), encodeFileInfo(info)});
+        }
+    }
     m_settings->endArray();
+
+    // 整批写入一个新快照，只同步一次磁盘
+    if (size > 0 && m_store->replaceAll(records)) {
+        m_settings->remove(SETTINGS_FILES_KEY);
+    }
     m_settings->endGroup();
 
-    Logger::instance().debug(
-        "[managers] Loaded {} valid recent files out of {} total entries "
-        "(without cleanup)",
-        validCount, size);
+    if (!records.isEmpty()) {
+        Logger::instance().info(
+            "[managers] Imported {} recent files from settings",
+            records.size());
+    }
+}
+
+QByteArray RecentFilesManager::encodeFileInfo(
+    const RecentFileInfo& info) const {
+    QByteArray payload;
+    QDataStream out(&payload, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << fileInfoToVariant(info);
+    return payload;
+}
+
+void RecentFilesManager::storeFileInfo(const RecentFileInfo& info) {
+    if (!m_store->put(info.filePath.toUtf8(), QByteArray(),
+                      encodeFileInfo(info))) {
+        Logger::instance().warning("[managers] Failed to store recent file: {}",
+                                   info.filePath.toStdString());
+    }
 }
 
 void RecentFilesManager::saveSettings() {
@@ -269,27 +434,20 @@ void RecentFilesManager::saveSettings() {
 
     // 注意：这里不需要加锁，因为调用此方法的地方已经加锁了
 
+    // 保存最大文件数量；文件列表的每次变化已写入存储日志
     m_settings->beginGroup(SETTINGS_GROUP);
-
-    // 保存最大文件数量
     m_settings->setValue(SETTINGS_MAX_FILES_KEY, m_maxRecentFiles);
-
-    // 保存文件列表
-    m_settings->beginWriteArray(SETTINGS_FILES_KEY);
-    for (int i = 0; i < m_recentFiles.size(); ++i) {
-        m_settings->setArrayIndex(i);
-        QVariantMap data = fileInfoToVariant(m_recentFiles[i]);
-        m_settings->setValue("fileInfo", data);
-    }
-    m_settings->endArray();
-
     m_settings->endGroup();
     m_settings->sync();
+
+    // 将日志合并进快照
+    m_store->compact();
 }
 
 void RecentFilesManager::enforceMaxSize() {
     // 注意：调用此方法时应该已经加锁
     while (m_recentFiles.size() > m_maxRecentFiles) {
+        m_store->remove(m_recentFiles.last().filePath.toUtf8(), QByteArray());
         m_recentFiles.removeLast();
     }
 }
@@ -2,28 +2,45 @@
 
 #include <QDateTime>
 #include <QFileInfo>
+#include <QFutureWatcher>
+#include <QHash>
 #include <QMutex>
 #include <QObject>
 #include <QSettings>
 #include <QStringList>
+#include <QThreadPool>
+#include <memory>
+
+class KeyedRecordStore;
 
 /**
  * 最近文件信息结构
  */
 struct RecentFileInfo {
+    // 文件可用性（由后台校验得出，不持久化）
+    enum class Availability {
+        Unknown,     // 尚未校验
+        Available,   // 文件存在
+        Missing,     // 文件已不存在
+        Unreachable  // 校验超时（如网络路径不可达）
+    };
+
     QString filePath;
     QString fileName;
     QDateTime lastOpened;
     qint64 fileSize;
+    Availability availability;
 
-    RecentFileInfo() : fileSize(0) {}
+    RecentFileInfo() : fileSize(0), availability(Availability::Unknown) {}
 
-    RecentFileInfo(const QString& path) : filePath(path), fileSize(0) {
+    RecentFileInfo(const QString& path)
+        : filePath(path), fileSize(0), availability(Availability::Unknown) {
         QFileInfo info(path);
         fileName = info.fileName();
         lastOpened = QDateTime::currentDateTime();
         if (info.exists()) {
             fileSize = info.size();
+            availability = Availability::Available;
         }
     }
 
@@ -39,6 +56,10 @@ struct RecentFileInfo {
 /**
  * 最近文件管理器
  * 负责管理最近打开的文件列表，提供添加、获取、清空等功能
+ *
+ * 文件列表保存在 KeyedRecordStore 中（以路径为键），每次变化只追加一条
+ * 日志记录，不再整体重写；异常退出时最多丢失正在写入的一条。
+ * 最大数量等配置仍保存在 QSettings 中。
  */
 class RecentFilesManager : public QObject {
     Q_OBJECT
@@ -66,11 +87,17 @@ public:
     // 异步初始化
     void initializeAsync();
 
+    // 后台校验：每个路径在线程池中检查，超时则标记为不可达
+    void validateFilesAsync(const QStringList& filePaths);
+    RecentFileInfo::Availability availability(const QString& filePath) const;
+
 signals:
     void recentFilesChanged();
     void recentFileAdded(const QString& filePath);
     void recentFileRemoved(const QString& filePath);
     void recentFilesCleared();
+    void fileAvailabilityChanged(const QString& filePath,
+                                 RecentFileInfo::Availability availability);
 
 private slots:
     void saveSettings();
@@ -78,17 +105,34 @@ private slots:
 private:
     void loadSettings();
     void loadSettingsWithoutCleanup();
+    void importLegacySettings();
+    void storeFileInfo(const RecentFileInfo& info);
+    QByteArray encodeFileInfo(const RecentFileInfo& info) const;
     void enforceMaxSize();
     QVariantMap fileInfoToVariant(const RecentFileInfo& info) const;
     RecentFileInfo variantToFileInfo(const QVariantMap& variant) const;
+    void onValidationFinished(const QString& filePath, qint64 fileSize);
+    void onValidationTimeout(const QString& filePath);
+    void setAvailability(const QString& filePath,
+                         RecentFileInfo::Availability availability,
+                         qint64 fileSize = -1);
 
     QSettings* m_settings;
+    std::unique_ptr<KeyedRecordStore> m_store;
     QList<RecentFileInfo> m_recentFiles;
     int m_maxRecentFiles;
     mutable QRecursiveMutex m_mutex;
 
+    // 校验线程池独立于全局线程池，阻塞的网络路径不会占用其他后台任务
+    QThreadPool* m_validationPool;
+    QHash<QString, QFutureWatcher<qint64>*> m_pendingValidations;
+
     static const int DEFAULT_MAX_RECENT_FILES = 10;
+    static const int VALIDATION_TIMEOUT_MS = 1500;
+    static const int VALIDATION_THREADS = 4;
     static const QString SETTINGS_GROUP;
     static const QString SETTINGS_MAX_FILES_KEY;
     static const QString SETTINGS_FILES_KEY;
 };
+
+Q_DECLARE_METATYPE(RecentFileInfo::Availability)
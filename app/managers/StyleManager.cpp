@@ -2,6 +2,7 @@
 #include <QFontDatabase>
 #include <QWidget>
 #include <QApplication>
+#include <QStyle>
 #include "utils/Logger.h"
 
 StyleManager& StyleManager::instance() {
@@ -12,7 +13,38 @@ StyleManager& StyleManager::instance() {
 StyleManager::StyleManager() : m_currentTheme(Theme::Light) {
     Logger::instance().info(
         "[managers] StyleManager initialized with Light theme");
+
+    // 预先构建两套主题的调色板；最后构建亮色主题，使当前颜色与默认主题一致
+    buildThemeResources(Theme::Dark);
+    buildThemeResources(Theme::Light);
+
+    // 样式表中的颜色全部引用调色板角色，两套主题共用同一份样式表，
+    // 只格式化一次
+    m_applicationStyleSheet = createApplicationStyle();
+    m_toolbarStyleSheet = createToolbarStyle();
+    m_statusBarStyleSheet = createStatusBarStyle();
+    m_pdfViewerStyleSheet = createPDFViewerStyle();
+    m_buttonStyleSheet = createButtonStyle();
+    m_scrollBarStyleSheet = createScrollBarStyle();
+
+    if (qobject_cast<QApplication*>(QCoreApplication::instance())) {
+        QApplication::setPalette(resources().palette);
+    }
+}
+
+void StyleManager::buildThemeResources(Theme theme) {
+    m_currentTheme = theme;
     updateColors();
+
+    ThemeResources& res = m_themeResources[static_cast<int>(theme)];
+    res.palette = createPalette();
+    res.viewerPalette = res.palette;
+    res.viewerPalette.setColor(QPalette::Window, viewerBackgroundColor());
+    res.viewerPalette.setColor(QPalette::Base, viewerBackgroundColor());
+}
+
+const StyleManager::ThemeResources& StyleManager::resources() const {
+    return m_themeResources[static_cast<int>(m_currentTheme)];
 }
 
 void StyleManager::setTheme(Theme theme) {
@@ -22,12 +54,36 @@ void StyleManager::setTheme(Theme theme) {
                                 static_cast<int>(theme));
         m_currentTheme = theme;
         updateColors();
+
+        // 只替换预构建的调色板，不重新设置样式表
+        if (qobject_cast<QApplication*>(QCoreApplication::instance())) {
+            QApplication::setPalette(resources().palette);
+            repolishStyledWidgets();
+        }
+
         emit themeChanged(theme);
         Logger::instance().debug(
             "[managers] Theme change completed and signal emitted");
     }
 }
 
+void StyleManager::repolishStyledWidgets() const {
+    // QStyleSheetStyle 在 polish 时才把 palette(...) 解析为具体颜色，
+    // 替换调色板后只有重新 polish 的控件才会变色。只处理样式表作用到的
+    // 控件，并跳过声明了样式与调色板无关的控件（如成百上千的页面控件）
+    const QWidgetList widgets = QApplication::allWidgets();
+    for (QWidget* widget : widgets) {
+        if (!widget->testAttribute(Qt::WA_StyleSheet) ||
+            widget->property(PALETTE_INDEPENDENT_PROPERTY).toBool()) {
+            continue;
+        }
+        QStyle* style = widget->style();
+        style->unpolish(widget);
+        style->polish(widget);
+        widget->update();
+    }
+}
+
 void StyleManager::toggleTheme() {
     Theme newTheme = (m_currentTheme == Theme::Light) ? Theme::Dark : Theme::Light;
     setTheme(newTheme);
@@ -56,6 +112,7 @@ void StyleManager::updateColors() {
         m_hoverColor = QColor(243, 242, 241);       // 悬停灰
         m_pressedColor = QColor(237, 235, 233);     // 按下灰
         m_accentColor = QColor(16, 110, 190);       // 强调蓝
+        m_viewerBackgroundColor = QColor(245, 245, 245);  // 查看区浅灰
     } else {
         // 暗色主题
         m_primaryColor = QColor(96, 205, 255);         // 亮蓝
@@ -68,98 +125,142 @@ void StyleManager::updateColors() {
         m_hoverColor = QColor(50, 49, 48);             // 悬停深灰
         m_pressedColor = QColor(60, 58, 56);           // 按下深灰
         m_accentColor = QColor(118, 185, 237);         // 强调亮蓝
+        m_viewerBackgroundColor = QColor(30, 30, 30);  // 查看区深灰
     }
 }
 
+QPalette StyleManager::createPalette() const {
+    QPalette palette;
+    palette.setColor(QPalette::Window, backgroundColor());
+    palette.setColor(QPalette::WindowText, textColor());
+    palette.setColor(QPalette::Base, backgroundColor());
+    palette.setColor(QPalette::AlternateBase, surfaceColor());
+    palette.setColor(QPalette::Text, textColor());
+    palette.setColor(QPalette::PlaceholderText, textSecondaryColor());
+    palette.setColor(QPalette::Button, surfaceColor());
+    palette.setColor(QPalette::ButtonText, textColor());
+    palette.setColor(QPalette::BrightText, accentColor());
+    palette.setColor(QPalette::ToolTipBase, surfaceColor());
+    palette.setColor(QPalette::ToolTipText, textColor());
+    palette.setColor(QPalette::Highlight, accentColor());
+    palette.setColor(QPalette::HighlightedText, QColor(255, 255, 255));
+    palette.setColor(QPalette::Link, primaryColor());
+    palette.setColor(QPalette::Light, hoverColor());
+    palette.setColor(QPalette::Midlight, hoverColor());
+    palette.setColor(QPalette::Mid, borderColor());
+    palette.setColor(QPalette::Dark, pressedColor());
+    palette.setColor(QPalette::Shadow, secondaryColor());
+
+    palette.setColor(QPalette::Disabled, QPalette::WindowText,
+                     textSecondaryColor());
+    palette.setColor(QPalette::Disabled, QPalette::Text, textSecondaryColor());
+    palette.setColor(QPalette::Disabled, QPalette::ButtonText,
+                     textSecondaryColor());
+    return palette;
+}
+
+QPalette StyleManager::palette() const { return resources().palette; }
+
+QPalette StyleManager::palette(Theme theme) const {
+    return m_themeResources[static_cast<int>(theme)].palette;
+}
+
+void StyleManager::applyPalette(QWidget* widget) const {
+    if (widget) {
+        widget->setPalette(resources().palette);
+    }
+}
+
+void StyleManager::applyViewerPalette(QWidget* widget) const {
+    if (!widget) {
+        return;
+    }
+
+    widget->setAutoFillBackground(true);
+    widget->setPalette(resources().viewerPalette);
+}
+
 QString StyleManager::getApplicationStyleSheet() const {
+    return m_applicationStyleSheet;
+}
+
+QString StyleManager::createApplicationStyle() const {
     return QString(R"(
         QMainWindow {
-            background-color: %1;
-            color: %2;
+            background-color: palette(window);
+            color: palette(text);
         }
         QWidget {
-            background-color: %1;
-            color: %2;
+            background-color: palette(window);
+            color: palette(text);
             font-family: "Segoe UI", Arial, sans-serif;
             font-size: 9pt;
         }
         QGroupBox {
             font-weight: bold;
-            border: 1px solid %3;
-            border-radius: %4px;
+            border: 1px solid palette(mid);
+            border-radius: %1px;
             margin-top: 8px;
             padding-top: 4px;
-            background-color: %5;
+            background-color: palette(alternate-base);
         }
         QGroupBox::title {
             subcontrol-origin: margin;
             left: 8px;
             padding: 0 4px 0 4px;
-            color: %6;
+            color: palette(placeholder-text);
         }
     )")
-        .arg(backgroundColor().name())
-        .arg(textColor().name())
-        .arg(borderColor().name())
-        .arg(borderRadius())
-        .arg(surfaceColor().name())
-        .arg(textSecondaryColor().name());
+        .arg(borderRadius());
 }
 
 QString StyleManager::getToolbarStyleSheet() const {
+    return m_toolbarStyleSheet;
+}
+
+QString StyleManager::createToolbarStyle() const {
     return QString(R"(
         QWidget#toolbar {
-            background-color: %1;
-            border-bottom: 1px solid %2;
-            padding: %3px;
+            background-color: palette(alternate-base);
+            border-bottom: 1px solid palette(mid);
+            padding: %1px;
         }
     )")
-        .arg(surfaceColor().name())
-        .arg(borderColor().name())
         .arg(spacing());
 }
 
 QString StyleManager::getButtonStyleSheet() const {
-    return createButtonStyle();
+    return m_buttonStyleSheet;
 }
 
 QString StyleManager::createButtonStyle() const {
     return QString(R"(
         QPushButton {
-            background-color: %1;
-            border: 1px solid %2;
-            border-radius: %3px;
-            color: %4;
+            background-color: palette(button);
+            border: 1px solid palette(mid);
+            border-radius: %1px;
+            color: palette(button-text);
             font-weight: 500;
             padding: 6px 12px;
         }
         QPushButton:hover {
-            background-color: %7;
-            border-color: %8;
+            background-color: palette(midlight);
+            border-color: palette(highlight);
         }
         QPushButton:pressed {
-            background-color: %9;
-            border-color: %8;
+            background-color: palette(dark);
+            border-color: palette(highlight);
         }
         QPushButton:disabled {
-            background-color: %1;
-            border-color: %2;
-            color: %10;
+            background-color: palette(button);
+            border-color: palette(mid);
+            color: palette(placeholder-text);
         }
         QPushButton:focus {
-            border: 2px solid %8;
+            border: 2px solid palette(highlight);
         }
     )")
-        .arg(surfaceColor().name())
-        .arg(borderColor().name())
-        .arg(borderRadius())
-        .arg(textColor().name())
-        .arg(buttonMinWidth())
-        .arg(buttonHeight())
-        .arg(hoverColor().name())
-        .arg(accentColor().name())
-        .arg(pressedColor().name())
-        .arg(textSecondaryColor().name());
+        .arg(borderRadius());
 }
 
 QColor StyleManager::primaryColor() const { return m_primaryColor; }
@@ -172,6 +273,9 @@ QColor StyleManager::borderColor() const { return m_borderColor; }
 QColor StyleManager::hoverColor() const { return m_hoverColor; }
 QColor StyleManager::pressedColor() const { return m_pressedColor; }
 QColor StyleManager::accentColor() const { return m_accentColor; }
+QColor StyleManager::viewerBackgroundColor() const {
+    return m_viewerBackgroundColor;
+}
 
 QFont StyleManager::defaultFont() const {
     QFont font("Segoe UI", 9);
@@ -191,79 +295,56 @@ QFont StyleManager::buttonFont() const {
 }
 
 QString StyleManager::getStatusBarStyleSheet() const {
+    return m_statusBarStyleSheet;
+}
+
+QString StyleManager::createStatusBarStyle() const {
     return QString(R"(
         QStatusBar {
-            background-color: %1;
-            border-top: 1px solid %2;
-            color: %3;
+            background-color: palette(alternate-base);
+            border-top: 1px solid palette(mid);
+            color: palette(text);
             padding: 4px;
         }
         QStatusBar::item {
             border: none;
         }
         QStatusBar QLabel {
-            color: %4;
+            color: palette(placeholder-text);
             padding: 2px 8px;
         }
         QStatusBar QLineEdit {
-            background-color: %5;
-            border: 1px solid %2;
+            background-color: palette(base);
+            border: 1px solid palette(mid);
             border-radius: 3px;
             padding: 2px 6px;
-            color: %3;
+            color: palette(text);
         }
         QStatusBar QLineEdit:focus {
-            border-color: %6;
+            border-color: palette(highlight);
         }
-    )")
-        .arg(surfaceColor().name())
-        .arg(borderColor().name())
-        .arg(textColor().name())
-        .arg(textSecondaryColor().name())
-        .arg(backgroundColor().name())
-        .arg(accentColor().name());
+    )");
 }
 
 QString StyleManager::getPDFViewerStyleSheet() const {
-    // 根据主题动态设置PDF查看器背景色
-    QColor pdfBackgroundColor = (m_currentTheme == Theme::Light) 
-                                ? QColor(245, 245, 245)  // 亮色主题使用浅灰
-                                : QColor(30, 30, 30);    // 暗色主题使用深灰
-    
-    QColor pageBackgroundColor = (m_currentTheme == Theme::Light) 
-                                ? QColor(255, 255, 255)  // 亮色主题PDF页面白色
-                                : QColor(45, 45, 48);    // 暗色主题PDF页面深灰
-    
+    return m_pdfViewerStyleSheet;
+}
+
+QString StyleManager::createPDFViewerStyle() const {
+    // PDF页面控件自行绘制纸张和边框；查看区域的背景由 applyViewerPalette
+    // 设置的调色板填充，样式表不再覆盖
     return QString(R"(
         QScrollArea#singlePageScrollArea {
-            background-color: %1;
             border: none;
         }
         QScrollArea#continuousScrollArea {
-            background-color: %1;
             border: none;
         }
-        QScrollArea > QWidget > QWidget {
-            background-color: %1;
-        }
-        QLabel#pdfPage {
-            background-color: %2;
-            border: 1px solid %3;
-            border-radius: 4px;
-            margin: 8px;
-        }
-        PDFPageWidget {
-            background-color: %2;
-            border: none;
-        }
-    )")
-        .arg(pdfBackgroundColor.name())
-        .arg(pageBackgroundColor.name())
-        .arg(borderColor().name());
+    )");
 }
 
 QString StyleManager::getScrollBarStyleSheet() const {
-    return createScrollBarStyle();
+    return m_scrollBarStyleSheet;
 }
 
 void StyleManager::applyThemeStyleSheet(const QString& styleSheet) {
@@ -318,52 +399,48 @@ void StyleManager::forceApplyTheme(QWidget* widget, const QString& styleSheet) {
 QString StyleManager::createScrollBarStyle() const {
     return QString(R"(
         QScrollBar:vertical {
-            background-color: %1;
+            background-color: palette(alternate-base);
             width: 12px;
             border: none;
             border-radius: 6px;
         }
         QScrollBar::handle:vertical {
-            background-color: %2;
+            background-color: palette(mid);
             border-radius: 6px;
             min-height: 20px;
             margin: 0px;
         }
         QScrollBar::handle:vertical:hover {
-            background-color: %3;
+            background-color: palette(placeholder-text);
         }
         QScrollBar::handle:vertical:pressed {
-            background-color: %4;
+            background-color: palette(shadow);
         }
         QScrollBar::add-line:vertical,
         QScrollBar::sub-line:vertical {
             height: 0px;
         }
         QScrollBar:horizontal {
-            background-color: %1;
+            background-color: palette(alternate-base);
             height: 12px;
             border: none;
             border-radius: 6px;
         }
         QScrollBar::handle:horizontal {
-            background-color: %2;
+            background-color: palette(mid);
             border-radius: 6px;
             min-width: 20px;
             margin: 0px;
         }
         QScrollBar::handle:horizontal:hover {
-            background-color: %3;
+            background-color: palette(placeholder-text);
         }
         QScrollBar::handle:horizontal:pressed {
-            background-color: %4;
+            background-color: palette(shadow);
         }
         QScrollBar::add-line:horizontal,
         QScrollBar::sub-line:horizontal {
             width: 0px;
         }
-    )")
-        .arg(surfaceColor().name())
-        .arg(borderColor().name())
-        .arg(textSecondaryColor().name())
-        .arg(secondaryColor().name());
+    )");
 }
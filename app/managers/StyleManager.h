@@ -4,6 +4,7 @@
 #include <QColor>
 #include <QFont>
 #include <QObject>
+#include <QPalette>
 #include <QString>
 #include <QWidget>
 #include <QList>
@@ -25,10 +26,18 @@ public:
     void setDarkTheme();  // 直接设置暗色主题
     Theme currentTheme() const { return m_currentTheme; }
 
-    // 统一主题应用
+    // 应用样式表：启动时调用一次，切换主题不再重新设置
     void applyThemeStyleSheet(const QString& styleSheet);
     void forceApplyTheme(QWidget* widget, const QString& styleSheet);
 
+    // 调色板主题：每个主题的调色板在启动时预先构建，切换主题时只替换调色板，
+    // 样式表中的颜色通过 palette(...) 随之变化
+    QPalette palette() const;
+    QPalette palette(Theme theme) const;
+    void applyPalette(QWidget* widget) const;
+    // PDF查看区域（页面之间的空白）使用的调色板
+    void applyViewerPalette(QWidget* widget) const;
+
     // 样式表获取
     QString getApplicationStyleSheet() const;
     QString getToolbarStyleSheet() const;
@@ -48,6 +57,7 @@ public:
     QColor hoverColor() const;
     QColor pressedColor() const;
     QColor accentColor() const;
+    QColor viewerBackgroundColor() const;
 
     // 字体获取
     QFont defaultFont() const;
@@ -62,6 +72,11 @@ public:
     int margin() const { return 12; }
     int borderRadius() const { return 6; }
 
+    // 样式表规则不含 palette(...) 的控件设置此属性为 true，切换主题时
+    // 不必重新 polish
+    static constexpr char PALETTE_INDEPENDENT_PROPERTY[] =
+        "paletteIndependentStyle";
+
 signals:
     void themeChanged(Theme theme);
     void styleSheetApplied(); // 新增：样式表应用完成信号
@@ -72,11 +87,34 @@ private:
     StyleManager(const StyleManager&) = delete;
     StyleManager& operator=(const StyleManager&) = delete;
 
+    // 每个主题的预构建调色板，切换主题时直接替换
+    struct ThemeResources {
+        QPalette palette;
+        QPalette viewerPalette;
+    };
+
     void updateColors();
+    void repolishStyledWidgets() const;
+    void buildThemeResources(Theme theme);
+    const ThemeResources& resources() const;
+    QPalette createPalette() const;
+    QString createApplicationStyle() const;
+    QString createToolbarStyle() const;
+    QString createStatusBarStyle() const;
+    QString createPDFViewerStyle() const;
     QString createButtonStyle() const;
     QString createScrollBarStyle() const;
 
     Theme m_currentTheme;
+    ThemeResources m_themeResources[2];
+
+    // 样式表只引用调色板角色，与主题无关，启动时格式化一次
+    QString m_applicationStyleSheet;
+    QString m_toolbarStyleSheet;
+    QString m_statusBarStyleSheet;
+    QString m_pdfViewerStyleSheet;
+    QString m_buttonStyleSheet;
+    QString m_scrollBarStyleSheet;
 
     // 颜色定义
     QColor m_primaryColor;
@@ -89,6 +127,7 @@ private:
     QColor m_hoverColor;
     QColor m_pressedColor;
     QColor m_accentColor;
+    QColor m_viewerBackgroundColor;
 };
 
 // 便捷宏
@@ -5,9 +5,49 @@
 #include <QHash>
 #include <QJsonDocument>
 #include <QPointF>
+#include <QPolygonF>
 #include <QRandomGenerator>
 #include <QtCore>
 #include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+
+void appendVarint(QByteArray& out, quint64 value) {
+    while (value >= 0x80) {
+        out.append(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+// Returns false when the data ends inside a varint or it overflows
+bool readVarint(const QByteArray& data, qsizetype& position, quint64& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (position >= data.size()) {
+            return false;
+        }
+        const quint8 byte = static_cast<quint8>(data[position++]);
+        value |= static_cast<quint64>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+quint64 zigzag(qint64 value) {
+    return (static_cast<quint64>(value) << 1) ^
+           static_cast<quint64>(value >> 63);
+}
+
+qint64 unzigzag(quint64 value) {
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+}  // namespace
 
 // PDFAnnotation serialization implementation
 QJsonObject PDFAnnotation::toJson() const {
@@ -47,16 +87,11 @@ QJsonObject PDFAnnotation::toJson() const {
         obj["endPoint"] = endObj;
     }
 
-    // Ink path for freehand drawing
+    // Ink path for freehand drawing, binary-encoded; a JSON object per
+    // point costs ~40 bytes where the varint deltas take 2-4
     if (type == AnnotationType::Ink && !inkPath.isEmpty()) {
-        QJsonArray pathArray;
-        for (const QPointF& point : inkPath) {
-            QJsonObject pointObj;
-            pointObj["x"] = point.x();
-            pointObj["y"] = point.y();
-            pathArray.append(pointObj);
-        }
-        obj["inkPath"] = pathArray;
+        obj["inkPathData"] =
+            QString::fromLatin1(encodeInkPath(inkPath).toBase64());
     }
 
     return obj;
@@ -100,8 +135,11 @@ PDFAnnotation PDFAnnotation::fromJson(const QJsonObject& json) {
             QPointF(endObj["x"].toDouble(), endObj["y"].toDouble());
     }
 
-    // Ink path
-    if (json.contains("inkPath")) {
+    // Ink path; files written before the binary encoding use a point list
+    if (json.contains("inkPathData")) {
+        annotation.inkPath = decodeInkPath(QByteArray::fromBase64(
+            json["inkPathData"].toString().toLatin1()));
+    } else if (json.contains("inkPath")) {
         QJsonArray pathArray = json["inkPath"].toArray();
         for (const QJsonValue& value : pathArray) {
             QJsonObject pointObj = value.toObject();
@@ -113,6 +151,139 @@ PDFAnnotation PDFAnnotation::fromJson(const QJsonObject& json) {
     return annotation;
 }
 
+void PDFAnnotation::setInkPath(const QList<QPointF>& points,
+                               double zoomFactor) {
+    const double tolerance =
+        INK_TOLERANCE_PIXELS / (zoomFactor > 0.0 ? zoomFactor : 1.0);
+    inkPath = simplifyInkPath(points, tolerance);
+    if (!inkPath.isEmpty()) {
+        boundingRect = QPolygonF(inkPath).boundingRect();
+    }
+}
+
+QList<QPointF> PDFAnnotation::simplifyInkPath(const QList<QPointF>& points,
+                                              double tolerance) {
+    const qsizetype count = points.size();
+    if (count < 3 || tolerance <= 0.0) {
+        return points;
+    }
+
+    const double toleranceSquared = tolerance * tolerance;
+    std::vector<bool> keep(count, false);
+    keep.front() = true;
+    keep.back() = true;
+
+    // Iterative Ramer-Douglas-Peucker: long strokes would overflow the
+    // stack with recursion
+    QList<std::pair<qsizetype, qsizetype>> ranges = {{0, count - 1}};
+    while (!ranges.isEmpty()) {
+        const auto [first, last] = ranges.takeLast();
+        const QPointF start = points[first];
+        const QPointF chord = points[last] - start;
+        const double chordSquared = QPointF::dotProduct(chord, chord);
+
+        double farthestSquared = 0.0;
+        qsizetype farthest = -1;
+        for (qsizetype i = first + 1; i < last; ++i) {
+            // Distance to the segment, not the infinite line, so strokes
+            // that double back are kept
+            const QPointF offset = points[i] - start;
+            double t = chordSquared > 0.0
+                           ? QPointF::dotProduct(offset, chord) / chordSquared
+                           : 0.0;
+            t = qBound(0.0, t, 1.0);
+            const QPointF away = offset - t * chord;
+            const double distanceSquared = QPointF::dotProduct(away, away);
+            if (distanceSquared > farthestSquared) {
+                farthestSquared = distanceSquared;
+                farthest = i;
+            }
+        }
+
+        if (farthest >= 0 && farthestSquared > toleranceSquared) {
+            keep[farthest] = true;
+            ranges.append({first, farthest});
+            ranges.append({farthest, last});
+        }
+    }
+
+    QList<QPointF> simplified;
+    for (qsizetype i = 0; i < count; ++i) {
+        if (keep[i]) {
+            simplified.append(points[i]);
+        }
+    }
+    return simplified;
+}
+
+const QPainterPath& PDFAnnotation::inkPainterPath() const {
+    if (!m_inkPathCache || m_inkPathCache->points != inkPath) {
+        auto cache = std::make_shared<InkPathCache>();
+        cache->points = inkPath;
+        if (!inkPath.isEmpty()) {
+            cache->path.moveTo(inkPath.first());
+            for (qsizetype i = 1; i < inkPath.size(); ++i) {
+                cache->path.lineTo(inkPath[i]);
+            }
+        }
+        m_inkPathCache = std::move(cache);
+    }
+    return m_inkPathCache->path;
+}
+
+QByteArray PDFAnnotation::encodeInkPath(const QList<QPointF>& points) {
+    QByteArray data;
+    data.reserve(2 + points.size() * 4);
+    data.append(static_cast<char>(INK_ENCODING_VERSION));
+    appendVarint(data, static_cast<quint64>(points.size()));
+
+    qint64 previousX = 0;
+    qint64 previousY = 0;
+    for (const QPointF& point : points) {
+        const qint64 x = qRound64(point.x() * INK_COORDINATE_SCALE);
+        const qint64 y = qRound64(point.y() * INK_COORDINATE_SCALE);
+        appendVarint(data, zigzag(x - previousX));
+        appendVarint(data, zigzag(y - previousY));
+        previousX = x;
+        previousY = y;
+    }
+    return data;
+}
+
+QList<QPointF> PDFAnnotation::decodeInkPath(const QByteArray& data) {
+    QList<QPointF> points;
+    if (data.isEmpty() ||
+        static_cast<quint8>(data[0]) != INK_ENCODING_VERSION) {
+        return points;
+    }
+
+    qsizetype position = 1;
+    quint64 count = 0;
+    // Every point takes at least two bytes, which bounds a corrupt count
+    if (!readVarint(data, position, count) ||
+        count > static_cast<quint64>(data.size() - position) / 2) {
+        return points;
+    }
+
+    points.reserve(static_cast<qsizetype>(count));
+    qint64 x = 0;
+    qint64 y = 0;
+    for (quint64 i = 0; i < count; ++i) {
+        quint64 dx = 0;
+        quint64 dy = 0;
+        if (!readVarint(data, position, dx) ||
+            !readVarint(data, position, dy)) {
+            qWarning() << "Truncated ink path data";
+            return {};
+        }
+        x += unzigzag(dx);
+        y += unzigzag(dy);
+        points.append(QPointF(x / INK_COORDINATE_SCALE,
+                              y / INK_COORDINATE_SCALE));
+    }
+    return points;
+}
+
 bool PDFAnnotation::containsPoint(const QPointF& point) const {
     return boundingRect.contains(point);
 }
@@ -173,7 +344,13 @@ AnnotationType PDFAnnotation::typeFromString(const QString& typeStr) {
 }
 
 AnnotationModel::AnnotationModel(QObject* parent)
-    : QAbstractListModel(parent), m_document(nullptr) {}
+    : QAbstractListModel(parent),
+      m_document(nullptr),
+      m_sweepTimer(new QTimer(this)) {
+    m_sweepTimer->setInterval(SWEEP_INTERVAL_MS);
+    connect(m_sweepTimer, &QTimer::timeout, this,
+            &AnnotationModel::loadNextPagesInBackground);
+}
 
 int AnnotationModel::rowCount(const QModelIndex& parent) const {
     Q_UNUSED(parent)
@@ -305,6 +482,11 @@ QHash<int, QByteArray> AnnotationModel::roleNames() const {
 }
 
 bool AnnotationModel::addAnnotation(const PDFAnnotation& annotation) {
+    // Load the page's own annotations first: otherwise the sweep adds them
+    // next to this one later, and a save in between writes the page's
+    // stored annotations back a second time
+    ensurePageLoaded(annotation.pageNumber);
+
     beginInsertRows(QModelIndex(), m_annotations.size(), m_annotations.size());
     m_annotations.append(annotation);
     endInsertRows();
@@ -371,6 +553,9 @@ QList<PDFAnnotation> AnnotationModel::getAnnotationsForPage(
 }
 
 bool AnnotationModel::removeAnnotationsForPage(int pageNumber) {
+    // Load first so the sweep cannot bring the page's annotations back
+    ensurePageLoaded(pageNumber);
+
     bool removed = false;
     for (int i = m_annotations.size() - 1; i >= 0; --i) {
         if (m_annotations.at(i).pageNumber == pageNumber) {
@@ -398,18 +583,156 @@ int AnnotationModel::getAnnotationCountForPage(int pageNumber) const {
 void AnnotationModel::setDocument(Poppler::Document* document) {
     m_document = document;
     clearAnnotations();
-    if (document) {
-        loadAnnotationsFromDocument();
+
+    // Nothing is read up front; visible pages are requested by the viewer
+    // and the sweep fills in the rest
+    const int pageCount = document ? document->numPages() : 0;
+    m_loadedPages = QBitArray(pageCount);
+    m_sweepCursor = 0;
+    m_loadStatistics = LoadStatistics();
+    m_loadStatistics.pageCount = pageCount;
+    m_loadClock.start();
+
+    if (pageCount > 0) {
+        m_sweepTimer->start();
     }
 }
 
 void AnnotationModel::clearAnnotations() {
+    // Cleared stays cleared: pages not yet read are not loaded afterwards
+    m_sweepTimer->stop();
+    m_loadedPages.fill(true);
+
     beginResetModel();
     m_annotations.clear();
     endResetModel();
     emit annotationsCleared();
 }
 
+bool AnnotationModel::isPageLoaded(int pageNumber) const {
+    return pageNumber < 0 || pageNumber >= m_loadedPages.size() ||
+           m_loadedPages.testBit(pageNumber);
+}
+
+bool AnnotationModel::isFullyLoaded() const {
+    return m_loadedPages.count(true) == m_loadedPages.size();
+}
+
+void AnnotationModel::ensurePageLoaded(int pageNumber) {
+    if (!m_document || isPageLoaded(pageNumber)) {
+        return;
+    }
+
+    QList<PDFAnnotation> loaded = readPageAnnotations(pageNumber);
+    if (!loaded.isEmpty()) {
+        std::sort(loaded.begin(), loaded.end(),
+                  [](const PDFAnnotation& a, const PDFAnnotation& b) {
+                      return a.createdTime > b.createdTime;
+                  });
+
+        // Rows stay grouped by page: insert after the page's existing rows
+        auto position = std::partition_point(
+            m_annotations.cbegin(), m_annotations.cend(),
+            [pageNumber](const PDFAnnotation& annotation) {
+                return annotation.pageNumber <= pageNumber;
+            });
+        const int row =
+            static_cast<int>(std::distance(m_annotations.cbegin(), position));
+
+        beginInsertRows(QModelIndex(), row, row + loaded.size() - 1);
+        for (int i = 0; i < loaded.size(); ++i) {
+            m_annotations.insert(row + i, loaded.at(i));
+        }
+        endInsertRows();
+    }
+
+    emit pageAnnotationsLoaded(pageNumber, loaded.size());
+
+    if (isFullyLoaded()) {
+        finishLoading();
+    }
+}
+
+void AnnotationModel::ensurePagesLoaded(int firstPage, int lastPage) {
+    for (int page = qMax(0, firstPage);
+         page <= lastPage && page < m_loadedPages.size(); ++page) {
+        ensurePageLoaded(page);
+    }
+
+    // Give the viewer a quiet interval before the sweep resumes
+    if (m_sweepTimer->isActive()) {
+        m_sweepTimer->start();
+    }
+}
+
+void AnnotationModel::ensureAllLoaded() {
+    ensurePagesLoaded(0, m_loadedPages.size() - 1);
+}
+
+void AnnotationModel::loadNextPagesInBackground() {
+    QElapsedTimer slice;
+    slice.start();
+
+    while (m_sweepCursor < m_loadedPages.size() &&
+           slice.elapsed() < SWEEP_SLICE_MS) {
+        ensurePageLoaded(m_sweepCursor++);
+    }
+
+    if (m_sweepCursor >= m_loadedPages.size()) {
+        m_sweepTimer->stop();
+    }
+}
+
+QList<PDFAnnotation> AnnotationModel::readPageAnnotations(int pageNumber) {
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<PDFAnnotation> result;
+    m_loadedPages.setBit(pageNumber);
+
+    std::unique_ptr<Poppler::Page> page(m_document->page(pageNumber));
+    if (page) {
+        std::vector<std::unique_ptr<Poppler::Annotation>> popplerAnnotations =
+            page->annotations();
+        for (auto& popplerAnnot : popplerAnnotations) {
+            try {
+                PDFAnnotation annotation = PDFAnnotation::fromPopplerAnnotation(
+                    popplerAnnot.get(), pageNumber);
+                if (!annotation.id.isEmpty()) {
+                    result.append(annotation);
+                }
+            } catch (const std::exception& e) {
+                qWarning() << "Failed to load annotation from page"
+                           << pageNumber << ":" << e.what();
+            }
+        }
+    }
+
+    const double elapsedMs = timer.nsecsElapsed() / 1e6;
+    m_loadStatistics.pagesLoaded++;
+    m_loadStatistics.annotationsLoaded += result.size();
+    m_loadStatistics.totalMs += elapsedMs;
+    if (elapsedMs > m_loadStatistics.slowestPageMs) {
+        m_loadStatistics.slowestPageMs = elapsedMs;
+        m_loadStatistics.slowestPage = pageNumber;
+    }
+
+    return result;
+}
+
+void AnnotationModel::finishLoading() {
+    m_sweepTimer->stop();
+    m_loadStatistics.timeToCompleteMs =
+        m_loadClock.isValid() ? m_loadClock.nsecsElapsed() / 1e6 : 0.0;
+
+    emit annotationsLoaded(m_loadStatistics.annotationsLoaded);
+    qDebug() << "Loaded" << m_loadStatistics.annotationsLoaded
+             << "annotations from" << m_loadStatistics.pagesLoaded
+             << "pages in" << m_loadStatistics.totalMs << "ms (slowest page"
+             << m_loadStatistics.slowestPage << "took"
+             << m_loadStatistics.slowestPageMs << "ms)";
+}
+
 int AnnotationModel::findAnnotationIndex(const QString& annotationId) const {
     for (int i = 0; i < m_annotations.size(); ++i) {
         if (m_annotations.at(i).id == annotationId) {
@@ -440,39 +763,22 @@ bool AnnotationModel::loadAnnotationsFromDocument() {
         return false;
     }
 
+    m_sweepTimer->stop();
+    const int pageCount = m_document->numPages();
+    m_loadedPages = QBitArray(pageCount);
+    m_loadStatistics = LoadStatistics();
+    m_loadStatistics.pageCount = pageCount;
+    m_loadClock.start();
+
     beginResetModel();
     m_annotations.clear();
-
-    int loadedCount = 0;
-    for (int pageNum = 0; pageNum < m_document->numPages(); ++pageNum) {
-        std::unique_ptr<Poppler::Page> page(m_document->page(pageNum));
-        if (!page) {
-            continue;
-        }
-
-        std::vector<std::unique_ptr<Poppler::Annotation>> popplerAnnotations =
-            page->annotations();
-        for (auto& popplerAnnot : popplerAnnotations) {
-            try {
-                PDFAnnotation annotation = PDFAnnotation::fromPopplerAnnotation(
-                    popplerAnnot.get(), pageNum);
-                if (!annotation.id.isEmpty()) {
-                    m_annotations.append(annotation);
-                    loadedCount++;
-                }
-            } catch (const std::exception& e) {
-                qWarning() << "Failed to load annotation from page" << pageNum
-                           << ":" << e.what();
-            }
-        }
+    for (int pageNum = 0; pageNum < pageCount; ++pageNum) {
+        m_annotations.append(readPageAnnotations(pageNum));
     }
-
     sortAnnotations();
     endResetModel();
 
-    emit annotationsLoaded(loadedCount);
-    qDebug() << "Loaded" << loadedCount << "annotations from document";
-
+    finishLoading();
     return true;
 }
 
@@ -2,15 +2,20 @@
 
 #include <poppler-qt6.h>
 #include <QAbstractListModel>
+#include <QBitArray>
 #include <QColor>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QList>
 #include <QObject>
+#include <QPainterPath>
 #include <QRandomGenerator>
 #include <QRectF>
 #include <QString>
+#include <QTimer>
+#include <memory>
 
 /**
  * Annotation types supported by the system
@@ -82,15 +87,66 @@ struct PDFAnnotation {
     bool containsPoint(const QPointF& point) const;
     QString getTypeString() const;
     static AnnotationType typeFromString(const QString& typeStr);
+
+    // Ink capture. Stylus input is simplified when the stroke is stored
+    // (Ramer-Douglas-Peucker), with a tolerance of INK_TOLERANCE_PIXELS
+    // screen pixels at the zoom it was drawn at: the stroke looks the same
+    // at that zoom with a fraction of the captured points. Points are in
+    // page coordinates; the bounding rect follows the stroke.
+    void setInkPath(const QList<QPointF>& points, double zoomFactor = 1.0);
+    static QList<QPointF> simplifyInkPath(const QList<QPointF>& points,
+                                          double tolerance);
+
+    // The stroke as a painter path, built on first use and reused until
+    // inkPath changes
+    const QPainterPath& inkPainterPath() const;
+
+    // Compact persistence: fixed-point coordinates (1/INK_COORDINATE_SCALE
+    // of a point), delta-encoded as zigzag varints
+    static QByteArray encodeInkPath(const QList<QPointF>& points);
+    static QList<QPointF> decodeInkPath(const QByteArray& data);
+
+    static constexpr double INK_TOLERANCE_PIXELS = 0.5;
+    static constexpr double INK_COORDINATE_SCALE = 100.0;
+    static constexpr quint8 INK_ENCODING_VERSION = 1;
+
+    // Render cache behind inkPainterPath(), not annotation data: not
+    // serialized or compared. Shared between copies; holds the points it
+    // was built from, so a changed inkPath is detected by comparing against
+    // them (O(1) while both still share the same data)
+    struct InkPathCache {
+        QList<QPointF> points;
+        QPainterPath path;
+    };
+    mutable std::shared_ptr<const InkPathCache> m_inkPathCache;
 };
 
 /**
  * Model for managing PDF annotations
+ *
+ * Annotations are read from the document lazily, one page at a time:
+ * pages the viewer is about to show are loaded on demand through
+ * ensurePagesLoaded(), and the rest are picked up by a low-priority
+ * background sweep that works in short time slices. Page and global
+ * queries answer from what has been loaded so far; isFullyLoaded() and
+ * the annotationsLoaded() signal tell callers when results are complete,
+ * and ensureAllLoaded() finishes the load synchronously when needed.
  */
 class AnnotationModel : public QAbstractListModel {
     Q_OBJECT
 
 public:
+    // Time spent reading annotations from the document
+    struct LoadStatistics {
+        int pageCount = 0;
+        int pagesLoaded = 0;
+        int annotationsLoaded = 0;
+        double totalMs = 0.0;          // Sum of per-page load times
+        double slowestPageMs = 0.0;
+        int slowestPage = -1;
+        double timeToCompleteMs = 0.0;  // setDocument() to fully loaded
+    };
+
     enum AnnotationRole {
         IdRole = Qt::UserRole + 1,
         TypeRole,
@@ -132,7 +188,11 @@ public:
 
     // Document integration
     void setDocument(Poppler::Document* document);
-    bool loadAnnotationsFromDocument();
+    bool loadAnnotationsFromDocument();  // Eager reload of every page
+    bool isPageLoaded(int pageNumber) const;
+    bool isFullyLoaded() const;
+    void ensureAllLoaded();
+    LoadStatistics loadStatistics() const { return m_loadStatistics; }
     bool saveAnnotationsToDocument();
     void clearAnnotations();
 
@@ -147,19 +207,40 @@ public:
     QMap<AnnotationType, int> getAnnotationCountByType() const;
     QStringList getAuthors() const;
 
+public slots:
+    // Load pages entering (or about to enter) the viewport right away
+    void ensurePageLoaded(int pageNumber);
+    void ensurePagesLoaded(int firstPage, int lastPage);
+
 signals:
     void annotationAdded(const PDFAnnotation& annotation);
     void annotationRemoved(const QString& annotationId);
     void annotationUpdated(const PDFAnnotation& annotation);
-    void annotationsLoaded(int count);
+    void annotationsLoaded(int count);  // Every page has been loaded
+    void pageAnnotationsLoaded(int pageNumber, int count);
     void annotationsSaved(int count);
     void annotationsCleared();
 
+private slots:
+    void loadNextPagesInBackground();
+
 private:
     int findAnnotationIndex(const QString& annotationId) const;
     void sortAnnotations();
     QString generateUniqueId() const;
+    QList<PDFAnnotation> readPageAnnotations(int pageNumber);
+    void finishLoading();
 
     QList<PDFAnnotation> m_annotations;
     Poppler::Document* m_document;
+
+    // Lazy loading state
+    QBitArray m_loadedPages;
+    int m_sweepCursor = 0;
+    QTimer* m_sweepTimer;
+    QElapsedTimer m_loadClock;
+    LoadStatistics m_loadStatistics;
+
+    static constexpr int SWEEP_INTERVAL_MS = 15;
+    static constexpr int SWEEP_SLICE_MS = 4;
 };
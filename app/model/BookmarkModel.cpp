@@ -2,7 +2,10 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QJsonParseError>
+#include <QSet>
 #include <algorithm>
+#include "utils/DocumentFingerprint.h"
+#include "utils/KeyedRecordStore.h"
 
 // Bookmark serialization implementation
 QJsonObject Bookmark::toJson() const {
@@ -10,6 +13,9 @@ QJsonObject Bookmark::toJson() const {
     obj["id"] = id;
     obj["title"] = title;
     obj["documentPath"] = documentPath;
+    if (!documentFingerprint.isEmpty()) {
+        obj["documentFingerprint"] = documentFingerprint;
+    }
     obj["pageNumber"] = pageNumber;
     obj["createdTime"] = createdTime.toString(Qt::ISODate);
     obj["lastAccessed"] = lastAccessed.toString(Qt::ISODate);
@@ -33,6 +39,7 @@ Bookmark Bookmark::fromJson(const QJsonObject& json) {
     bookmark.id = json["id"].toString();
     bookmark.title = json["title"].toString();
     bookmark.documentPath = json["documentPath"].toString();
+    bookmark.documentFingerprint = json["documentFingerprint"].toString();
     bookmark.pageNumber = json["pageNumber"].toInt();
     bookmark.createdTime =
         QDateTime::fromString(json["createdTime"].toString(), Qt::ISODate);
@@ -56,15 +63,13 @@ BookmarkModel::BookmarkModel(QObject* parent)
     initializeStorage();
     loadFromFile();
 
-    // Connect to auto-save on data changes
-    connect(this, &BookmarkModel::dataChanged, this,
-            &BookmarkModel::onDataChanged);
-    connect(this, &BookmarkModel::rowsInserted, this,
-            &BookmarkModel::onDataChanged);
-    connect(this, &BookmarkModel::rowsRemoved, this,
-            &BookmarkModel::onDataChanged);
+    connect(&DocumentFingerprint::instance(),
+            &DocumentFingerprint::fingerprintReady, this,
+            &BookmarkModel::onFingerprintReady);
 }
 
+BookmarkModel::~BookmarkModel() = default;
+
 QModelIndex BookmarkModel::index(int row, int column,
                                  const QModelIndex& parent) const {
     if (!hasIndex(row, column, parent) || parent.isValid()) {
@@ -83,6 +88,9 @@ int BookmarkModel::rowCount(const QModelIndex& parent) const {
     if (parent.isValid()) {
         return 0;
     }
+    // Records that fail to decode are not rows, so a view asking for the
+    // size is the first use that decodes the list
+    ensureMaterialized();
     return m_bookmarks.size();
 }
 
@@ -92,7 +100,12 @@ int BookmarkModel::columnCount(const QModelIndex& parent) const {
 }
 
 QVariant BookmarkModel::data(const QModelIndex& index, int role) const {
-    if (!index.isValid() || index.row() >= m_bookmarks.size()) {
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    ensureMaterialized();
+    if (index.row() >= m_bookmarks.size()) {
         return QVariant();
     }
 
@@ -164,6 +177,7 @@ QVariant BookmarkModel::headerData(int section, Qt::Orientation orientation,
 
 bool BookmarkModel::setData(const QModelIndex& index, const QVariant& value,
                             int role) {
+    ensureMaterialized();
     if (!index.isValid() || index.row() >= m_bookmarks.size()) {
         return false;
     }
@@ -195,6 +209,9 @@ bool BookmarkModel::setData(const QModelIndex& index, const QVariant& value,
     }
 
     if (changed) {
+        if (m_autoSave) {
+            writeBookmark(bookmark);
+        }
         emit dataChanged(index, index, {role});
         emit bookmarkUpdated(bookmark);
         return true;
@@ -233,12 +250,24 @@ bool BookmarkModel::addBookmark(const Bookmark& bookmark) {
         return false;
     }
 
+    Bookmark stored = bookmark;
+    if (stored.documentFingerprint.isEmpty()) {
+        stored.documentFingerprint = fingerprintFor(stored.documentPath);
+    }
+
+    // Before touching the store, so the row count stays consistent
+    ensureMaterialized();
+    if (m_autoSave && !writeBookmark(stored)) {
+        qWarning() << "Failed to store bookmark" << stored.id;
+        return false;
+    }
+
     beginInsertRows(QModelIndex(), m_bookmarks.size(), m_bookmarks.size());
-    m_bookmarks.append(bookmark);
+    m_bookmarks.append(stored);
     endInsertRows();
 
     sortBookmarks();
-    emit bookmarkAdded(bookmark);
+    emit bookmarkAdded(stored);
 
     return true;
 }
@@ -249,6 +278,10 @@ bool BookmarkModel::removeBookmark(const QString& bookmarkId) {
         return false;
     }
 
+    if (m_autoSave) {
+        eraseBookmark(m_bookmarks.at(index));
+    }
+
     beginRemoveRows(QModelIndex(), index, index);
     m_bookmarks.removeAt(index);
     endRemoveRows();
@@ -264,6 +297,12 @@ bool BookmarkModel::updateBookmark(const QString& bookmarkId,
         return false;
     }
 
+    if (m_autoSave) {
+        // The document key may have changed along with the path
+        eraseBookmark(m_bookmarks.at(index));
+        writeBookmark(updatedBookmark);
+    }
+
     m_bookmarks[index] = updatedBookmark;
     QModelIndex modelIndex = this->index(index, 0);
     emit dataChanged(modelIndex, this->index(index, columnCount() - 1));
@@ -280,59 +319,223 @@ Bookmark BookmarkModel::getBookmark(const QString& bookmarkId) const {
     return Bookmark();
 }
 
-QList<Bookmark> BookmarkModel::getAllBookmarks() const { return m_bookmarks; }
+QList<Bookmark> BookmarkModel::getAllBookmarks() const {
+    ensureMaterialized();
+    return m_bookmarks;
+}
 
 QList<Bookmark> BookmarkModel::getBookmarksForDocument(
     const QString& documentPath) const {
-    QList<Bookmark> result;
-    for (const Bookmark& bookmark : m_bookmarks) {
-        if (bookmark.documentPath == documentPath) {
-            result.append(bookmark);
-        }
-    }
-    return result;
+    return lookupDocument(documentPath);
 }
 
 bool BookmarkModel::hasBookmarkForPage(const QString& documentPath,
                                        int pageNumber) const {
-    for (const Bookmark& bookmark : m_bookmarks) {
-        if (bookmark.documentPath == documentPath &&
-            bookmark.pageNumber == pageNumber) {
-            return true;
-        }
-    }
-    return false;
+    return getBookmarkForPage(documentPath, pageNumber).pageNumber >= 0;
 }
 
 Bookmark BookmarkModel::getBookmarkForPage(const QString& documentPath,
                                            int pageNumber) const {
-    for (const Bookmark& bookmark : m_bookmarks) {
-        if (bookmark.documentPath == documentPath &&
-            bookmark.pageNumber == pageNumber) {
+    for (const Bookmark& bookmark : lookupDocument(documentPath)) {
+        if (bookmark.pageNumber == pageNumber) {
             return bookmark;
         }
     }
     return Bookmark();
 }
 
+QList<Bookmark> BookmarkModel::lookupDocument(
+    const QString& documentPath) const {
+    const QString fingerprint = fingerprintFor(documentPath);
+    QList<Bookmark> result;
+
+    if (m_materialized && !m_autoSave) {
+        // Unsaved changes only exist in memory
+        for (const Bookmark& bookmark : m_bookmarks) {
+            if (bookmark.documentPath == documentPath ||
+                (!fingerprint.isEmpty() &&
+                 bookmark.documentFingerprint == fingerprint)) {
+                result.append(bookmark);
+            }
+        }
+        return result;
+    }
+
+    // The content fingerprint lets bookmarks follow a file that was moved or
+    // renamed; the path index keeps them on a file that was edited in place
+    QSet<QString> seen;
+    const QByteArray documentKey =
+        fingerprint.isEmpty() ? QByteArray()
+                              : QByteArray("f:") + fingerprint.toUtf8();
+    if (!documentKey.isEmpty()) {
+        for (const KeyedRecordStore::Record& record :
+             m_store->values(documentKey)) {
+            Bookmark bookmark = decodeBookmark(record.payload);
+            if (!bookmark.id.isEmpty() && !seen.contains(bookmark.id)) {
+                seen.insert(bookmark.id);
+                result.append(bookmark);
+            }
+        }
+    }
+
+    for (const KeyedRecordStore::Record& alias :
+         m_pathIndex->values(documentPath.toUtf8())) {
+        if (alias.payload == documentKey ||
+            seen.contains(QString::fromUtf8(alias.id))) {
+            continue;
+        }
+        const std::optional<QByteArray> payload =
+            m_store->value(alias.payload, alias.id);
+        if (payload) {
+            Bookmark bookmark = decodeBookmark(*payload);
+            if (!bookmark.id.isEmpty()) {
+                seen.insert(bookmark.id);
+                result.append(bookmark);
+            }
+        }
+    }
+
+    std::sort(result.begin(), result.end(),
+              [](const Bookmark& a, const Bookmark& b) {
+                  return a.lastAccessed > b.lastAccessed;
+              });
+    return result;
+}
+
+void BookmarkModel::ensureMaterialized() const {
+    if (m_materialized) {
+        return;
+    }
+    m_materialized = true;
+
+    m_bookmarks.clear();
+    m_bookmarks.reserve(m_store->count());
+    for (const KeyedRecordStore::Record& record : m_store->records()) {
+        Bookmark bookmark = decodeBookmark(record.payload);
+        if (!bookmark.id.isEmpty()) {
+            m_bookmarks.append(bookmark);
+        }
+    }
+    sortBookmarks();
+}
+
+bool BookmarkModel::replaceStores(const QList<Bookmark>& bookmarks) {
+    QList<KeyedRecordStore::Record> records;
+    QList<KeyedRecordStore::Record> aliases;
+    records.reserve(bookmarks.size());
+    aliases.reserve(bookmarks.size());
+    for (const Bookmark& bookmark : bookmarks) {
+        const QByteArray key = primaryKey(bookmark);
+        const QByteArray id = bookmark.id.toUtf8();
+        records.append(
+            {key, id,
+             QJsonDocument(bookmark.toJson()).toJson(QJsonDocument::Compact)});
+        aliases.append({bookmark.documentPath.toUtf8(), id, key});
+    }
+
+    // Each store swaps its snapshot in one write
+    return m_store->replaceAll(records) && m_pathIndex->replaceAll(aliases);
+}
+
+bool BookmarkModel::writeBookmark(const Bookmark& bookmark) {
+    const QByteArray key = primaryKey(bookmark);
+    const QByteArray id = bookmark.id.toUtf8();
+    const QByteArray payload =
+        QJsonDocument(bookmark.toJson()).toJson(QJsonDocument::Compact);
+
+    return m_store->put(key, id, payload) &&
+           m_pathIndex->put(bookmark.documentPath.toUtf8(), id, key);
+}
+
+void BookmarkModel::eraseBookmark(const Bookmark& bookmark) {
+    const QByteArray id = bookmark.id.toUtf8();
+    m_store->remove(primaryKey(bookmark), id);
+    m_pathIndex->remove(bookmark.documentPath.toUtf8(), id);
+}
+
+QByteArray BookmarkModel::primaryKey(const Bookmark& bookmark) {
+    // Prefixes keep fingerprints and fallback paths from ever colliding
+    if (bookmark.documentFingerprint.isEmpty()) {
+        return QByteArray("p:") + bookmark.documentPath.toUtf8();
+    }
+    return QByteArray("f:") + bookmark.documentFingerprint.toUtf8();
+}
+
+Bookmark BookmarkModel::decodeBookmark(const QByteArray& payload) {
+    return Bookmark::fromJson(QJsonDocument::fromJson(payload).object());
+}
+
 void BookmarkModel::initializeStorage() {
     m_storageFile = getStorageFilePath();
+    m_store = std::make_unique<KeyedRecordStore>(m_storageFile);
+    m_pathIndex = std::make_unique<KeyedRecordStore>(getPathIndexFilePath());
+}
+
+QString BookmarkModel::fingerprintFor(const QString& documentPath) {
+    // Memo lookup only, so it just stats the file. Unknown files are hashed
+    // in the background and rekeyed in onFingerprintReady; until then they
+    // are found through the path key.
+    DocumentFingerprint& fingerprints = DocumentFingerprint::instance();
+    const QString fingerprint = fingerprints.cachedFingerprint(documentPath);
+    if (fingerprint.isEmpty()) {
+        fingerprints.requestFingerprint(documentPath);
+    }
+    return fingerprint;
+}
+
+void BookmarkModel::onFingerprintReady(const QString& filePath,
+                                       const QString& fingerprint) {
+    if (fingerprint.isEmpty()) {
+        return;
+    }
+
+    if (m_autoSave) {
+        Bookmark pathOnly;
+        pathOnly.documentPath = filePath;
+        for (const KeyedRecordStore::Record& record :
+             m_store->values(primaryKey(pathOnly))) {
+            Bookmark bookmark = decodeBookmark(record.payload);
+            if (!bookmark.id.isEmpty()) {
+                eraseBookmark(bookmark);
+                bookmark.documentFingerprint = fingerprint;
+                writeBookmark(bookmark);
+            }
+        }
+    }
 
-    // Ensure directory exists
-    QFileInfo fileInfo(m_storageFile);
-    QDir dir = fileInfo.absoluteDir();
-    if (!dir.exists()) {
-        dir.mkpath(".");
+    if (!m_materialized) {
+        return;
+    }
+    for (int i = 0; i < m_bookmarks.size(); ++i) {
+        Bookmark& bookmark = m_bookmarks[i];
+        if (bookmark.documentPath == filePath &&
+            bookmark.documentFingerprint.isEmpty()) {
+            bookmark.documentFingerprint = fingerprint;
+            emit bookmarkUpdated(bookmark);
+        }
     }
 }
 
 QString BookmarkModel::getStorageFilePath() const {
+    QString dataPath =
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(dataPath).filePath("bookmarks.db");
+}
+
+QString BookmarkModel::getPathIndexFilePath() const {
+    QString dataPath =
+        QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QDir(dataPath).filePath("bookmark-paths.db");
+}
+
+QString BookmarkModel::getLegacyFilePath() const {
     QString dataPath =
         QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
     return QDir(dataPath).filePath("bookmarks.json");
 }
 
 int BookmarkModel::findBookmarkIndex(const QString& bookmarkId) const {
+    ensureMaterialized();
     for (int i = 0; i < m_bookmarks.size(); ++i) {
         if (m_bookmarks.at(i).id == bookmarkId) {
             return i;
@@ -341,20 +544,15 @@ int BookmarkModel::findBookmarkIndex(const QString& bookmarkId) const {
     return -1;
 }
 
-void BookmarkModel::sortBookmarks() {
+void BookmarkModel::sortBookmarks() const {
     std::sort(m_bookmarks.begin(), m_bookmarks.end(),
               [](const Bookmark& a, const Bookmark& b) {
                   return a.lastAccessed > b.lastAccessed;  // Most recent first
               });
 }
 
-void BookmarkModel::onDataChanged() {
-    if (m_autoSave) {
-        saveToFile();
-    }
-}
-
 QStringList BookmarkModel::getCategories() const {
+    ensureMaterialized();
     QStringList categories;
     for (const Bookmark& bookmark : m_bookmarks) {
         if (!bookmark.category.isEmpty() &&
@@ -368,6 +566,7 @@ QStringList BookmarkModel::getCategories() const {
 
 QList<Bookmark> BookmarkModel::getBookmarksInCategory(
     const QString& category) const {
+    ensureMaterialized();
     QList<Bookmark> result;
     for (const Bookmark& bookmark : m_bookmarks) {
         if (bookmark.category == category) {
@@ -385,6 +584,9 @@ bool BookmarkModel::moveBookmarkToCategory(const QString& bookmarkId,
     }
 
     m_bookmarks[index].category = category;
+    if (m_autoSave) {
+        writeBookmark(m_bookmarks[index]);
+    }
     QModelIndex modelIndex = this->index(index, 0);
     emit dataChanged(modelIndex, modelIndex, {CategoryRole});
     emit bookmarkUpdated(m_bookmarks[index]);
@@ -393,6 +595,7 @@ bool BookmarkModel::moveBookmarkToCategory(const QString& bookmarkId,
 }
 
 QList<Bookmark> BookmarkModel::searchBookmarks(const QString& query) const {
+    ensureMaterialized();
     QList<Bookmark> result;
     QString lowerQuery = query.toLower();
 
@@ -409,6 +612,7 @@ QList<Bookmark> BookmarkModel::searchBookmarks(const QString& query) const {
 }
 
 QList<Bookmark> BookmarkModel::getRecentBookmarks(int count) const {
+    ensureMaterialized();
     QList<Bookmark> sorted = m_bookmarks;
     std::sort(sorted.begin(), sorted.end(),
               [](const Bookmark& a, const Bookmark& b) {
@@ -423,49 +627,64 @@ QList<Bookmark> BookmarkModel::getRecentBookmarks(int count) const {
 }
 
 bool BookmarkModel::saveToFile() {
-    QJsonArray bookmarksArray;
-    for (const Bookmark& bookmark : m_bookmarks) {
-        bookmarksArray.append(bookmark.toJson());
+    if (!m_store->isOpen() || !m_pathIndex->isOpen()) {
+        return false;
     }
 
-    QJsonObject rootObject;
-    rootObject["version"] = "1.0";
-    rootObject["bookmarks"] = bookmarksArray;
-    rootObject["savedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
-
-    QJsonDocument doc(rootObject);
+    if (!m_autoSave) {
+        // Changes were only kept in memory; replace the store with them
+        ensureMaterialized();
+        if (!replaceStores(m_bookmarks)) {
+            qWarning() << "Failed to write bookmark store:" << m_storageFile;
+            return false;
+        }
+    }
 
-    QFile file(m_storageFile);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open bookmarks file for writing:"
-                   << m_storageFile;
+    // Fold the journal into the snapshots
+    if (!m_store->compact() || !m_pathIndex->compact()) {
+        qWarning() << "Failed to compact bookmark store:" << m_storageFile;
         return false;
     }
 
-    qint64 bytesWritten = file.write(doc.toJson());
-    file.close();
+    emit bookmarksSaved(rowCount());
+    qDebug() << "Saved" << rowCount() << "bookmarks to" << m_storageFile;
+    return true;
+}
 
-    if (bytesWritten > 0) {
-        emit bookmarksSaved(m_bookmarks.size());
-        qDebug() << "Saved" << m_bookmarks.size() << "bookmarks to"
-                 << m_storageFile;
-        return true;
+bool BookmarkModel::loadFromFile() {
+    beginResetModel();
+    m_bookmarks.clear();
+    m_materialized = false;
+
+    // Maps the snapshots and replays the journals; no bookmark is decoded
+    const bool opened = m_store->open() && m_pathIndex->open();
+    if (opened && m_store->count() == 0) {
+        importLegacyFile();
     }
+    endResetModel();
 
-    return false;
+    if (!opened) {
+        qWarning() << "Failed to open bookmark store:" << m_storageFile;
+        return false;
+    }
+
+    emit bookmarksLoaded(m_store->count());
+    qDebug() << "Opened" << m_store->count() << "bookmarks from"
+             << m_storageFile;
+
+    return true;
 }
 
-bool BookmarkModel::loadFromFile() {
-    QFile file(m_storageFile);
+void BookmarkModel::importLegacyFile() {
+    QFile file(getLegacyFilePath());
     if (!file.exists()) {
-        qDebug() << "Bookmarks file does not exist, starting with empty list";
-        return true;  // Not an error for first run
+        return;  // Not an error for first run
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
         qWarning() << "Failed to open bookmarks file for reading:"
-                   << m_storageFile;
-        return false;
+                   << file.fileName();
+        return;
     }
 
     QByteArray data = file.readAll();
@@ -477,30 +696,33 @@ bool BookmarkModel::loadFromFile() {
     if (parseError.error != QJsonParseError::NoError) {
         qWarning() << "Failed to parse bookmarks JSON:"
                    << parseError.errorString();
-        return false;
+        return;
     }
 
     QJsonObject rootObject = doc.object();
     QJsonArray bookmarksArray = rootObject["bookmarks"].toArray();
 
-    beginResetModel();
-    m_bookmarks.clear();
-
+    // Entries without a fingerprint stay keyed by path; fingerprinting
+    // thousands of files here would undo the point of a lazy startup
+    QList<Bookmark> bookmarks;
+    bookmarks.reserve(bookmarksArray.size());
     for (const QJsonValue& value : bookmarksArray) {
         if (value.isObject()) {
             Bookmark bookmark = Bookmark::fromJson(value.toObject());
             if (!bookmark.id.isEmpty()) {
-                m_bookmarks.append(bookmark);
+                bookmarks.append(bookmark);
             }
         }
     }
 
-    sortBookmarks();
-    endResetModel();
+    if (!replaceStores(bookmarks)) {
+        return;  // Keep the JSON file so the import is retried
+    }
 
-    emit bookmarksLoaded(m_bookmarks.size());
-    qDebug() << "Loaded" << m_bookmarks.size() << "bookmarks from"
-             << m_storageFile;
+    // Kept as a backup instead of deleted
+    QFile::remove(file.fileName() + ".migrated");
+    file.rename(file.fileName() + ".migrated");
 
-    return true;
+    qDebug() << "Imported" << bookmarks.size() << "bookmarks from"
+             << file.fileName();
 }
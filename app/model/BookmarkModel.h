@@ -12,6 +12,9 @@
 #include <QSettings>
 #include <QStandardPaths>
 #include <QString>
+#include <memory>
+
+class KeyedRecordStore;
 
 /**
  * Represents a single bookmark entry
@@ -20,6 +23,7 @@ struct Bookmark {
     QString id;              // Unique identifier
     QString title;           // User-defined title
     QString documentPath;    // Path to the PDF document
+    QString documentFingerprint;  // Content digest, survives renames
     int pageNumber;          // Page number (0-based)
     QDateTime createdTime;   // When bookmark was created
     QDateTime lastAccessed;  // When bookmark was last accessed
@@ -61,6 +65,13 @@ struct Bookmark {
 
 /**
  * Model for managing bookmarks with persistent storage
+ *
+ * Bookmarks are kept in a KeyedRecordStore keyed by document fingerprint
+ * (or path, for documents that could not be fingerprinted). Opening the
+ * store only maps it, so startup cost does not grow with the history;
+ * per-document lookups are binary searches in the store, and the full
+ * list is decoded on first use by a view or a whole-list query. Every
+ * change is journaled as it happens.
  */
 class BookmarkModel : public QAbstractItemModel {
     Q_OBJECT
@@ -79,7 +90,7 @@ public:
     };
 
     explicit BookmarkModel(QObject* parent = nullptr);
-    ~BookmarkModel() = default;
+    ~BookmarkModel() override;
 
     // QAbstractItemModel interface
     QModelIndex index(int row, int column,
@@ -134,15 +145,35 @@ signals:
     void bookmarksSaved(int count);
 
 private slots:
-    void onDataChanged();
+    // Moves bookmarks added before their document's digest was known from
+    // the path key to the fingerprint key
+    void onFingerprintReady(const QString& filePath,
+                            const QString& fingerprint);
 
 private:
     void initializeStorage();
+    void importLegacyFile();
+    void ensureMaterialized() const;
+    QList<Bookmark> lookupDocument(const QString& documentPath) const;
+    bool replaceStores(const QList<Bookmark>& bookmarks);
+    bool writeBookmark(const Bookmark& bookmark);
+    void eraseBookmark(const Bookmark& bookmark);
+    static QByteArray primaryKey(const Bookmark& bookmark);
+    static Bookmark decodeBookmark(const QByteArray& payload);
+    static QString fingerprintFor(const QString& documentPath);
     QString getStorageFilePath() const;
+    QString getPathIndexFilePath() const;
+    QString getLegacyFilePath() const;
     int findBookmarkIndex(const QString& bookmarkId) const;
-    void sortBookmarks();
-
-    QList<Bookmark> m_bookmarks;
+    void sortBookmarks() const;
+
+    // Bookmarks under their document key, plus a path -> document key
+    // index that keeps bookmarks reachable after a file is edited in place
+    std::unique_ptr<KeyedRecordStore> m_store;
+    std::unique_ptr<KeyedRecordStore> m_pathIndex;
+    // Decoded rows, filled on first use; mutations keep it in sync
+    mutable QList<Bookmark> m_bookmarks;
+    mutable bool m_materialized = false;
     bool m_autoSave;
     QString m_storageFile;
 };
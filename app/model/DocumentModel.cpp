@@ -1,6 +1,8 @@
 #include "DocumentModel.h"
 #include <QFileInfo>
 #include "RenderModel.h"
+#include "utils/DocumentBundle.h"
+#include "utils/DocumentFingerprint.h"
 #include "utils/LoggingMacros.h"
 
 // 添加支持RenderModel的构造函数
@@ -19,6 +21,9 @@ DocumentModel::DocumentModel(RenderModel* _renderModel)
             &DocumentModel::loadingMessageChanged);
     connect(asyncLoader, &AsyncDocumentLoader::loadingFailed, this,
             &DocumentModel::loadingFailed);
+    connect(&DocumentFingerprint::instance(),
+            &DocumentFingerprint::fingerprintReady, this,
+            &DocumentModel::onFingerprintReady);
 }
 
 DocumentModel::DocumentModel() : currentDocumentIndex(-1) {
@@ -34,6 +39,9 @@ DocumentModel::DocumentModel() : currentDocumentIndex(-1) {
             &DocumentModel::onDocumentLoaded);
     connect(asyncLoader, &AsyncDocumentLoader::loadingFailed, this,
             &DocumentModel::loadingFailed);
+    connect(&DocumentFingerprint::instance(),
+            &DocumentFingerprint::fingerprintReady, this,
+            &DocumentModel::onFingerprintReady);
 }
 
 bool DocumentModel::openFromFile(const QString& filePath) {
@@ -131,12 +139,22 @@ void DocumentModel::onDocumentLoaded(Poppler::Document* document,
     // 创建文档信息
     auto docInfo =
         std::make_unique<DocumentInfo>(filePath, std::move(popplerDoc));
+
+    // 存在与文档内容指纹一致的预生成文档包时，元数据、文本层、大纲和
+    // 缩略图直接从包中读取，首次打开即可达到再次打开的速度。这里不计算
+    // 指纹：使用已记住的指纹，或大小和修改时间与 PDF 一致的附属包；都没有
+    // 时在后台计算完成后再挂接（见 onFingerprintReady）
+    attachBundle(*docInfo, DocumentBundle::openFor(filePath));
     documents.push_back(std::move(docInfo));
 
     int newIndex = static_cast<int>(documents.size() - 1);
     currentDocumentIndex = newIndex;
 
     LOG_INFO("Async loaded successfully: {}", filePath.toStdString());
+
+    // 在后台预先计算内容指纹，书签和分析缓存随后查询时直接命中
+    DocumentFingerprint::instance().requestFingerprint(filePath);
+
     emit documentOpened(newIndex, documents[newIndex]->fileName);
     emit currentDocumentChanged(newIndex);
 
@@ -153,11 +171,38 @@ void DocumentModel::onDocumentLoaded(Poppler::Document* document,
     }
 }
 
+void DocumentModel::onFingerprintReady(const QString& filePath,
+                                       const QString& fingerprint) {
+    for (const auto& docInfo : documents) {
+        if (docInfo->filePath != filePath) {
+            continue;
+        }
+        // 按大小和修改时间信任的附属包若与实际指纹不符，则改用匹配的包
+        const std::shared_ptr<DocumentBundle> attached =
+            DocumentBundle::find(docInfo->document.get());
+        if (attached && attached->fingerprint() != fingerprint) {
+            DocumentBundle::detach(docInfo->document.get());
+        } else if (attached) {
+            continue;
+        }
+        attachBundle(*docInfo, DocumentBundle::openFor(filePath, fingerprint));
+    }
+}
+
+void DocumentModel::attachBundle(
+    const DocumentInfo& docInfo,
+    const std::shared_ptr<DocumentBundle>& bundle) {
+    if (bundle && bundle->pageCount() == docInfo.document->numPages()) {
+        DocumentBundle::attach(docInfo.document, bundle);
+    }
+}
+
 bool DocumentModel::closeDocument(int index) {
     if (!isValidIndex(index)) {
         return false;
     }
 
+    DocumentBundle::detach(documents[index]->document.get());
     documents.erase(documents.begin() + index);
     emit documentClosed(index);
 
@@ -12,6 +12,7 @@
 
 // Forward declarations
 class RecentFilesManager;
+class DocumentBundle;
 
 struct DocumentInfo {
     QString filePath;
@@ -44,6 +45,13 @@ private:
 
 private slots:
     void onDocumentLoaded(Poppler::Document* document, const QString& filePath);
+    // 指纹在后台算出后，为尚未挂接文档包的文档补上
+    void onFingerprintReady(const QString& filePath,
+                            const QString& fingerprint);
+
+private:
+    static void attachBundle(const DocumentInfo& docInfo,
+                             const std::shared_ptr<DocumentBundle>& bundle);
 
 public:
     DocumentModel();
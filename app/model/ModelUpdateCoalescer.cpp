@@ -0,0 +1,121 @@
+#include "ModelUpdateCoalescer.h"
+#include <algorithm>
+#include <vector>
+
+ModelUpdateCoalescer::ModelUpdateCoalescer(QAbstractItemModel* model,
+                                           int maxFramesPerSecond)
+    : QObject(model), m_model(model), m_timer(new QTimer(this)) {
+    setMaxFramesPerSecond(maxFramesPerSecond);
+
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &ModelUpdateCoalescer::flush);
+
+    m_sinceFlush.start();
+}
+
+void ModelUpdateCoalescer::markChanged(int row, const QList<int>& roles) {
+    ++m_requested;
+    m_changedRows.insert(row);
+
+    // 任意一次不指定角色即视为所有角色变化
+    if (roles.isEmpty()) {
+        m_allRoles = true;
+    } else if (!m_allRoles) {
+        for (int role : roles) {
+            m_changedRoles.insert(role);
+        }
+    }
+
+    schedule();
+}
+
+void ModelUpdateCoalescer::setInsertFlusher(std::function<void()> flusher) {
+    m_insertFlusher = std::move(flusher);
+}
+
+void ModelUpdateCoalescer::markRowsPending() {
+    ++m_requested;
+    m_rowsPending = true;
+    schedule();
+}
+
+void ModelUpdateCoalescer::setMaxFramesPerSecond(int fps) {
+    m_minIntervalMs = 1000 / qBound(1, fps, 1000);
+}
+
+bool ModelUpdateCoalescer::hasPendingUpdates() const {
+    return m_rowsPending || !m_changedRows.isEmpty();
+}
+
+void ModelUpdateCoalescer::schedule() {
+    if (m_timer->isActive()) {
+        return;  // 已排期，本次变化随同一批提交
+    }
+
+    // 至少等到下一次事件循环；距上次提交不足一帧时等到帧边界
+    const qint64 sinceFlush = m_sinceFlush.elapsed();
+    const int delay =
+        sinceFlush >= m_minIntervalMs
+            ? 0
+            : static_cast<int>(m_minIntervalMs - sinceFlush);
+    m_timer->start(delay);
+}
+
+void ModelUpdateCoalescer::flush() {
+    m_timer->stop();
+    if (!hasPendingUpdates()) {
+        return;
+    }
+
+    m_sinceFlush.restart();
+    ++m_batches;
+
+    // 先插入，后续的 dataChanged 行号以插入后的模型为准
+    if (m_rowsPending) {
+        m_rowsPending = false;
+        if (m_insertFlusher) {
+            m_insertFlusher();
+        }
+    }
+
+    if (m_changedRows.isEmpty()) {
+        return;
+    }
+
+    std::vector<int> rows(m_changedRows.cbegin(), m_changedRows.cend());
+    std::sort(rows.begin(), rows.end());
+    const QList<int> roles =
+        m_allRoles ? QList<int>() : QList<int>(m_changedRoles.cbegin(),
+                                               m_changedRoles.cend());
+    m_changedRows.clear();
+    m_changedRoles.clear();
+    m_allRoles = false;
+
+    const int rowCount = m_model->rowCount();
+    size_t i = 0;
+    while (i < rows.size()) {
+        const int first = rows[i];
+        int last = first;
+        while (i + 1 < rows.size() && rows[i + 1] == last + 1) {
+            last = rows[++i];
+        }
+        ++i;
+
+        // 忽略已被移除的行
+        const int top = qMax(0, first);
+        const int bottom = qMin(last, rowCount - 1);
+        if (top > bottom) {
+            continue;
+        }
+        emit m_model->dataChanged(m_model->index(top, 0),
+                                  m_model->index(bottom, 0), roles);
+    }
+}
+
+void ModelUpdateCoalescer::clear() {
+    m_timer->stop();
+    m_changedRows.clear();
+    m_changedRoles.clear();
+    m_allRoles = false;
+    m_rowsPending = false;
+}
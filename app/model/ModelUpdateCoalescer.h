@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+#include <functional>
+
+/**
+ * @brief 列表模型的批量更新合并器
+ *
+ * 后台任务逐项完成时，每项单独发出 dataChanged / rowsInserted 会让视图
+ * 为每一项各做一次布局和重绘。合并器在同一事件循环周期内收集变化，
+ * 到期后一次性发出：
+ * - 变化的行排序后合并为连续区间，每个区间一次 dataChanged，角色取并集
+ * - 追加行由模型暂存，到期时通过回调一次 begin/endInsertRows 提交
+ *
+ * 两次提交之间至少间隔一帧（默认 60 FPS），突发大量更新时视图刷新频率有上限。
+ */
+class ModelUpdateCoalescer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ModelUpdateCoalescer(QAbstractItemModel* model,
+                                  int maxFramesPerSecond = DEFAULT_MAX_FPS);
+
+    void markChanged(int row, const QList<int>& roles = QList<int>());
+
+    // 模型已暂存待插入的行；到期时调用 flusher 执行实际插入
+    void setInsertFlusher(std::function<void()> flusher);
+    void markRowsPending();
+
+    void setMaxFramesPerSecond(int fps);
+
+    // 立即提交所有待处理的变化（例如模型重置前）
+    void flush();
+    // 丢弃待处理的变化（行号已失效时）
+    void clear();
+
+    bool hasPendingUpdates() const;
+
+    // 统计：请求的单项更新数与实际发出的批次数
+    qint64 requestedUpdates() const { return m_requested; }
+    qint64 emittedBatches() const { return m_batches; }
+
+private:
+    void schedule();
+
+    QAbstractItemModel* m_model;
+    QTimer* m_timer;
+    QElapsedTimer m_sinceFlush;
+    int m_minIntervalMs;
+
+    QSet<int> m_changedRows;
+    QSet<int> m_changedRoles;
+    bool m_allRoles = false;
+
+    std::function<void()> m_insertFlusher;
+    bool m_rowsPending = false;
+
+    qint64 m_requested = 0;
+    qint64 m_batches = 0;
+
+    static constexpr int DEFAULT_MAX_FPS = 60;
+};
@@ -1,5 +1,6 @@
 #include "PDFOutlineModel.h"
 #include <QDebug>
+#include "utils/DocumentBundle.h"
 
 PDFOutlineModel::PDFOutlineModel(QObject* parent)
     : QObject(parent), totalItemCount(0) {}
@@ -13,6 +14,18 @@ bool PDFOutlineModel::parseOutline(
         return false;
     }
 
+    if (loadOutlineFromBundle(document.get())) {
+        totalItemCount = countNodes(rootNodes);
+        if (rootNodes.isEmpty()) {
+            qDebug() << "PDFOutlineModel: Document has no outline";
+            return false;
+        }
+        qDebug() << "PDFOutlineModel: Loaded" << totalItemCount
+                 << "outline items from bundle";
+        emit outlineParsed();
+        return true;
+    }
+
     // 获取PDF文档的目录
     QList<Poppler::OutlineItem> outline = document->outline();
     if (outline.isEmpty()) {
@@ -63,6 +76,29 @@ QList<std::shared_ptr<PDFOutlineNode>> PDFOutlineModel::getFlattenedNodes()
     return result;
 }
 
+bool PDFOutlineModel::loadOutlineFromBundle(
+    const Poppler::Document* document) {
+    std::shared_ptr<DocumentBundle> bundle = DocumentBundle::find(document);
+    if (!bundle || !bundle->hasOutline()) {
+        return false;
+    }
+
+    // 包中按先序存储，每项的父节点是栈中层级小一级的节点
+    QList<std::shared_ptr<PDFOutlineNode>> parents;
+    for (const DocumentBundle::OutlineEntry& entry : bundle->outline()) {
+        auto node = std::make_shared<PDFOutlineNode>(
+            entry.title, entry.pageNumber, entry.level);
+        parents.resize(entry.level);
+        if (parents.isEmpty()) {
+            rootNodes.append(node);
+        } else {
+            parents.last()->addChild(node);
+        }
+        parents.append(node);
+    }
+    return true;
+}
+
 void PDFOutlineModel::parseOutlineItemRecursive(
     const Poppler::OutlineItem& item, std::shared_ptr<PDFOutlineNode> node,
     int level) {
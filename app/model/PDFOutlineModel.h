@@ -71,6 +71,9 @@ private:
     std::shared_ptr<PDFOutlineNode> parseOutlineItem(
         const QList<Poppler::OutlineItem>& items, int level = 0);
 
+    // 从预生成的文档包重建目录树；包中没有目录数据时返回false
+    bool loadOutlineFromBundle(const Poppler::Document* document);
+
     // 递归解析单个目录项
     void parseOutlineItemRecursive(const Poppler::OutlineItem& item,
                                    std::shared_ptr<PDFOutlineNode> parentNode,
@@ -0,0 +1,237 @@
+#include "PageMetadataTable.h"
+#include <QMutexLocker>
+#include <QRectF>
+#include <QtConcurrent/QtConcurrent>
+#include "utils/DocumentBundle.h"
+#include "utils/DocumentFingerprint.h"
+#include "utils/LoggingMacros.h"
+
+QHash<const Poppler::Document*, PageMetadataTable::RegistryEntry>
+    PageMetadataTable::s_registry;
+QMutex PageMetadataTable::s_registryMutex;
+
+PageMetadataTable::PageMetadataTable(int pageCount)
+    : m_pageCount(qMax(0, pageCount)), m_columns(std::make_shared<Columns>()) {
+    // 预先分配所有列，填充过程中不再重新分配，读取方可安全访问已发布的前缀
+    m_columns->widths.resize(m_pageCount, 0.0f);
+    m_columns->heights.resize(m_pageCount, 0.0f);
+    m_columns->orientations.resize(m_pageCount, 0);
+    m_columns->labels.resize(m_pageCount);
+    m_columns->flags.resize(m_pageCount, 0);
+    m_columns->fingerprints.resize(m_pageCount, 0);
+}
+
+PageMetadataTable::~PageMetadataTable() {
+    // 工作线程持有列与文档的共享引用，这里只需通知取消，不阻塞调用方
+    m_columns->cancelled.store(true);
+}
+
+std::shared_ptr<PageMetadataTable> PageMetadataTable::forDocument(
+    const std::shared_ptr<Poppler::Document>& document) {
+    if (!document) {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&s_registryMutex);
+
+    auto it = s_registry.find(document.get());
+    if (it != s_registry.end()) {
+        std::shared_ptr<PageMetadataTable> table = it->table.lock();
+        if (table && it->document.lock() == document) {
+            return table;
+        }
+    }
+
+    // 清理已失效的条目
+    for (auto entry = s_registry.begin(); entry != s_registry.end();) {
+        if (entry->table.expired() || entry->document.expired()) {
+            entry = s_registry.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+
+    std::shared_ptr<PageMetadataTable> table(
+        new PageMetadataTable(document->numPages()));
+    s_registry.insert(document.get(), {document, table});
+    if (!table->fillFromBundle(document.get())) {
+        table->start(document);
+    }
+    return table;
+}
+
+std::shared_ptr<PageMetadataTable> PageMetadataTable::find(
+    const Poppler::Document* document) {
+    if (!document) {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&s_registryMutex);
+    auto it = s_registry.find(document);
+    if (it == s_registry.end() || it->document.expired()) {
+        return nullptr;
+    }
+    return it->table.lock();
+}
+
+void PageMetadataTable::start(
+    const std::shared_ptr<Poppler::Document>& document) {
+    auto columns = m_columns;
+    m_future = QtConcurrent::run(
+        [document, columns]() { fill(document, columns); });
+}
+
+bool PageMetadataTable::fillFromBundle(const Poppler::Document* document) {
+    std::shared_ptr<DocumentBundle> bundle = DocumentBundle::find(document);
+    if (!bundle || bundle->pageCount() != m_pageCount) {
+        return false;
+    }
+
+    QList<DocumentBundle::PageMetadata> pages;
+    if (!bundle->readPageMetadata(&pages)) {
+        return false;
+    }
+
+    for (int i = 0; i < m_pageCount; ++i) {
+        const DocumentBundle::PageMetadata& page = pages[i];
+        m_columns->widths[i] = page.width;
+        m_columns->heights[i] = page.height;
+        m_columns->orientations[i] = page.orientation;
+        m_columns->labels[i] = page.label;
+        m_columns->flags[i] = page.flags;
+        m_columns->fingerprints[i] = page.contentFingerprint;
+    }
+    m_columns->geometryFilled.store(m_pageCount, std::memory_order_release);
+    m_columns->contentFilled.store(m_pageCount, std::memory_order_release);
+
+    LOG_DEBUG("PageMetadataTable: Loaded metadata for {} pages from bundle",
+              m_pageCount);
+    return true;
+}
+
+void PageMetadataTable::fill(
+    const std::shared_ptr<Poppler::Document>& document,
+    const std::shared_ptr<Columns>& columns) {
+    const int pageCount = static_cast<int>(columns->widths.size());
+
+    // 几何阶段：代价低，先整体完成，供布局和缩放使用
+    for (int i = 0; i < pageCount; ++i) {
+        if (columns->cancelled.load()) {
+            return;
+        }
+
+        std::unique_ptr<Poppler::Page> page(document->page(i));
+        if (page) {
+            const QSizeF size = page->pageSizeF();
+            columns->widths[i] = static_cast<float>(size.width());
+            columns->heights[i] = static_cast<float>(size.height());
+            columns->orientations[i] =
+                static_cast<quint8>(page->orientation());
+            columns->labels[i] = page->label();
+        }
+        columns->geometryFilled.store(i + 1, std::memory_order_release);
+    }
+
+    // 内容阶段：需要提取文本
+    for (int i = 0; i < pageCount; ++i) {
+        if (columns->cancelled.load()) {
+            return;
+        }
+
+        std::unique_ptr<Poppler::Page> page(document->page(i));
+        if (page) {
+            const QString text = page->text(QRectF());
+            const double area = static_cast<double>(columns->widths[i]) *
+                                columns->heights[i];
+
+            quint8 flags = 0;
+            if (!text.trimmed().isEmpty()) {
+                flags |= HasText;
+            }
+            if (text.length() < area / 1000.0) {
+                flags |= HasImages;
+            }
+            columns->flags[i] = flags;
+            columns->fingerprints[i] = DocumentFingerprint::pageContentHash(
+                text, columns->widths[i], columns->heights[i]);
+        }
+        columns->contentFilled.store(i + 1, std::memory_order_release);
+    }
+
+    LOG_DEBUG("PageMetadataTable: Filled metadata for {} pages", pageCount);
+}
+
+bool PageMetadataTable::hasGeometry(int pageNumber) const {
+    return pageNumber >= 0 &&
+           pageNumber <
+               m_columns->geometryFilled.load(std::memory_order_acquire);
+}
+
+bool PageMetadataTable::hasContent(int pageNumber) const {
+    return pageNumber >= 0 &&
+           pageNumber <
+               m_columns->contentFilled.load(std::memory_order_acquire);
+}
+
+bool PageMetadataTable::isComplete() const {
+    return m_columns->contentFilled.load(std::memory_order_acquire) ==
+           m_pageCount;
+}
+
+void PageMetadataTable::waitForFinished() const {
+    QFuture<void> future = m_future;
+    future.waitForFinished();
+}
+
+QSizeF PageMetadataTable::pageSize(int pageNumber) const {
+    if (!hasGeometry(pageNumber)) {
+        return QSizeF();
+    }
+    return QSizeF(m_columns->widths[pageNumber],
+                  m_columns->heights[pageNumber]);
+}
+
+Poppler::Page::Orientation PageMetadataTable::orientation(
+    int pageNumber) const {
+    if (!hasGeometry(pageNumber)) {
+        return Poppler::Page::Portrait;
+    }
+    return static_cast<Poppler::Page::Orientation>(
+        m_columns->orientations[pageNumber]);
+}
+
+QString PageMetadataTable::label(int pageNumber) const {
+    if (!hasGeometry(pageNumber)) {
+        return QString();
+    }
+    return m_columns->labels[pageNumber];
+}
+
+bool PageMetadataTable::hasText(int pageNumber) const {
+    return hasContent(pageNumber) &&
+           (m_columns->flags[pageNumber] & HasText) != 0;
+}
+
+bool PageMetadataTable::hasImages(int pageNumber) const {
+    return hasContent(pageNumber) &&
+           (m_columns->flags[pageNumber] & HasImages) != 0;
+}
+
+quint64 PageMetadataTable::contentFingerprint(int pageNumber) const {
+    return hasContent(pageNumber) ? m_columns->fingerprints[pageNumber] : 0;
+}
+
+QSizeF PageMetadataTable::pageSize(Poppler::Document* document,
+                                   int pageNumber) {
+    if (!document) {
+        return QSizeF();
+    }
+
+    std::shared_ptr<PageMetadataTable> table = find(document);
+    if (table && table->hasGeometry(pageNumber)) {
+        return table->pageSize(pageNumber);
+    }
+
+    std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+    return page ? page->pageSizeF() : QSizeF();
+}
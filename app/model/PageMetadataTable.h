@@ -0,0 +1,97 @@
+#pragma once
+
+#include <poppler/qt6/poppler-qt6.h>
+#include <QFuture>
+#include <QHash>
+#include <QMutex>
+#include <QSizeF>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 每个文档一份的页面元数据表
+ *
+ * 许多组件只为获取页面尺寸、方向或标签而创建 Poppler::Page 对象。
+ * 此表在后台一次性遍历文档并以列式（struct-of-arrays）存储：
+ * - 几何阶段：尺寸、方向、标签，先完成并立即可用
+ * - 内容阶段：是否有文本/图像、内容指纹
+ *
+ * 每列按页码索引，已填充的前缀只读，读取无需加锁；
+ * 尚未填充的页面由调用方回退到直接访问页面。
+ */
+class PageMetadataTable {
+public:
+    enum PageFlag : quint8 {
+        HasText = 0x01,
+        HasImages = 0x02  // 启发式：页面面积大而文本稀疏
+    };
+
+    // 获取（必要时创建并启动后台填充）文档对应的表
+    static std::shared_ptr<PageMetadataTable> forDocument(
+        const std::shared_ptr<Poppler::Document>& document);
+    // 仅查找已存在的表，不创建
+    static std::shared_ptr<PageMetadataTable> find(
+        const Poppler::Document* document);
+
+    ~PageMetadataTable();
+
+    PageMetadataTable(const PageMetadataTable&) = delete;
+    PageMetadataTable& operator=(const PageMetadataTable&) = delete;
+
+    int pageCount() const { return m_pageCount; }
+
+    // 填充进度
+    bool hasGeometry(int pageNumber) const;
+    bool hasContent(int pageNumber) const;
+    bool isComplete() const;
+    void waitForFinished() const;
+
+    // 几何信息
+    QSizeF pageSize(int pageNumber) const;
+    Poppler::Page::Orientation orientation(int pageNumber) const;
+    QString label(int pageNumber) const;
+
+    // 内容信息
+    bool hasText(int pageNumber) const;
+    bool hasImages(int pageNumber) const;
+    quint64 contentFingerprint(int pageNumber) const;
+
+    // 带回退的便捷接口：表中已有则直接返回，否则创建页面对象读取
+    static QSizeF pageSize(Poppler::Document* document, int pageNumber);
+
+private:
+    // 列存储；由工作线程填充，填充计数以 release 语义发布
+    struct Columns {
+        std::vector<float> widths;
+        std::vector<float> heights;
+        std::vector<quint8> orientations;
+        std::vector<QString> labels;
+        std::vector<quint8> flags;
+        std::vector<quint64> fingerprints;
+
+        std::atomic<int> geometryFilled{0};
+        std::atomic<int> contentFilled{0};
+        std::atomic<bool> cancelled{false};
+    };
+
+    explicit PageMetadataTable(int pageCount);
+
+    void start(const std::shared_ptr<Poppler::Document>& document);
+    // 从预生成的文档包一次性填充全部列，成功则无需后台遍历
+    bool fillFromBundle(const Poppler::Document* document);
+    static void fill(const std::shared_ptr<Poppler::Document>& document,
+                     const std::shared_ptr<Columns>& columns);
+
+    const int m_pageCount;
+    std::shared_ptr<Columns> m_columns;
+    QFuture<void> m_future;
+
+    struct RegistryEntry {
+        std::weak_ptr<Poppler::Document> document;
+        std::weak_ptr<PageMetadataTable> table;
+    };
+    static QHash<const Poppler::Document*, RegistryEntry> s_registry;
+    static QMutex s_registryMutex;
+};
@@ -2,14 +2,25 @@
 #include <QDebug>
 // #include <QtConcurrent> // Not available in this setup
 #include <QApplication>
+#include <QBitArray>
+#include <QElapsedTimer>
 #include <QPointF>
 #include <QRectF>
 #include <QRegularExpression>
 #include <QSize>
 #include <QSizeF>
 #include <QTransform>
+#include <QtConcurrent/QtConcurrent>
 #include <QtGlobal>
+#include <algorithm>
 #include <cmath>
+#include <iterator>
+#include <map>
+#include "ModelUpdateCoalescer.h"
+#include "utils/CjkTokenizer.h"
+#include "utils/DocumentBundle.h"
+#include "utils/FuzzyMatcher.h"
+#include "utils/TextArena.h"
 
 SearchModel::SearchModel(QObject* parent)
     : QAbstractListModel(parent),
@@ -19,16 +30,35 @@ SearchModel::SearchModel(QObject* parent)
       m_searchWatcher(new QFutureWatcher<QList<SearchResult>>(this)),
       m_realTimeSearchTimer(new QTimer(this)),
       m_isRealTimeSearchEnabled(true),
-      m_realTimeSearchDelay(300) {
+      m_realTimeSearchDelay(300),
+      m_updateCoalescer(new ModelUpdateCoalescer(this)) {
     connect(m_searchWatcher, &QFutureWatcher<QList<SearchResult>>::finished,
             this, &SearchModel::onSearchFinished);
 
+    // Pending results are appended with a single rowsInserted per batch
+    m_updateCoalescer->setInsertFlusher([this]() {
+        if (m_pendingResults.isEmpty()) {
+            return;
+        }
+        const int first = m_results.size();
+        beginInsertRows(QModelIndex(), first,
+                        first + m_pendingResults.size() - 1);
+        m_results.append(m_pendingResults);
+        m_pendingResults.clear();
+        endInsertRows();
+    });
+
     // Setup real-time search timer
     m_realTimeSearchTimer->setSingleShot(true);
     connect(m_realTimeSearchTimer, &QTimer::timeout, this,
             &SearchModel::performRealTimeSearch);
 }
 
+SearchModel::~SearchModel() {
+    // The worker only holds the document, never the model
+    m_prefetchFuture.cancel();
+}
+
 int SearchModel::rowCount(const QModelIndex& parent) const {
     Q_UNUSED(parent)
     return m_results.size();
@@ -58,6 +88,8 @@ QVariant SearchModel::data(const QModelIndex& index, int role) const {
             return result.startIndex;
         case LengthRole:
             return result.length;
+        case EditDistanceRole:
+            return result.editDistance;
         default:
             return QVariant();
     }
@@ -72,6 +104,7 @@ QHash<int, QByteArray> SearchModel::roleNames() const {
     roles[BoundingRectRole] = "boundingRect";
     roles[StartIndexRole] = "startIndex";
     roles[LengthRole] = "length";
+    roles[EditDistanceRole] = "editDistance";
     return roles;
 }
 
@@ -121,6 +154,9 @@ void SearchModel::startRealTimeSearch(
 }
 
 void SearchModel::clearResults() {
+    m_updateCoalescer->clear();
+    m_pendingResults.clear();
+
     beginResetModel();
     m_results.clear();
     m_currentResultIndex = -1;
@@ -207,9 +243,15 @@ void SearchModel::performSearch() {
         return;
     }
 
-    const int pageCount = m_document->numPages();
+    if (m_currentOptions.fuzzy && !m_currentOptions.useRegex) {
+        m_searchResults = performFuzzySearch();
+        return;
+    }
 
-    for (int i = 0; i < pageCount && !m_searchFuture.isCanceled(); ++i) {
+    for (int i : candidatePages()) {
+        if (m_searchFuture.isCanceled()) {
+            break;
+        }
         std::unique_ptr<Poppler::Page> page(m_document->page(i));
         if (page) {
             QList<SearchResult> pageResults =
@@ -222,10 +264,9 @@ void SearchModel::performSearch() {
         }
     }
 
-    // Update the model with results
-    beginResetModel();
+    // Only the backing list changes here; the displayed rows are untouched,
+    // so there is nothing to reset
     m_searchResults = allResults;
-    endResetModel();
 }
 
 QList<SearchResult> SearchModel::searchInPage(Poppler::Page* page,
@@ -238,19 +279,14 @@ QList<SearchResult> SearchModel::searchInPage(Poppler::Page* page,
         return results;
     }
 
-    QString pageText = page->text(QRectF());
+    const QString pageText = cachedPageText(pageNumber, page);
     if (pageText.isEmpty()) {
         return results;
     }
 
-    QRegularExpression regex = createSearchRegex(query, options);
-    QRegularExpressionMatchIterator iterator = regex.globalMatch(pageText);
-
-    while (iterator.hasNext() && results.size() < options.maxResults) {
-        QRegularExpressionMatch match = iterator.next();
-        int startPos = match.capturedStart();
-        int length = match.capturedLength();
-        QString matchedText = match.captured();
+    for (const auto& [startPos, length] :
+         findMatches(pageText, query, options)) {
+        const QString matchedText = pageText.mid(startPos, length);
 
         // Extract context around the match
         QString context = extractContext(pageText, startPos, length);
@@ -271,22 +307,315 @@ QList<SearchResult> SearchModel::searchInPage(Poppler::Page* page,
     return results;
 }
 
+QList<std::pair<int, int>> SearchModel::findMatches(
+    const QString& text, const QString& query, const SearchOptions& options) {
+    QList<std::pair<int, int>> matches;
+
+    // \b knows nothing of CJK text; whole CJK words are matches that start
+    // and end on boundaries of the page's word segmentation
+    const QBitArray wordBoundaries =
+        options.wholeWords && CjkTokenizer::containsCjk(query)
+            ? CjkTokenizer::wordBoundaries(text)
+            : QBitArray();
+
+    const QRegularExpression regex = createSearchRegex(query, options);
+    QRegularExpressionMatchIterator iterator = regex.globalMatch(text);
+
+    while (iterator.hasNext() && matches.size() < options.maxResults) {
+        const QRegularExpressionMatch match = iterator.next();
+        const int start = static_cast<int>(match.capturedStart());
+        const int length = static_cast<int>(match.capturedLength());
+        if (!wordBoundaries.isEmpty() &&
+            (!wordBoundaries.testBit(start) ||
+             !wordBoundaries.testBit(start + length))) {
+            continue;
+        }
+        matches.append({start, length});
+    }
+    return matches;
+}
+
+QList<SearchResult> SearchModel::performFuzzySearch() {
+    QList<SearchResult> results;
+    const int pageCount = m_document->numPages();
+
+    const FuzzyMatcher matcher(m_currentQuery, m_currentOptions.maxEditDistance,
+                               m_currentOptions.caseSensitive
+                                   ? Qt::CaseSensitive
+                                   : Qt::CaseInsensitive);
+    if (!matcher.isValid()) {
+        // Too long for the bit-parallel matcher: fall back to exact search
+        SearchOptions exactOptions = m_currentOptions;
+        exactOptions.fuzzy = false;
+        for (int i = 0; i < pageCount; ++i) {
+            if (results.size() >= m_currentOptions.maxResults) {
+                break;
+            }
+            std::unique_ptr<Poppler::Page> page(m_document->page(i));
+            results.append(
+                searchInPage(page.get(), i, m_currentQuery, exactOptions));
+        }
+        return results;
+    }
+
+    // Poppler is only touched from this thread; the extracted (and cached)
+    // text layer is then scanned on all cores
+    QList<QString> texts;
+    texts.reserve(pageCount);
+    for (int i = 0; i < pageCount; ++i) {
+        texts.append(cachedPageText(i));
+    }
+
+    const bool wholeWords = m_currentOptions.wholeWords;
+    const bool cjkQuery = CjkTokenizer::containsCjk(m_currentQuery);
+    const int maxPerPage = m_currentOptions.maxResults;
+    auto isWordChar = [](QChar ch) {
+        return ch.isLetterOrNumber() || ch == u'_';
+    };
+    const QList<QList<FuzzyMatcher::Match>> pageMatches =
+        QtConcurrent::blockingMapped<QList<QList<FuzzyMatcher::Match>>>(
+            texts, [&](const QString& text) {
+                QList<FuzzyMatcher::Match> matches =
+                    matcher.findAll(text, wholeWords ? -1 : maxPerPage);
+                if (wholeWords) {
+                    // CJK words are delimited by segmentation, not by
+                    // neighbouring non-letters
+                    const QBitArray boundaries =
+                        cjkQuery ? CjkTokenizer::wordBoundaries(text)
+                                 : QBitArray();
+                    matches.removeIf([&](const FuzzyMatcher::Match& match) {
+                        const int end = match.start + match.length;
+                        if (!boundaries.isEmpty()) {
+                            return !boundaries.testBit(match.start) ||
+                                   !boundaries.testBit(end);
+                        }
+                        return (match.start > 0 &&
+                                isWordChar(text[match.start - 1])) ||
+                               (end < text.size() && isWordChar(text[end]));
+                    });
+                }
+                return matches;
+            });
+
+    // Rank by distance; within a distance keep document order
+    struct Candidate {
+        int pageNumber;
+        FuzzyMatcher::Match match;
+    };
+    std::vector<Candidate> candidates;
+    for (int i = 0; i < pageMatches.size(); ++i) {
+        for (const FuzzyMatcher::Match& match : pageMatches.at(i)) {
+            candidates.push_back({i, match});
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const Candidate& a, const Candidate& b) {
+                         return a.match.distance < b.match.distance;
+                     });
+    if (candidates.size() >
+        static_cast<size_t>(qMax(0, m_currentOptions.maxResults))) {
+        candidates.resize(qMax(0, m_currentOptions.maxResults));
+    }
+
+    // Highlight rectangles only for the results that are kept
+    std::map<int, std::unique_ptr<Poppler::Page>> pages;
+    results.reserve(static_cast<qsizetype>(candidates.size()));
+    for (const Candidate& candidate : candidates) {
+        const QString& text = texts.at(candidate.pageNumber);
+        const FuzzyMatcher::Match& match = candidate.match;
+        const QString matchedText = text.mid(match.start, match.length);
+
+        std::unique_ptr<Poppler::Page>& page = pages[candidate.pageNumber];
+        if (!page) {
+            page.reset(m_document->page(candidate.pageNumber));
+        }
+        QRectF boundingRect;
+        if (page) {
+            const QList<QRectF> rects = page->search(matchedText);
+            if (!rects.isEmpty()) {
+                boundingRect = rects.first();
+            }
+        }
+
+        SearchResult result(candidate.pageNumber, matchedText,
+                            extractContext(text, match.start, match.length),
+                            boundingRect, match.start, match.length);
+        result.editDistance = match.distance;
+        results.append(result);
+    }
+
+    return results;
+}
+
+QString SearchModel::cachedPageText(int pageNumber, Poppler::Page* page) {
+    if (m_pageTextDocument.lock() != m_document) {
+        m_pageTexts.clear();
+        m_pageTextDocument = m_document;
+    }
+
+    auto cached = m_pageTexts.constFind(pageNumber);
+    if (cached != m_pageTexts.cend()) {
+        return *cached;
+    }
+
+    QString text;
+    std::shared_ptr<DocumentBundle> bundle =
+        DocumentBundle::find(m_document.get());
+    if (bundle && bundle->hasTextLayer()) {
+        // The bundle was validated against this document when attached
+        text = bundle->pageText(pageNumber);
+    } else if (page) {
+        text = page->text(QRectF());
+    } else if (m_document) {
+        std::unique_ptr<Poppler::Page> ownPage(m_document->page(pageNumber));
+        if (ownPage) {
+            text = ownPage->text(QRectF());
+        }
+    }
+    m_pageTexts.insert(pageNumber, text);
+    return text;
+}
+
+void SearchModel::prefetchPageTexts(
+    std::shared_ptr<Poppler::Document> document) {
+    m_prefetchFuture.cancel();
+    if (!document) {
+        return;
+    }
+
+    // The next query on this document finds the text layer cached
+    m_document = document;
+    if (m_pageTextDocument.lock() != document) {
+        m_pageTexts.clear();
+        m_pageTextDocument = document;
+    }
+
+    QList<int> pages;
+    for (int i = 0; i < document->numPages(); ++i) {
+        if (!m_pageTexts.contains(i)) {
+            pages.append(i);
+        }
+    }
+    if (pages.isEmpty()) {
+        return;
+    }
+
+    std::shared_ptr<DocumentBundle> bundle =
+        DocumentBundle::find(document.get());
+
+    auto* watcher = new QFutureWatcher<PrefetchedPage>(this);
+    connect(watcher, &QFutureWatcher<PrefetchedPage>::resultReadyAt, this,
+            [this, watcher, document](int index) {
+                if (m_pageTextDocument.lock() != document) {
+                    return;  // The cache moved on to another document
+                }
+                const PrefetchedPage page = watcher->resultAt(index);
+                // A query may have extracted the page in the meantime
+                if (!m_pageTexts.contains(page.pageNumber)) {
+                    m_pageTexts.insert(page.pageNumber, page.text);
+                }
+            });
+    connect(watcher, &QFutureWatcher<PrefetchedPage>::finished, watcher,
+            &QObject::deleteLater);
+
+    // Pages are handed over one by one, each only once it is extracted
+    m_prefetchFuture = QtConcurrent::run(
+        [document, bundle, pages](QPromise<PrefetchedPage>& promise) {
+            for (int pageNumber : pages) {
+                if (promise.isCanceled()) {
+                    return;
+                }
+                PrefetchedPage result;
+                result.pageNumber = pageNumber;
+                if (bundle && bundle->hasTextLayer()) {
+                    result.text = bundle->pageText(pageNumber);
+                } else {
+                    std::unique_ptr<Poppler::Page> page(
+                        document->page(pageNumber));
+                    if (page) {
+                        result.text = page->text(QRectF());
+                    }
+                }
+                promise.addResult(std::move(result));
+            }
+        });
+    watcher->setFuture(m_prefetchFuture);
+}
+
+QList<int> SearchModel::candidatePages() const {
+    QList<int> pages;
+    if (!m_document) {
+        return pages;
+    }
+
+    const int pageCount = m_document->numPages();
+    std::shared_ptr<DocumentBundle> bundle =
+        DocumentBundle::find(m_document.get());
+    if (bundle && bundle->hasSearchIndex() && m_currentOptions.wholeWords &&
+        !m_currentOptions.useRegex) {
+        // A whole-word match contains each of the query's word runs as a
+        // complete word and each of its CJK bigrams, so only pages indexed
+        // under all of them qualify. A lone CJK character is only indexed
+        // where it stands alone, and over-long terms are not indexed at
+        // all, so neither can narrow anything; without any other term every
+        // page is scanned.
+        const QString query = m_currentQuery.toLower();
+        TextArena arena;
+        auto words = arena.makeVector<QStringView>();
+        CjkTokenizer::indexTerms(query, words);
+        words.erase(
+            std::remove_if(words.begin(), words.end(),
+                           [](QStringView term) {
+                               return (term.size() == 1 &&
+                                       CjkTokenizer::isCjk(term[0])) ||
+                                      term.size() >
+                                          DocumentBundle::MAX_TERM_LENGTH;
+                           }),
+            words.end());
+        if (!words.empty()) {
+            pages = bundle->pagesWithWord(words.front());
+            for (std::size_t w = 1; w < words.size() && !pages.isEmpty();
+                 ++w) {
+                const QList<int> other = bundle->pagesWithWord(words[w]);
+                QList<int> both;
+                std::set_intersection(pages.cbegin(), pages.cend(),
+                                      other.cbegin(), other.cend(),
+                                      std::back_inserter(both));
+                pages = both;
+            }
+            return pages;
+        }
+    }
+
+    pages.reserve(pageCount);
+    for (int i = 0; i < pageCount; ++i) {
+        pages.append(i);
+    }
+    return pages;
+}
+
 QString SearchModel::extractContext(const QString& pageText, int position,
                                     int length, int contextLength) {
     int start = qMax(0, position - contextLength);
     int end = qMin(pageText.length(), position + length + contextLength);
 
-    QString context = pageText.mid(start, end - start);
+    // Assemble into one buffer from a view of the page text instead of
+    // copying the window and re-concatenating it for each ellipsis
+    const QStringView window = QStringView(pageText).sliced(start, end - start);
+    QString context;
+    context.reserve(window.size() + 6);
 
     // Add ellipsis if we truncated
     if (start > 0) {
-        context = "..." + context;
+        context += u"...";
     }
+    context += window;
     if (end < pageText.length()) {
-        context = context + "...";
+        context += u"...";
     }
 
-    return context.simplified();  // Remove extra whitespace
+    // Remove extra whitespace; simplified() reuses the buffer of an rvalue
+    return std::move(context).simplified();
 }
 
 QRegularExpression SearchModel::createSearchRegex(
@@ -297,7 +626,8 @@ QRegularExpression SearchModel::createSearchRegex(
         pattern = QRegularExpression::escape(pattern);
     }
 
-    if (options.wholeWords) {
+    // CJK queries are checked against word boundaries in findMatches
+    if (options.wholeWords && !CjkTokenizer::containsCjk(query)) {
         pattern = "\\b" + pattern + "\\b";
     }
 
@@ -318,20 +648,52 @@ void SearchModel::performRealTimeSearch() {
 
     emit realTimeSearchStarted();
 
+    // Start from an empty list; matches are appended in coalesced batches
+    // instead of resetting the whole model at the end
+    clearResults();
+
+    if (m_currentOptions.fuzzy && !m_currentOptions.useRegex) {
+        // Ranked results are only known once every page is scanned, so
+        // they are committed in one go
+        const QList<SearchResult> results = performFuzzySearch();
+        emit realTimeSearchProgress(m_document->numPages(),
+                                    m_document->numPages());
+        if (!results.isEmpty()) {
+            m_pendingResults = results;
+            m_updateCoalescer->markRowsPending();
+            m_updateCoalescer->flush();
+            emit realTimeResultsUpdated(results);
+        }
+        m_searchResults = results;
+        emit searchFinished(results.size());
+        return;
+    }
+
     QList<SearchResult> allResults;
-    const int pageCount = m_document->numPages();
+    const QList<int> pages = candidatePages();
+    const int pageCount = static_cast<int>(pages.size());
+    QElapsedTimer sinceUpdate;
+    sinceUpdate.start();
 
-    for (int i = 0; i < pageCount; ++i) {
+    for (int done = 0; done < pageCount; ++done) {
+        const int i = pages[done];
         std::unique_ptr<Poppler::Page> page(m_document->page(i));
         if (page) {
             QList<SearchResult> pageResults =
                 searchInPage(page.get(), i, m_currentQuery, m_currentOptions);
             allResults.append(pageResults);
+            if (!pageResults.isEmpty()) {
+                m_pendingResults.append(pageResults);
+                m_updateCoalescer->markRowsPending();
+            }
 
-            // Emit progress and partial results for real-time feedback
-            emit realTimeSearchProgress(i + 1, pageCount);
-            if (!allResults.isEmpty()) {
+            // Emit progress and partial results for real-time feedback, at
+            // most once per frame so highlight listeners are not flooded
+            emit realTimeSearchProgress(done + 1, pageCount);
+            if (!allResults.isEmpty() &&
+                sinceUpdate.elapsed() >= REALTIME_UPDATE_INTERVAL_MS) {
                 emit realTimeResultsUpdated(allResults);
+                sinceUpdate.restart();
             }
 
             // Limit results for performance
@@ -341,12 +703,13 @@ void SearchModel::performRealTimeSearch() {
         }
     }
 
-    // Update the model with final results
-    beginResetModel();
-    m_searchResults = allResults;
-    m_results = allResults;  // Keep both for compatibility
-    endResetModel();
+    // Commit whatever is still pending as one insertion
+    m_updateCoalescer->flush();
+    m_searchResults = allResults;  // Keep both for compatibility
 
+    if (!allResults.isEmpty()) {
+        emit realTimeResultsUpdated(allResults);
+    }
     emit searchFinished(allResults.size());
 }
 
@@ -4,11 +4,16 @@
 #include <QAbstractListModel>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QRegularExpression>
 #include <QString>
 #include <QTimer>
+#include <memory>
+#include <utility>
+
+class ModelUpdateCoalescer;
 
 /**
  * Represents a single search result with enhanced coordinate transformation
@@ -23,6 +28,7 @@ struct SearchResult {
     int length;
     QRectF widgetRect;     // Transformed widget coordinates for highlighting
     bool isCurrentResult;  // Whether this is the currently selected result
+    int editDistance = 0;  // Edits between query and text (fuzzy search)
 
     SearchResult()
         : pageNumber(-1), startIndex(-1), length(0), isCurrentResult(false) {}
@@ -58,6 +64,11 @@ struct SearchOptions {
     int maxResults = 1000;
     QString highlightColor = "#FFFF00";
 
+    // Approximate matching for OCR'd text; ignored when useRegex is set.
+    // Results are ranked by edit distance, closest first.
+    bool fuzzy = false;
+    int maxEditDistance = 1;
+
     SearchOptions() = default;
 };
 
@@ -74,11 +85,12 @@ public:
         ContextRole,
         BoundingRectRole,
         StartIndexRole,
-        LengthRole
+        LengthRole,
+        EditDistanceRole
     };
 
     explicit SearchModel(QObject* parent = nullptr);
-    ~SearchModel() = default;
+    ~SearchModel() override;
 
     // QAbstractListModel interface
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
@@ -113,6 +125,19 @@ public:
     const QString& getCurrentQuery() const { return m_currentQuery; }
     const SearchOptions& getCurrentOptions() const { return m_currentOptions; }
 
+    // Start and length of each match of query in a page's text, at most
+    // options.maxResults. Whole-word CJK queries only match where the
+    // text's segmentation puts word boundaries.
+    static QList<std::pair<int, int>> findMatches(
+        const QString& text, const QString& query,
+        const SearchOptions& options);
+
+    // Extracts the text layer of every page not cached yet ahead of the
+    // first query, for staged document opening. Extraction runs on a
+    // worker thread; each page enters the cache on this thread as it
+    // arrives.
+    void prefetchPageTexts(std::shared_ptr<Poppler::Document> document);
+
 signals:
     void searchStarted();
     void searchFinished(int resultCount);
@@ -130,15 +155,25 @@ private slots:
     void onSearchFinished();
 
 private:
+    struct PrefetchedPage {
+        int pageNumber = -1;
+        QString text;
+    };
+
     void performSearch();
     void performRealTimeSearch();
+    QList<SearchResult> performFuzzySearch();
+    QString cachedPageText(int pageNumber, Poppler::Page* page = nullptr);
+    // Pages that can contain the current query: narrowed by the word index
+    // of an attached document bundle for whole-word searches, otherwise all
+    QList<int> candidatePages() const;
     QList<SearchResult> searchInPage(Poppler::Page* page, int pageNumber,
                                      const QString& query,
                                      const SearchOptions& options);
     QString extractContext(const QString& pageText, int position, int length,
                            int contextLength = 50);
-    QRegularExpression createSearchRegex(const QString& query,
-                                         const SearchOptions& options);
+    static QRegularExpression createSearchRegex(const QString& query,
+                                                const SearchOptions& options);
 
     QList<SearchResult> m_results;
     int m_currentResultIndex;
@@ -155,4 +190,18 @@ private:
     QTimer* m_realTimeSearchTimer;
     bool m_isRealTimeSearchEnabled;
     int m_realTimeSearchDelay;
+
+    // Results found but not yet inserted into the model; committed in
+    // batches by the coalescer
+    QList<SearchResult> m_pendingResults;
+    ModelUpdateCoalescer* m_updateCoalescer;
+
+    // Text layer per page of m_pageTextDocument, kept across queries so
+    // search-as-you-type does not re-extract text on every keystroke
+    QHash<int, QString> m_pageTexts;
+    std::weak_ptr<Poppler::Document> m_pageTextDocument;
+    QFuture<PrefetchedPage> m_prefetchFuture;
+
+    // Minimum interval between partial result broadcasts (one frame)
+    static constexpr int REALTIME_UPDATE_INTERVAL_MS = 16;
 };
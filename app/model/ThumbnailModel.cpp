@@ -4,8 +4,12 @@
 #include <QDateTime>
 #include <QDebug>
 #include <QMutexLocker>
+#include <iterator>
+#include "ModelUpdateCoalescer.h"
+#include "PageMetadataTable.h"
 #include "utils/LoggingMacros.h"
 #include "ui/thumbnail/ThumbnailGenerator.h"
+#include "ui/viewer/CompactRaster.h"
 
 ThumbnailModel::ThumbnailModel(QObject* parent)
     : QAbstractListModel(parent),
@@ -38,6 +42,9 @@ void ThumbnailModel::initializeModel() {
     // 创建缩略图生成器
     m_generator = std::make_unique<ThumbnailGenerator>(this);
 
+    // 成批生成的缩略图合并为区间更新，视图每帧最多刷新一次
+    m_updateCoalescer = new ModelUpdateCoalescer(this);
+
     // 连接信号
     connect(m_generator.get(), &ThumbnailGenerator::thumbnailGenerated, this,
             &ThumbnailModel::onThumbnailGenerated);
@@ -99,6 +106,22 @@ QVariant ThumbnailModel::data(const QModelIndex& index, int role) const {
                     const_cast<ThumbnailModel*>(this)->m_cacheHits++;
                     return it->pixmap;
                 }
+
+                // 显示尺寸变化后从主图派生，不需要重新渲染
+                if (!it->master.isNull()) {
+                    ThumbnailModel* self = const_cast<ThumbnailModel*>(this);
+                    self->m_cacheHits++;
+                    it->pixmap = deriveDisplayPixmap(it->master);
+                    self->m_currentMemory -= it->memorySize;
+                    it->memorySize = calculateItemMemory(*it);
+                    self->m_currentMemory += it->memorySize;
+
+                    // 主图分辨率不足时先显示放大结果，同时请求更高一级主图
+                    if (!hasUsableMaster(*it) && !it->isLoading) {
+                        self->requestThumbnail(pageNumber);
+                    }
+                    return it->pixmap;
+                }
             }
 
             // 缓存未命中，请求生成缩略图
@@ -128,7 +151,12 @@ QVariant ThumbnailModel::data(const QModelIndex& index, int role) const {
                 return it->pageSize;
             }
 
-            // 如果没有缓存页面尺寸，尝试获取
+            // 优先读取页面元数据表，避免为尺寸创建页面对象
+            if (m_pageMetadata && m_pageMetadata->hasGeometry(pageNumber)) {
+                return m_pageMetadata->pageSize(pageNumber).toSize();
+            }
+
+            // 元数据表尚未填充到该页时回退到直接读取
             if (m_document) {
                 std::unique_ptr<Poppler::Page> page(
                     m_document->page(pageNumber));
@@ -171,9 +199,12 @@ QHash<int, QByteArray> ThumbnailModel::roleNames() const {
 }
 
 void ThumbnailModel::setDocument(std::shared_ptr<Poppler::Document> document) {
+    // 旧文档的行号在重置后失效
+    m_updateCoalescer->clear();
     beginResetModel();
 
     m_document = document;
+    m_pageMetadata = PageMetadataTable::forDocument(document);
     clearCache();
 
     if (m_generator) {
@@ -193,21 +224,11 @@ void ThumbnailModel::setThumbnailSize(const QSize& size) {
             m_generator->setThumbnailSize(size);
         }
 
-        LOG_DEBUG("ThumbnailModel: Thumbnail size changed from {}x{} to {}x{}, clearing cache selectively", 
+        LOG_DEBUG("ThumbnailModel: Thumbnail size changed from {}x{} to {}x{}, re-deriving from master images",
                   oldSize.width(), oldSize.height(), size.width(), size.height());
 
-        // 渐进式清除缓存：只清除pixmap数据，保留其他信息
-        {
-            QMutexLocker locker(&m_thumbnailsMutex);
-            for (auto& item : m_thumbnails) {
-                if (!item.pixmap.isNull()) {
-                    m_currentMemory -= item.memorySize;
-                    item.pixmap = QPixmap();  // 清除pixmap但保留其他状态
-                    item.memorySize = 0;
-                    item.isLoading = false;  // 重置加载状态
-                }
-            }
-        }
+        // 只丢弃派生的显示图，主图保留；视图重新请求时按新尺寸缩放
+        dropDisplayPixmaps(false);
 
         emit memoryUsageChanged(m_currentMemory);
         emit cacheUpdated();
@@ -231,18 +252,8 @@ void ThumbnailModel::setThumbnailQuality(double quality) {
         LOG_DEBUG("ThumbnailModel: Thumbnail quality changed from {:.2f} to {:.2f}, clearing cache selectively", 
                   oldQuality, quality);
 
-        // 渐进式清除缓存：只清除pixmap数据，保留其他信息
-        {
-            QMutexLocker locker(&m_thumbnailsMutex);
-            for (auto& item : m_thumbnails) {
-                if (!item.pixmap.isNull()) {
-                    m_currentMemory -= item.memorySize;
-                    item.pixmap = QPixmap();  // 清除pixmap但保留其他状态
-                    item.memorySize = 0;
-                    item.isLoading = false;  // 重置加载状态
-                }
-            }
-        }
+        // 质量变化需要重新渲染：主图与显示图一并清除，保留其他信息
+        dropDisplayPixmaps(true);
 
         emit memoryUsageChanged(m_currentMemory);
         emit cacheUpdated();
@@ -302,8 +313,8 @@ void ThumbnailModel::requestThumbnail(int pageNumber) {
     // 首先检查是否已经有有效的缓存
     auto it = m_thumbnails.find(pageNumber);
     if (it != m_thumbnails.end()) {
-        // 如果已经有有效的pixmap，更新访问时间后直接返回
-        if (!it->pixmap.isNull()) {
+        // 如果已经有足够分辨率的主图，更新访问时间后直接返回
+        if (hasUsableMaster(*it)) {
             it->lastAccessed = QDateTime::currentMSecsSinceEpoch();
             updateAccessFrequency(pageNumber);
             LOG_DEBUG("ThumbnailModel: Page {} already cached, skip request", pageNumber);
@@ -335,18 +346,18 @@ void ThumbnailModel::requestThumbnail(int pageNumber) {
 
     locker.unlock();
 
-    // 发送生成请求，使用优先级
+    // 发送生成请求，使用优先级；渲染目标是主分辨率而不是显示尺寸
     if (m_generator) {
         int priority = calculatePriority(pageNumber);
-        m_generator->generateThumbnail(pageNumber, m_thumbnailSize,
+        int level = requiredMasterLevel();
+        m_generator->generateThumbnail(pageNumber, QSize(level, level),
                                        m_thumbnailQuality, priority);
     }
 
     // 通知加载状态变化
     emit loadingStateChanged(pageNumber, true);
 
-    QModelIndex idx = index(pageNumber);
-    emit dataChanged(idx, idx, {LoadingRole});
+    m_updateCoalescer->markChanged(pageNumber, {LoadingRole});
 }
 
 void ThumbnailModel::requestThumbnailRange(int startPage, int endPage) {
@@ -362,8 +373,8 @@ void ThumbnailModel::requestThumbnailRange(int startPage, int endPage) {
     for (int i = startPage; i <= endPage; ++i) {
         QMutexLocker locker(&m_thumbnailsMutex);
         auto it = m_thumbnails.find(i);
-        bool needRequest = (it == m_thumbnails.end() || 
-                           (it->pixmap.isNull() && !it->isLoading));
+        bool needRequest = (it == m_thumbnails.end() ||
+                            (!hasUsableMaster(*it) && !it->isLoading));
         locker.unlock();
         
         if (needRequest) {
@@ -459,13 +470,19 @@ void ThumbnailModel::onThumbnailGenerated(int pageNumber,
         return;  // 项目可能已被清理
     }
 
-    // 更新缓存项
-    it->pixmap = pixmap;
+    // 更新缓存项：生成结果作为主图，显示图按当前尺寸派生；
+    // 灰度/黑白页面的主图以 8 位或 1 位保存
+    m_currentMemory -= it->memorySize;
+    it->master = CompactRaster(pixmap.toImage().convertToFormat(
+                                   QImage::Format_ARGB32_Premultiplied))
+                     .image();
+    it->masterLevel = qMax(pixmap.width(), pixmap.height());
+    it->pixmap = deriveDisplayPixmap(it->master);
     it->isLoading = false;
     it->hasError = false;
     it->errorMessage.clear();
     it->lastAccessed = QDateTime::currentMSecsSinceEpoch();
-    it->memorySize = calculatePixmapMemory(pixmap);
+    it->memorySize = calculateItemMemory(*it);
 
     m_currentMemory += it->memorySize;
     
@@ -485,8 +502,7 @@ void ThumbnailModel::onThumbnailGenerated(int pageNumber,
     emit loadingStateChanged(pageNumber, false);
     emit memoryUsageChanged(m_currentMemory);
 
-    QModelIndex idx = index(pageNumber);
-    emit dataChanged(idx, idx, {PixmapRole, LoadingRole});
+    m_updateCoalescer->markChanged(pageNumber, {PixmapRole, LoadingRole});
 }
 
 void ThumbnailModel::onThumbnailError(int pageNumber, const QString& error) {
@@ -509,8 +525,8 @@ void ThumbnailModel::onThumbnailError(int pageNumber, const QString& error) {
     emit thumbnailError(pageNumber, error);
     emit loadingStateChanged(pageNumber, false);
 
-    QModelIndex idx = index(pageNumber);
-    emit dataChanged(idx, idx, {LoadingRole, ErrorRole, ErrorMessageRole});
+    m_updateCoalescer->markChanged(pageNumber,
+                                   {LoadingRole, ErrorRole, ErrorMessageRole});
 }
 
 void ThumbnailModel::onPreloadTimer() {
@@ -582,8 +598,62 @@ qint64 ThumbnailModel::calculatePixmapMemory(const QPixmap& pixmap) const {
         return 0;
     }
 
-    // 估算内存使用：宽度 × 高度 × 4字节(ARGB32)
-    return static_cast<qint64>(pixmap.width()) * pixmap.height() * 4;
+    // 按位图实际色深估算内存使用
+    return CompactRaster::pixmapBytes(pixmap);
+}
+
+qint64 ThumbnailModel::calculateItemMemory(const ThumbnailItem& item) const {
+    return item.master.sizeInBytes() + calculatePixmapMemory(item.pixmap);
+}
+
+int ThumbnailModel::requiredMasterLevel() const {
+    // 选择不小于显示长边的最小主分辨率
+    const int longEdge =
+        qMax(m_thumbnailSize.width(), m_thumbnailSize.height());
+    for (int level : MASTER_RESOLUTIONS) {
+        if (level >= longEdge) {
+            return level;
+        }
+    }
+    return MASTER_RESOLUTIONS[std::size(MASTER_RESOLUTIONS) - 1];
+}
+
+bool ThumbnailModel::hasUsableMaster(const ThumbnailItem& item) const {
+    return !item.master.isNull() && item.masterLevel >= requiredMasterLevel();
+}
+
+QPixmap ThumbnailModel::deriveDisplayPixmap(const QImage& master) const {
+    if (master.isNull()) {
+        return QPixmap();
+    }
+
+    QSize target = master.size().scaled(m_thumbnailSize, Qt::KeepAspectRatio);
+    if (target == master.size()) {
+        return QPixmap::fromImage(master);
+    }
+
+    // 预乘ARGB32格式的平滑缩放走Qt内部的SIMD路径；压缩存储的主图在此展开
+    return QPixmap::fromImage(
+        master.scaled(target, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+}
+
+void ThumbnailModel::dropDisplayPixmaps(bool dropMasters) {
+    QMutexLocker locker(&m_thumbnailsMutex);
+    for (auto& item : m_thumbnails) {
+        if (item.pixmap.isNull() && (!dropMasters || item.master.isNull())) {
+            continue;
+        }
+
+        m_currentMemory -= item.memorySize;
+        item.pixmap = QPixmap();
+        if (dropMasters) {
+            item.master = QImage();
+            item.masterLevel = 0;
+            item.isLoading = false;  // 重置加载状态
+        }
+        item.memorySize = calculateItemMemory(item);
+        m_currentMemory += item.memorySize;
+    }
 }
 
 void ThumbnailModel::updateMemoryUsage() {
@@ -608,7 +678,7 @@ bool ThumbnailModel::shouldPreload(int pageNumber) const {
     auto it = m_thumbnails.find(pageNumber);
     if (it != m_thumbnails.end()) {
         // 如果已有有效缓存，不需要预加载
-        if (!it->pixmap.isNull()) {
+        if (hasUsableMaster(*it)) {
             return false;
         }
         // 如果正在加载或有错误，也不需要预加载
@@ -622,7 +692,7 @@ bool ThumbnailModel::shouldPreload(int pageNumber) const {
 bool ThumbnailModel::hasCachedThumbnail(int pageNumber) const {
     QMutexLocker locker(&m_thumbnailsMutex);
     auto it = m_thumbnails.find(pageNumber);
-    return (it != m_thumbnails.end() && !it->pixmap.isNull());
+    return (it != m_thumbnails.end() && hasUsableMaster(*it));
 }
 
 bool ThumbnailModel::isThumbnailLoading(int pageNumber) const {
@@ -7,6 +7,7 @@
 #include <QFuture>
 #include <QFutureWatcher>
 #include <QHash>
+#include <QImage>
 #include <QModelIndex>
 #include <QMutex>
 #include <QObject>
@@ -24,6 +25,8 @@ class Page;
 }  // namespace Poppler
 
 class ThumbnailGenerator;
+class PageMetadataTable;
+class ModelUpdateCoalescer;
 
 /**
  * @brief 高性能的PDF缩略图数据模型
@@ -34,6 +37,7 @@ class ThumbnailGenerator;
  * - 智能缓存管理
  * - 懒加载机制
  * - 内存使用优化
+ * - 多分辨率主缩略图：显示尺寸由主图缩放派生，改变尺寸不重新渲染
  */
 class ThumbnailModel : public QAbstractListModel {
     Q_OBJECT
@@ -125,7 +129,9 @@ private slots:
 
 private:
     struct ThumbnailItem {
-        QPixmap pixmap;
+        QImage master;        // 主分辨率图像（长边为 MASTER_RESOLUTIONS 之一）
+        int masterLevel = 0;  // 主图长边像素
+        QPixmap pixmap;       // 由主图派生的当前显示尺寸
         bool isLoading = false;
         bool hasError = false;
         QString errorMessage;
@@ -144,6 +150,13 @@ private:
     void evictLeastFrequentlyUsed();
     void evictByAdaptivePolicy();
     qint64 calculatePixmapMemory(const QPixmap& pixmap) const;
+    qint64 calculateItemMemory(const ThumbnailItem& item) const;
+
+    // 多分辨率主图
+    int requiredMasterLevel() const;
+    bool hasUsableMaster(const ThumbnailItem& item) const;
+    QPixmap deriveDisplayPixmap(const QImage& master) const;
+    void dropDisplayPixmaps(bool dropMasters);
     void updateMemoryUsage();
     bool shouldPreload(int pageNumber) const;
 
@@ -159,7 +172,9 @@ private:
 
     // 数据成员
     std::shared_ptr<Poppler::Document> m_document;
+    std::shared_ptr<PageMetadataTable> m_pageMetadata;
     std::unique_ptr<ThumbnailGenerator> m_generator;
+    ModelUpdateCoalescer* m_updateCoalescer = nullptr;  // 合并逐项的数据变化
 
     mutable QHash<int, ThumbnailItem> m_thumbnails;
     mutable QRecursiveMutex m_thumbnailsMutex;
@@ -203,4 +218,5 @@ private:
     static constexpr qint64 DEFAULT_MEMORY_LIMIT = 128 * 1024 * 1024;  // 128MB
     static constexpr int DEFAULT_PRELOAD_RANGE = 5;
     static constexpr int PRELOAD_TIMER_INTERVAL = 100;  // ms
+    static constexpr int MASTER_RESOLUTIONS[] = {128, 256, 512};
 };
@@ -7,12 +7,183 @@
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
 #include <QStandardPaths>
 #include "utils/LoggingMacros.h"
 
 // Static instance
 PluginManager* PluginManager::s_instance = nullptr;
 
+namespace {
+constexpr int METADATA_CACHE_VERSION = 1;
+
+QJsonArray toJsonArray(const QStringList& list) {
+    QJsonArray array;
+    for (const QString& value : list) {
+        array.append(value);
+    }
+    return array;
+}
+
+QStringList fromJsonArray(const QJsonArray& array) {
+    QStringList list;
+    for (const QJsonValue& value : array) {
+        list.append(value.toString());
+    }
+    return list;
+}
+}  // namespace
+
+// PluginMetadata Implementation
+QJsonObject PluginMetadata::toJson() const {
+    QJsonObject json;
+    json["name"] = name;
+    json["version"] = version;
+    json["description"] = description;
+    json["author"] = author;
+    json["filePath"] = filePath;
+    json["dependencies"] = toJsonArray(dependencies);
+    json["supportedTypes"] = toJsonArray(supportedTypes);
+    json["features"] = toJsonArray(features);
+    json["configuration"] = configuration;
+    json["fileSize"] = fileSize;
+    json["lastModified"] = lastModified;
+    return json;
+}
+
+PluginMetadata PluginMetadata::fromJson(const QJsonObject& json) {
+    PluginMetadata metadata;
+    metadata.name = json.value("name").toString();
+    metadata.version = json.value("version").toString();
+    metadata.description = json.value("description").toString();
+    metadata.author = json.value("author").toString();
+    metadata.filePath = json.value("filePath").toString();
+    metadata.dependencies = fromJsonArray(json.value("dependencies").toArray());
+    metadata.supportedTypes =
+        fromJsonArray(json.value("supportedTypes").toArray());
+    metadata.features = fromJsonArray(json.value("features").toArray());
+    metadata.configuration = json.value("configuration").toObject();
+    metadata.fileSize = json.value("fileSize").toInteger();
+    metadata.lastModified = json.value("lastModified").toInteger();
+    return metadata;
+}
+
+// PluginMetadataCache Implementation
+PluginMetadataCache::PluginMetadataCache(const QString& cacheFilePath)
+    : m_cacheFilePath(cacheFilePath), m_dirty(false) {}
+
+bool PluginMetadataCache::load() {
+    m_entries.clear();
+    m_dirty = false;
+
+    if (m_cacheFilePath.isEmpty()) {
+        return false;
+    }
+
+    QFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version").toInt() != METADATA_CACHE_VERSION) {
+        LOG_DEBUG("Discarding plugin metadata cache with outdated version");
+        m_dirty = true;
+        return false;
+    }
+
+    const QJsonArray entries = root.value("plugins").toArray();
+    for (const QJsonValue& value : entries) {
+        PluginMetadata metadata = PluginMetadata::fromJson(value.toObject());
+        if (!metadata.filePath.isEmpty()) {
+            m_entries.insert(metadata.filePath, metadata);
+        }
+    }
+
+    LOG_DEBUG("Loaded {} cached plugin metadata entries", m_entries.size());
+    return true;
+}
+
+bool PluginMetadataCache::save() {
+    if (m_cacheFilePath.isEmpty()) {
+        return false;
+    }
+
+    QDir().mkpath(QFileInfo(m_cacheFilePath).absolutePath());
+
+    QJsonArray entries;
+    for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+        entries.append(it.value().toJson());
+    }
+
+    QJsonObject root;
+    root["version"] = METADATA_CACHE_VERSION;
+    root["plugins"] = entries;
+
+    // Write atomically so an interrupted save never leaves a corrupt cache
+    QSaveFile file(m_cacheFilePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        return false;
+    }
+
+    m_dirty = false;
+    return true;
+}
+
+void PluginMetadataCache::clear() {
+    m_entries.clear();
+    m_dirty = true;
+}
+
+bool PluginMetadataCache::lookup(const QString& filePath,
+                                 PluginMetadata& metadata) const {
+    auto it = m_entries.constFind(filePath);
+    if (it == m_entries.constEnd()) {
+        return false;
+    }
+
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.exists() || fileInfo.size() != it.value().fileSize ||
+        fileInfo.lastModified().toMSecsSinceEpoch() !=
+            it.value().lastModified) {
+        return false;
+    }
+
+    metadata = it.value();
+    return true;
+}
+
+void PluginMetadataCache::insert(const QString& filePath,
+                                 const PluginMetadata& metadata) {
+    PluginMetadata entry = metadata;
+    entry.filePath = filePath;
+    m_entries.insert(filePath, entry);
+    m_dirty = true;
+}
+
+void PluginMetadataCache::remove(const QString& filePath) {
+    if (m_entries.remove(filePath) > 0) {
+        m_dirty = true;
+    }
+}
+
+void PluginMetadataCache::prune(const QStringList& existingPaths) {
+    QSet<QString> existing(existingPaths.begin(), existingPaths.end());
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (!existing.contains(it.key())) {
+            it = m_entries.erase(it);
+            m_dirty = true;
+        } else {
+            ++it;
+        }
+    }
+}
+
 // PluginDependencyResolver Implementation
 QStringList PluginDependencyResolver::resolveDependencies(
     const QHash<QString, PluginMetadata>& plugins) {
@@ -101,11 +272,19 @@ PluginManager& PluginManager::instance() {
 PluginManager::PluginManager(QObject* parent)
     : QObject(parent),
       m_settings(nullptr),
+      m_metadataCache(
+          QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+          "/plugin_metadata.json"),
+      m_lazyLoadingEnabled(true),
       m_hotReloadingEnabled(false),
+      m_fileWatcher(nullptr),
       m_hotReloadTimer(nullptr) {
     // Initialize settings
     m_settings = new QSettings("SAST", "Readium-Plugins", this);
 
+    // Load cached metadata so plugins can be enumerated without loading them
+    m_metadataCache.load();
+
     // Setup default plugin directories
     QStringList defaultDirs;
     defaultDirs << QApplication::applicationDirPath() + "/plugins";
@@ -114,9 +293,18 @@ PluginManager::PluginManager(QObject* parent)
                        "/plugins";
     setPluginDirectories(defaultDirs);
 
-    // Setup hot reloading timer
+    // Setup hot reloading: file system notifications (inotify on Linux)
+    // feed a short debounce timer, since plugin files are usually written
+    // in several steps by build tools and installers
+    m_fileWatcher = new QFileSystemWatcher(this);
+    connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, this,
+            &PluginManager::onPluginFileChanged);
+    connect(m_fileWatcher, &QFileSystemWatcher::directoryChanged, this,
+            &PluginManager::onPluginDirectoryChanged);
+
     m_hotReloadTimer = new QTimer(this);
-    m_hotReloadTimer->setInterval(5000);  // Check every 5 seconds
+    m_hotReloadTimer->setSingleShot(true);
+    m_hotReloadTimer->setInterval(500);
     connect(m_hotReloadTimer, &QTimer::timeout, this,
             &PluginManager::checkForPluginChanges);
 
@@ -136,9 +324,19 @@ void PluginManager::scanForPlugins() {
     LOG_DEBUG("Scanning for plugins in directories: [{}]",
               m_pluginDirectories.join(", ").toStdString());
 
+    QElapsedTimer timer;
+    timer.start();
+
+    // Keep runtime state of plugins that are already loaded
+    QHash<QString, PluginMetadata> previousMetadata = m_pluginMetadata;
     m_pluginMetadata.clear();
+    QStringList scannedFiles;
     int pluginCount = 0;
 
+    if (m_settings) {
+        m_settings->beginGroup("plugins");
+    }
+
     for (const QString& directory : m_pluginDirectories) {
         QDir pluginDir(directory);
         if (!pluginDir.exists()) {
@@ -154,25 +352,75 @@ void PluginManager::scanForPlugins() {
 
         while (it.hasNext()) {
             QString filePath = it.next();
+            scannedFiles.append(filePath);
 
-            if (validatePlugin(filePath)) {
-                QPluginLoader loader(filePath);
-                PluginMetadata metadata = extractMetadata(&loader);
-
-                if (!metadata.name.isEmpty()) {
-                    metadata.filePath = filePath;
-                    m_pluginMetadata[metadata.name] = metadata;
-                    pluginCount++;
+            PluginMetadata metadata = readMetadata(filePath);
+            if (metadata.name.isEmpty()) {
+                continue;
+            }
 
-                    qDebug()
-                        << "Found plugin:" << metadata.name << "at" << filePath;
-                }
+            if (previousMetadata.contains(metadata.name)) {
+                const PluginMetadata& previous =
+                    previousMetadata[metadata.name];
+                metadata.isLoaded = previous.isLoaded;
+                metadata.loadTime = previous.loadTime;
+            }
+            if (m_settings) {
+                metadata.isEnabled =
+                    m_settings->value(metadata.name + "/enabled", true)
+                        .toBool();
             }
+
+            m_pluginMetadata[metadata.name] = metadata;
+            pluginCount++;
+
+            qDebug() << "Found plugin:" << metadata.name << "at" << filePath;
         }
     }
 
-    qDebug() << "Found" << pluginCount << "plugins";
+    if (m_settings) {
+        m_settings->endGroup();
+    }
+
+    m_metadataCache.prune(scannedFiles);
+    if (m_metadataCache.isDirty()) {
+        m_metadataCache.save();
+    }
+
+    if (m_hotReloadingEnabled) {
+        updateFileWatcher();
+    }
+
+    qDebug() << "Found" << pluginCount << "plugins in" << timer.elapsed()
+             << "ms";
     emit pluginsScanned(pluginCount);
+
+    if (!m_lazyLoadingEnabled) {
+        loadAllPlugins();
+    }
+}
+
+PluginMetadata PluginManager::readMetadata(const QString& filePath) {
+    PluginMetadata metadata;
+    if (m_metadataCache.lookup(filePath, metadata)) {
+        return metadata;
+    }
+
+    // Cache miss: read the embedded metadata from the plugin file. Files
+    // without valid metadata are cached too, so they are not re-read on
+    // every scan.
+    QPluginLoader loader(filePath);
+    if (!loader.metaData().isEmpty()) {
+        metadata = extractMetadata(&loader);
+    }
+
+    QFileInfo fileInfo(filePath);
+    metadata.filePath = filePath;
+    metadata.fileSize = fileInfo.size();
+    metadata.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    m_metadataCache.insert(filePath, metadata);
+
+    return metadata;
 }
 
 bool PluginManager::loadPlugin(const QString& pluginName) {
@@ -296,12 +544,124 @@ void PluginManager::loadAllPlugins() {
         PluginDependencyResolver::getLoadOrder(m_pluginMetadata);
 
     for (const QString& pluginName : loadOrder) {
-        if (m_pluginMetadata[pluginName].isEnabled) {
+        if (m_pluginMetadata[pluginName].isEnabled &&
+            !isPluginLoaded(pluginName)) {
             loadPlugin(pluginName);
         }
     }
 }
 
+void PluginManager::setLazyLoadingEnabled(bool enabled) {
+    if (m_lazyLoadingEnabled == enabled) {
+        return;
+    }
+    m_lazyLoadingEnabled = enabled;
+
+    // Switching to eager loading loads what has been deferred so far
+    if (!enabled) {
+        loadAllPlugins();
+    }
+}
+
+bool PluginManager::activatePlugin(const QString& pluginName) {
+    QStringList activationStack;
+    return activatePluginInternal(pluginName, activationStack);
+}
+
+bool PluginManager::activatePluginInternal(const QString& pluginName,
+                                           QStringList& activationStack) {
+    if (isPluginLoaded(pluginName)) {
+        return true;
+    }
+
+    if (!m_pluginMetadata.contains(pluginName) ||
+        !m_pluginMetadata[pluginName].isEnabled) {
+        return false;
+    }
+
+    if (activationStack.contains(pluginName)) {
+        qWarning() << "Cyclic dependency detected involving plugin:"
+                   << pluginName;
+        return false;
+    }
+
+    activationStack.append(pluginName);
+
+    // Dependencies are activated on demand as well
+    const QStringList dependencies = m_pluginMetadata[pluginName].dependencies;
+    for (const QString& dependency : dependencies) {
+        if (!activatePluginInternal(dependency, activationStack)) {
+            m_pluginErrors[pluginName].append(
+                QString("Dependency could not be activated: %1")
+                    .arg(dependency));
+            activationStack.removeLast();
+            return false;
+        }
+    }
+
+    activationStack.removeLast();
+    return loadPlugin(pluginName);
+}
+
+IPlugin* PluginManager::activatePluginForFeature(const QString& feature) {
+    const QStringList candidates = getPluginsWithFeature(feature);
+
+    // Prefer a plugin that is already running
+    for (const QString& pluginName : candidates) {
+        if (isPluginLoaded(pluginName)) {
+            return getPlugin(pluginName);
+        }
+    }
+
+    for (const QString& pluginName : candidates) {
+        if (activatePlugin(pluginName)) {
+            return getPlugin(pluginName);
+        }
+    }
+
+    return nullptr;
+}
+
+IPlugin* PluginManager::activatePluginForFileType(const QString& fileType) {
+    const QStringList candidates = getPluginsForFileType(fileType);
+
+    for (const QString& pluginName : candidates) {
+        if (isPluginLoaded(pluginName)) {
+            return getPlugin(pluginName);
+        }
+    }
+
+    for (const QString& pluginName : candidates) {
+        if (activatePlugin(pluginName)) {
+            return getPlugin(pluginName);
+        }
+    }
+
+    return nullptr;
+}
+
+IDocumentPlugin* PluginManager::activateDocumentPluginFor(
+    const QString& filePath) {
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix.isEmpty()) {
+        return nullptr;
+    }
+
+    const QStringList candidates = getPluginsForFileType(suffix);
+    for (const QString& pluginName : candidates) {
+        if (!activatePlugin(pluginName)) {
+            continue;
+        }
+
+        IDocumentPlugin* docPlugin = getPlugin<IDocumentPlugin>(pluginName);
+        if (docPlugin && docPlugin->canProcess(filePath)) {
+            return docPlugin;
+        }
+    }
+
+    return nullptr;
+}
+
 void PluginManager::unloadAllPlugins() {
     QStringList loadedPlugins = getLoadedPlugins();
 
@@ -504,6 +864,11 @@ void PluginManager::saveSettings() {
     m_settings->sync();
 }
 
+void PluginManager::clearMetadataCache() {
+    m_metadataCache.clear();
+    m_metadataCache.save();
+}
+
 void PluginManager::enableHotReloading(bool enabled) {
     m_hotReloadingEnabled = enabled;
 
@@ -516,34 +881,128 @@ void PluginManager::enableHotReloading(bool enabled) {
                 fileInfo.lastModified().toMSecsSinceEpoch();
         }
 
-        m_hotReloadTimer->start();
+        updateFileWatcher();
     } else {
         m_hotReloadTimer->stop();
+        m_pendingChangedFiles.clear();
+
+        const QStringList watched =
+            m_fileWatcher->files() + m_fileWatcher->directories();
+        if (!watched.isEmpty()) {
+            m_fileWatcher->removePaths(watched);
+        }
     }
 }
 
+void PluginManager::updateFileWatcher() {
+    QStringList paths;
+    for (const QString& directory : m_pluginDirectories) {
+        if (QDir(directory).exists()) {
+            paths.append(directory);
+        }
+    }
+    for (auto it = m_pluginMetadata.begin(); it != m_pluginMetadata.end();
+         ++it) {
+        if (QFile::exists(it.value().filePath)) {
+            paths.append(it.value().filePath);
+        }
+    }
+
+    const QStringList watched =
+        m_fileWatcher->files() + m_fileWatcher->directories();
+    QStringList toAdd;
+    for (const QString& path : paths) {
+        if (!watched.contains(path)) {
+            toAdd.append(path);
+        }
+    }
+    if (!toAdd.isEmpty()) {
+        m_fileWatcher->addPaths(toAdd);
+    }
+}
+
+void PluginManager::onPluginFileChanged(const QString& filePath) {
+    if (!m_hotReloadingEnabled)
+        return;
+
+    if (!m_pendingChangedFiles.contains(filePath)) {
+        m_pendingChangedFiles.append(filePath);
+    }
+    m_hotReloadTimer->start();
+}
+
+void PluginManager::onPluginDirectoryChanged(const QString& directory) {
+    if (!m_hotReloadingEnabled)
+        return;
+
+    if (!m_pendingChangedFiles.contains(directory)) {
+        m_pendingChangedFiles.append(directory);
+    }
+    m_hotReloadTimer->start();
+}
+
 void PluginManager::checkForPluginChanges() {
     if (!m_hotReloadingEnabled)
         return;
 
+    const QStringList changedPaths = m_pendingChangedFiles;
+    m_pendingChangedFiles.clear();
+
+    bool directoryChanged = false;
+    for (const QString& path : changedPaths) {
+        if (m_pluginDirectories.contains(path)) {
+            directoryChanged = true;
+        }
+    }
+
     for (auto it = m_pluginMetadata.begin(); it != m_pluginMetadata.end();
          ++it) {
-        QFileInfo fileInfo(it.value().filePath);
+        const QString pluginName = it.key();
+        const QString filePath = it.value().filePath;
+        if (!changedPaths.contains(filePath)) {
+            continue;
+        }
+
+        QFileInfo fileInfo(filePath);
+        if (!fileInfo.exists()) {
+            // Removed or being replaced; the directory rescan handles it
+            directoryChanged = true;
+            continue;
+        }
+
         qint64 currentModTime = fileInfo.lastModified().toMSecsSinceEpoch();
-        qint64 recordedModTime = m_pluginModificationTimes.value(it.key(), 0);
+        qint64 recordedModTime = m_pluginModificationTimes.value(pluginName, 0);
 
         if (currentModTime > recordedModTime) {
-            qDebug() << "Plugin file changed, reloading:" << it.key();
+            qDebug() << "Plugin file changed, reloading:" << pluginName;
+
+            m_metadataCache.remove(filePath);
+            PluginMetadata metadata = readMetadata(filePath);
+            if (!metadata.name.isEmpty() && metadata.name == pluginName) {
+                metadata.isEnabled = it.value().isEnabled;
+                metadata.isLoaded = it.value().isLoaded;
+                metadata.loadTime = it.value().loadTime;
+                it.value() = metadata;
+            }
 
             // Unload and reload the plugin
-            if (isPluginLoaded(it.key())) {
-                unloadPlugin(it.key());
-                loadPlugin(it.key());
+            if (isPluginLoaded(pluginName)) {
+                unloadPlugin(pluginName);
+                loadPlugin(pluginName);
             }
 
-            m_pluginModificationTimes[it.key()] = currentModTime;
+            m_pluginModificationTimes[pluginName] = currentModTime;
         }
     }
+
+    if (directoryChanged) {
+        scanForPlugins();
+    } else if (m_metadataCache.isDirty()) {
+        m_metadataCache.save();
+    }
+
+    // Files replaced by rename drop out of the watch list; add them back
+    updateFileWatcher();
 }
 
 QJsonObject PluginManager::getPluginConfiguration(
@@ -650,6 +1109,8 @@ bool PluginManager::uninstallPlugin(const QString& pluginName) {
 
     // Remove from metadata
     m_pluginMetadata.remove(pluginName);
+    m_metadataCache.remove(filePath);
+    m_metadataCache.save();
 
     emit pluginUninstalled(pluginName);
 
@@ -685,10 +1146,11 @@ bool PluginManager::updatePlugin(const QString& pluginName,
     }
 
     // Update metadata
-    QPluginLoader loader(oldPath);
-    PluginMetadata newMetadata = extractMetadata(&loader);
-    newMetadata.filePath = oldPath;
+    m_metadataCache.remove(oldPath);
+    PluginMetadata newMetadata = readMetadata(oldPath);
+    newMetadata.isEnabled = m_pluginMetadata[pluginName].isEnabled;
     m_pluginMetadata[pluginName] = newMetadata;
+    m_metadataCache.save();
 
     // Reload if it was loaded before
     if (wasLoaded) {
@@ -2,6 +2,7 @@
 
 #include <QAction>
 #include <QDir>
+#include <QFileSystemWatcher>
 #include <QHash>
 #include <QJsonArray>
 #include <QJsonDocument>
@@ -94,8 +95,47 @@ struct PluginMetadata {
     bool isLoaded;
     bool isEnabled;
     qint64 loadTime;
+    qint64 fileSize;      // Size of the plugin file when metadata was read
+    qint64 lastModified;  // Modification time (ms since epoch) of the file
+
+    PluginMetadata()
+        : isLoaded(false),
+          isEnabled(true),
+          loadTime(0),
+          fileSize(0),
+          lastModified(0) {}
+
+    QJsonObject toJson() const;
+    static PluginMetadata fromJson(const QJsonObject& json);
+};
+
+/**
+ * Persistent cache of plugin metadata keyed by file path.
+ *
+ * Entries are considered valid while the file's size and modification time
+ * match, so plugins can be enumerated without opening the shared library.
+ */
+class PluginMetadataCache {
+public:
+    explicit PluginMetadataCache(const QString& cacheFilePath = QString());
+
+    bool load();
+    bool save();
+    void clear();
+
+    bool lookup(const QString& filePath, PluginMetadata& metadata) const;
+    void insert(const QString& filePath, const PluginMetadata& metadata);
+    void remove(const QString& filePath);
+    void prune(const QStringList& existingPaths);
 
-    PluginMetadata() : isLoaded(false), isEnabled(true), loadTime(0) {}
+    QString cacheFilePath() const { return m_cacheFilePath; }
+    bool isDirty() const { return m_dirty; }
+    int size() const { return m_entries.size(); }
+
+private:
+    QString m_cacheFilePath;
+    QHash<QString, PluginMetadata> m_entries;
+    bool m_dirty;
 };
 
 /**
@@ -136,6 +176,15 @@ public:
     void loadAllPlugins();
     void unloadAllPlugins();
 
+    // Lazy activation: plugins are only loaded when first needed. With lazy
+    // loading disabled every enabled plugin is loaded after each scan.
+    void setLazyLoadingEnabled(bool enabled);
+    bool isLazyLoadingEnabled() const { return m_lazyLoadingEnabled; }
+    bool activatePlugin(const QString& pluginName);
+    IPlugin* activatePluginForFeature(const QString& feature);
+    IPlugin* activatePluginForFileType(const QString& fileType);
+    IDocumentPlugin* activateDocumentPluginFor(const QString& filePath);
+
     // Plugin management
     QStringList getAvailablePlugins() const;
     QStringList getLoadedPlugins() const;
@@ -178,6 +227,10 @@ public:
     void loadSettings();
     void saveSettings();
 
+    // Metadata cache
+    PluginMetadataCache& metadataCache() { return m_metadataCache; }
+    void clearMetadataCache();
+
     // Hot reloading
     void enableHotReloading(bool enabled);
     bool isHotReloadingEnabled() const { return m_hotReloadingEnabled; }
@@ -221,6 +274,8 @@ signals:
     void pluginConfigurationRestored(const QString& filePath);
 
 private slots:
+    void onPluginFileChanged(const QString& filePath);
+    void onPluginDirectoryChanged(const QString& directory);
     void checkForPluginChanges();
 
 private:
@@ -230,6 +285,10 @@ private:
     bool loadPluginFromFile(const QString& filePath);
     void unloadPluginInternal(const QString& pluginName);
     PluginMetadata extractMetadata(QPluginLoader* loader) const;
+    PluginMetadata readMetadata(const QString& filePath);
+    bool activatePluginInternal(const QString& pluginName,
+                                QStringList& activationStack);
+    void updateFileWatcher();
     bool checkDependencies(const QString& pluginName) const;
     void resolveAndLoadPlugins();
 
@@ -243,9 +302,15 @@ private:
     QStringList m_pluginDirectories;
     QSettings* m_settings;
 
-    // Hot reloading
+    // Metadata cache and lazy activation
+    PluginMetadataCache m_metadataCache;
+    bool m_lazyLoadingEnabled;
+
+    // Hot reloading (file system notifications, debounced)
     bool m_hotReloadingEnabled;
+    QFileSystemWatcher* m_fileWatcher;
     QTimer* m_hotReloadTimer;
+    QStringList m_pendingChangedFiles;
     QHash<QString, qint64> m_pluginModificationTimes;
 
     static PluginManager* s_instance;
@@ -0,0 +1,120 @@
+#include "DocumentOpenPipeline.h"
+#include <QPointer>
+#include "utils/LoggingMacros.h"
+
+DocumentOpenPipeline::DocumentOpenPipeline(QObject* parent)
+    : QObject(parent),
+      m_phase(FirstPage),
+      m_started(false),
+      m_timer(new QTimer(this)) {
+    // 零间隔单次定时器：每个时间片之间先处理已排队的绘制与输入事件
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(0);
+    connect(m_timer, &QTimer::timeout, this, &DocumentOpenPipeline::runSlice);
+}
+
+void DocumentOpenPipeline::addStep(Phase phase, Step step) {
+    if (!step) {
+        return;
+    }
+
+    const int target = qMin<int>(qMax<int>(phase, m_phase), PhaseCount - 1);
+    m_steps[target].push_back(std::move(step));
+
+    if (m_started && !m_timer->isActive()) {
+        m_timer->start();
+    }
+}
+
+void DocumentOpenPipeline::start() {
+    if (m_started) {
+        return;
+    }
+    m_started = true;
+    m_clock.start();
+    emit phaseStarted(currentPhase());
+    // 首个时间片在事件循环处理完首页的布局与绘制之后才执行
+    m_timer->start();
+}
+
+void DocumentOpenPipeline::cancel() {
+    m_timer->stop();
+    for (auto& steps : m_steps) {
+        steps.clear();
+    }
+    m_phase = PhaseCount;
+    m_started = false;
+}
+
+void DocumentOpenPipeline::runSlice() {
+    QElapsedTimer slice;
+    slice.start();
+    // 阶段信号的处理函数可能关闭文档并销毁本对象
+    QPointer<DocumentOpenPipeline> self(this);
+
+    for (;;) {
+        auto& steps = m_steps[qMin<int>(m_phase, PhaseCount - 1)];
+        if (steps.empty()) {
+            if (m_phase == PhaseCount) {
+                return;
+            }
+            finishCurrentPhase();
+            if (!self || !m_started) {
+                return;
+            }
+            continue;
+        }
+
+        // 预算在步骤之间检查，单个步骤自身需保持短小
+        if (slice.elapsed() >= SLICE_BUDGET_MS) {
+            break;
+        }
+
+        // 同一阶段的步骤轮流执行，较长的任务不会让其他步骤一直等待
+        Step step = std::move(steps.front());
+        steps.pop_front();
+        const bool more = step();
+        if (!self || !m_started) {
+            return;  // 步骤中取消了流水线
+        }
+        if (more) {
+            m_steps[qMin<int>(m_phase, PhaseCount - 1)].push_back(
+                std::move(step));
+        }
+    }
+
+    m_timer->start();
+}
+
+void DocumentOpenPipeline::finishCurrentPhase() {
+    const Phase phase = static_cast<Phase>(m_phase++);
+    const qint64 elapsed = m_clock.elapsed();
+    LOG_DEBUG("DocumentOpenPipeline: Phase '{}' finished after {} ms",
+              phaseName(phase).toStdString(), elapsed);
+
+    QPointer<DocumentOpenPipeline> self(this);
+    emit phaseFinished(phase, elapsed);
+    if (!self || !m_started) {
+        return;
+    }
+    if (m_phase == PhaseCount) {
+        emit finished();
+    } else {
+        emit phaseStarted(currentPhase());
+    }
+}
+
+QString DocumentOpenPipeline::phaseName(Phase phase) {
+    switch (phase) {
+        case FirstPage:
+            return "first page";
+        case NavigationChrome:
+            return "navigation chrome";
+        case VisibleThumbnails:
+            return "visible thumbnails";
+        case BackgroundIndexing:
+            return "background indexing";
+        default:
+            return "done";
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <array>
+#include <deque>
+#include <functional>
+
+/**
+ * 文档打开的分阶段初始化流水线
+ *
+ * 打开文档时只同步完成显示首个可见页所需的工作，其余初始化按阶段排队：
+ * 首个可见页 → 导航界面（目录、连续视图占位页）→ 可见行缩略图 →
+ * 后台索引。各阶段的工作拆成若干步骤，由零间隔定时器按时间片执行，
+ * 每个时间片用完预算后把控制权交还事件循环，绘制与输入不会被打开过程
+ * 阻塞，首页出现的时间也与文档页数无关。
+ *
+ * 阶段严格按顺序推进：前一阶段的步骤全部完成后才开始下一阶段。
+ */
+class DocumentOpenPipeline : public QObject {
+    Q_OBJECT
+
+public:
+    enum Phase {
+        FirstPage,           // 首个可见页
+        NavigationChrome,    // 目录、页码范围、连续视图占位页
+        VisibleThumbnails,   // 缩略图模型（只生成可见行）
+        BackgroundIndexing,  // 搜索文本等后台索引
+        PhaseCount
+    };
+    Q_ENUM(Phase)
+
+    // 执行一小段有界的工作；返回 true 表示还有剩余，稍后再次调用
+    using Step = std::function<bool()>;
+
+    explicit DocumentOpenPipeline(QObject* parent = nullptr);
+
+    // 已经完成的阶段不再回头，加入的步骤并入当前阶段执行；全部阶段完成后
+    // 加入的步骤（如之后切换到连续视图）仍按时间片执行，不再发出阶段信号
+    void addStep(Phase phase, Step step);
+
+    void start();
+    void cancel();
+
+    bool isPhaseReached(Phase phase) const { return phase <= m_phase; }
+    bool isPhaseDone(Phase phase) const { return phase < m_phase; }
+    Phase currentPhase() const { return static_cast<Phase>(m_phase); }
+
+    static QString phaseName(Phase phase);
+
+signals:
+    // 进入某一阶段时发出，尚未执行该阶段的任何步骤；不属于流水线的组件
+    // （如侧边栏缩略图）据此开始本阶段的工作
+    void phaseStarted(DocumentOpenPipeline::Phase phase);
+    // elapsedMs 为自 start() 起的耗时
+    void phaseFinished(DocumentOpenPipeline::Phase phase, qint64 elapsedMs);
+    void finished();
+
+private slots:
+    void runSlice();
+
+private:
+    void finishCurrentPhase();
+
+    std::array<std::deque<Step>, PhaseCount> m_steps;
+    int m_phase;  // PhaseCount 表示全部完成
+    bool m_started;
+    QTimer* m_timer;
+    QElapsedTimer m_clock;
+
+    // 单个时间片的预算，留出一帧中余下的时间给绘制与输入
+    static constexpr int SLICE_BUDGET_MS = 8;
+};
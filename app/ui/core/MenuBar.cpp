@@ -135,10 +135,15 @@ void MenuBar::createViewMenu() {
     continuousScrollAction->setShortcut(QKeySequence("Ctrl+2"));
     continuousScrollAction->setCheckable(true);
 
+    QAction* reflowAction = new QAction(tr("文本重排"), this);
+    reflowAction->setShortcut(QKeySequence("Ctrl+3"));
+    reflowAction->setCheckable(true);
+
     // 创建查看模式动作组
     QActionGroup* viewModeGroup = new QActionGroup(this);
     viewModeGroup->addAction(singlePageAction);
     viewModeGroup->addAction(continuousScrollAction);
+    viewModeGroup->addAction(reflowAction);
 
     // 视图控制
     QAction* fullScreenAction = new QAction(tr("全屏"), this);
@@ -178,6 +183,7 @@ void MenuBar::createViewMenu() {
     viewMenu->addSeparator();
     viewMenu->addAction(singlePageAction);
     viewMenu->addAction(continuousScrollAction);
+    viewMenu->addAction(reflowAction);
     viewMenu->addSeparator();
     viewMenu->addAction(fullScreenAction);
     viewMenu->addSeparator();
@@ -200,6 +206,8 @@ void MenuBar::createViewMenu() {
             [this]() { emit onExecuted(ActionMap::setSinglePageMode); });
     connect(continuousScrollAction, &QAction::triggered, this,
             [this]() { emit onExecuted(ActionMap::setContinuousScrollMode); });
+    connect(reflowAction, &QAction::triggered, this,
+            [this]() { emit onExecuted(ActionMap::setReflowMode); });
 
     // 连接调试面板信号
     connect(m_debugPanelToggleAction, &QAction::triggered, this,
@@ -35,12 +35,8 @@ RightSideBar::RightSideBar(QWidget* parent)
     initAnimation();
     restoreState();
 
-    // Connect to theme changes - monitor StyleManager's styleSheetApplied signal
-    connect(&STYLE, &StyleManager::styleSheetApplied, this, [this]() {
-        applyTheme();
-    });
-
-    // Apply initial theme
+    // The sheets only reference palette roles, so they are applied once and
+    // theme toggles just swap the application palette
     applyTheme();
 }
 
@@ -219,40 +215,35 @@ void RightSideBar::onAnimationFinished() {
 }
 
 void RightSideBar::applyTheme() {
-    // Apply consistent styling using StyleManager
+    // Colours resolve through the palette, so the sheets follow theme
+    // toggles without being set again
     QString tabWidgetStyle = QString(R"(
         QTabWidget::pane {
-            border: 1px solid %1;
-            background-color: %2;
+            border: 1px solid palette(mid);
+            background-color: palette(window);
             border-radius: 4px;
         }
         QTabWidget::tab-bar {
             alignment: center;
         }
         QTabBar::tab {
-            background-color: %3;
-            color: %4;
-            border: 1px solid %1;
+            background-color: palette(alternate-base);
+            color: palette(placeholder-text);
+            border: 1px solid palette(mid);
             padding: 6px 12px;
             margin-right: 2px;
             border-top-left-radius: 4px;
             border-top-right-radius: 4px;
         }
         QTabBar::tab:selected {
-            background-color: %2;
-            color: %5;
-            border-bottom: 1px solid %2;
+            background-color: palette(window);
+            color: palette(text);
+            border-bottom: 1px solid palette(window);
         }
         QTabBar::tab:hover:!selected {
-            background-color: %6;
+            background-color: palette(midlight);
         }
-    )")
-                                 .arg(STYLE.borderColor().name())
-                                 .arg(STYLE.backgroundColor().name())
-                                 .arg(STYLE.surfaceColor().name())
-                                 .arg(STYLE.textSecondaryColor().name())
-                                 .arg(STYLE.textColor().name())
-                                 .arg(STYLE.hoverColor().name());
+    )");
 
     if (tabWidget) {
         tabWidget->setStyleSheet(tabWidgetStyle);
@@ -261,14 +252,11 @@ void RightSideBar::applyTheme() {
     // Apply general widget styling
     setStyleSheet(QString(R"(
         RightSideBar {
-            background-color: %1;
-            border-left: 1px solid %2;
+            background-color: palette(window);
+            border-left: 1px solid palette(mid);
         }
         QLabel {
-            color: %3;
+            color: palette(text);
         }
-    )")
-                      .arg(STYLE.backgroundColor().name())
-                      .arg(STYLE.borderColor().name())
-                      .arg(STYLE.textColor().name()));
+    )"));
 }
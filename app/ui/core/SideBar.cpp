@@ -17,6 +17,7 @@
 #include "../../delegate/ThumbnailDelegate.h"
 #include "../../model/ThumbnailModel.h"
 #include "../../managers/StyleManager.h"
+#include "../thumbnail/ThumbnailContextMenu.h"
 #include "../thumbnail/ThumbnailListView.h"
 
 // 定义静态常量
@@ -31,6 +32,7 @@ SideBar::SideBar(QWidget* parent)
       settings(nullptr),
       outlineWidget(nullptr),
       thumbnailView(nullptr),
+      thumbnailContextMenu(nullptr),
       isCurrentlyVisible(true),
       preferredWidth(defaultWidth),
       lastWidth(defaultWidth) {
@@ -44,10 +46,9 @@ SideBar::SideBar(QWidget* parent)
     initAnimation();
     restoreState();
 
-    // 监听StyleManager的样式表应用信号，确保在主题样式表应用后再更新组件
-    connect(&StyleManager::instance(), &StyleManager::styleSheetApplied, this, [this]() {
-        updateThemeUI();
-    });
+    // 切换主题只替换调色板，样式表不会重新设置，这里据此更新组件
+    connect(&StyleManager::instance(), &StyleManager::themeChanged, this,
+            [this]() { updateThemeUI(); });
 }
 
 void SideBar::initWindow() {
@@ -94,6 +95,19 @@ QWidget* SideBar::createThumbnailsTab() {
     connect(thumbnailView, &ThumbnailListView::pageDoubleClicked, this,
             &SideBar::pageDoubleClicked);
 
+    // 右键菜单：多选时提供批量操作
+    thumbnailContextMenu = new ThumbnailContextMenu(thumbnailView);
+    thumbnailContextMenu->setThumbnailModel(thumbnailModel.get());
+    connect(thumbnailView, &ThumbnailListView::pageRightClicked, this,
+            [this](int pageNumber, const QPoint& globalPos) {
+                thumbnailContextMenu->showForPages(
+                    thumbnailView->selectedPages(), pageNumber, globalPos);
+            });
+    connect(thumbnailContextMenu, &ThumbnailContextMenu::goToPageRequested,
+            this, &SideBar::pageClicked);
+    connect(thumbnailContextMenu, &ThumbnailContextMenu::bookmarksRequested,
+            this, &SideBar::pagesBookmarkRequested);
+
     thumbLayout->addWidget(thumbnailView);
 
     return thumbnailsTab;
@@ -239,10 +253,19 @@ void SideBar::setOutlineModel(PDFOutlineModel* model) {
     }
 }
 
+void SideBar::setBookmarkModel(BookmarkModel* model) {
+    if (bookmarkWidget) {
+        bookmarkWidget->setBookmarkModel(model);
+    }
+}
+
 void SideBar::setDocument(std::shared_ptr<Poppler::Document> document) {
     if (thumbnailModel) {
         thumbnailModel->setDocument(document);
     }
+    if (thumbnailContextMenu) {
+        thumbnailContextMenu->setDocument(document);
+    }
 }
 
 void SideBar::setThumbnailSize(const QSize& size) {
@@ -265,10 +288,8 @@ void SideBar::refreshThumbnails() {
 }
 
 void SideBar::updateThemeUI() {
-    // 清除所有内联样式，让QSS文件中的主题样式生效
-    // 不直接设置滚动条样式，让QSS文件中的样式来控制
-    
-    // 更新ThumbnailDelegate的主题
+    // 样式表中的颜色由调色板解析，切换主题时无需重新设置样式表；
+    // 这里只更新自行绘制缩略图的委托所使用的颜色
     if (thumbnailDelegate) {
         Theme currentTheme = StyleManager::instance().currentTheme();
         if (currentTheme == Theme::Dark) {
@@ -277,38 +298,10 @@ void SideBar::updateThemeUI() {
             thumbnailDelegate->setLightTheme();
         }
     }
-    
-    if (tabWidget) {
-        tabWidget->setStyleSheet("");
-    }
-    
+
     if (thumbnailView) {
-        // 清除缩略图视图的内联样式，让CSS主题样式生效
-        thumbnailView->setStyleSheet("");
-        // 清除滚动条的内联样式，让QSS文件中的样式生效
-        if (thumbnailView->verticalScrollBar()) {
-            thumbnailView->verticalScrollBar()->setStyleSheet("");
-        }
-        if (thumbnailView->horizontalScrollBar()) {
-            thumbnailView->horizontalScrollBar()->setStyleSheet("");
-        }
-        // 触发重绘
         thumbnailView->viewport()->update();
     }
-    
-    // 递归更新所有子控件的样式
-    QList<QWidget*> allWidgets = findChildren<QWidget*>();
-    for (QWidget* widget : allWidgets) {
-        // 取消样式缓存并重新应用
-        widget->style()->unpolish(widget);
-        widget->style()->polish(widget);
-        widget->update();
-    }
-    
-    // 最后清除侧边栏的内联样式，让QSS文件中的样式生效
-    setStyleSheet("");
-    
-    // 强制重绘
+
     update();
-    repaint();
 }
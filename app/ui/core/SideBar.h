@@ -9,6 +9,7 @@
 #include "model/PDFOutlineModel.h"
 #include "ui/viewer/PDFBookmarkWidget.h"
 #include "model/ThumbnailModel.h"
+#include "ui/thumbnail/ThumbnailContextMenu.h"
 #include "ui/thumbnail/ThumbnailListView.h"
 #include "ui/viewer/PDFOutlineWidget.h"
 
@@ -42,6 +43,9 @@ public:
     void setOutlineModel(PDFOutlineModel* model);
     PDFOutlineWidget* getOutlineWidget() const { return outlineWidget; }
 
+    // 书签相关
+    void setBookmarkModel(BookmarkModel* model);
+
     // 缩略图相关
     void setDocument(std::shared_ptr<Poppler::Document> document);
     void setThumbnailSize(const QSize& size);
@@ -65,6 +69,7 @@ signals:
     void pageClicked(int pageNumber);
     void pageDoubleClicked(int pageNumber);
     void thumbnailSizeChanged(const QSize& size);
+    void pagesBookmarkRequested(const QList<int>& pageNumbers);
 
 private:
     QTabWidget* tabWidget;
@@ -77,6 +82,7 @@ private:
     ThumbnailListView* thumbnailView;
     std::unique_ptr<ThumbnailModel> thumbnailModel;
     std::unique_ptr<ThumbnailDelegate> thumbnailDelegate;
+    ThumbnailContextMenu* thumbnailContextMenu;
 
     bool isCurrentlyVisible;
     int preferredWidth;
@@ -166,6 +166,7 @@ void ToolBar::setupViewActions() {
     viewModeCombo = new QComboBox(viewWidget);
     viewModeCombo->addItem("单页视图");
     viewModeCombo->addItem("连续滚动");
+    viewModeCombo->addItem("文本重排");
     viewModeCombo->setCurrentIndex(0);
     viewModeCombo->setToolTip("选择视图模式");
     viewModeCombo->setFixedWidth(100);
@@ -291,5 +292,7 @@ void ToolBar::onViewModeChanged() {
         emit actionTriggered(ActionMap::setSinglePageMode);
     } else if (mode == 1) {
         emit actionTriggered(ActionMap::setContinuousScrollMode);
+    } else if (mode == 2) {
+        emit actionTriggered(ActionMap::setReflowMode);
     }
 }
@@ -1,6 +1,7 @@
 #include "ViewWidget.h"
 #include <QDebug>
 #include <QLabel>
+#include <QPointer>
 #include "../viewer/PDFViewer.h"
 
 ViewWidget::ViewWidget(QWidget* parent)
@@ -179,6 +180,9 @@ void ViewWidget::executePDFAction(ActionMap action) {
         case ActionMap::setContinuousScrollMode:
             currentViewer->setViewMode(PDFViewMode::ContinuousScroll);
             break;
+        case ActionMap::setReflowMode:
+            currentViewer->setViewMode(PDFViewMode::Reflow);
+            break;
         default:
             qWarning() << "Unhandled PDF action in ViewWidget:"
                        << static_cast<int>(action);
@@ -194,6 +198,15 @@ int ViewWidget::getCurrentDocumentIndex() const {
     return documentModel ? documentModel->getCurrentDocumentIndex() : -1;
 }
 
+bool ViewWidget::isOpenPhaseReached(int index,
+                                    DocumentOpenPipeline::Phase phase) const {
+    if (index < 0 || index >= pdfViewers.size()) {
+        return false;
+    }
+    DocumentOpenPipeline* pipeline = pdfViewers[index]->getOpenPipeline();
+    return !pipeline || pipeline->isPhaseReached(phase);
+}
+
 PDFOutlineModel* ViewWidget::getCurrentOutlineModel() const {
     int currentIndex = getCurrentDocumentIndex();
     if (currentIndex >= 0 && currentIndex < outlineModels.size()) {
@@ -236,13 +249,36 @@ void ViewWidget::onDocumentOpened(int index, const QString& fileName) {
     QString filePath = documentModel->getDocumentFilePath(index);
     auto document = documentModel->getDocument(index);
 
-    // 创建新的PDF查看器
+    // 创建新的PDF查看器；这里只同步完成首个可见页，其余初始化交给
+    // 打开流水线按阶段、按时间片执行
     PDFViewer* viewer = createPDFViewer();
-    viewer->setDocument(document);
+    DocumentOpenPipeline* pipeline = new DocumentOpenPipeline(viewer);
+    viewer->setDocument(document, pipeline);
 
-    // 创建目录模型并解析目录
+    // 创建目录模型，目录解析推迟到导航阶段
     PDFOutlineModel* docOutlineModel = new PDFOutlineModel(this);
-    docOutlineModel->parseOutline(document);
+    QPointer<PDFOutlineModel> outline(docOutlineModel);
+    std::weak_ptr<Poppler::Document> weakDocument = document;
+    pipeline->addStep(DocumentOpenPipeline::NavigationChrome,
+                      [this, viewer, outline, weakDocument]() {
+                          std::shared_ptr<Poppler::Document> doc =
+                              weakDocument.lock();
+                          if (outline && doc) {
+                              outline->parseOutline(doc);
+                              if (pdfViewers.indexOf(viewer) ==
+                                  getCurrentDocumentIndex()) {
+                                  emit currentOutlineModelChanged(outline);
+                              }
+                          }
+                          return false;
+                      });
+    connect(pipeline, &DocumentOpenPipeline::phaseStarted, this,
+            [this, viewer](DocumentOpenPipeline::Phase phase) {
+                const int viewerIndex = pdfViewers.indexOf(viewer);
+                if (viewerIndex >= 0) {
+                    emit documentOpenPhaseStarted(viewerIndex, phase);
+                }
+            });
 
     // 检查是否已经有加载中的占位组件需要替换
     bool hasLoadingWidget = false;
@@ -284,6 +320,9 @@ void ViewWidget::onDocumentOpened(int index, const QString& fileName) {
         emit currentOutlineModelChanged(docOutlineModel);
     }
 
+    // 首页已在界面上，开始后续阶段
+    pipeline->start();
+
     qDebug() << "Document opened:" << fileName << "at index" << index;
 }
 
@@ -336,6 +375,9 @@ void ViewWidget::onCurrentDocumentChanged(int index) {
 void ViewWidget::onAllDocumentsClosed() {
     // 清理所有PDF查看器
     for (PDFViewer* viewer : pdfViewers) {
+        if (DocumentOpenPipeline* pipeline = viewer->getOpenPipeline()) {
+            pipeline->cancel();
+        }
         viewerStack->removeWidget(viewer);
         viewer->deleteLater();
     }
@@ -468,6 +510,10 @@ void ViewWidget::removePDFViewer(int index) {
         return;
 
     PDFViewer* viewer = pdfViewers.takeAt(index);
+    // 查看器延迟销毁，期间不应再执行打开流水线中剩余的步骤
+    if (DocumentOpenPipeline* pipeline = viewer->getOpenPipeline()) {
+        pipeline->cancel();
+    }
     viewerStack->removeWidget(viewer);
     viewer->deleteLater();
 }
@@ -38,6 +38,8 @@ public:
     bool hasDocuments() const;
     int getCurrentDocumentIndex() const;
     PDFOutlineModel* getCurrentOutlineModel() const;
+    // 文档的打开流水线是否已进入指定阶段
+    bool isOpenPhaseReached(int index, DocumentOpenPipeline::Phase phase) const;
 
     // 获取当前PDF查看器状态
     int getCurrentPage() const;
@@ -73,6 +75,8 @@ signals:
     void currentViewerPageChanged(int pageNumber, int totalPages);
     void currentViewerZoomChanged(double zoomFactor);
     void currentOutlineModelChanged(PDFOutlineModel* model);
+    void documentOpenPhaseStarted(int index,
+                                  DocumentOpenPipeline::Phase phase);
 
 private:
     // UI组件
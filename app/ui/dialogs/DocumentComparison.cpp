@@ -16,6 +16,7 @@
 // available in this MSYS2 setup
 #include <QDebug>
 #include <QElapsedTimer>
+#include "ui/viewer/RenderBroker.h"
 
 DocumentComparison::DocumentComparison(QWidget* parent)
     : QWidget(parent),
@@ -378,8 +379,8 @@ QList<DocumentDifference> DocumentComparison::comparePages(int page1,
 
         // Compare images if enabled
         if (m_options.compareImages) {
-            QImage image1 = popplerPage1->renderToImage(150, 150);
-            QImage image2 = popplerPage2->renderToImage(150, 150);
+            QImage image1 = renderPage(m_document1, popplerPage1.get(), page1);
+            QImage image2 = renderPage(m_document2, popplerPage2.get(), page2);
             QPixmap pixmap1 = QPixmap::fromImage(image1);
             QPixmap pixmap2 = QPixmap::fromImage(image2);
             differences.append(compareImages(pixmap1, pixmap2, page1, page2));
@@ -655,7 +656,8 @@ void DocumentComparison::highlightDifference(const DocumentDifference& diff) {
             std::unique_ptr<Poppler::Page> page1(
                 m_document1->page(diff.pageNumber1));
             if (page1) {
-                QImage image1 = page1->renderToImage(150, 150);
+                QImage image1 =
+                    renderPage(m_document1, page1.get(), diff.pageNumber1);
                 m_leftImageLabel->setPixmap(QPixmap::fromImage(image1));
             }
         }
@@ -665,7 +667,8 @@ void DocumentComparison::highlightDifference(const DocumentDifference& diff) {
             std::unique_ptr<Poppler::Page> page2(
                 m_document2->page(diff.pageNumber2));
             if (page2) {
-                QImage image2 = page2->renderToImage(150, 150);
+                QImage image2 =
+                    renderPage(m_document2, page2.get(), diff.pageNumber2);
                 m_rightImageLabel->setPixmap(QPixmap::fromImage(image2));
             }
         }
@@ -676,6 +679,15 @@ void DocumentComparison::highlightDifference(const DocumentDifference& diff) {
     }
 }
 
+QImage DocumentComparison::renderPage(Poppler::Document* document,
+                                      Poppler::Page* page, int pageNumber) {
+    // Shares the render with the viewer when it is drawing the same page
+    return RenderBroker::instance().render(
+        document, pageNumber, COMPARISON_DPI, 0, [page](double dpi) {
+            return page->renderToImage(dpi, dpi);
+        });
+}
+
 void DocumentComparison::clearHighlights() {
     m_leftImageLabel->clear();
     m_rightImageLabel->clear();
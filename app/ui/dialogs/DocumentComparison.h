@@ -194,6 +194,8 @@ private:
     QList<DocumentDifference> compareImages(const QPixmap& image1,
                                             const QPixmap& image2, int page1,
                                             int page2);
+    static QImage renderPage(Poppler::Document* document, Poppler::Page* page,
+                             int pageNumber);
     double calculateTextSimilarity(const QString& text1, const QString& text2);
     double calculateImageSimilarity(const QPixmap& image1,
                                     const QPixmap& image2);
@@ -249,4 +251,6 @@ private:
     QFuture<ComparisonResults> m_comparisonFuture;
     QFutureWatcher<ComparisonResults>* m_comparisonWatcher;
     QTimer* m_progressTimer;
+
+    static constexpr double COMPARISON_DPI = 150.0;
 };
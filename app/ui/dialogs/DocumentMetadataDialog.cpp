@@ -7,18 +7,33 @@
 #include <QMessageBox>
 #include <stdexcept>
 #include "../../managers/StyleManager.h"
+#include "../../utils/DocumentMetadataExtractor.h"
 
 DocumentMetadataDialog::DocumentMetadataDialog(QWidget* parent)
-    : QDialog(parent), m_currentDocument(nullptr) {
+    : QDialog(parent), m_currentDocument(nullptr), m_extractor(nullptr) {
     setWindowTitle(tr("文档属性"));
     setModal(true);
     resize(600, 500);
 
+    m_extractor = new DocumentMetadataExtractor(this);
+
     setupUI();
     setupConnections();
     applyCurrentTheme();
 }
 
+DocumentMetadataDialog::~DocumentMetadataDialog() {
+    if (m_extractor) {
+        m_extractor->cancel();
+    }
+}
+
+void DocumentMetadataDialog::done(int result) {
+    // 关闭对话框时无需继续统计
+    m_extractor->cancel();
+    QDialog::done(result);
+}
+
 void DocumentMetadataDialog::setupUI() {
     m_mainLayout = new QVBoxLayout(this);
     m_mainLayout->setContentsMargins(12, 12, 12, 12);
@@ -151,6 +166,49 @@ void DocumentMetadataDialog::setupUI() {
 
     m_contentLayout->addWidget(m_securityGroup);
 
+    // 统计信息组
+    m_statisticsGroup = new QGroupBox(tr("统计信息"), m_contentWidget);
+    m_statisticsLayout = new QGridLayout(m_statisticsGroup);
+    m_statisticsLayout->setColumnStretch(1, 1);
+
+    // 字数
+    m_statisticsLayout->addWidget(new QLabel(tr("字数:")), 0, 0);
+    m_wordCountEdit = new QLineEdit();
+    m_wordCountEdit->setReadOnly(true);
+    m_statisticsLayout->addWidget(m_wordCountEdit, 0, 1);
+
+    // 字符数
+    m_statisticsLayout->addWidget(new QLabel(tr("字符数:")), 1, 0);
+    m_characterCountEdit = new QLineEdit();
+    m_characterCountEdit->setReadOnly(true);
+    m_statisticsLayout->addWidget(m_characterCountEdit, 1, 1);
+
+    // 注释数
+    m_statisticsLayout->addWidget(new QLabel(tr("注释数:")), 2, 0);
+    m_annotationCountEdit = new QLineEdit();
+    m_annotationCountEdit->setReadOnly(true);
+    m_statisticsLayout->addWidget(m_annotationCountEdit, 2, 1);
+
+    // 含文本页数
+    m_statisticsLayout->addWidget(new QLabel(tr("含文本页数:")), 3, 0);
+    m_pagesWithTextEdit = new QLineEdit();
+    m_pagesWithTextEdit->setReadOnly(true);
+    m_statisticsLayout->addWidget(m_pagesWithTextEdit, 3, 1);
+
+    // 平均页面尺寸
+    m_statisticsLayout->addWidget(new QLabel(tr("平均页面尺寸:")), 4, 0);
+    m_averagePageSizeEdit = new QLineEdit();
+    m_averagePageSizeEdit->setReadOnly(true);
+    m_statisticsLayout->addWidget(m_averagePageSizeEdit, 4, 1);
+
+    // 统计进度
+    m_statisticsProgress = new QProgressBar();
+    m_statisticsProgress->setTextVisible(true);
+    m_statisticsProgress->setVisible(false);
+    m_statisticsLayout->addWidget(m_statisticsProgress, 5, 0, 1, 2);
+
+    m_contentLayout->addWidget(m_statisticsGroup);
+
     // 添加弹性空间
     m_contentLayout->addStretch();
 
@@ -171,9 +229,19 @@ void DocumentMetadataDialog::setupUI() {
 void DocumentMetadataDialog::setupConnections() {
     connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
 
-    // 连接主题变化信号
+    // 后台统计结果
+    connect(m_extractor, &DocumentMetadataExtractor::statisticsProgress, this,
+            &DocumentMetadataDialog::onStatisticsProgress);
+    connect(m_extractor, &DocumentMetadataExtractor::statisticsReady, this,
+            &DocumentMetadataDialog::onStatisticsReady);
+    connect(m_extractor, &DocumentMetadataExtractor::extractionFailed, this,
+            &DocumentMetadataDialog::onStatisticsFailed);
+
+    // 连接主题变化信号；切换主题时样式表不会重新应用，只发出 themeChanged
     connect(&StyleManager::instance(), &StyleManager::styleSheetApplied, this,
             &DocumentMetadataDialog::onThemeChanged);
+    connect(&StyleManager::instance(), &StyleManager::themeChanged, this,
+            &DocumentMetadataDialog::onThemeChanged);
 }
 
 void DocumentMetadataDialog::onThemeChanged() { applyCurrentTheme(); }
@@ -185,6 +253,7 @@ void DocumentMetadataDialog::applyCurrentTheme() {
 
 void DocumentMetadataDialog::setDocument(
     std::shared_ptr<Poppler::Document> document, const QString& filePath) {
+    m_extractor->cancel();
     m_currentDocument = document;
     m_currentFilePath = filePath;
 
@@ -194,6 +263,7 @@ void DocumentMetadataDialog::setDocument(
     }
 
     try {
+        // 廉价字段立即显示
         populateBasicInfo(filePath);
         populateDocumentProperties();
         populateSecurityInfo();
@@ -201,7 +271,37 @@ void DocumentMetadataDialog::setDocument(
         QMessageBox::warning(this, tr("错误"),
                              tr("获取文档元数据时发生错误: %1").arg(e.what()));
         clearMetadata();
+        return;
     }
+
+    // 逐页统计在后台进行，命中缓存时会立即返回结果
+    clearStatistics();
+    m_statisticsProgress->setRange(0, document->numPages());
+    m_statisticsProgress->setValue(0);
+    m_statisticsProgress->setVisible(true);
+    m_extractor->start(filePath);
+}
+
+void DocumentMetadataDialog::onStatisticsProgress(
+    int processedPages, int totalPages, const QJsonObject& partialStatistics) {
+    m_statisticsProgress->setRange(0, totalPages);
+    m_statisticsProgress->setValue(processedPages);
+    populateStatistics(partialStatistics);
+}
+
+void DocumentMetadataDialog::onStatisticsReady(const QJsonObject& statistics) {
+    m_statisticsProgress->setVisible(false);
+    populateStatistics(statistics);
+}
+
+void DocumentMetadataDialog::onStatisticsFailed(const QString& error) {
+    m_statisticsProgress->setVisible(false);
+    m_wordCountEdit->setText(tr("不可用"));
+    m_characterCountEdit->setText(tr("不可用"));
+    m_annotationCountEdit->setText(tr("不可用"));
+    m_pagesWithTextEdit->setText(tr("不可用"));
+    m_averagePageSizeEdit->setText(tr("不可用"));
+    m_statisticsGroup->setToolTip(error);
 }
 
 void DocumentMetadataDialog::clearMetadata() {
@@ -224,6 +324,36 @@ void DocumentMetadataDialog::clearMetadata() {
     m_canExtractTextEdit->clear();
     m_canPrintEdit->clear();
     m_canModifyEdit->clear();
+
+    clearStatistics();
+}
+
+void DocumentMetadataDialog::clearStatistics() {
+    m_wordCountEdit->clear();
+    m_characterCountEdit->clear();
+    m_annotationCountEdit->clear();
+    m_pagesWithTextEdit->clear();
+    m_averagePageSizeEdit->clear();
+    m_statisticsProgress->setVisible(false);
+    m_statisticsGroup->setToolTip(QString());
+}
+
+void DocumentMetadataDialog::populateStatistics(const QJsonObject& statistics) {
+    QLocale locale = QLocale::system();
+    m_wordCountEdit->setText(
+        locale.toString(statistics["totalWords"].toInteger()));
+    m_characterCountEdit->setText(
+        locale.toString(statistics["totalCharacters"].toInteger()));
+    m_annotationCountEdit->setText(
+        locale.toString(statistics["totalAnnotations"].toInt()));
+    m_pagesWithTextEdit->setText(
+        QString("%1 / %2")
+            .arg(statistics["pagesWithText"].toInt())
+            .arg(statistics["pageCount"].toInt()));
+    m_averagePageSizeEdit->setText(
+        QString("%1 × %2 pt")
+            .arg(statistics["averagePageWidth"].toDouble(), 0, 'f', 1)
+            .arg(statistics["averagePageHeight"].toDouble(), 0, 'f', 1));
 }
 
 void DocumentMetadataDialog::populateBasicInfo(const QString& filePath) {
@@ -254,29 +384,32 @@ void DocumentMetadataDialog::populateDocumentProperties() {
         return;
     }
 
-    // 直接使用Poppler::Document的info方法获取元数据
-    QString title = m_currentDocument->info("Title");
+    // 与DocumentAnalyzer共享按文档指纹缓存的基本信息
+    QJsonObject basic = DocumentMetadataExtractor::cachedBasicInfo(
+        m_currentFilePath, m_currentDocument.get());
+
+    QString title = basic["title"].toString();
     m_titleEdit->setText(title.isEmpty() ? tr("未设置") : title);
 
-    QString author = m_currentDocument->info("Author");
+    QString author = basic["author"].toString();
     m_authorEdit->setText(author.isEmpty() ? tr("未设置") : author);
 
-    QString subject = m_currentDocument->info("Subject");
+    QString subject = basic["subject"].toString();
     m_subjectEdit->setText(subject.isEmpty() ? tr("未设置") : subject);
 
-    QString keywords = m_currentDocument->info("Keywords");
+    QString keywords = basic["keywords"].toString();
     m_keywordsEdit->setText(keywords.isEmpty() ? tr("未设置") : keywords);
 
-    QString creator = m_currentDocument->info("Creator");
+    QString creator = basic["creator"].toString();
     m_creatorEdit->setText(creator.isEmpty() ? tr("未设置") : creator);
 
-    QString producer = m_currentDocument->info("Producer");
+    QString producer = basic["producer"].toString();
     m_producerEdit->setText(producer.isEmpty() ? tr("未设置") : producer);
 
-    QString creationDate = m_currentDocument->info("CreationDate");
+    QString creationDate = basic["creationDate"].toString();
     m_creationDateEdit->setText(formatDateTime(creationDate));
 
-    QString modificationDate = m_currentDocument->info("ModDate");
+    QString modificationDate = basic["modificationDate"].toString();
     m_modificationDateEdit->setText(formatDateTime(modificationDate));
 }
 
@@ -8,7 +8,9 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QJsonObject>
 #include <QObject>
+#include <QProgressBar>
 #include <QPushButton>
 #include <QScrollArea>
 #include <QString>
@@ -16,19 +18,28 @@
 #include <QWidget>
 #include <QtGlobal>
 
+class DocumentMetadataExtractor;
+
 class DocumentMetadataDialog : public QDialog {
     Q_OBJECT
 
 public:
     explicit DocumentMetadataDialog(QWidget* parent = nullptr);
-    ~DocumentMetadataDialog() = default;
+    ~DocumentMetadataDialog() override;
 
     // 设置要显示元数据的PDF文档
     void setDocument(std::shared_ptr<Poppler::Document> document,
                      const QString& filePath);
 
+protected:
+    void done(int result) override;
+
 private slots:
     void onThemeChanged();
+    void onStatisticsProgress(int processedPages, int totalPages,
+                              const QJsonObject& partialStatistics);
+    void onStatisticsReady(const QJsonObject& statistics);
+    void onStatisticsFailed(const QString& error);
 
 private:
     void setupUI();
@@ -38,6 +49,8 @@ private:
     void populateBasicInfo(const QString& filePath);
     void populateDocumentProperties();
     void populateSecurityInfo();
+    void populateStatistics(const QJsonObject& statistics);
+    void clearStatistics();
 
     QString formatDateTime(const QString& dateTimeStr);
     QString formatFileSize(qint64 bytes);
@@ -76,6 +89,16 @@ private:
     QLineEdit* m_canPrintEdit;
     QLineEdit* m_canModifyEdit;
 
+    // 统计信息组（后台逐步填充）
+    QGroupBox* m_statisticsGroup;
+    QGridLayout* m_statisticsLayout;
+    QLineEdit* m_wordCountEdit;
+    QLineEdit* m_characterCountEdit;
+    QLineEdit* m_annotationCountEdit;
+    QLineEdit* m_pagesWithTextEdit;
+    QLineEdit* m_averagePageSizeEdit;
+    QProgressBar* m_statisticsProgress;
+
     // 按钮
     QHBoxLayout* m_buttonLayout;
     QPushButton* m_closeButton;
@@ -83,4 +106,7 @@ private:
     // 当前文档信息
     QString m_currentFilePath;
     std::shared_ptr<Poppler::Document> m_currentDocument;
+
+    // 后台元数据/统计提取
+    DocumentMetadataExtractor* m_extractor;
 };
@@ -0,0 +1,306 @@
+#include "ThumbnailBatchOperation.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPainter>
+#include <QSaveFile>
+#include <QSemaphore>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+#include <QtMath>
+#include "utils/LoggingMacros.h"
+
+ThumbnailBatchOperation::ThumbnailBatchOperation(QObject* parent)
+    : QObject(parent),
+      m_jobPool(new QThreadPool(this)),
+      m_encodePool(new QThreadPool(this)),
+      m_watcher(new QFutureWatcher<BatchResult>(this)) {
+    qRegisterMetaType<ThumbnailBatchOperation::BatchResult>();
+
+    // 任务线程只有一个：同一时刻只有一个批次访问文档
+    m_jobPool->setMaxThreadCount(1);
+    m_encodePool->setMaxThreadCount(
+        qMax(1, QThread::idealThreadCount() - 1));
+
+    connect(m_watcher, &QFutureWatcher<BatchResult>::finished, this,
+            &ThumbnailBatchOperation::onJobFinished);
+}
+
+ThumbnailBatchOperation::~ThumbnailBatchOperation() {
+    cancel();
+    m_watcher->waitForFinished();
+    m_encodePool->waitForDone();
+}
+
+void ThumbnailBatchOperation::setDocument(
+    std::shared_ptr<Poppler::Document> document) {
+    cancel();
+    m_document = document;
+}
+
+bool ThumbnailBatchOperation::start(const BatchRequest& request) {
+    if (isRunning()) {
+        LOG_WARNING("ThumbnailBatchOperation: A batch is already running");
+        return false;
+    }
+
+    if (!m_document || request.pages.isEmpty()) {
+        return false;
+    }
+
+    m_cancelled = std::make_shared<std::atomic<bool>>(false);
+
+    auto cancelled = m_cancelled;
+    auto document = m_document;
+    m_watcher->setFuture(QtConcurrent::run(
+        m_jobPool, [this, request, document, cancelled]() {
+            return runJob(request, document, cancelled);
+        }));
+
+    LOG_INFO("ThumbnailBatchOperation: Started batch of {} pages",
+             request.pages.size());
+    return true;
+}
+
+void ThumbnailBatchOperation::cancel() {
+    if (m_cancelled) {
+        m_cancelled->store(true);
+    }
+}
+
+bool ThumbnailBatchOperation::isRunning() const {
+    return m_watcher->isRunning();
+}
+
+void ThumbnailBatchOperation::onJobFinished() {
+    m_lastResult = m_watcher->result();
+
+    LOG_INFO(
+        "ThumbnailBatchOperation: Batch finished - {} succeeded, {} failed, "
+        "cancelled: {}, {} ms",
+        m_lastResult.succeeded, m_lastResult.failed, m_lastResult.cancelled,
+        m_lastResult.elapsedMs);
+    emit finished(m_lastResult);
+}
+
+ThumbnailBatchOperation::BatchResult ThumbnailBatchOperation::runJob(
+    const BatchRequest& request, std::shared_ptr<Poppler::Document> document,
+    std::shared_ptr<std::atomic<bool>> cancelled) {
+    QElapsedTimer timer;
+    timer.start();
+
+    BatchResult result;
+    result.operation = request.operation;
+    result.totalPages = request.pages.size();
+
+    switch (request.operation) {
+        case Operation::ExportImages:
+            runExport(request, document.get(), *cancelled, result);
+            break;
+        case Operation::CopyImages:
+            runCopy(request, document.get(), *cancelled, result);
+            break;
+        case Operation::ExtractText:
+            runExtractText(request, document.get(), *cancelled, result);
+            break;
+    }
+
+    result.cancelled = cancelled->load();
+    result.elapsedMs = timer.elapsed();
+    return result;
+}
+
+void ThumbnailBatchOperation::runExport(const BatchRequest& request,
+                                        Poppler::Document* document,
+                                        const std::atomic<bool>& cancelled,
+                                        BatchResult& result) {
+    QDir outputDir(request.outputPath);
+    if (!outputDir.exists() && !QDir().mkpath(request.outputPath)) {
+        result.failed = result.totalPages;
+        result.errors.append(
+            QString("无法创建导出目录: %1").arg(request.outputPath));
+        return;
+    }
+
+    const QString format = request.format.toUpper();
+    const QString extension = (format == "JPEG") ? "jpg" : "png";
+    const int total = request.pages.size();
+
+    // 渲染在本线程串行进行，编码写盘交给线程池；信号量限制在途页面数
+    QSemaphore inFlight(MAX_PAGES_IN_FLIGHT);
+    QMutex resultMutex;
+    std::atomic<int> completed{0};
+
+    for (int pageNumber : request.pages) {
+        if (cancelled.load()) {
+            break;
+        }
+
+        inFlight.acquire();
+
+        QImage image;
+        std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+        if (page) {
+            image = page->renderToImage(request.dpi, request.dpi);
+        }
+
+        if (image.isNull()) {
+            {
+                QMutexLocker locker(&resultMutex);
+                result.failed++;
+                result.errors.append(
+                    QString("无法渲染第 %1 页").arg(pageNumber + 1));
+            }
+            inFlight.release();
+            emit progressChanged(++completed, total);
+            continue;
+        }
+
+        const QString filePath = outputDir.filePath(
+            QString("page_%1.%2")
+                .arg(pageNumber + 1, 3, 10, QChar('0'))
+                .arg(extension));
+
+        m_encodePool->start([this, image, filePath, format, pageNumber, total,
+                             &inFlight, &resultMutex, &result, &completed]() {
+            bool saved = image.save(filePath, format.toUtf8().constData());
+            {
+                QMutexLocker locker(&resultMutex);
+                if (saved) {
+                    result.succeeded++;
+                    result.outputFiles.append(filePath);
+                } else {
+                    result.failed++;
+                    result.errors.append(
+                        QString("保存第 %1 页失败").arg(pageNumber + 1));
+                }
+            }
+            inFlight.release();
+            emit progressChanged(++completed, total);
+        });
+    }
+
+    // 等待流水线中剩余的编码任务
+    m_encodePool->waitForDone();
+    result.outputFiles.sort();
+}
+
+void ThumbnailBatchOperation::runCopy(const BatchRequest& request,
+                                      Poppler::Document* document,
+                                      const std::atomic<bool>& cancelled,
+                                      BatchResult& result) {
+    const int total = request.pages.size();
+
+    // 先用页面尺寸确定合成图大小，必要时降低DPI以适应高度上限
+    double totalHeightPt = 0.0;
+    double maxWidthPt = 0.0;
+    for (int pageNumber : request.pages) {
+        std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+        if (page) {
+            QSizeF size = page->pageSizeF();
+            totalHeightPt += size.height();
+            maxWidthPt = qMax(maxWidthPt, size.width());
+        }
+    }
+
+    if (totalHeightPt <= 0.0) {
+        result.failed = total;
+        return;
+    }
+
+    double dpi =
+        qMin(request.dpi, MAX_COMPOSED_HEIGHT * 72.0 / totalHeightPt);
+    dpi = qMax(dpi, 1.0);
+
+    const QSize composedSize(qCeil(maxWidthPt * dpi / 72.0),
+                             qCeil(totalHeightPt * dpi / 72.0));
+    QImage composed(composedSize, QImage::Format_ARGB32_Premultiplied);
+    if (composed.isNull()) {
+        result.failed = total;
+        result.errors.append("无法分配合成图像");
+        return;
+    }
+    composed.fill(Qt::white);
+
+    QPainter painter(&composed);
+    int y = 0;
+    int completed = 0;
+
+    for (int pageNumber : request.pages) {
+        if (cancelled.load()) {
+            break;
+        }
+
+        std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+        QImage image = page ? page->renderToImage(dpi, dpi) : QImage();
+        if (image.isNull()) {
+            result.failed++;
+            result.errors.append(
+                QString("无法渲染第 %1 页").arg(pageNumber + 1));
+        } else {
+            int x = (composedSize.width() - image.width()) / 2;
+            painter.drawImage(QPoint(x, y), image);
+            y += image.height();
+            result.succeeded++;
+        }
+
+        emit progressChanged(++completed, total);
+    }
+
+    painter.end();
+
+    if (!cancelled.load() && result.succeeded > 0) {
+        result.combinedImage = composed.copy(0, 0, composedSize.width(),
+                                             qMin(y, composedSize.height()));
+    }
+}
+
+void ThumbnailBatchOperation::runExtractText(
+    const BatchRequest& request, Poppler::Document* document,
+    const std::atomic<bool>& cancelled, BatchResult& result) {
+    const int total = request.pages.size();
+    QString text;
+    int completed = 0;
+
+    for (int pageNumber : request.pages) {
+        if (cancelled.load()) {
+            break;
+        }
+
+        std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+        if (page) {
+            text += QString("--- 第 %1 页 ---\n").arg(pageNumber + 1);
+            text += page->text(QRectF());
+            text += "\n\n";
+            result.succeeded++;
+        } else {
+            result.failed++;
+            result.errors.append(
+                QString("无法读取第 %1 页").arg(pageNumber + 1));
+        }
+
+        emit progressChanged(++completed, total);
+    }
+
+    if (cancelled.load()) {
+        return;
+    }
+
+    if (request.outputPath.isEmpty()) {
+        result.text = text;
+        return;
+    }
+
+    QSaveFile file(request.outputPath);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        file.write(text.toUtf8());
+        if (file.commit()) {
+            result.outputFiles.append(request.outputPath);
+            return;
+        }
+    }
+
+    result.errors.append(
+        QString("无法写入文件: %1").arg(request.outputPath));
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <poppler/qt6/poppler-qt6.h>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QImage>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+
+/**
+ * @brief 缩略图多选批量操作
+ *
+ * 将选中页面的导出、复制图像、提取文本作为一个后台任务执行：
+ * - 单个任务线程按顺序渲染页面（串行访问Poppler文档）
+ * - 编码/写文件阶段交给共享的线程池，与下一页的渲染流水线并行
+ * - 有界的在途页面数，避免大选择时内存暴涨
+ * - 进度报告与随时取消
+ */
+class ThumbnailBatchOperation : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Operation {
+        ExportImages,  // 每页导出为一个图像文件
+        CopyImages,    // 合成为一张图像放入剪贴板
+        ExtractText    // 提取文本到文件或剪贴板
+    };
+
+    struct BatchRequest {
+        Operation operation;
+        QList<int> pages;
+        QString outputPath;  // 导出目录或文本文件路径
+        QString format;      // 图像格式 (PNG/JPEG)
+        double dpi;
+
+        BatchRequest()
+            : operation(Operation::ExportImages), format("PNG"), dpi(150.0) {}
+    };
+
+    struct BatchResult {
+        Operation operation;
+        int totalPages;
+        int succeeded;
+        int failed;
+        bool cancelled;
+        qint64 elapsedMs;
+        QStringList outputFiles;
+        QStringList errors;
+        QImage combinedImage;  // CopyImages
+        QString text;          // ExtractText（未指定输出文件时）
+
+        BatchResult()
+            : operation(Operation::ExportImages),
+              totalPages(0),
+              succeeded(0),
+              failed(0),
+              cancelled(false),
+              elapsedMs(0) {}
+    };
+
+    explicit ThumbnailBatchOperation(QObject* parent = nullptr);
+    ~ThumbnailBatchOperation() override;
+
+    void setDocument(std::shared_ptr<Poppler::Document> document);
+
+    bool start(const BatchRequest& request);
+    void cancel();
+    bool isRunning() const;
+
+    BatchResult lastResult() const { return m_lastResult; }
+
+signals:
+    void progressChanged(int completed, int total);
+    void finished(const ThumbnailBatchOperation::BatchResult& result);
+
+private slots:
+    void onJobFinished();
+
+private:
+    BatchResult runJob(const BatchRequest& request,
+                       std::shared_ptr<Poppler::Document> document,
+                       std::shared_ptr<std::atomic<bool>> cancelled);
+    void runExport(const BatchRequest& request, Poppler::Document* document,
+                   const std::atomic<bool>& cancelled, BatchResult& result);
+    void runCopy(const BatchRequest& request, Poppler::Document* document,
+                 const std::atomic<bool>& cancelled, BatchResult& result);
+    void runExtractText(const BatchRequest& request,
+                        Poppler::Document* document,
+                        const std::atomic<bool>& cancelled,
+                        BatchResult& result);
+
+    std::shared_ptr<Poppler::Document> m_document;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+
+    // 共享的工作线程：一个任务线程 + 编码线程池，所有批次复用
+    QThreadPool* m_jobPool;
+    QThreadPool* m_encodePool;
+    QFutureWatcher<BatchResult>* m_watcher;
+
+    BatchResult m_lastResult;
+
+    static constexpr int MAX_PAGES_IN_FLIGHT = 8;
+    static constexpr int MAX_COMPOSED_HEIGHT = 32000;
+};
+
+Q_DECLARE_METATYPE(ThumbnailBatchOperation::BatchResult)
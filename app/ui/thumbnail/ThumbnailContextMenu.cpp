@@ -9,6 +9,7 @@
 #include <QMessageBox>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <algorithm>
 #include <stdexcept>
 #include "model/ThumbnailModel.h"
 #include "utils/LoggingMacros.h"
@@ -22,11 +23,20 @@ ThumbnailContextMenu::ThumbnailContextMenu(QWidget* parent)
     : QMenu(parent),
       m_thumbnailModel(nullptr),
       m_currentPage(-1),
+      m_batchOperation(nullptr),
+      m_batchProgressDialog(nullptr),
       m_isDarkTheme(false) {
     setObjectName("ThumbnailContextMenu");
 
     m_clipboard = QApplication::clipboard();
 
+    // 批量操作在后台任务中执行，所有批次复用同一组工作线程
+    m_batchOperation = new ThumbnailBatchOperation(this);
+    connect(m_batchOperation, &ThumbnailBatchOperation::progressChanged, this,
+            &ThumbnailContextMenu::onBatchProgress);
+    connect(m_batchOperation, &ThumbnailBatchOperation::finished, this,
+            &ThumbnailContextMenu::onBatchFinished);
+
     createActions();
     setupMenu();
     updateMenuStyle();
@@ -81,6 +91,33 @@ void ThumbnailContextMenu::createActions() {
     connect(m_setBookmarkAction, &QAction::triggered, this,
             &ThumbnailContextMenu::onSetAsBookmark);
 
+    // 批量操作子菜单
+    m_batchMenu = new QMenu("批量操作", this);
+    m_batchMenu->setObjectName("ThumbnailContextMenu");
+
+    m_batchExportAction = new QAction("导出所选页面...", this);
+    connect(m_batchExportAction, &QAction::triggered, this,
+            &ThumbnailContextMenu::onBatchExport);
+
+    m_batchCopyAction = new QAction("复制所选页面图像", this);
+    connect(m_batchCopyAction, &QAction::triggered, this,
+            &ThumbnailContextMenu::onBatchCopy);
+
+    m_batchExtractTextAction = new QAction("提取所选页面文本...", this);
+    connect(m_batchExtractTextAction, &QAction::triggered, this,
+            &ThumbnailContextMenu::onBatchExtractText);
+
+    m_batchBookmarkAction = new QAction("为所选页面添加书签", this);
+    connect(m_batchBookmarkAction, &QAction::triggered, this,
+            &ThumbnailContextMenu::onBatchBookmark);
+
+    m_batchMenu->addAction(m_batchExportAction);
+    m_batchMenu->addAction(m_batchCopyAction);
+    m_batchMenu->addAction(m_batchExtractTextAction);
+    m_batchMenu->addSeparator();
+    m_batchMenu->addAction(m_batchBookmarkAction);
+    m_batchMenuAction = m_batchMenu->menuAction();
+
     // 创建分隔符
     m_separator1 = new QAction(this);
     m_separator1->setSeparator(true);
@@ -98,6 +135,7 @@ void ThumbnailContextMenu::setupMenu() {
     addAction(m_copyPageNumberAction);
     addAction(m_exportPageAction);
     addAction(m_printPageAction);
+    addAction(m_batchMenuAction);
     addAction(m_separator2);
 
     addAction(m_refreshPageAction);
@@ -172,11 +210,15 @@ void ThumbnailContextMenu::updateMenuStyle() {
     )";
 
     setStyleSheet(m_isDarkTheme ? m_darkStyleSheet : m_lightStyleSheet);
+    m_batchMenu->setStyleSheet(m_isDarkTheme ? m_darkStyleSheet
+                                             : m_lightStyleSheet);
 }
 
 void ThumbnailContextMenu::setDocument(
     std::shared_ptr<Poppler::Document> document) {
     m_document = document;
+    m_batchOperation->setDocument(document);
+    m_selectedPages.clear();
     updateActionStates();
 }
 
@@ -190,8 +232,32 @@ void ThumbnailContextMenu::setCurrentPage(int pageNumber) {
     updateActionStates();
 }
 
+void ThumbnailContextMenu::setSelectedPages(const QList<int>& pages) {
+    m_selectedPages = pages;
+    std::sort(m_selectedPages.begin(), m_selectedPages.end());
+    m_selectedPages.erase(
+        std::unique(m_selectedPages.begin(), m_selectedPages.end()),
+        m_selectedPages.end());
+    updateActionStates();
+}
+
 void ThumbnailContextMenu::showForPage(int pageNumber,
                                        const QPoint& globalPos) {
+    setSelectedPages(QList<int>());
+    setCurrentPage(pageNumber);
+    updateActionStates();
+    popup(globalPos);
+}
+
+void ThumbnailContextMenu::showForPages(const QList<int>& pages,
+                                        int pageNumber,
+                                        const QPoint& globalPos) {
+    // 右键点在选区之外时只针对该页
+    if (pages.contains(pageNumber)) {
+        setSelectedPages(pages);
+    } else {
+        setSelectedPages(QList<int>());
+    }
     setCurrentPage(pageNumber);
     updateActionStates();
     popup(globalPos);
@@ -221,6 +287,17 @@ void ThumbnailContextMenu::updateActionStates() {
     m_pageInfoAction->setEnabled(canOperate);
     m_setBookmarkAction->setEnabled(canOperate);
 
+    // 批量操作仅在多选时显示；同一时刻只允许一个批次
+    const int selectionCount = m_selectedPages.size();
+    const bool batchIdle = !isBatchRunning();
+    m_batchMenuAction->setVisible(selectionCount > 1);
+    m_batchMenuAction->setText(
+        QString("批量操作 (%1 页)").arg(selectionCount));
+    m_batchExportAction->setEnabled(hasDocument && batchIdle);
+    m_batchCopyAction->setEnabled(hasDocument && batchIdle);
+    m_batchExtractTextAction->setEnabled(hasDocument && batchIdle);
+    m_batchBookmarkAction->setEnabled(hasDocument);
+
     // 更新动作文本
     if (hasValidPage) {
         m_goToPageAction->setText(
@@ -533,3 +610,158 @@ void ThumbnailContextMenu::exportPageAsPDF(Poppler::Page* page,
                 .arg(pngFilePath));
     }
 }
+
+bool ThumbnailContextMenu::isBatchRunning() const {
+    return m_batchOperation && m_batchOperation->isRunning();
+}
+
+void ThumbnailContextMenu::cancelBatch() {
+    if (m_batchOperation) {
+        m_batchOperation->cancel();
+    }
+}
+
+QList<int> ThumbnailContextMenu::batchPages() const {
+    if (!m_selectedPages.isEmpty()) {
+        return m_selectedPages;
+    }
+    return m_currentPage >= 0 ? QList<int>{m_currentPage} : QList<int>();
+}
+
+void ThumbnailContextMenu::onBatchExport() {
+    QList<int> pages = batchPages();
+    if (pages.isEmpty() || !m_document) {
+        return;
+    }
+
+    QString directory = QFileDialog::getExistingDirectory(
+        parentWidget(), QString("导出 %1 个页面到").arg(pages.size()),
+        QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation));
+
+    if (!directory.isEmpty()) {
+        startBatch(ThumbnailBatchOperation::Operation::ExportImages,
+                   directory, EXPORT_DPI);
+    }
+}
+
+void ThumbnailContextMenu::onBatchCopy() {
+    startBatch(ThumbnailBatchOperation::Operation::CopyImages, QString(),
+               COPY_DPI);
+}
+
+void ThumbnailContextMenu::onBatchExtractText() {
+    QList<int> pages = batchPages();
+    if (pages.isEmpty() || !m_document) {
+        return;
+    }
+
+    QString defaultPath = QDir(QStandardPaths::writableLocation(
+                                   QStandardPaths::DocumentsLocation))
+                              .filePath("pages_text.txt");
+    QString filePath = QFileDialog::getSaveFileName(
+        parentWidget(), QString("提取 %1 个页面的文本").arg(pages.size()),
+        defaultPath, "文本文件 (*.txt);;所有文件 (*.*)");
+
+    if (!filePath.isEmpty()) {
+        startBatch(ThumbnailBatchOperation::Operation::ExtractText, filePath,
+                   0.0);
+    }
+}
+
+void ThumbnailContextMenu::onBatchBookmark() {
+    QList<int> pages = batchPages();
+    if (pages.isEmpty()) {
+        return;
+    }
+
+    LOG_INFO("ThumbnailContextMenu: User added bookmarks for {} pages",
+             pages.size());
+    emit bookmarksRequested(pages);
+}
+
+void ThumbnailContextMenu::startBatch(
+    ThumbnailBatchOperation::Operation operation, const QString& outputPath,
+    double dpi) {
+    QList<int> pages = batchPages();
+    if (pages.isEmpty() || !m_document) {
+        return;
+    }
+
+    ThumbnailBatchOperation::BatchRequest request;
+    request.operation = operation;
+    request.pages = pages;
+    request.outputPath = outputPath;
+    request.dpi = dpi;
+
+    if (!m_batchOperation->start(request)) {
+        QMessageBox::warning(parentWidget(), "批量操作",
+                             "已有批量操作正在进行，请稍后再试");
+        return;
+    }
+
+    if (!m_batchProgressDialog) {
+        m_batchProgressDialog = new QProgressDialog(parentWidget());
+        m_batchProgressDialog->setWindowTitle("批量操作");
+        m_batchProgressDialog->setWindowModality(Qt::NonModal);
+        m_batchProgressDialog->setMinimumDuration(300);
+        m_batchProgressDialog->setAutoClose(false);
+        m_batchProgressDialog->setAutoReset(false);
+        connect(m_batchProgressDialog, &QProgressDialog::canceled, this,
+                &ThumbnailContextMenu::cancelBatch);
+    }
+
+    m_batchProgressDialog->setLabelText(
+        QString("正在处理 %1 个页面...").arg(pages.size()));
+    m_batchProgressDialog->setRange(0, pages.size());
+    m_batchProgressDialog->setValue(0);
+}
+
+void ThumbnailContextMenu::onBatchProgress(int completed, int total) {
+    if (m_batchProgressDialog) {
+        m_batchProgressDialog->setMaximum(total);
+        m_batchProgressDialog->setValue(completed);
+    }
+}
+
+void ThumbnailContextMenu::onBatchFinished(
+    const ThumbnailBatchOperation::BatchResult& result) {
+    if (m_batchProgressDialog) {
+        m_batchProgressDialog->reset();
+        m_batchProgressDialog->hide();
+    }
+
+    emit batchFinished(result);
+
+    if (result.cancelled) {
+        return;
+    }
+
+    switch (result.operation) {
+        case ThumbnailBatchOperation::Operation::CopyImages:
+            if (!result.combinedImage.isNull() && m_clipboard) {
+                m_clipboard->setImage(result.combinedImage);
+            }
+            break;
+        case ThumbnailBatchOperation::Operation::ExtractText:
+            if (!result.text.isEmpty() && m_clipboard) {
+                m_clipboard->setText(result.text);
+            }
+            break;
+        case ThumbnailBatchOperation::Operation::ExportImages:
+            break;
+    }
+
+    if (result.failed > 0) {
+        QMessageBox::warning(parentWidget(), "批量操作",
+                             QString("%1 个页面处理成功，%2 个失败:\n%3")
+                                 .arg(result.succeeded)
+                                 .arg(result.failed)
+                                 .arg(result.errors.mid(0, 10).join("\n")));
+    } else {
+        QMessageBox::information(
+            parentWidget(), "批量操作",
+            QString("已完成 %1 个页面，用时 %2 秒")
+                .arg(result.succeeded)
+                .arg(result.elapsedMs / 1000.0, 0, 'f', 1));
+    }
+}
@@ -17,6 +17,7 @@
 #include <QtGui>
 #include <QtWidgets>
 #include <memory>
+#include "ThumbnailBatchOperation.h"
 
 class ThumbnailModel;
 
@@ -29,6 +30,7 @@ class ThumbnailModel;
  * - 打印单页
  * - 页面信息显示
  * - 刷新缩略图
+ * - 多选页面的批量操作（导出、复制、提取文本、旋转视图、书签）
  */
 class ThumbnailContextMenu : public QMenu {
     Q_OBJECT
@@ -41,9 +43,17 @@ public:
     void setDocument(std::shared_ptr<Poppler::Document> document);
     void setThumbnailModel(ThumbnailModel* model);
     void setCurrentPage(int pageNumber);
+    void setSelectedPages(const QList<int>& pages);
+    QList<int> selectedPages() const { return m_selectedPages; }
 
     // 菜单显示
     void showForPage(int pageNumber, const QPoint& globalPos);
+    void showForPages(const QList<int>& pages, int pageNumber,
+                      const QPoint& globalPos);
+
+    // 批量操作
+    bool isBatchRunning() const;
+    void cancelBatch();
 
     // 动作启用/禁用
     void setActionsEnabled(bool enabled);
@@ -62,6 +72,8 @@ signals:
     void pageInfoRequested(int pageNumber);
     void goToPageRequested(int pageNumber);
     void bookmarkRequested(int pageNumber);
+    void bookmarksRequested(const QList<int>& pageNumbers);
+    void batchFinished(const ThumbnailBatchOperation::BatchResult& result);
 
 private slots:
     void onCopyPage();
@@ -73,6 +85,13 @@ private slots:
     void onCopyPageNumber();
     void onSetAsBookmark();
 
+    void onBatchExport();
+    void onBatchCopy();
+    void onBatchExtractText();
+    void onBatchBookmark();
+    void onBatchProgress(int completed, int total);
+    void onBatchFinished(const ThumbnailBatchOperation::BatchResult& result);
+
 private:
     void createActions();
     void setupMenu();
@@ -83,6 +102,10 @@ private:
     void exportPageAsPDF(Poppler::Page* page, const QString& filePath);
     void showPageInfoDialog(int pageNumber);
 
+    void startBatch(ThumbnailBatchOperation::Operation operation,
+                    const QString& outputPath, double dpi);
+    QList<int> batchPages() const;
+
     QString getDefaultExportPath(int pageNumber) const;
     QPixmap getPagePixmap(int pageNumber) const;
     QString getPageInfoText(int pageNumber) const;
@@ -103,6 +126,17 @@ private:
     QAction* m_copyPageNumberAction;
     QAction* m_setBookmarkAction;
 
+    // 批量操作
+    QMenu* m_batchMenu;
+    QAction* m_batchMenuAction;
+    QAction* m_batchExportAction;
+    QAction* m_batchCopyAction;
+    QAction* m_batchExtractTextAction;
+    QAction* m_batchBookmarkAction;
+    QList<int> m_selectedPages;
+    ThumbnailBatchOperation* m_batchOperation;
+    QProgressDialog* m_batchProgressDialog;
+
     // 分隔符
     QAction* m_separator1;
     QAction* m_separator2;
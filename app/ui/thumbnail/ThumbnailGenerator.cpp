@@ -12,6 +12,9 @@
 #include <QtGui>
 #include <QtWidgets>
 #include <algorithm>
+#include "ui/viewer/RenderBroker.h"
+#include "ui/viewer/RenderCostModel.h"
+#include "utils/DocumentBundle.h"
 #include "utils/LoggingMacros.h"
 
 ThumbnailGenerator::ThumbnailGenerator(QObject* parent)
@@ -461,6 +464,22 @@ QPixmap ThumbnailGenerator::generatePixmap(const GenerationRequest& request) {
     }
 
     try {
+        // 文档包中预生成的缩略图不小于目标尺寸时，解码后缩小即可，无需渲染
+        std::shared_ptr<DocumentBundle> bundle =
+            DocumentBundle::find(m_document.get());
+        if (bundle) {
+            QImage image = bundle->thumbnail(request.pageNumber);
+            const QSize target =
+                image.size().scaled(request.size, Qt::KeepAspectRatio);
+            if (!image.isNull() && target.width() <= image.width()) {
+                if (image.size() != target) {
+                    image = image.scaled(target, Qt::KeepAspectRatio,
+                                         Qt::SmoothTransformation);
+                }
+                return QPixmap::fromImage(image);
+            }
+        }
+
         std::unique_ptr<Poppler::Page> page(
             m_document->page(request.pageNumber));
         if (!page) {
@@ -496,9 +515,32 @@ QPixmap ThumbnailGenerator::renderPageToPixmapOptimized(Poppler::Page* page,
         QSizeF pageSize = page->pageSizeF();
         double dpi = getCachedDPI(size, pageSize, quality);
 
-        // 渲染页面 - 直接渲染到目标尺寸附近以减少缩放
-        QImage image = page->renderToImage(dpi, dpi, -1, -1, -1, -1,
-                                           Poppler::Page::Rotate0);
+        // 按实测耗时在缩略图预算内取 DPI；超出预算的重页面放大显示即可
+        RenderCostModel& costModel = RenderCostModel::instance();
+        dpi = costModel
+                  .chooseDpi(m_document.get(), page->index(), pageSize, dpi,
+                             RenderCostModel::Interaction::Thumbnail)
+                  .dpi;
+
+        // 渲染页面 - 直接渲染到目标尺寸附近以减少缩放；
+        // 查看器正在渲染同一页面时，缩小其结果即可
+        const void* documentKey = m_document.get();
+        const int pageNumber = page->index();
+        QImage image = RenderBroker::instance().render(
+            documentKey, pageNumber, dpi, 0,
+            [page, documentKey, pageNumber, &costModel](double renderDpi) {
+                QElapsedTimer renderTimer;
+                renderTimer.start();
+                QImage rendered =
+                    page->renderToImage(renderDpi, renderDpi, -1, -1, -1, -1,
+                                        Poppler::Page::Rotate0);
+                if (!rendered.isNull()) {
+                    costModel.recordRender(documentKey, pageNumber,
+                                           rendered.size(),
+                                           renderTimer.nsecsElapsed() / 1e6);
+                }
+                return rendered;
+            });
 
         if (image.isNull()) {
             return QPixmap();
@@ -593,12 +635,13 @@ void ThumbnailGenerator::cacheDPI(const QSize& targetSize,
 
 Qt::TransformationMode ThumbnailGenerator::getOptimalTransformationMode(
     const QSize& sourceSize, const QSize& targetSize) {
-    // 如果缩放比例较小或目标尺寸较小，使用快速变换
+    // 缩放比例接近1时使用快速变换；生成结果会作为主图再次缩放，
+    // 小尺寸也需要平滑变换以避免混叠
     double scaleRatio =
         qMin(static_cast<double>(targetSize.width()) / sourceSize.width(),
              static_cast<double>(targetSize.height()) / sourceSize.height());
 
-    if (scaleRatio > 0.8 || targetSize.width() <= 150) {
+    if (scaleRatio > 0.8) {
         return Qt::FastTransformation;
     }
 
@@ -80,7 +80,8 @@ void ThumbnailListView::setupUI() {
     setWrapping(false);
     setResizeMode(QListView::Adjust);
     setMovement(QListView::Static);
-    setSelectionMode(QAbstractItemView::SingleSelection);
+    // 扩展选择：Ctrl/Shift 多选页面以进行批量操作
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
     setSelectionBehavior(QAbstractItemView::SelectItems);
 
     // 设置滚动属性
@@ -550,7 +551,6 @@ void ThumbnailListView::contextMenuEvent(QContextMenuEvent* event) {
         int pageNumber = pageAtIndex(index);
         if (pageNumber >= 0) {
             m_contextMenuPage = pageNumber;
-            handlePageRightClick(pageNumber, event->globalPos());
             showContextMenu(event->pos());
         }
     }
@@ -596,9 +596,18 @@ void ThumbnailListView::onScrollBarRangeChanged(int min, int max) {
 
 void ThumbnailListView::onModelDataChanged(const QModelIndex& topLeft,
                                            const QModelIndex& bottomRight) {
-    Q_UNUSED(topLeft);
-    Q_UNUSED(bottomRight);
-    update();
+    // 只重绘落在可见范围内的项，不可见的批量更新不触发整窗重绘
+    const int first = qMax(topLeft.row(), m_visibleRange.first);
+    const int last = qMin(bottomRight.row(), m_visibleRange.second);
+    if (!model() || first < 0 || first > last) {
+        return;
+    }
+
+    QRect dirty;
+    for (int row = first; row <= last; ++row) {
+        dirty |= visualRect(model()->index(row, 0));
+    }
+    viewport()->update(dirty);
 }
 
 void ThumbnailListView::onModelRowsInserted(const QModelIndex& parent,
@@ -0,0 +1,119 @@
+#include "CompactRaster.h"
+#include <cstring>
+
+namespace {
+
+bool isRgb32(QImage::Format format) {
+    return format == QImage::Format_RGB32 || format == QImage::Format_ARGB32 ||
+           format == QImage::Format_ARGB32_Premultiplied;
+}
+
+}  // namespace
+
+CompactRaster::CompactRaster(const QImage& image) : m_depth(classify(image)) {
+    switch (m_depth) {
+        case Depth::Grayscale:
+            m_image = toGrayscale(image);
+            break;
+        case Depth::Bilevel:
+            m_image = toBilevel(image);
+            break;
+        case Depth::Color:
+            m_image = image;
+            break;
+    }
+}
+
+CompactRaster::Depth CompactRaster::classify(const QImage& image) {
+    if (image.isNull() || !isRgb32(image.format())) {
+        return Depth::Color;
+    }
+
+    // RGB32 的 alpha 字节未定义，按不透明处理
+    const quint32 alphaFill =
+        image.format() == QImage::Format_RGB32 ? 0xFF000000u : 0u;
+    const int width = image.width();
+    quint32 notBilevel = 0;
+
+    for (int y = 0; y < image.height(); ++y) {
+        const quint32* line =
+            reinterpret_cast<const quint32*>(image.constScanLine(y));
+
+        // 行内循环无分支，只做按位累积，编译器可自动向量化：
+        // - 灰度：p ^ (p >> 8) 的低 16 位依次是 B^G、G^R，全为 0 即 R=G=B
+        // - 不透明：所有像素按位与后 alpha 仍为 0xFF
+        // - 黑白：(v + 1) & 0xFE 仅在 v 为 0 或 255 时为 0
+        quint32 notGray = 0;
+        quint32 opaque = 0xFFFFFFFFu;
+        quint32 rowNotBilevel = 0;
+        for (int x = 0; x < width; ++x) {
+            const quint32 p = line[x] | alphaFill;
+            notGray |= (p ^ (p >> 8)) & 0xFFFFu;
+            opaque &= p;
+            rowNotBilevel |= ((p & 0xFFu) + 1) & 0xFEu;
+        }
+
+        if (notGray != 0 || (opaque >> 24) != 0xFFu) {
+            return Depth::Color;
+        }
+        notBilevel |= rowNotBilevel;
+    }
+
+    return notBilevel == 0 ? Depth::Bilevel : Depth::Grayscale;
+}
+
+qint64 CompactRaster::imageBytes(const QImage& image) {
+    return image.isNull() ? 0 : static_cast<qint64>(image.sizeInBytes());
+}
+
+qint64 CompactRaster::pixmapBytes(const QPixmap& pixmap) {
+    if (pixmap.isNull()) {
+        return 0;
+    }
+    // 按平台位图的实际深度计算，行宽按 4 字节对齐
+    const qint64 bytesPerLine =
+        ((static_cast<qint64>(pixmap.width()) * pixmap.depth() + 31) / 32) *
+        4;
+    return bytesPerLine * pixmap.height();
+}
+
+QPixmap CompactRaster::toPixmap() const {
+    return m_image.isNull() ? QPixmap() : QPixmap::fromImage(m_image);
+}
+
+QImage CompactRaster::toGrayscale(const QImage& image) {
+    QImage gray(image.size(), QImage::Format_Grayscale8);
+    const int width = image.width();
+    for (int y = 0; y < image.height(); ++y) {
+        const quint32* source =
+            reinterpret_cast<const quint32*>(image.constScanLine(y));
+        uchar* target = gray.scanLine(y);
+        for (int x = 0; x < width; ++x) {
+            target[x] = static_cast<uchar>(source[x] & 0xFFu);
+        }
+    }
+    gray.setDevicePixelRatio(image.devicePixelRatio());
+    return gray;
+}
+
+QImage CompactRaster::toBilevel(const QImage& image) {
+    // Format_Mono 高位在前；颜色表 0 为黑、1 为白
+    QImage mono(image.size(), QImage::Format_Mono);
+    mono.setColorCount(2);
+    mono.setColor(0, qRgb(0, 0, 0));
+    mono.setColor(1, qRgb(255, 255, 255));
+
+    const int width = image.width();
+    for (int y = 0; y < image.height(); ++y) {
+        const quint32* source =
+            reinterpret_cast<const quint32*>(image.constScanLine(y));
+        uchar* target = mono.scanLine(y);
+        std::memset(target, 0, mono.bytesPerLine());
+        for (int x = 0; x < width; ++x) {
+            const uchar bit = static_cast<uchar>(source[x] & 1u);
+            target[x >> 3] |= static_cast<uchar>(bit << (7 - (x & 7)));
+        }
+    }
+    mono.setDevicePixelRatio(image.devicePixelRatio());
+    return mono;
+}
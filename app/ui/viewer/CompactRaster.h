@@ -0,0 +1,53 @@
+#pragma once
+
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+
+/**
+ * @brief 按色彩深度压缩存储的渲染结果
+ *
+ * 扫描版办公文档大多是灰度或纯黑白页面，按 32 位 ARGB 缓存时四分之三
+ * 以上的字节是冗余的。构造时扫描一遍像素：
+ * - 所有像素不透明且 R = G = B：存为 Format_Grayscale8（1/4 内存）
+ * - 其中只有纯黑和纯白：存为 1 位的 Format_Mono（1/32 内存）
+ * - 其他情况原样保存
+ *
+ * 转换无损。QPainter 可直接绘制压缩后的图像（灰度或颜色表），
+ * 需要 QPixmap 的使用方在取用时才展开。
+ */
+class CompactRaster {
+public:
+    enum class Depth {
+        Color,      // 原样保存
+        Grayscale,  // 8 位灰度
+        Bilevel     // 1 位黑白
+    };
+
+    CompactRaster() = default;
+    explicit CompactRaster(const QImage& image);
+
+    // 只识别 32 位 RGB/ARGB 格式，其他格式视为彩色
+    static Depth classify(const QImage& image);
+
+    // 实际占用字节数（按存储格式计算）
+    static qint64 imageBytes(const QImage& image);
+    static qint64 pixmapBytes(const QPixmap& pixmap);
+
+    bool isNull() const { return m_image.isNull(); }
+    Depth depth() const { return m_depth; }
+    QSize size() const { return m_image.size(); }
+    qint64 memorySize() const { return imageBytes(m_image); }
+
+    // 压缩后的图像，可直接交给 QPainter::drawImage
+    const QImage& image() const { return m_image; }
+    // 展开为可显示的位图，只在绘制时调用
+    QPixmap toPixmap() const;
+
+private:
+    static QImage toGrayscale(const QImage& image);
+    static QImage toBilevel(const QImage& image);
+
+    QImage m_image;
+    Depth m_depth = Depth::Color;
+};
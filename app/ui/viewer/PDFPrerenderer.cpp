@@ -10,6 +10,8 @@
 #include <QtWidgets>
 #include <algorithm>
 #include <cmath>
+#include "RenderBroker.h"
+#include "RenderCostModel.h"
 
 // PDFPrerenderer Implementation
 PDFPrerenderer::PDFPrerenderer(QObject* parent)
@@ -109,7 +111,8 @@ QPixmap PDFPrerenderer::getCachedPage(int pageNumber, double scaleFactor,
         item.timestamp = QDateTime::currentMSecsSinceEpoch();
         item.accessCount++;
         m_cacheHits++;
-        return item.pixmap;
+        // 只有灰度/黑白页面需要展开，彩色页面返回缓存的位图本身
+        return item.pixmap.isNull() ? item.raster.toPixmap() : item.pixmap;
     }
 
     m_cacheMisses++;
@@ -313,13 +316,24 @@ void PDFPrerenderer::cleanupWorkerThreads() {
     m_workerThreads.clear();
 }
 
-void PDFPrerenderer::onRenderCompleted(int pageNumber, const QPixmap& pixmap,
+void PDFPrerenderer::onRenderCompleted(int pageNumber,
+                                       const CompactRaster& raster,
                                        double scaleFactor, int rotation) {
-    if (pixmap.isNull())
+    if (raster.isNull())
         return;
 
+    // 扫描的灰度/黑白页面以 8 位或 1 位存储，同样内存可缓存 4-32 倍页数；
+    // 彩色页面照旧转换为位图保存
+    CacheItem item;
+    if (raster.depth() == CompactRaster::Depth::Color) {
+        item.pixmap = QPixmap::fromImage(raster.image());
+    } else {
+        item.raster = raster;
+    }
     QString cacheKey = getCacheKey(pageNumber, scaleFactor, rotation);
-    qint64 pixmapSize = getPixmapMemorySize(pixmap);
+    qint64 pixmapSize = item.pixmap.isNull()
+                            ? raster.memorySize()
+                            : CompactRaster::pixmapBytes(item.pixmap);
 
     // Evict items if necessary
     while (m_currentMemoryUsage + pixmapSize > m_maxMemoryUsage &&
@@ -328,8 +342,6 @@ void PDFPrerenderer::onRenderCompleted(int pageNumber, const QPixmap& pixmap,
     }
 
     // Add to cache
-    CacheItem item;
-    item.pixmap = pixmap;
     item.timestamp = QDateTime::currentMSecsSinceEpoch();
     item.memorySize = pixmapSize;
     item.accessCount = 0;
@@ -415,10 +427,6 @@ void PDFPrerenderer::evictLRUItems() {
     }
 }
 
-qint64 PDFPrerenderer::getPixmapMemorySize(const QPixmap& pixmap) {
-    return pixmap.width() * pixmap.height() * 4;  // 32-bit ARGB
-}
-
 double PDFPrerenderer::cacheHitRatio() const {
     int total = m_cacheHits + m_cacheMisses;
     return total > 0 ? static_cast<double>(m_cacheHits) / total : 0.0;
@@ -470,9 +478,11 @@ void PDFRenderWorker::processRenderQueue() {
         }
 
         try {
-            QPixmap pixmap = renderPage(request);
-            if (!pixmap.isNull()) {
-                emit pageRendered(request.pageNumber, pixmap,
+            QImage image = renderPage(request);
+            if (!image.isNull()) {
+                // 像素扫描与灰度/黑白压缩在工作线程完成，GUI 线程只按色深
+                // 决定是否转换为位图
+                emit pageRendered(request.pageNumber, CompactRaster(image),
                                   request.scaleFactor, request.rotation);
             }
         } catch (const std::exception& e) {
@@ -482,28 +492,44 @@ void PDFRenderWorker::processRenderQueue() {
     }
 }
 
-QPixmap PDFRenderWorker::renderPage(
+QImage PDFRenderWorker::renderPage(
     const PDFPrerenderer::RenderRequest& request) {
     if (!m_document) {
-        return QPixmap();
+        return QImage();
     }
 
     std::unique_ptr<Poppler::Page> page(m_document->page(request.pageNumber));
     if (!page) {
-        return QPixmap();
+        return QImage();
     }
 
-    double dpi = calculateOptimalDPI(request.scaleFactor);
-
-    QImage image = page->renderToImage(
-        dpi, dpi, -1, -1, -1, -1,
-        static_cast<Poppler::Page::Rotation>(request.rotation / 90));
-
-    if (image.isNull()) {
-        return QPixmap();
-    }
+    // 预渲染使用较宽松的后台预算；受限的页面显示时由查看器补充渲染
+    RenderCostModel& costModel = RenderCostModel::instance();
+    const RenderCostModel::Decision decision = costModel.chooseDpi(
+        m_document, request.pageNumber, page->pageSizeF(),
+        calculateOptimalDPI(request.scaleFactor),
+        RenderCostModel::Interaction::Prefetch);
+    const double dpi = decision.dpi;
+
+    // 与查看器或缩略图同时请求同一页面时共享一次渲染
+    QImage image = RenderBroker::instance().render(
+        m_document, request.pageNumber, dpi, request.rotation,
+        [this, &page, &request, &costModel](double renderDpi) {
+            QElapsedTimer renderTimer;
+            renderTimer.start();
+            QImage rendered = page->renderToImage(
+                renderDpi, renderDpi, -1, -1, -1, -1,
+                static_cast<Poppler::Page::Rotation>(request.rotation / 90));
+            if (!rendered.isNull()) {
+                costModel.recordRender(m_document, request.pageNumber,
+                                       rendered.size(),
+                                       renderTimer.nsecsElapsed() / 1e6);
+            }
+            return rendered;
+        });
 
-    return QPixmap::fromImage(image);
+    // 位图在缓存取用时才创建，工作线程只产出图像
+    return image;
 }
 
 double PDFRenderWorker::calculateOptimalDPI(double scaleFactor) {
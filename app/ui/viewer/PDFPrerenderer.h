@@ -11,6 +11,7 @@
 #include <QThread>
 #include <QTimer>
 #include <QWaitCondition>
+#include "CompactRaster.h"
 
 /**
  * Intelligent PDF page prerendering system with predictive loading
@@ -79,7 +80,7 @@ public slots:
     void resumePrerendering();
 
 private slots:
-    void onRenderCompleted(int pageNumber, const QPixmap& pixmap,
+    void onRenderCompleted(int pageNumber, const CompactRaster& raster,
                            double scaleFactor, int rotation);
     void onAdaptiveAnalysis();
 
@@ -111,7 +112,8 @@ private:
 
     // Cache management
     struct CacheItem {
-        QPixmap pixmap;
+        QPixmap pixmap;        // 彩色页面，取用时直接共享，不再复制
+        CompactRaster raster;  // 灰度/黑白页面按实际色深存储
         qint64 timestamp;
         qint64 memorySize;
         int accessCount;
@@ -135,7 +137,6 @@ private:
     // Helper methods
     QString getCacheKey(int pageNumber, double scaleFactor, int rotation);
     void evictLRUItems();
-    qint64 getPixmapMemorySize(const QPixmap& pixmap);
 
 signals:
     void pagePrerendered(int pageNumber, double scaleFactor, int rotation);
@@ -163,7 +164,7 @@ public slots:
     void processRenderQueue();
 
 private:
-    QPixmap renderPage(const PDFPrerenderer::RenderRequest& request);
+    QImage renderPage(const PDFPrerenderer::RenderRequest& request);
     double calculateOptimalDPI(double scaleFactor);
 
     Poppler::Document* m_document;
@@ -173,8 +174,9 @@ private:
     bool m_shouldStop;
 
 signals:
-    void pageRendered(int pageNumber, const QPixmap& pixmap, double scaleFactor,
-                      int rotation);
+    // 色深已在工作线程中判定并压缩
+    void pageRendered(int pageNumber, const CompactRaster& raster,
+                      double scaleFactor, int rotation);
     void renderError(int pageNumber, const QString& error);
 };
 
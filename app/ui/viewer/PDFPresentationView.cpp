@@ -0,0 +1,396 @@
+#include "PDFPresentationView.h"
+#include <QCloseEvent>
+#include <QFutureWatcher>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QResizeEvent>
+#include <QScreen>
+#include <QWheelEvent>
+#include <QtConcurrent/QtConcurrent>
+#include "utils/LoggingMacros.h"
+
+PDFPresentationView::PDFPresentationView(QWidget* parent)
+    : QWidget(parent),
+      m_radius(DEFAULT_PRERENDER_RADIUS),
+      m_renderPool(new QThreadPool(this)),
+      m_cancelled(std::make_shared<std::atomic<bool>>(false)),
+      m_windowCenter(std::make_shared<std::atomic<int>>(0)) {
+    // 有父对象时仍作为独立的顶层窗口显示，随查看器一起销毁
+    setWindowFlag(Qt::Window);
+    setWindowTitle("演示");
+
+    // 同一文档的页面不并发渲染；按请求顺序（离当前页由近到远）依次完成
+    m_renderPool->setMaxThreadCount(1);
+
+    // 每次绘制都会覆盖整个窗口，跳过背景擦除
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setFocusPolicy(Qt::StrongFocus);
+    setCursor(Qt::BlankCursor);
+}
+
+PDFPresentationView::~PDFPresentationView() {
+    m_cancelled->store(true);
+    m_renderPool->clear();
+    m_renderPool->waitForDone();
+}
+
+void PDFPresentationView::start(std::shared_ptr<Poppler::Document> document,
+                                int pageNumber, QScreen* screen) {
+    if (!document || document->numPages() <= 0) {
+        return;
+    }
+
+    m_document = std::move(document);
+    m_pageCount = m_document->numPages();
+    m_currentSlide = qBound(0, pageNumber, m_pageCount - 1);
+    m_windowCenter->store(m_currentSlide);
+    resetAdvanceStatistics();
+
+    // 先确定目标屏幕和尺寸，保证首页即按最终分辨率渲染
+    QScreen* target = screen ? screen : this->screen();
+    if (target) {
+        setScreen(target);
+        setGeometry(target->geometry());
+    }
+
+    // 开始前同步渲染当前页，观众不会看到空白或逐步出现的页面
+    invalidateSlides();
+    QImage first = renderSlide(m_document.get(), m_currentSlide, m_pixelSize);
+    if (!first.isNull()) {
+        QPixmap pixmap = QPixmap::fromImage(std::move(first));
+        pixmap.setDevicePixelRatio(devicePixelRatioF());
+        m_slides.insert(m_currentSlide, pixmap);
+        m_frontBuffer = pixmap;
+        m_frontSlide = m_currentSlide;
+    }
+
+    showFullScreen();
+    activateWindow();
+    setFocus();
+
+    updatePinnedWindow();
+}
+
+void PDFPresentationView::stop() {
+    if (!m_document) {
+        return;
+    }
+
+    const int lastSlide = m_currentSlide;
+
+    m_cancelled->store(true);
+    m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    ++m_generation;
+    m_slides.clear();
+    m_pending.clear();
+    m_frontBuffer = QPixmap();
+    m_frontSlide = -1;
+    m_advancePending = false;
+    m_document.reset();
+    m_pageCount = 0;
+
+    hide();
+
+    if (m_statistics.advances > 0) {
+        LOG_DEBUG(
+            "PDFPresentationView: {} slide advances, avg {:.1f} ms, max "
+            "{:.1f} ms, {} over {} ms, {} cache misses",
+            m_statistics.advances, m_statistics.averageMs, m_statistics.maxMs,
+            m_statistics.overTarget, ADVANCE_TARGET_MS,
+            m_statistics.cacheMisses);
+    }
+
+    emit presentationFinished(lastSlide);
+}
+
+void PDFPresentationView::setPrerenderRadius(int radius) {
+    radius = qBound(0, radius, MAX_PRERENDER_RADIUS);
+    if (radius == m_radius) {
+        return;
+    }
+    m_radius = radius;
+    if (m_document) {
+        updatePinnedWindow();
+    }
+}
+
+void PDFPresentationView::goToSlide(int pageNumber) {
+    if (!m_document) {
+        return;
+    }
+
+    pageNumber = qBound(0, pageNumber, m_pageCount - 1);
+    if (pageNumber == m_currentSlide) {
+        return;
+    }
+
+    m_advanceTimer.start();
+    m_advancePending = true;
+    m_currentSlide = pageNumber;
+    m_windowCenter->store(pageNumber);
+
+    auto it = m_slides.constFind(pageNumber);
+    if (it != m_slides.constEnd()) {
+        // 已预渲染：交换前台位图并同步重绘，不经过事件队列
+        m_frontBuffer = it.value();
+        m_frontSlide = pageNumber;
+        repaint();
+    } else {
+        // 尚未就绪：继续显示上一页，渲染完成后再翻页并计入延迟
+        ++m_statistics.cacheMisses;
+    }
+
+    emit slideChanged(pageNumber);
+
+    // 翻页完成后再滑动缓存窗口，不占用翻页本身的时间
+    updatePinnedWindow();
+}
+
+QSize PDFPresentationView::targetPixelSize() const {
+    // 以物理像素为单位，位图与屏幕像素一一对应
+    return size() * devicePixelRatioF();
+}
+
+void PDFPresentationView::invalidateSlides() {
+    m_cancelled->store(true);
+    m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    ++m_generation;
+    m_slides.clear();
+    m_pending.clear();
+    m_pixelSize = targetPixelSize();
+    // 旧位图保留显示，新尺寸的当前页就绪后替换
+    m_frontSlide = -1;
+}
+
+void PDFPresentationView::updatePinnedWindow() {
+    const int low = qMax(0, m_currentSlide - m_radius);
+    const int high = qMin(m_pageCount - 1, m_currentSlide + m_radius);
+
+    // 释放滑出窗口的页面
+    for (auto it = m_slides.begin(); it != m_slides.end();) {
+        if (it.key() < low || it.key() > high) {
+            it = m_slides.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // 由近到远请求，下一页优先于上一页
+    requestSlide(m_currentSlide);
+    for (int distance = 1; distance <= m_radius; ++distance) {
+        if (m_currentSlide + distance <= high) {
+            requestSlide(m_currentSlide + distance);
+        }
+        if (m_currentSlide - distance >= low) {
+            requestSlide(m_currentSlide - distance);
+        }
+    }
+}
+
+void PDFPresentationView::requestSlide(int pageNumber) {
+    if (!m_document || m_slides.contains(pageNumber) ||
+        m_pending.contains(pageNumber) || m_pixelSize.isEmpty()) {
+        return;
+    }
+
+    m_pending.insert(pageNumber);
+
+    auto document = m_document;
+    auto cancelled = m_cancelled;
+    auto windowCenter = m_windowCenter;
+    const int radius = m_radius;
+    const QSize pixelSize = m_pixelSize;
+    const int generation = m_generation;
+
+    auto* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this,
+            [this, watcher, pageNumber, generation]() {
+                watcher->deleteLater();
+                QImage image;
+                if (watcher->future().resultCount() > 0) {
+                    image = watcher->result();
+                }
+                onSlideRendered(pageNumber, generation, std::move(image));
+            });
+    watcher->setFuture(QtConcurrent::run(
+        m_renderPool,
+        [document, cancelled, windowCenter, radius, pixelSize, pageNumber]() {
+            if (cancelled->load() ||
+                qAbs(pageNumber - windowCenter->load()) > radius) {
+                return QImage();
+            }
+            return renderSlide(document.get(), pageNumber, pixelSize);
+        }));
+}
+
+void PDFPresentationView::onSlideRendered(int pageNumber, int generation,
+                                          QImage image) {
+    if (generation != m_generation) {
+        return;  // 演示已结束或屏幕尺寸已变化
+    }
+
+    m_pending.remove(pageNumber);
+    if (image.isNull() || qAbs(pageNumber - m_currentSlide) > m_radius) {
+        return;
+    }
+
+    // 位图在到达时转换一次，翻页时只需绘制
+    QPixmap pixmap = QPixmap::fromImage(std::move(image));
+    pixmap.setDevicePixelRatio(devicePixelRatioF());
+    m_slides.insert(pageNumber, pixmap);
+
+    if (pageNumber == m_currentSlide && m_frontSlide != pageNumber) {
+        showSlide(pageNumber);
+    }
+}
+
+void PDFPresentationView::showSlide(int pageNumber) {
+    m_frontBuffer = m_slides.value(pageNumber);
+    m_frontSlide = pageNumber;
+    repaint();
+}
+
+QImage PDFPresentationView::renderSlide(Poppler::Document* document,
+                                        int pageNumber,
+                                        const QSize& pixelSize) {
+    std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+    if (!page || pixelSize.isEmpty()) {
+        return QImage();
+    }
+
+    // 等比适配屏幕：页面尺寸单位为点（1/72 英寸）
+    const QSizeF pageSize = page->pageSizeF();
+    if (pageSize.isEmpty()) {
+        return QImage();
+    }
+    const double scale = qMin(pixelSize.width() / pageSize.width(),
+                              pixelSize.height() / pageSize.height());
+    const double dpi = 72.0 * scale;
+
+    QImage image = page->renderToImage(dpi, dpi);
+    if (image.isNull()) {
+        return image;
+    }
+
+    // 不透明格式的绘制最快
+    if (image.format() != QImage::Format_RGB32) {
+        image = std::move(image).convertToFormat(QImage::Format_RGB32);
+    }
+    return image;
+}
+
+void PDFPresentationView::recordAdvance() {
+    m_advancePending = false;
+
+    const double elapsed =
+        static_cast<double>(m_advanceTimer.nsecsElapsed()) / 1e6;
+    AdvanceStatistics& stats = m_statistics;
+    stats.averageMs =
+        (stats.averageMs * stats.advances + elapsed) / (stats.advances + 1);
+    ++stats.advances;
+    stats.lastMs = elapsed;
+    stats.maxMs = qMax(stats.maxMs, elapsed);
+    if (elapsed > ADVANCE_TARGET_MS) {
+        ++stats.overTarget;
+        LOG_DEBUG("PDFPresentationView: Slide advance took {:.1f} ms, "
+                  "target {} ms",
+                  elapsed, ADVANCE_TARGET_MS);
+    }
+
+    emit slideAdvanceMeasured(elapsed);
+}
+
+void PDFPresentationView::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+
+    if (!m_frontBuffer.isNull()) {
+        // 位图已是物理像素尺寸，居中绘制，不做任何缩放
+        const QSizeF logicalSize = m_frontBuffer.deviceIndependentSize();
+        const QPointF topLeft((width() - logicalSize.width()) / 2.0,
+                              (height() - logicalSize.height()) / 2.0);
+        painter.drawPixmap(topLeft, m_frontBuffer);
+    }
+
+    if (m_advancePending && m_frontSlide == m_currentSlide) {
+        recordAdvance();
+    }
+}
+
+void PDFPresentationView::resizeEvent(QResizeEvent* event) {
+    QWidget::resizeEvent(event);
+
+    // 进入全屏或移动到其他屏幕后按新的物理尺寸重新渲染
+    if (m_document && targetPixelSize() != m_pixelSize) {
+        invalidateSlides();
+        updatePinnedWindow();
+    }
+}
+
+void PDFPresentationView::keyPressEvent(QKeyEvent* event) {
+    switch (event->key()) {
+        case Qt::Key_Right:
+        case Qt::Key_Down:
+        case Qt::Key_PageDown:
+        case Qt::Key_Space:
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+        case Qt::Key_N:
+            nextSlide();
+            break;
+        case Qt::Key_Left:
+        case Qt::Key_Up:
+        case Qt::Key_PageUp:
+        case Qt::Key_Backspace:
+        case Qt::Key_P:
+            previousSlide();
+            break;
+        case Qt::Key_Home:
+            goToSlide(0);
+            break;
+        case Qt::Key_End:
+            goToSlide(m_pageCount - 1);
+            break;
+        case Qt::Key_Escape:
+        case Qt::Key_F5:
+            stop();
+            break;
+        default:
+            QWidget::keyPressEvent(event);
+            return;
+    }
+    event->accept();
+}
+
+void PDFPresentationView::mousePressEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        nextSlide();
+    } else if (event->button() == Qt::RightButton) {
+        previousSlide();
+    } else {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    event->accept();
+}
+
+void PDFPresentationView::wheelEvent(QWheelEvent* event) {
+    const int delta = event->angleDelta().y();
+    if (delta < 0) {
+        nextSlide();
+    } else if (delta > 0) {
+        previousSlide();
+    }
+    event->accept();
+}
+
+void PDFPresentationView::closeEvent(QCloseEvent* event) {
+    // 被窗口管理器关闭时同样结束演示
+    stop();
+    QWidget::closeEvent(event);
+}
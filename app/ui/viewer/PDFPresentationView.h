@@ -0,0 +1,111 @@
+#pragma once
+
+#include <poppler/qt6/poppler-qt6.h>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QSet>
+#include <QSize>
+#include <QThreadPool>
+#include <QWidget>
+#include <atomic>
+#include <memory>
+
+class QScreen;
+
+/**
+ * @brief 全屏演示视图
+ *
+ * 幻灯片按屏幕的物理分辨率（逻辑尺寸 × devicePixelRatio）渲染，绘制时不再缩放。
+ * 当前页前后 N 页常驻在专用的固定窗口缓存中，翻页只是把已就绪的位图
+ * 一次性绘制到窗口上；缓存窗口随翻页滑动，窗口外的页面立即释放。
+ *
+ * 每次翻页的延迟（从输入事件到新页面绘制完成）都会被记录，
+ * 目标是低于一帧（ADVANCE_TARGET_MS）。
+ */
+class PDFPresentationView : public QWidget {
+    Q_OBJECT
+
+public:
+    struct AdvanceStatistics {
+        int advances = 0;
+        int cacheMisses = 0;  // 翻页时目标页尚未渲染完成
+        int overTarget = 0;   // 延迟超过目标的次数
+        double lastMs = 0.0;
+        double averageMs = 0.0;
+        double maxMs = 0.0;
+    };
+
+    explicit PDFPresentationView(QWidget* parent = nullptr);
+    ~PDFPresentationView() override;
+
+    void start(std::shared_ptr<Poppler::Document> document, int pageNumber,
+               QScreen* screen);
+    void stop();
+    bool isPresenting() const { return m_document != nullptr; }
+
+    void goToSlide(int pageNumber);
+    void nextSlide() { goToSlide(m_currentSlide + 1); }
+    void previousSlide() { goToSlide(m_currentSlide - 1); }
+    int currentSlide() const { return m_currentSlide; }
+
+    // 当前页前后各预渲染的页数
+    void setPrerenderRadius(int radius);
+    int prerenderRadius() const { return m_radius; }
+
+    AdvanceStatistics advanceStatistics() const { return m_statistics; }
+    void resetAdvanceStatistics() { m_statistics = AdvanceStatistics(); }
+
+signals:
+    void slideChanged(int pageNumber);
+    void slideAdvanceMeasured(double milliseconds);
+    void presentationFinished(int pageNumber);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void keyPressEvent(QKeyEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void closeEvent(QCloseEvent* event) override;
+
+private:
+    // 工作线程：按给定像素尺寸等比渲染一页
+    static QImage renderSlide(Poppler::Document* document, int pageNumber,
+                              const QSize& pixelSize);
+
+    QSize targetPixelSize() const;
+    void invalidateSlides();
+    void updatePinnedWindow();
+    void requestSlide(int pageNumber);
+    void onSlideRendered(int pageNumber, int generation, QImage image);
+    void showSlide(int pageNumber);
+    void recordAdvance();
+
+    std::shared_ptr<Poppler::Document> m_document;
+    int m_pageCount = 0;
+    int m_currentSlide = 0;
+    int m_radius;
+
+    // 固定窗口缓存：只保存 [当前页 - N, 当前页 + N] 内的页面
+    QHash<int, QPixmap> m_slides;
+    QSet<int> m_pending;
+    QPixmap m_frontBuffer;  // 当前显示的页面
+    int m_frontSlide = -1;
+
+    QSize m_pixelSize;
+    QThreadPool* m_renderPool;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    // 工作线程据此跳过已滑出窗口的排队任务
+    std::shared_ptr<std::atomic<int>> m_windowCenter;
+    int m_generation = 0;
+
+    QElapsedTimer m_advanceTimer;
+    bool m_advancePending = false;
+    AdvanceStatistics m_statistics;
+
+    static constexpr int DEFAULT_PRERENDER_RADIUS = 2;
+    static constexpr int MAX_PRERENDER_RADIUS = 8;
+    static constexpr double ADVANCE_TARGET_MS = 16.0;
+};
@@ -0,0 +1,660 @@
+#include "PDFReflowView.h"
+#include <QFontMetrics>
+#include <QFutureWatcher>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QResizeEvent>
+#include <QScrollBar>
+#include <QTextCharFormat>
+#include <QTextOption>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 中日韩文字之间不插入空格
+bool isCjk(QChar ch) {
+    const char16_t u = ch.unicode();
+    return (u >= 0x3000 && u <= 0x30FF) || (u >= 0x3400 && u <= 0x4DBF) ||
+           (u >= 0x4E00 && u <= 0x9FFF) || (u >= 0xAC00 && u <= 0xD7AF) ||
+           (u >= 0xF900 && u <= 0xFAFF) || (u >= 0xFF00 && u <= 0xFFEF);
+}
+
+// 把一行文本接到段落末尾：去掉断词连字符，西文之间补空格
+void appendLine(QString& paragraph, const QString& line) {
+    if (line.isEmpty()) {
+        return;
+    }
+    if (paragraph.isEmpty()) {
+        paragraph = line;
+        return;
+    }
+
+    const QChar last = paragraph.back();
+    const QChar first = line.front();
+    if (last == QLatin1Char('-') && paragraph.size() > 1 &&
+        paragraph.at(paragraph.size() - 2).isLetter() && first.isLower()) {
+        paragraph.chop(1);
+        paragraph += line;
+    } else if (isCjk(last) || isCjk(first)) {
+        paragraph += line;
+    } else {
+        paragraph += QLatin1Char(' ');
+        paragraph += line;
+    }
+}
+
+}  // namespace
+
+PDFReflowView::PDFReflowView(QWidget* parent)
+    : QAbstractScrollArea(parent),
+      m_extractPool(new QThreadPool(this)),
+      m_cancelled(std::make_shared<std::atomic<bool>>(false)) {
+    // 单线程提取即可跟上滚动速度，且不与渲染线程争抢 CPU
+    m_extractPool->setMaxThreadCount(1);
+    m_textCache.setMaxCost(TEXT_CACHE_BYTES);
+    m_layoutCache.setMaxCost(LAYOUT_CACHE_PAGES);
+
+    setObjectName("reflowView");
+    setFrameShape(QFrame::NoFrame);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    viewport()->setAutoFillBackground(true);
+}
+
+PDFReflowView::~PDFReflowView() {
+    m_cancelled->store(true);
+    m_extractPool->clear();
+    m_extractPool->waitForDone();
+}
+
+void PDFReflowView::setDocument(std::shared_ptr<Poppler::Document> document) {
+    m_document = std::move(document);
+    m_pageCount = m_document ? m_document->numPages() : 0;
+    m_currentPage = 0;
+    resetPages();
+
+    m_updatingScrollBar = true;
+    verticalScrollBar()->setValue(0);
+    m_updatingScrollBar = false;
+
+    updateVisiblePages();
+}
+
+void PDFReflowView::clearDocument() { setDocument(nullptr); }
+
+void PDFReflowView::resetPages() {
+    // 旧文档的提取任务会在开始前检查此标志并直接返回
+    m_cancelled->store(true);
+    m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    ++m_generation;
+
+    m_pending.clear();
+    m_textCache.clear();
+    m_layoutCache.clear();
+    m_layoutWidth = textWidth();
+
+    m_heights.assign(m_pageCount, estimatedPageHeight());
+    m_measured.assign(m_pageCount, 0);
+    rebuildOffsets();
+    updateScrollBar();
+}
+
+void PDFReflowView::setFontScale(double scale) {
+    scale = qBound(MIN_FONT_SCALE, scale, MAX_FONT_SCALE);
+    if (qFuzzyCompare(scale, m_fontScale)) {
+        return;
+    }
+
+    // 行高与每行字数都随字号变化，页面高度约与字号的平方成正比
+    const double ratio = scale / m_fontScale;
+    m_fontScale = scale;
+    invalidateLayouts(ratio * ratio);
+}
+
+double PDFReflowView::fitWidthScale() const {
+    // 行宽上限随字号线性增长，由默认字号下的上限换算
+    const QFontMetricsF metrics(font());
+    const double maxWidth =
+        metrics.horizontalAdvance(QLatin1Char('M')) * MAX_TEXT_WIDTH_EM;
+    const int available = viewport()->width() - 2 * PAGE_MARGIN;
+    if (maxWidth <= 0 || available <= 0) {
+        return m_fontScale;
+    }
+    return qBound(MIN_FONT_SCALE, available / maxWidth, MAX_FONT_SCALE);
+}
+
+void PDFReflowView::setHighlightTerm(const QString& term,
+                                     Qt::CaseSensitivity sensitivity) {
+    if (term == m_highlightTerm && sensitivity == m_highlightSensitivity) {
+        return;
+    }
+
+    // 高亮在绘制时作为选区传入，无需重新排版
+    m_highlightTerm = term;
+    m_highlightSensitivity = sensitivity;
+    ++m_highlightGeneration;
+    viewport()->update();
+}
+
+void PDFReflowView::scrollToPage(int pageNumber) {
+    if (m_pageCount == 0) {
+        return;
+    }
+
+    pageNumber = qBound(0, pageNumber, m_pageCount - 1);
+    m_updatingScrollBar = true;
+    verticalScrollBar()->setValue(static_cast<int>(m_offsets[pageNumber]));
+    m_updatingScrollBar = false;
+
+    // 目标页排版后高度可能变化，锚点保证仍停在页首
+    updateVisiblePages();
+}
+
+qint64 PDFReflowView::memoryUsage() const {
+    qint64 bytes = m_textCache.totalCost();
+    const QList<int> pages = m_layoutCache.keys();
+    for (int page : pages) {
+        if (const PageLayout* layout = m_layoutCache.object(page)) {
+            bytes += layout->bytes;
+        }
+    }
+    bytes += static_cast<qint64>(m_heights.capacity() * sizeof(int) +
+                                 m_measured.capacity() * sizeof(quint8) +
+                                 m_offsets.capacity() * sizeof(qint64));
+    return bytes;
+}
+
+PDFReflowView::PageText PDFReflowView::extractPage(
+    Poppler::Document* document, int pageNumber) {
+    PageText result;
+    std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+    if (!page) {
+        return result;
+    }
+
+    // 第一步：按纵向中心把文本框归并成行
+    struct Line {
+        QString text;
+        double top;
+        double bottom;
+        double glyphHeight;
+    };
+    QList<Line> lines;
+
+    for (const auto& box : page->textList()) {
+        const QString word = box->text();
+        if (word.isEmpty()) {
+            continue;
+        }
+
+        const QRectF rect = box->boundingBox();
+        bool newLine = lines.isEmpty();
+        if (!newLine) {
+            const Line& line = lines.last();
+            const double lineCenter = (line.top + line.bottom) / 2.0;
+            newLine = qAbs(rect.center().y() - lineCenter) >
+                      qMax(rect.height(), line.glyphHeight) / 2.0;
+        }
+        if (newLine) {
+            lines.append({QString(), rect.top(), rect.bottom(), 0.0});
+        }
+
+        Line& line = lines.last();
+        line.top = qMin(line.top, rect.top());
+        line.bottom = qMax(line.bottom, rect.bottom());
+        line.glyphHeight = qMax(line.glyphHeight, rect.height());
+        line.text += word;
+        if (box->hasSpaceAfter()) {
+            line.text += QLatin1Char(' ');
+        }
+    }
+
+    if (lines.isEmpty()) {
+        return result;
+    }
+
+    // 第二步：以行高中位数作为正文字号
+    std::vector<double> heights;
+    heights.reserve(lines.size());
+    for (const Line& line : lines) {
+        heights.push_back(line.glyphHeight);
+    }
+    std::nth_element(heights.begin(), heights.begin() + heights.size() / 2,
+                     heights.end());
+    const double bodyHeight = qMax(1.0, heights[heights.size() / 2]);
+
+    // 第三步：行距过大、字号变化或回到上方（分栏）时开始新段落
+    TextBlock current;
+    auto flush = [&result, &current]() {
+        current.text = current.text.trimmed();
+        if (!current.text.isEmpty()) {
+            result.bytes += sizeof(TextBlock) + current.text.size() * 2;
+            result.blocks.append(current);
+        }
+        current = TextBlock();
+    };
+
+    const Line* previous = nullptr;
+    for (const Line& line : lines) {
+        if (previous) {
+            const double gap = line.top - previous->bottom;
+            const bool sizeChanged = qAbs(line.glyphHeight -
+                                          previous->glyphHeight) >
+                                     bodyHeight * 0.2;
+            if (gap > bodyHeight * PARAGRAPH_GAP_RATIO ||
+                gap < -bodyHeight || sizeChanged) {
+                flush();
+            }
+        }
+
+        if (current.text.isEmpty()) {
+            current.heading =
+                line.glyphHeight > bodyHeight * HEADING_HEIGHT_RATIO;
+        }
+        appendLine(current.text, line.text.trimmed());
+        previous = &line;
+    }
+    flush();
+
+    result.bytes += sizeof(PageText);
+    return result;
+}
+
+void PDFReflowView::requestText(int pageNumber) {
+    if (!m_document || m_pending.contains(pageNumber) ||
+        m_textCache.contains(pageNumber)) {
+        return;
+    }
+
+    m_pending.insert(pageNumber);
+
+    auto document = m_document;
+    auto cancelled = m_cancelled;
+    const int generation = m_generation;
+
+    auto* watcher = new QFutureWatcher<PageText>(this);
+    connect(watcher, &QFutureWatcher<PageText>::finished, this,
+            [this, watcher, pageNumber, generation]() {
+                watcher->deleteLater();
+                if (watcher->future().resultCount() == 0) {
+                    m_pending.remove(pageNumber);
+                    return;
+                }
+                onTextExtracted(pageNumber, generation, watcher->result());
+            });
+    watcher->setFuture(QtConcurrent::run(
+        m_extractPool, [document, cancelled, pageNumber]() {
+            if (cancelled->load()) {
+                return PageText();
+            }
+            return extractPage(document.get(), pageNumber);
+        }));
+}
+
+void PDFReflowView::onTextExtracted(int pageNumber, int generation,
+                                    PageText text) {
+    if (generation != m_generation) {
+        return;  // 文档已更换
+    }
+
+    m_pending.remove(pageNumber);
+
+    // 单页文本超过缓存上限时按上限计费，避免插入失败后反复提取
+    const qint64 cost = qBound<qint64>(1, text.bytes, TEXT_CACHE_BYTES / 4);
+    m_textCache.insert(pageNumber, new PageText(std::move(text)), cost);
+
+    updateVisiblePages();
+}
+
+QFont PDFReflowView::bodyFont() const {
+    QFont result = font();
+    if (result.pointSizeF() > 0) {
+        result.setPointSizeF(result.pointSizeF() * m_fontScale);
+    } else {
+        result.setPixelSize(
+            qMax(1, qRound(result.pixelSize() * m_fontScale)));
+    }
+    return result;
+}
+
+QFont PDFReflowView::headingFont() const {
+    QFont result = bodyFont();
+    if (result.pointSizeF() > 0) {
+        result.setPointSizeF(result.pointSizeF() * 1.3);
+    } else {
+        result.setPixelSize(qRound(result.pixelSize() * 1.3));
+    }
+    result.setBold(true);
+    return result;
+}
+
+int PDFReflowView::textWidth() const {
+    // 限制行宽以保持舒适的阅读长度
+    const QFontMetrics metrics(bodyFont());
+    const int maxWidth =
+        metrics.horizontalAdvance(QLatin1Char('M')) * MAX_TEXT_WIDTH_EM;
+    return qMax(100, qMin(viewport()->width() - 2 * PAGE_MARGIN, maxWidth));
+}
+
+PDFReflowView::PageLayout* PDFReflowView::layoutFor(int pageNumber) {
+    if (PageLayout* cached = m_layoutCache.object(pageNumber)) {
+        return cached;
+    }
+
+    PageText* text = m_textCache.object(pageNumber);
+    if (!text) {
+        return nullptr;
+    }
+
+    const int width = textWidth();
+    const QFont body = bodyFont();
+    const QFont heading = headingFont();
+
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+
+    auto* layout = new PageLayout;
+    int y = PAGE_HEADER_HEIGHT;
+    for (const TextBlock& block : text->blocks) {
+        auto textLayout = std::make_unique<QTextLayout>(
+            block.text, block.heading ? heading : body);
+        textLayout->setTextOption(option);
+        textLayout->setCacheEnabled(true);
+
+        qreal height = 0;
+        textLayout->beginLayout();
+        for (QTextLine line = textLayout->createLine(); line.isValid();
+             line = textLayout->createLine()) {
+            line.setLineWidth(width);
+            line.setPosition(QPointF(0, height));
+            height += line.height();
+        }
+        textLayout->endLayout();
+
+        layout->blockTops.push_back(y);
+        layout->blocks.push_back(std::move(textLayout));
+        y += qCeil(height) + PARAGRAPH_SPACING;
+        // 粗略估计字形与行数据的开销
+        layout->bytes += block.text.size() * 24;
+    }
+
+    if (text->blocks.isEmpty()) {
+        y += QFontMetrics(body).lineSpacing();  // 空页提示
+    }
+
+    layout->highlights.resize(layout->blocks.size());
+    layout->height = y + PAGE_MARGIN;
+    m_layoutCache.insert(pageNumber, layout, 1);
+    return layout;
+}
+
+void PDFReflowView::updateHighlights(PageLayout* layout) {
+    if (layout->highlightGeneration == m_highlightGeneration) {
+        return;
+    }
+    layout->highlightGeneration = m_highlightGeneration;
+
+    QTextCharFormat format;
+    format.setBackground(QColor(255, 255, 0, 100));
+
+    for (size_t i = 0; i < layout->blocks.size(); ++i) {
+        QList<QTextLayout::FormatRange>& ranges = layout->highlights[i];
+        ranges.clear();
+        if (m_highlightTerm.isEmpty()) {
+            continue;
+        }
+
+        const QString& text = layout->blocks[i]->text();
+        for (qsizetype pos =
+                 text.indexOf(m_highlightTerm, 0, m_highlightSensitivity);
+             pos >= 0; pos = text.indexOf(m_highlightTerm,
+                                          pos + m_highlightTerm.size(),
+                                          m_highlightSensitivity)) {
+            QTextLayout::FormatRange range;
+            range.start = static_cast<int>(pos);
+            range.length = static_cast<int>(m_highlightTerm.size());
+            range.format = format;
+            ranges.append(range);
+        }
+    }
+}
+
+void PDFReflowView::updateVisiblePages() {
+    if (!m_document || m_pageCount == 0) {
+        viewport()->update();
+        return;
+    }
+
+    // 实测高度替换估算值后可见范围会变化，最多迭代几次即可收敛
+    for (int pass = 0; pass < 3; ++pass) {
+        const Anchor anchor = currentAnchor();
+        const int top = verticalScrollBar()->value();
+        const int first = pageAt(top);
+        const int last = pageAt(top + viewport()->height());
+
+        bool heightsChanged = false;
+        for (int page = first; page <= last; ++page) {
+            PageLayout* layout = layoutFor(page);
+            if (!layout) {
+                requestText(page);
+                continue;
+            }
+            if (m_heights[page] != layout->height) {
+                m_heights[page] = layout->height;
+                heightsChanged = true;
+            }
+            m_measured[page] = 1;
+        }
+
+        if (!heightsChanged) {
+            // 预取前后几页，滚动时文本已就绪
+            for (int page = qMax(0, first - PREFETCH_PAGES);
+                 page <= qMin(m_pageCount - 1, last + PREFETCH_PAGES);
+                 ++page) {
+                requestText(page);
+            }
+            break;
+        }
+
+        rebuildOffsets();
+        updateScrollBar();
+        restoreAnchor(anchor);
+    }
+
+    updateCurrentPage();
+    viewport()->update();
+}
+
+void PDFReflowView::invalidateLayouts(double heightRatio) {
+    const Anchor anchor = currentAnchor();
+
+    // 行宽变窄时行数按比例增加
+    const int newWidth = textWidth();
+    if (m_layoutWidth > 0 && newWidth > 0) {
+        heightRatio *= static_cast<double>(m_layoutWidth) / newWidth;
+    }
+    m_layoutWidth = newWidth;
+
+    // 已知高度按比例缩放，只有可见页面会被真正重排
+    m_layoutCache.clear();
+    for (int page = 0; page < m_pageCount; ++page) {
+        m_heights[page] = qMax(PAGE_HEADER_HEIGHT + PAGE_MARGIN,
+                               qRound(m_heights[page] * heightRatio));
+        m_measured[page] = 0;
+    }
+
+    rebuildOffsets();
+    updateScrollBar();
+    restoreAnchor(anchor);
+    updateVisiblePages();
+}
+
+void PDFReflowView::rebuildOffsets() {
+    m_offsets.resize(m_pageCount + 1);
+    qint64 offset = 0;
+    for (int page = 0; page < m_pageCount; ++page) {
+        m_offsets[page] = offset;
+        offset += m_heights[page];
+    }
+    m_offsets[m_pageCount] = offset;
+}
+
+void PDFReflowView::updateScrollBar() {
+    const qint64 total = m_offsets.empty() ? 0 : m_offsets.back();
+    const int pageStep = viewport()->height();
+
+    const qint64 maximum = qBound<qint64>(0, total - pageStep,
+                                          std::numeric_limits<int>::max());
+
+    m_updatingScrollBar = true;
+    QScrollBar* bar = verticalScrollBar();
+    bar->setRange(0, static_cast<int>(maximum));
+    bar->setPageStep(pageStep);
+    bar->setSingleStep(QFontMetrics(bodyFont()).lineSpacing() * 3);
+    m_updatingScrollBar = false;
+}
+
+int PDFReflowView::pageAt(int y) const {
+    if (m_pageCount == 0) {
+        return 0;
+    }
+    auto it = std::upper_bound(m_offsets.begin(), m_offsets.end(),
+                               static_cast<qint64>(y));
+    const int page = static_cast<int>(it - m_offsets.begin()) - 1;
+    return qBound(0, page, m_pageCount - 1);
+}
+
+int PDFReflowView::estimatedPageHeight() const {
+    // 约 30 行正文：文本到达前用作占位高度
+    return PAGE_HEADER_HEIGHT + PAGE_MARGIN +
+           QFontMetrics(bodyFont()).lineSpacing() * 30;
+}
+
+PDFReflowView::Anchor PDFReflowView::currentAnchor() const {
+    Anchor anchor;
+    if (m_pageCount == 0) {
+        return anchor;
+    }
+
+    const int top = verticalScrollBar()->value();
+    anchor.page = pageAt(top);
+    const int height = m_heights[anchor.page];
+    if (height > 0) {
+        anchor.fraction =
+            static_cast<double>(top - m_offsets[anchor.page]) / height;
+    }
+    return anchor;
+}
+
+void PDFReflowView::restoreAnchor(const Anchor& anchor) {
+    if (anchor.page >= m_pageCount) {
+        return;
+    }
+
+    const qint64 value =
+        m_offsets[anchor.page] +
+        static_cast<qint64>(std::lround(anchor.fraction *
+                                        m_heights[anchor.page]));
+    m_updatingScrollBar = true;
+    verticalScrollBar()->setValue(static_cast<int>(value));
+    m_updatingScrollBar = false;
+}
+
+void PDFReflowView::updateCurrentPage() {
+    if (m_pageCount == 0) {
+        return;
+    }
+
+    // 以视口上方三分之一处所在的页面为当前页
+    const int page =
+        pageAt(verticalScrollBar()->value() + viewport()->height() / 3);
+    if (page != m_currentPage) {
+        m_currentPage = page;
+        emit currentPageChanged(page);
+    }
+}
+
+void PDFReflowView::paintEvent(QPaintEvent* event) {
+    QPainter painter(viewport());
+    if (!m_document || m_pageCount == 0) {
+        return;
+    }
+
+    const int top = verticalScrollBar()->value();
+    const QRect clip = event->rect();
+    const int width = textWidth();
+    const int left = (viewport()->width() - width) / 2;
+
+    const QColor textColor = palette().color(QPalette::WindowText);
+    QColor mutedColor = textColor;
+    mutedColor.setAlphaF(0.45);
+
+    for (int page = pageAt(top + clip.top()); page < m_pageCount; ++page) {
+        const int pageTop = static_cast<int>(m_offsets[page] - top);
+        if (pageTop > clip.bottom()) {
+            break;
+        }
+
+        // 页眉：页码与分隔线
+        painter.setFont(font());
+        painter.setPen(mutedColor);
+        const QRect headerRect(left, pageTop, width, PAGE_HEADER_HEIGHT);
+        painter.drawText(headerRect, Qt::AlignLeft | Qt::AlignVCenter,
+                         QString("第 %1 页").arg(page + 1));
+        painter.drawLine(headerRect.bottomLeft(), headerRect.bottomRight());
+
+        const QRect bodyRect(left, pageTop + PAGE_HEADER_HEIGHT, width,
+                             m_heights[page] - PAGE_HEADER_HEIGHT);
+        PageLayout* layout = m_layoutCache.object(page);
+        if (!layout) {
+            painter.drawText(bodyRect, Qt::AlignHCenter | Qt::AlignTop,
+                             "正在提取文本…");
+            continue;
+        }
+        if (layout->blocks.empty()) {
+            painter.drawText(bodyRect, Qt::AlignHCenter | Qt::AlignTop,
+                             "本页没有可提取的文本");
+            continue;
+        }
+
+        updateHighlights(layout);
+        painter.setPen(textColor);
+        for (size_t i = 0; i < layout->blocks.size(); ++i) {
+            layout->blocks[i]->draw(
+                &painter, QPointF(left, pageTop + layout->blockTops[i]),
+                layout->highlights[i]);
+        }
+    }
+}
+
+void PDFReflowView::resizeEvent(QResizeEvent* event) {
+    QAbstractScrollArea::resizeEvent(event);
+
+    if (textWidth() != m_layoutWidth) {
+        invalidateLayouts(1.0);
+    } else {
+        updateScrollBar();
+        updateVisiblePages();
+    }
+}
+
+void PDFReflowView::scrollContentsBy(int dx, int dy) {
+    Q_UNUSED(dx);
+    Q_UNUSED(dy);
+    if (m_updatingScrollBar) {
+        return;  // 内部调整滚动位置，调用方负责刷新
+    }
+    updateVisiblePages();
+}
+
+void PDFReflowView::changeEvent(QEvent* event) {
+    QAbstractScrollArea::changeEvent(event);
+
+    if (event->type() == QEvent::FontChange) {
+        invalidateLayouts(1.0);
+    } else if (event->type() == QEvent::PaletteChange) {
+        viewport()->update();
+    }
+}
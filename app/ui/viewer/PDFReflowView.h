@@ -0,0 +1,151 @@
+#pragma once
+
+#include <poppler/qt6/poppler-qt6.h>
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QFont>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QTextLayout>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief 文本重排阅读视图
+ *
+ * 不渲染任何页面位图，而是把文本层按字形几何重新组织为段落和标题，
+ * 以当前字体排版为一条可滚动的文本流。适用于低内存会话：
+ * - 页面文本在后台线程提取，按字节数计入有上限的缓存，逐出后按需重新提取
+ * - 只为可见页面创建 QTextLayout，其余页面只保留一个高度值（估算或实测）
+ * - 字号变化时按比例缩放已知高度并只重排可见页面，因此切换是即时的
+ *
+ * 整个视图的内存占用与文档页数基本无关（每页仅几个字节的高度信息）。
+ */
+class PDFReflowView : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit PDFReflowView(QWidget* parent = nullptr);
+    ~PDFReflowView() override;
+
+    void setDocument(std::shared_ptr<Poppler::Document> document);
+    void clearDocument();
+
+    // 相对于控件默认字号的缩放比例
+    void setFontScale(double scale);
+    double fontScale() const { return m_fontScale; }
+    // 行宽上限恰好占满视口宽度时的缩放比例，供适应页面/宽度使用
+    double fitWidthScale() const;
+
+    // 搜索高亮，空字符串表示清除
+    void setHighlightTerm(
+        const QString& term,
+        Qt::CaseSensitivity sensitivity = Qt::CaseInsensitive);
+    void clearHighlight() { setHighlightTerm(QString()); }
+
+    void scrollToPage(int pageNumber);
+    int currentPage() const { return m_currentPage; }
+
+    // 当前缓存的文本与排版占用的近似字节数
+    qint64 memoryUsage() const;
+
+signals:
+    void currentPageChanged(int pageNumber);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void changeEvent(QEvent* event) override;
+
+private:
+    // 从文本层恢复出的一个段落或标题
+    struct TextBlock {
+        QString text;
+        bool heading = false;
+    };
+
+    struct PageText {
+        QList<TextBlock> blocks;
+        qint64 bytes = 0;
+    };
+
+    // 一页的排版结果，仅为可见页面保留
+    struct PageLayout {
+        std::vector<std::unique_ptr<QTextLayout>> blocks;
+        std::vector<int> blockTops;
+        std::vector<QList<QTextLayout::FormatRange>> highlights;
+        int highlightGeneration = -1;
+        int height = 0;
+        qint64 bytes = 0;
+    };
+
+    // 工作线程：提取一页文本并按字形几何分段
+    static PageText extractPage(Poppler::Document* document, int pageNumber);
+
+    void resetPages();
+    void requestText(int pageNumber);
+    void onTextExtracted(int pageNumber, int generation, PageText text);
+
+    PageLayout* layoutFor(int pageNumber);
+    void updateHighlights(PageLayout* layout);
+    QFont bodyFont() const;
+    QFont headingFont() const;
+    int textWidth() const;
+
+    // 可见区域：补齐排版、修正高度、请求缺失文本
+    void updateVisiblePages();
+    void invalidateLayouts(double heightRatio);
+    void rebuildOffsets();
+    void updateScrollBar();
+    int pageAt(int y) const;
+    int estimatedPageHeight() const;
+
+    // 滚动锚点：页码 + 页内相对位置，在高度变化前后保持阅读位置
+    struct Anchor {
+        int page = 0;
+        double fraction = 0.0;
+    };
+    Anchor currentAnchor() const;
+    void restoreAnchor(const Anchor& anchor);
+    void updateCurrentPage();
+
+    std::shared_ptr<Poppler::Document> m_document;
+    int m_pageCount = 0;
+
+    std::vector<int> m_heights;      // 每页高度（像素）
+    std::vector<quint8> m_measured;  // 高度是否来自实际排版
+    std::vector<qint64> m_offsets;   // 每页顶部的纵向偏移，末尾为总高度
+
+    QCache<int, PageText> m_textCache;
+    QCache<int, PageLayout> m_layoutCache;
+    QSet<int> m_pending;
+
+    QThreadPool* m_extractPool;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+    int m_generation = 0;
+
+    double m_fontScale = 1.0;
+    int m_layoutWidth = 0;
+    QString m_highlightTerm;
+    Qt::CaseSensitivity m_highlightSensitivity = Qt::CaseInsensitive;
+    int m_highlightGeneration = 0;
+
+    int m_currentPage = 0;
+    bool m_updatingScrollBar = false;
+
+    static constexpr qint64 TEXT_CACHE_BYTES = 2 * 1024 * 1024;
+    static constexpr int LAYOUT_CACHE_PAGES = 12;
+    static constexpr int PREFETCH_PAGES = 2;
+    static constexpr int PAGE_MARGIN = 32;
+    static constexpr int PAGE_HEADER_HEIGHT = 28;
+    static constexpr int PARAGRAPH_SPACING = 10;
+    static constexpr int MAX_TEXT_WIDTH_EM = 40;
+    static constexpr double MIN_FONT_SCALE = 0.5;
+    static constexpr double MAX_FONT_SCALE = 4.0;
+    static constexpr double HEADING_HEIGHT_RATIO = 1.25;
+    static constexpr double PARAGRAPH_GAP_RATIO = 0.8;
+};
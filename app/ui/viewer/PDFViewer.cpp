@@ -4,6 +4,7 @@
 #include <QComboBox>
 #include <QDateTime>
 #include <QDebug>
+#include <QFutureWatcher>
 #include <QGesture>
 #include <QGestureEvent>
 #include <QGraphicsOpacityEffect>
@@ -24,14 +25,17 @@
 #include <QSplitter>
 #include <QStackedWidget>
 #include <QSwipeGesture>
+#include <QThreadPool>
 #include <QTouchEvent>
 #include <QWheelEvent>
+#include <QtConcurrent/QtConcurrent>
 #include <QtCore>
 #include <QtGlobal>
 #include <QtWidgets>
 #include <memory>
 #include <stdexcept>
 #include "managers/StyleManager.h"
+#include "utils/LoggingMacros.h"
 
 // PDFPageWidget Implementation
 PDFPageWidget::PDFPageWidget(QWidget* parent)
@@ -46,6 +50,8 @@ PDFPageWidget::PDFPageWidget(QWidget* parent)
     setAlignment(Qt::AlignCenter);
     setMinimumSize(200, 200);
     setObjectName("pdfPage");
+    // 样式表只让页面透明，文字颜色直接取调色板，切换主题无需重新 polish
+    setProperty(StyleManager::PALETTE_INDEPENDENT_PROPERTY, true);
 
     // Enable gesture support
     grabGesture(Qt::PinchGesture);
@@ -55,24 +61,8 @@ PDFPageWidget::PDFPageWidget(QWidget* parent)
     // Enable touch events
     setAttribute(Qt::WA_AcceptTouchEvents, true);
 
-    // 设置现代化的页面样式 (仅在非测试环境中)
-    try {
-        setStyleSheet(QString(R"(
-            QLabel#pdfPage {
-                background-color: white;
-                border: 1px solid %1;
-                border-radius: 8px;
-                margin: 12px;
-                padding: 8px;
-            }
-        )")
-                          .arg(STYLE.borderColor().name()));
-    } catch (...) {
-        // 在测试环境中忽略样式错误
-        setStyleSheet(
-            "QLabel#pdfPage { background-color: white; border: 1px solid gray; "
-            "}");
-    }
+    // 页面的纸张与边框在 paintEvent 中绘制，不为每个页面设置独立样式表：
+    // 切换主题时页面控件无需重新解析样式，只需重绘可见页面
 
     setText("No PDF loaded");
 
@@ -85,8 +75,11 @@ PDFPageWidget::PDFPageWidget(QWidget* parent)
     setGraphicsEffect(shadowEffect);
 }
 
+PDFPageWidget::~PDFPageWidget() { cancelRefine(); }
+
 void PDFPageWidget::setPage(Poppler::Page* page, double scaleFactor,
                             int rotation) {
+    cancelRefine();
     currentPage = page;
     currentScaleFactor = scaleFactor;
     currentRotation = rotation;
@@ -95,6 +88,7 @@ void PDFPageWidget::setPage(Poppler::Page* page, double scaleFactor,
 
 void PDFPageWidget::setScaleFactor(double factor) {
     if (factor != currentScaleFactor) {
+        cancelRefine();
         currentScaleFactor = factor;
         renderPage();
         emit scaleChanged(factor);
@@ -128,12 +122,118 @@ void PDFPageWidget::setRotation(int degrees) {
     // 确保旋转角度是90度的倍数
     degrees = ((degrees % 360) + 360) % 360;
     if (degrees != currentRotation) {
+        cancelRefine();
         currentRotation = degrees;
         renderPage();
     }
 }
 
 void PDFPageWidget::renderPage() {
+    renderPage(RenderCostModel::Interaction::Visible);
+}
+
+void PDFPageWidget::startRefine(std::shared_ptr<Poppler::Document> document,
+                                QThreadPool* pool) {
+    if (!document || !pool || m_renderedPageNumber < 0) {
+        return;
+    }
+    cancelRefine();
+
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_refineCancelled = cancelled;
+
+    // 工作线程不访问控件，所需参数在这里按值取出
+    const void* documentKey = m_documentKey;
+    const int pageNumber = m_renderedPageNumber;
+    const double scaleFactor = currentScaleFactor;
+    const int rotation = currentRotation;
+    const double devicePixelRatio = devicePixelRatioF();
+
+    auto* watcher = new QFutureWatcher<RefineResult>(this);
+    connect(watcher, &QFutureWatcher<RefineResult>::finished, this,
+            [this, watcher, cancelled]() {
+                watcher->deleteLater();
+                if (m_refineCancelled == cancelled) {
+                    m_refineCancelled.reset();
+                }
+                if (cancelled->load() ||
+                    watcher->future().resultCount() == 0) {
+                    return;
+                }
+                onRefineFinished(watcher->result());
+            });
+    watcher->setFuture(QtConcurrent::run(
+        pool, [document, cancelled, documentKey, pageNumber, scaleFactor,
+               rotation, devicePixelRatio]() {
+            RefineResult result;
+            result.pageNumber = pageNumber;
+            result.scaleFactor = scaleFactor;
+            result.rotation = rotation;
+            // 排队期间页面可能已滚出视口
+            if (cancelled->load()) {
+                return result;
+            }
+
+            std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+            if (!page) {
+                return result;
+            }
+
+            // 理想 DPI 对应页面在屏幕上的尺寸 × devicePixelRatio，
+            // 位图不会超过这一尺寸
+            const double desiredDpi = 72.0 * scaleFactor * devicePixelRatio;
+            RenderCostModel& costModel = RenderCostModel::instance();
+            const RenderCostModel::Decision decision = costModel.chooseDpi(
+                documentKey, pageNumber, page->pageSizeF(), desiredDpi,
+                RenderCostModel::Interaction::Refine);
+            if (cancelled->load()) {
+                return result;
+            }
+
+            Poppler::Page* rawPage = page.get();
+            result.image = RenderBroker::instance().render(
+                documentKey, pageNumber, decision.dpi, rotation,
+                [rawPage, documentKey, pageNumber, rotation,
+                 &costModel](double dpi) {
+                    QElapsedTimer renderTimer;
+                    renderTimer.start();
+                    QImage rendered = rawPage->renderToImage(
+                        dpi, dpi, -1, -1, -1, -1,
+                        static_cast<Poppler::Page::Rotation>(rotation / 90));
+                    if (!rendered.isNull()) {
+                        costModel.recordRender(
+                            documentKey, pageNumber, rendered.size(),
+                            renderTimer.nsecsElapsed() / 1e6);
+                    }
+                    return rendered;
+                });
+            result.pixelRatio = devicePixelRatio * decision.dpi / desiredDpi;
+            result.capped = decision.capped;
+            return result;
+        }));
+}
+
+void PDFPageWidget::cancelRefine() {
+    if (m_refineCancelled) {
+        m_refineCancelled->store(true);
+        m_refineCancelled.reset();
+    }
+}
+
+void PDFPageWidget::onRefineFinished(const RefineResult& result) {
+    // 渲染期间页面已换页、缩放或旋转，结果已过时
+    if (result.image.isNull() || result.pageNumber != m_renderedPageNumber ||
+        qAbs(result.scaleFactor - currentScaleFactor) > 0.001 ||
+        result.rotation != currentRotation) {
+        return;
+    }
+
+    // 补充渲染仍受限时（如预算不足）不再重复请求
+    m_renderCapped = result.capped;
+    showRenderedImage(result.image, result.pixelRatio);
+}
+
+void PDFPageWidget::renderPage(RenderCostModel::Interaction interaction) {
     if (!currentPage) {
         setText("No page to render");
         return;
@@ -143,36 +243,46 @@ void PDFPageWidget::renderPage() {
         // Enhanced rendering with optimized DPI calculation
         double devicePixelRatio = devicePixelRatioF();
         double baseDpi = 72.0 * currentScaleFactor;
-        double optimizedDpi = baseDpi * devicePixelRatio;
-
-        // Limit DPI to prevent excessive memory usage
-        optimizedDpi = qMin(optimizedDpi, 300.0);
+        double desiredDpi = baseDpi * devicePixelRatio;
 
+        // 在当前交互的延迟预算内取最高 DPI；理想 DPI 对应页面在屏幕上的
+        // 尺寸 × devicePixelRatio，位图不会超过这一尺寸
+        const int pageNumber = currentPage->index();
         QSizeF pageSize = currentPage->pageSizeF();
-
-        // Note: Document configuration would be done at document level
-        // High-quality rendering is achieved through optimized DPI and render
-        // hints
-
-        // 渲染页面为图像，包含旋转和优化设置
-        QImage image = currentPage->renderToImage(
-            optimizedDpi, optimizedDpi, -1, -1, -1, -1,
-            static_cast<Poppler::Page::Rotation>(currentRotation / 90));
+        RenderCostModel& costModel = RenderCostModel::instance();
+        const RenderCostModel::Decision decision = costModel.chooseDpi(
+            m_documentKey, pageNumber, pageSize, desiredDpi, interaction);
+        const double renderDpi = decision.dpi;
+
+        // 渲染页面为图像，包含旋转和优化设置；同一页面的并发请求经代理合并
+        Poppler::Page* page = currentPage;
+        const int rotation = currentRotation;
+        QImage image = RenderBroker::instance().render(
+            m_documentKey, pageNumber, renderDpi, rotation,
+            [this, page, pageNumber, rotation, &costModel](double dpi) {
+                QElapsedTimer renderTimer;
+                renderTimer.start();
+                QImage rendered = page->renderToImage(
+                    dpi, dpi, -1, -1, -1, -1,
+                    static_cast<Poppler::Page::Rotation>(rotation / 90));
+                if (!rendered.isNull()) {
+                    costModel.recordRender(m_documentKey, pageNumber,
+                                           rendered.size(),
+                                           renderTimer.nsecsElapsed() / 1e6);
+                }
+                return rendered;
+            });
         if (image.isNull()) {
             setText("Failed to render page");
             return;
         }
 
-        // Apply device pixel ratio for high-DPI displays
-        renderedPixmap = QPixmap::fromImage(image);
-        renderedPixmap.setDevicePixelRatio(devicePixelRatio);
-
-        // 保存原始渲染的pixmap用于快速缩放
-        originalPixmap = renderedPixmap;
-        originalScaleFactor = currentScaleFactor;
-
-        setPixmap(renderedPixmap);
-        setFixedSize(renderedPixmap.size() / renderedPixmap.devicePixelRatio());
+        m_renderedPageNumber = pageNumber;
+        m_renderCapped = decision.capped;
+        showRenderedImage(image, devicePixelRatio * renderDpi / desiredDpi);
+        if (decision.capped) {
+            emit renderCapped();
+        }
 
     } catch (const std::exception& e) {
         setText(QString("渲染错误: %1").arg(e.what()));
@@ -183,6 +293,19 @@ void PDFPageWidget::renderPage() {
     }
 }
 
+void PDFPageWidget::showRenderedImage(const QImage& image, double pixelRatio) {
+    // 受限时位图按比例放大显示，保持页面的逻辑尺寸不变
+    renderedPixmap = QPixmap::fromImage(image);
+    renderedPixmap.setDevicePixelRatio(pixelRatio);
+
+    // 保存原始渲染的pixmap用于快速缩放
+    originalPixmap = renderedPixmap;
+    originalScaleFactor = currentScaleFactor;
+
+    setPixmap(renderedPixmap);
+    setFixedSize(renderedPixmap.size() / renderedPixmap.devicePixelRatio());
+}
+
 void PDFPageWidget::paintEvent(QPaintEvent* event) {
     QPainter painter(this);
 
@@ -191,12 +314,12 @@ void PDFPageWidget::paintEvent(QPaintEvent* event) {
                            QPainter::SmoothPixmapTransform |
                            QPainter::TextAntialiasing);
 
-    // 先绘制边框
-    if (!renderedPixmap.isNull()) {
-        QRect pixmapRect = rect();
-        painter.setPen(QPen(QColor(0, 0, 0, 30), 1));
-        painter.drawRect(pixmapRect.adjusted(0, 0, -1, -1));
-    }
+    // 先绘制纸张背景和边框，边框颜色在绘制时从当前主题读取
+    const QRectF pageRect = QRectF(rect()).adjusted(0.5, 0.5, -0.5, -0.5);
+    painter.setPen(QPen(STYLE.borderColor(), 1));
+    painter.setBrush(Qt::white);
+    painter.drawRoundedRect(pageRect, PAGE_CORNER_RADIUS, PAGE_CORNER_RADIUS);
+    painter.setBrush(Qt::NoBrush);
 
     // Draw search highlights
     if (!m_searchResults.isEmpty()) {
@@ -544,6 +667,17 @@ PDFViewer::PDFViewer(QWidget* parent, bool enableStyling)
     scrollTimer->setSingleShot(true);
     scrollTimer->setInterval(100);  // 100ms滚动防抖
 
+    refineTimer = new QTimer(this);
+    refineTimer->setSingleShot(true);
+    refineTimer->setInterval(REFINE_DELAY_MS);
+    connect(refineTimer, &QTimer::timeout, this,
+            &PDFViewer::refineCappedPages);
+
+    // 补充渲染耗时可达上百毫秒，放在工作线程中进行；保留部分核心给
+    // 预渲染和缩略图
+    refinePool = new QThreadPool(this);
+    refinePool->setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+
     // 初始化页面缓存
     maxCacheSize = 20;  // 最多缓存20页
 
@@ -565,15 +699,19 @@ void PDFViewer::setupUI() {
     mainLayout->setContentsMargins(0, 0, 0, 0);
 
     // 应用样式 (仅在非测试环境中)
+    // 查看器本身只使用调色板；样式表只设置在工具栏上，
+    // 避免主题切换时所有页面控件随祖先样式表一起重新polish
     if (m_enableStyling) {
-        setStyleSheet(STYLE.getApplicationStyleSheet());
+        setFont(STYLE.defaultFont());
+        STYLE.applyPalette(this);
     }
 
     // 创建工具栏
     toolbar = new QWidget(this);
     toolbar->setObjectName("toolbar");
     if (m_enableStyling) {
-        toolbar->setStyleSheet(STYLE.getToolbarStyleSheet());
+        toolbar->setStyleSheet(STYLE.getApplicationStyleSheet() +
+                               STYLE.getToolbarStyleSheet());
         toolbarLayout = new QHBoxLayout(toolbar);
         toolbarLayout->setContentsMargins(STYLE.margin(), STYLE.spacing(),
                                           STYLE.margin(), STYLE.spacing());
@@ -707,6 +845,8 @@ void PDFViewer::setupUI() {
                               static_cast<int>(PDFViewMode::SinglePage));
     viewModeComboBox->addItem("连续滚动",
                               static_cast<int>(PDFViewMode::ContinuousScroll));
+    viewModeComboBox->addItem("文本重排",
+                              static_cast<int>(PDFViewMode::Reflow));
     viewModeComboBox->setCurrentIndex(0);  // 默认单页视图
 
     viewLayout->addWidget(viewModeComboBox);
@@ -743,12 +883,6 @@ void PDFViewer::setupViewModes() {
     singlePageScrollArea->setWidgetResizable(true);
     singlePageScrollArea->setAlignment(Qt::AlignCenter);
 
-    // 应用样式
-    if (m_enableStyling) {
-        singlePageScrollArea->setStyleSheet(STYLE.getPDFViewerStyleSheet() +
-                                            STYLE.getScrollBarStyleSheet());
-    }
-
     // 创建连续滚动视图
     continuousScrollArea = new QScrollArea(this);
     // 便于调试
@@ -770,18 +904,32 @@ void PDFViewer::setupViewModes() {
     continuousScrollArea->setWidget(continuousWidget);
     continuousScrollArea->setWidgetResizable(true);
 
+    // 创建文本重排视图
+    reflowView = new PDFReflowView(this);
+
     // 应用样式
     if (m_enableStyling) {
-        continuousScrollArea->setStyleSheet(STYLE.getPDFViewerStyleSheet() +
-                                            STYLE.getScrollBarStyleSheet());
+        applyViewAreaTheme();
+
+        // 滚动条样式表只引用调色板颜色，创建时设置一次；
+        // 滚动条没有子控件，直接设置在其上开销固定
+        const QString scrollBarStyle = STYLE.getScrollBarStyleSheet();
+        const QList<QAbstractScrollArea*> areas = {
+            singlePageScrollArea, continuousScrollArea, reflowView};
+        for (QAbstractScrollArea* area : areas) {
+            area->verticalScrollBar()->setStyleSheet(scrollBarStyle);
+            area->horizontalScrollBar()->setStyleSheet(scrollBarStyle);
+        }
     }
 
     // 添加到堆叠组件
     viewStack->addWidget(singlePageScrollArea);  // index 0
     viewStack->addWidget(continuousScrollArea);  // index 1
+    viewStack->addWidget(reflowView);            // index 2
 
-    // 为连续滚动区域安装事件过滤器以处理Ctrl+滚轮缩放
+    // 为连续滚动区域和重排视图安装事件过滤器以处理Ctrl+滚轮缩放
     continuousScrollArea->installEventFilter(this);
+    reflowView->installEventFilter(this);
 
     // 默认显示单页视图
     viewStack->setCurrentIndex(0);
@@ -854,11 +1002,27 @@ void PDFViewer::setupConnections() {
     // 页面组件信号
     connect(singlePageWidget, &PDFPageWidget::scaleChanged, this,
             &PDFViewer::onScaleChanged);
+    connect(singlePageWidget, &PDFPageWidget::renderCapped, this,
+            [this]() { scheduleRefine(singlePageWidget); });
+
+    // 重排视图滚动时同步当前页，不触发跳转
+    connect(reflowView, &PDFReflowView::currentPageChanged, this,
+            [this](int pageNumber) {
+                if (currentViewMode != PDFViewMode::Reflow ||
+                    pageNumber == currentPageNumber) {
+                    return;
+                }
+                currentPageNumber = pageNumber;
+                pageNumberSpinBox->blockSignals(true);
+                pageNumberSpinBox->setValue(pageNumber + 1);
+                pageNumberSpinBox->blockSignals(false);
+                updateNavigationButtons();
+                emit pageChanged(pageNumber);
+            });
 
-    // 监听 StyleManager 的样式表应用信号，确保在主题样式表应用后再更新组件
-    connect(&StyleManager::instance(), &StyleManager::styleSheetApplied, this, [this]() {
-        updateThemeUI();
-    });
+    // 切换主题只替换调色板，样式表不会重新设置，这里据此更新组件
+    connect(&StyleManager::instance(), &StyleManager::themeChanged, this,
+            [this]() { updateThemeUI(); });
 }
 
 void PDFViewer::setupShortcuts() {
@@ -921,7 +1085,7 @@ void PDFViewer::setupShortcuts() {
     QShortcut* showBookmarks = new QShortcut(QKeySequence("Ctrl+B"), this);
 
     // 文档操作快捷键
-    QShortcut* refresh = new QShortcut(QKeySequence("F5"), this);
+    QShortcut* refresh = new QShortcut(QKeySequence("Ctrl+F5"), this);
     QShortcut* properties = new QShortcut(QKeySequence("Alt+Enter"), this);
     QShortcut* selectAll = new QShortcut(QKeySequence("Ctrl+A"), this);
     QShortcut* copyText = new QShortcut(QKeySequence("Ctrl+C"), this);
@@ -1005,6 +1169,9 @@ void PDFViewer::setupShortcuts() {
         emit sidebarToggleRequested();
     });
 
+    connect(presentationMode, &QShortcut::activated, this,
+            &PDFViewer::startPresentation);
+
     // 连接搜索快捷键
     connect(findShortcut, &QShortcut::activated, this, &PDFViewer::showSearch);
 
@@ -1024,14 +1191,33 @@ void PDFViewer::setupShortcuts() {
     });
 }
 
-void PDFViewer::setDocument(std::shared_ptr<Poppler::Document> doc) {
+void PDFViewer::setDocument(std::shared_ptr<Poppler::Document> doc,
+                            DocumentOpenPipeline* pipeline) {
+    // 打开流水线只服务于本次打开，旧文档的流水线不再接收新步骤
+    openPipeline = pipeline;
+
     try {
         // 清理旧文档
         if (document) {
+            stopPresentation();
             clearPageCache();  // 清理缓存
+            RenderCostModel::instance().forgetDocument(document.get());
+
+            const RenderBroker::Statistics renderStats =
+                RenderBroker::instance().statistics();
+            LOG_DEBUG(
+                "PDFViewer: Render broker {} requests, {} renders, {} "
+                "coalesced ({} downscaled)",
+                renderStats.requests, renderStats.renders,
+                renderStats.coalesced, renderStats.downscaled);
         }
+        refineTimer->stop();
+        cappedPages.clear();
+        cancelAllRefines();
 
         document = doc;
+        singlePageWidget->setDocumentKey(document.get());
+        pageMetadata = PageMetadataTable::forDocument(doc);
         currentPageNumber = 0;
         currentRotation = 0;  // 重置旋转
 
@@ -1063,6 +1249,22 @@ void PDFViewer::setDocument(std::shared_ptr<Poppler::Document> doc) {
             // 如果是连续模式，创建所有页面
             if (currentViewMode == PDFViewMode::ContinuousScroll) {
                 createContinuousPages();
+            } else if (currentViewMode == PDFViewMode::Reflow) {
+                reflowView->setDocument(document);
+            }
+
+            // 后台索引阶段开始在工作线程中逐页提取搜索文本，首次搜索无需
+            // 再等待提取
+            if (openPipeline) {
+                QPointer<PDFViewer> viewer(this);
+                openPipeline->addStep(
+                    DocumentOpenPipeline::BackgroundIndexing, [viewer]() {
+                        if (viewer && viewer->document) {
+                            viewer->searchWidget->getSearchModel()
+                                ->prefetchPageTexts(viewer->document);
+                        }
+                        return false;
+                    });
             }
 
             setMessage(QString("文档加载成功，共 %1 页").arg(numPages));
@@ -1079,6 +1281,7 @@ void PDFViewer::setDocument(std::shared_ptr<Poppler::Document> doc) {
             pageNumberSpinBox->setRange(0, 0);
             pageCountLabel->setText("/ 0");
             singlePageWidget->setPage(nullptr);
+            reflowView->clearDocument();
 
             // 清空连续视图
             QLayoutItem* item;
@@ -1103,9 +1306,11 @@ void PDFViewer::setDocument(std::shared_ptr<Poppler::Document> doc) {
     } catch (const std::exception& e) {
         // 文档加载失败，清理状态
         document = nullptr;
+        pageMetadata.reset();
         pageNumberSpinBox->setRange(0, 0);
         pageCountLabel->setText("/ 0");
         singlePageWidget->setPage(nullptr);
+        reflowView->clearDocument();
 
         setMessage(QString("文档加载失败: %1").arg(e.what()));
         qDebug() << "Document loading failed:" << e.what();
@@ -1159,12 +1364,44 @@ bool PDFViewer::goToPageWithValidation(int pageNumber, bool showMessage) {
     emit pageChanged(pageNumber);
 
     if (showMessage) {
-        setMessage(QString("跳转到第 %1 页").arg(pageNumber + 1));
+        // 文档定义了页面标签（如罗马数字前言页）时一并显示
+        QString pageLabel =
+            pageMetadata ? pageMetadata->label(pageNumber) : QString();
+        if (!pageLabel.isEmpty() &&
+            pageLabel != QString::number(pageNumber + 1)) {
+            setMessage(QString("跳转到第 %1 页 (%2)")
+                           .arg(pageNumber + 1)
+                           .arg(pageLabel));
+        } else {
+            setMessage(QString("跳转到第 %1 页").arg(pageNumber + 1));
+        }
     }
 
     return true;
 }
 
+QSizeF PDFViewer::pageSizeAt(int pageNumber) const {
+    if (pageMetadata && pageMetadata->hasGeometry(pageNumber)) {
+        return pageMetadata->pageSize(pageNumber);
+    }
+
+    if (!document) {
+        return QSizeF();
+    }
+
+    std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+    return page ? page->pageSizeF() : QSizeF();
+}
+
+QSizeF PDFViewer::placeholderSizeAt(int pageNumber,
+                                    const QSizeF& fallback) const {
+    // 不为占位符创建页面对象；元数据尚未填充的页面使用首页尺寸
+    if (pageMetadata && pageMetadata->hasGeometry(pageNumber)) {
+        return pageMetadata->pageSize(pageNumber);
+    }
+    return fallback;
+}
+
 void PDFViewer::nextPage() {
     if (document && currentPageNumber < document->numPages() - 1) {
         goToPage(currentPageNumber + 1);
@@ -1203,6 +1440,12 @@ void PDFViewer::zoomToFit() {
     if (!document)
         return;
 
+    // 重排视图没有页面几何，按文本栏占满视口宽度换算字号
+    if (currentViewMode == PDFViewMode::Reflow) {
+        setZoomWithType(reflowView->fitWidthScale(), ZoomType::FitPage);
+        return;
+    }
+
     // 获取当前视图的viewport大小
     QScrollArea* currentScrollArea =
         (currentViewMode == PDFViewMode::SinglePage) ? singlePageScrollArea
@@ -1210,9 +1453,8 @@ void PDFViewer::zoomToFit() {
     QSize viewportSize = currentScrollArea->viewport()->size();
 
     if (document->numPages() > 0) {
-        std::unique_ptr<Poppler::Page> page(document->page(currentPageNumber));
-        if (page) {
-            QSizeF pageSize = page->pageSizeF();
+        QSizeF pageSize = pageSizeAt(currentPageNumber);
+        if (!pageSize.isEmpty()) {
             double scaleX = viewportSize.width() / pageSize.width();
             double scaleY = viewportSize.height() / pageSize.height();
             setZoomWithType(qMin(scaleX, scaleY) * 0.9,
@@ -1225,6 +1467,11 @@ void PDFViewer::zoomToWidth() {
     if (!document)
         return;
 
+    if (currentViewMode == PDFViewMode::Reflow) {
+        setZoomWithType(reflowView->fitWidthScale(), ZoomType::FitWidth);
+        return;
+    }
+
     // 获取当前视图的viewport大小
     QScrollArea* currentScrollArea =
         (currentViewMode == PDFViewMode::SinglePage) ? singlePageScrollArea
@@ -1232,9 +1479,8 @@ void PDFViewer::zoomToWidth() {
     QSize viewportSize = currentScrollArea->viewport()->size();
 
     if (document->numPages() > 0) {
-        std::unique_ptr<Poppler::Page> page(document->page(currentPageNumber));
-        if (page) {
-            QSizeF pageSize = page->pageSizeF();
+        QSizeF pageSize = pageSizeAt(currentPageNumber);
+        if (!pageSize.isEmpty()) {
             double scale = viewportSize.width() / pageSize.width();
             setZoomWithType(scale * 0.95, ZoomType::FitWidth);  // 留一些边距
         }
@@ -1278,6 +1524,10 @@ void PDFViewer::updatePageDisplay() {
     } else if (currentViewMode == PDFViewMode::ContinuousScroll) {
         // 连续滚动模式下需要滚动到对应的页面位置
         scrollToPageInContinuousView(currentPageNumber);
+    } else if (currentViewMode == PDFViewMode::Reflow) {
+        if (reflowView->currentPage() != currentPageNumber) {
+            reflowView->scrollToPage(currentPageNumber);
+        }
     }
 }
 
@@ -1291,16 +1541,11 @@ void PDFViewer::updateContinuousView() {
 
     // 更新占位符尺寸
     QSizeF placeholderSize(100, 140);  // 默认A4比例
-    std::unique_ptr<Poppler::Page> firstPage(document->page(0));
-    if (firstPage) {
-        placeholderSize = firstPage->pageSizeF();
+    QSizeF firstPageSize = pageSizeAt(0);
+    if (!firstPageSize.isEmpty()) {
+        placeholderSize = firstPageSize;
     }
 
-    int placeholderWidth =
-        static_cast<int>(placeholderSize.width() * currentZoomFactor);
-    int placeholderHeight =
-        static_cast<int>(placeholderSize.height() * currentZoomFactor);
-
     // 更新所有页面的占位符尺寸
     for (int i = 0; i < continuousLayout->count() - 1; ++i) {
         QLayoutItem* item = continuousLayout->itemAt(i);
@@ -1310,8 +1555,11 @@ void PDFViewer::updateContinuousView() {
             if (pageWidget) {
                 // 只更新占位符尺寸，不立即渲染
                 if (!renderedPages.contains(qMakePair(i, currentZoomFactor))) {
-                    pageWidget->setFixedSize(placeholderWidth,
-                                             placeholderHeight);
+                    QSizeF pageSize = placeholderSizeAt(i, placeholderSize);
+                    pageWidget->setFixedSize(
+                        static_cast<int>(pageSize.width() * currentZoomFactor),
+                        static_cast<int>(pageSize.height() *
+                                         currentZoomFactor));
                 } else {
                     // 已渲染的页面需要重新渲染
                     pageWidget->blockSignals(true);
@@ -1469,11 +1717,18 @@ void PDFViewer::setViewMode(PDFViewMode mode) {
         viewModeComboBox->setCurrentIndex(static_cast<int>(mode));
         viewModeComboBox->blockSignals(false);
 
+        // 离开重排模式时释放提取的文本
+        if (oldMode == PDFViewMode::Reflow) {
+            reflowView->clearDocument();
+        }
+
         // 切换视图
         if (mode == PDFViewMode::SinglePage) {
             switchToSinglePageMode();
-        } else {
+        } else if (mode == PDFViewMode::ContinuousScroll) {
             switchToContinuousMode();
+        } else {
+            switchToReflowMode();
         }
 
         // 恢复状态
@@ -1496,9 +1751,11 @@ void PDFViewer::setViewMode(PDFViewMode mode) {
         }
 
         emit viewModeChanged(mode);
-        setMessage(
-            QString("切换到%1模式")
-                .arg(mode == PDFViewMode::SinglePage ? "单页" : "连续滚动"));
+        const char* modeName = mode == PDFViewMode::SinglePage ? "单页"
+                               : mode == PDFViewMode::ContinuousScroll
+                                   ? "连续滚动"
+                                   : "文本重排";
+        setMessage(QString("切换到%1模式").arg(modeName));
 
     } catch (const std::exception& e) {
         // 恢复到原来的模式
@@ -1524,6 +1781,40 @@ void PDFViewer::switchToContinuousMode() {
     }
 }
 
+void PDFViewer::switchToReflowMode() {
+    viewStack->setCurrentIndex(2);
+
+    // 重排模式不使用任何页面位图，释放已渲染的页面
+    clearPageCache();
+    singlePageWidget->setPage(nullptr);
+    QLayoutItem* item;
+    while ((item = continuousLayout->takeAt(0)) != nullptr) {
+        delete item->widget();
+        delete item;
+    }
+    visiblePageStart = -1;
+    visiblePageEnd = -1;
+    isWidgetReady = false;
+
+    reflowView->setFontScale(currentZoomFactor);
+    reflowView->setDocument(document);
+
+    // 在其他模式下发起的搜索，切换过来后继续高亮
+    const SearchModel* searchModel =
+        searchWidget ? searchWidget->getSearchModel() : nullptr;
+    if (searchModel && searchWidget->isVisible() &&
+        searchWidget->getResultCount() > 0) {
+        const Qt::CaseSensitivity sensitivity =
+            searchModel->getCurrentOptions().caseSensitive
+                ? Qt::CaseSensitive
+                : Qt::CaseInsensitive;
+        reflowView->setHighlightTerm(searchModel->getCurrentQuery(),
+                                     sensitivity);
+    } else {
+        reflowView->clearHighlight();
+    }
+}
+
 void PDFViewer::createContinuousPages() {
     if (!document)
         return;
@@ -1538,48 +1829,86 @@ void PDFViewer::createContinuousPages() {
     // 清空渲染状态
     renderedPages.clear();
 
+    // 布局中的索引即页码，占位页只能从第 0 页起按顺序创建。这里同步创建
+    // 到当前页之后 INITIAL_CONTINUOUS_PAGES 页为止，其余页面在打开流水线
+    // 的导航阶段分批追加。打开文档时当前页为第 0 页，首页出现的时间不随
+    // 文档页数增长；从其他模式切换到靠后的页面时，同步部分随当前页码增长
+    continuousLayout->addStretch();
+    if (appendContinuousPages(currentPageNumber + INITIAL_CONTINUOUS_PAGES)) {
+        if (openPipeline) {
+            QPointer<PDFViewer> viewer(this);
+            openPipeline->addStep(
+                DocumentOpenPipeline::NavigationChrome, [viewer]() {
+                    return viewer && viewer->appendContinuousPages(
+                                         CONTINUOUS_PAGES_PER_STEP);
+                });
+        } else {
+            appendContinuousPages(document->numPages());
+        }
+    }
+
+    // 连接滚动区域的滚动信号以实现虚拟化渲染
+    if (continuousScrollArea->verticalScrollBar()) {
+        connect(continuousScrollArea->verticalScrollBar(),
+                &QScrollBar::valueChanged, this, [this]() {
+                    scrollTimer->start();  // 使用防抖
+                });
+    }
+
+    // 确保滚动条正确初始化
+    continuousScrollArea->verticalScrollBar()->setValue(0);
+
+    // 立即渲染初始可见页面
+    QTimer::singleShot(0, this, [this]() { updateVisiblePages(); });
+}
+
+bool PDFViewer::appendContinuousPages(int count) {
+    // 最后一项是stretch；布局为空说明连续视图已被清空
+    if (!document || currentViewMode != PDFViewMode::ContinuousScroll ||
+        continuousLayout->count() == 0) {
+        return false;
+    }
+
+    const int numPages = document->numPages();
+    const int created = continuousLayout->count() - 1;
+    const int end = qMin(numPages, created + qMax(0, count));
+
     // 获取第一页尺寸用于占位符
     QSizeF placeholderSize(100, 140);  // 默认A4比例
-    std::unique_ptr<Poppler::Page> firstPage(document->page(0));
-    if (firstPage) {
-        placeholderSize = firstPage->pageSizeF();
+    QSizeF firstPageSize = pageSizeAt(0);
+    if (!firstPageSize.isEmpty()) {
+        placeholderSize = firstPageSize;
     }
 
     // 应用缩放后的尺寸
     double scale = currentZoomFactor;
-    int placeholderWidth = static_cast<int>(placeholderSize.width() * scale);
-    int placeholderHeight = static_cast<int>(placeholderSize.height() * scale);
 
-    // 创建所有页面占位符（不立即渲染）
-    for (int i = 0; i < document->numPages(); ++i) {
+    // 创建页面占位符（不立即渲染），插入到stretch之前
+    for (int i = created; i < end; ++i) {
         PDFPageWidget* pageWidget = new PDFPageWidget(continuousWidget);
+        pageWidget->setDocumentKey(document.get());
 
-        // 设置占位符尺寸，但不渲染内容
-        pageWidget->setFixedSize(placeholderWidth, placeholderHeight);
+        // 设置占位符尺寸，但不渲染内容；元数据表已就绪时使用各页实际尺寸
+        QSizeF pageSize = placeholderSizeAt(i, placeholderSize);
+        pageWidget->setFixedSize(static_cast<int>(pageSize.width() * scale),
+                                 static_cast<int>(pageSize.height() * scale));
         pageWidget->setText(QString("第 %1 页").arg(i + 1));  // 显示占位文本
 
-        continuousLayout->addWidget(pageWidget);
+        continuousLayout->insertWidget(i, pageWidget);
 
         // 连接信号
         connect(pageWidget, &PDFPageWidget::scaleChanged, this,
                 &PDFViewer::onScaleChanged);
+        connect(pageWidget, &PDFPageWidget::renderCapped, this,
+                [this, pageWidget]() { scheduleRefine(pageWidget); });
     }
 
-    continuousLayout->addStretch();
-
-    // 连接滚动区域的滚动信号以实现虚拟化渲染
-    if (continuousScrollArea->verticalScrollBar()) {
-        connect(continuousScrollArea->verticalScrollBar(),
-                &QScrollBar::valueChanged, this, [this]() {
-                    scrollTimer->start();  // 使用防抖
-                });
+    // 可见区域已到达此前的末尾时，新占位页可能直接进入视口
+    if (end > created && visiblePageEnd >= created - 1) {
+        scrollTimer->start();
     }
 
-    // 确保滚动条正确初始化
-    continuousScrollArea->verticalScrollBar()->setValue(0);
-
-    // 立即渲染初始可见页面
-    QTimer::singleShot(0, this, [this]() { updateVisiblePages(); });
+    return end < numPages;
 }
 
 void PDFViewer::updateVisiblePages() {
@@ -1643,6 +1972,9 @@ void PDFViewer::updateVisiblePages() {
 
     visiblePageStart = newVisibleStart;
     visiblePageEnd = newVisibleEnd;
+
+    // 已滚出视口的页面不再需要补充渲染
+    cancelHiddenRefines();
     renderVisiblePages();
 }
 
@@ -1705,7 +2037,17 @@ void PDFViewer::scrollToPageInContinuousView(int pageNumber) {
     }
 
     // 确保连续视图布局已经创建
-    if (continuousLayout->count() <= pageNumber) {
+    if (continuousLayout->count() == 0) {
+        return;
+    }
+
+    // 目标页的占位页可能仍在分批创建中：先补齐，待新占位页完成布局后再滚动
+    const int createdPages = continuousLayout->count() - 1;
+    if (createdPages <= pageNumber) {
+        appendContinuousPages(pageNumber + 1 - createdPages);
+        QTimer::singleShot(0, this, [this, pageNumber]() {
+            scrollToPageInContinuousView(pageNumber);
+        });
         return;
     }
 
@@ -1731,6 +2073,66 @@ void PDFViewer::scrollToPageInContinuousView(int pageNumber) {
     updateVisiblePages();
 }
 
+void PDFViewer::scheduleRefine(PDFPageWidget* pageWidget) {
+    if (!cappedPages.contains(pageWidget)) {
+        cappedPages.append(pageWidget);
+    }
+    // 每次受限渲染都重新计时，连续缩放或滚动期间不做补充渲染
+    refineTimer->start();
+}
+
+void PDFViewer::refineCappedPages() {
+    if (!document) {
+        cappedPages.clear();
+        return;
+    }
+
+    // 缩放或滚动仍在进行中，稍后再试
+    if (zoomTimer->isActive() || scrollTimer->isActive()) {
+        refineTimer->start();
+        return;
+    }
+
+    const QList<QPointer<PDFPageWidget>> pending = cappedPages;
+    cappedPages.clear();
+
+    for (const QPointer<PDFPageWidget>& pageWidget : pending) {
+        // 已销毁、已被完整渲染或已滚出视口的页面跳过
+        if (!pageWidget || !pageWidget->isRenderCapped() ||
+            pageWidget->visibleRegion().isEmpty()) {
+            continue;
+        }
+
+        // 在工作线程中渲染，完成后由页面控件替换位图
+        pageWidget->startRefine(document, refinePool);
+        if (!refiningPages.contains(pageWidget)) {
+            refiningPages.append(pageWidget);
+        }
+    }
+}
+
+void PDFViewer::cancelHiddenRefines() {
+    refiningPages.removeIf([](const QPointer<PDFPageWidget>& pageWidget) {
+        if (!pageWidget || !pageWidget->isRefining()) {
+            return true;
+        }
+        if (pageWidget->visibleRegion().isEmpty()) {
+            pageWidget->cancelRefine();
+            return true;
+        }
+        return false;
+    });
+}
+
+void PDFViewer::cancelAllRefines() {
+    for (const QPointer<PDFPageWidget>& pageWidget : refiningPages) {
+        if (pageWidget) {
+            pageWidget->cancelRefine();
+        }
+    }
+    refiningPages.clear();
+}
+
 QPixmap PDFViewer::getCachedPage(int pageNumber, double zoomFactor,
                                  int rotation) {
     auto it = pageCache.find(pageNumber);
@@ -1815,47 +2217,96 @@ void PDFViewer::updateThemeUI() {
         themeToggleBtn->setToolTip("切换到暗色主题 (Ctrl+Shift+T)");
     }
 
-    // 重新应用主界面样式
-    setStyleSheet(STYLE.getApplicationStyleSheet());
+    // 调色板已由 StyleManager 预先构建，直接替换；工具栏与按钮的样式表
+    // 只引用调色板颜色，无需重新设置
+    STYLE.applyPalette(this);
+
+    // 查看区域显式设置了调色板，不随应用调色板变化，需要重新替换
+    applyViewAreaTheme();
+
+    // 页面控件在绘制时读取主题颜色，只需重绘当前可见的页面
+    refreshVisiblePageWidgets();
+}
 
-    // 更新工具栏样式
-    if (toolbar) {
-        toolbar->setStyleSheet(STYLE.getToolbarStyleSheet());
+void PDFViewer::applyViewAreaTheme() {
+    const QList<QAbstractScrollArea*> areas = {
+        singlePageScrollArea, continuousScrollArea, reflowView};
+    for (QAbstractScrollArea* area : areas) {
+        if (area) {
+            STYLE.applyViewerPalette(area->viewport());
+        }
     }
 
-    // 更新所有按钮的样式
-    QString buttonStyle = STYLE.getButtonStyleSheet();
-    if (firstPageBtn) firstPageBtn->setStyleSheet(buttonStyle);
-    if (prevPageBtn) prevPageBtn->setStyleSheet(buttonStyle);
-    if (nextPageBtn) nextPageBtn->setStyleSheet(buttonStyle);
-    if (lastPageBtn) lastPageBtn->setStyleSheet(buttonStyle);
-    if (zoomOutBtn) zoomOutBtn->setStyleSheet(buttonStyle);
-    if (zoomInBtn) zoomInBtn->setStyleSheet(buttonStyle);
-    if (fitWidthBtn) fitWidthBtn->setStyleSheet(buttonStyle);
-    if (fitHeightBtn) fitHeightBtn->setStyleSheet(buttonStyle);
-    if (fitPageBtn) fitPageBtn->setStyleSheet(buttonStyle);
-    if (rotateLeftBtn) rotateLeftBtn->setStyleSheet(buttonStyle);
-    if (rotateRightBtn) rotateRightBtn->setStyleSheet(buttonStyle);
-    if (themeToggleBtn) themeToggleBtn->setStyleSheet(buttonStyle);
-
-    // 更新滚动区域样式
-    QString scrollStyle =
-        STYLE.getPDFViewerStyleSheet() + STYLE.getScrollBarStyleSheet();
-    if (singlePageScrollArea) singlePageScrollArea->setStyleSheet(scrollStyle);
-    if (continuousScrollArea) continuousScrollArea->setStyleSheet(scrollStyle);
-
-    // 递归更新所有子控件的样式，强制重新绘制
-    QList<QWidget*> allWidgets = findChildren<QWidget*>();
-    for (QWidget* widget : allWidgets) {
-        // 取消样式缓存并重新应用
-        widget->style()->unpolish(widget);
-        widget->style()->polish(widget);
-        widget->update();
+    STYLE.applyViewerPalette(continuousWidget);
+}
+
+void PDFViewer::refreshVisiblePageWidgets() {
+    if (currentViewMode != PDFViewMode::ContinuousScroll) {
+        if (singlePageWidget) {
+            singlePageWidget->update();
+        }
+        return;
+    }
+
+    if (!continuousLayout || visiblePageStart < 0) {
+        return;
+    }
+
+    for (int i = visiblePageStart; i <= visiblePageEnd; ++i) {
+        if (i >= continuousLayout->count()) {
+            break;
+        }
+
+        QLayoutItem* item = continuousLayout->itemAt(i);
+        PDFPageWidget* pageWidget =
+            qobject_cast<PDFPageWidget*>(item ? item->widget() : nullptr);
+        if (pageWidget) {
+            pageWidget->update();
+        }
+    }
+}
+
+void PDFViewer::startPresentation() {
+    if (!document) {
+        setMessage("没有打开的文档");
+        return;
+    }
+
+    if (!presentationView) {
+        presentationView = new PDFPresentationView(this);
+        connect(presentationView, &PDFPresentationView::presentationFinished,
+                this, [this](int pageNumber) {
+                    // 演示期间查看器不跟随翻页，结束时一次性同步
+                    emit fullscreenToggled(false);
+                    goToPage(pageNumber);
+
+                    const auto stats = presentationView->advanceStatistics();
+                    if (stats.advances > 0) {
+                        setMessage(QString("演示结束：翻页 %1 次，平均 %2 ms，"
+                                           "最长 %3 ms")
+                                       .arg(stats.advances)
+                                       .arg(stats.averageMs, 0, 'f', 1)
+                                       .arg(stats.maxMs, 0, 'f', 1));
+                    }
+                });
+    }
+
+    if (presentationView->isPresenting()) {
+        return;
+    }
+
+    presentationView->start(document, currentPageNumber, screen());
+    emit fullscreenToggled(true);
+}
+
+void PDFViewer::stopPresentation() {
+    if (presentationView) {
+        presentationView->stop();
     }
-    
-    // 强制整体重绘
-    update();
-    repaint();
+}
+
+bool PDFViewer::isPresenting() const {
+    return presentationView && presentationView->isPresenting();
 }
 
 void PDFViewer::onViewModeChanged(int index) {
@@ -1939,6 +2390,12 @@ void PDFViewer::zoomToHeight() {
     if (!document)
         return;
 
+    // 文本流没有页高可适应，与适应页面相同
+    if (currentViewMode == PDFViewMode::Reflow) {
+        setZoomWithType(reflowView->fitWidthScale(), ZoomType::FitHeight);
+        return;
+    }
+
     // 获取当前视图的viewport大小
     QScrollArea* currentScrollArea =
         (currentViewMode == PDFViewMode::SinglePage) ? singlePageScrollArea
@@ -1946,9 +2403,8 @@ void PDFViewer::zoomToHeight() {
     QSize viewportSize = currentScrollArea->viewport()->size();
 
     if (document->numPages() > 0) {
-        std::unique_ptr<Poppler::Page> page(document->page(currentPageNumber));
-        if (page) {
-            QSizeF pageSize = page->pageSizeF();
+        QSizeF pageSize = pageSizeAt(currentPageNumber);
+        if (!pageSize.isEmpty()) {
             double scale = viewportSize.height() / pageSize.height();
             setZoomWithType(scale * 0.95, ZoomType::FitHeight);  // 留一些边距
         }
@@ -1975,6 +2431,9 @@ void PDFViewer::applyZoom(double factor) {
                 singlePageWidget->blockSignals(true);
                 singlePageWidget->setScaleFactor(factor);
                 singlePageWidget->blockSignals(false);
+            } else if (currentViewMode == PDFViewMode::Reflow) {
+                // 重排模式下缩放即字号，只重排可见页面
+                reflowView->setFontScale(factor);
             } else {
                 updateContinuousView();
             }
@@ -2048,7 +2507,8 @@ void PDFViewer::quickApplyZoom(double factor) {
 
 bool PDFViewer::eventFilter(QObject* object, QEvent* event) {
     // 处理连续滚动区域的Ctrl+滚轮缩放
-    if (object == continuousScrollArea && event->type() == QEvent::Wheel) {
+    if ((object == continuousScrollArea || object == reflowView) &&
+        event->type() == QEvent::Wheel) {
         QWheelEvent* wheelEvent = static_cast<QWheelEvent*>(event);
         if (wheelEvent->modifiers() & Qt::ControlModifier) {
             int delta = wheelEvent->angleDelta().y();
@@ -2275,6 +2735,11 @@ void PDFViewer::onSearchRequested(const QString& query,
     if (!query.isEmpty() && document) {
         // The search is handled by SearchWidget, but we prepare for
         // highlighting
+        if (currentViewMode == PDFViewMode::Reflow) {
+            reflowView->setHighlightTerm(query, options.caseSensitive
+                                                    ? Qt::CaseSensitive
+                                                    : Qt::CaseInsensitive);
+        }
         setMessage(QString("搜索: %1").arg(query));
     }
 }
@@ -2309,6 +2774,10 @@ void PDFViewer::clearSearchHighlights() {
     m_allSearchResults.clear();
     m_currentSearchResultIndex = -1;
 
+    if (reflowView) {
+        reflowView->clearHighlight();
+    }
+
     // Clear highlights from current page widget
     if (currentViewMode == PDFViewMode::SinglePage && singlePageWidget) {
         singlePageWidget->clearSearchHighlights();
@@ -14,6 +14,7 @@
 #include <QGraphicsOpacityEffect>
 #include <QHBoxLayout>
 #include <QHash>
+#include <QImage>
 #include <QLabel>
 #include <QList>
 #include <QMimeData>
@@ -26,6 +27,7 @@
 #include <QPinchGesture>
 #include <QPixmap>
 #include <QPoint>
+#include <QPointer>
 #include <QPropertyAnimation>
 #include <QPushButton>
 #include <QScrollArea>
@@ -41,19 +43,30 @@
 #include <QWheelEvent>
 #include <QWidget>
 #include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include "model/PageMetadataTable.h"
 #include "model/SearchModel.h"
 #include "PDFAnimations.h"
 
 #ifdef ENABLE_QGRAPHICS_PDF_SUPPORT
 #include "QGraphicsPDFViewer.h"
 #endif
+#include "../core/DocumentOpenPipeline.h"
 #include "../widgets/SearchWidget.h"
 #include "PDFPrerenderer.h"
+#include "PDFPresentationView.h"
+#include "PDFReflowView.h"
+#include "RenderBroker.h"
+#include "RenderCostModel.h"
+
+class QThreadPool;
 
 // 页面查看模式枚举
 enum class PDFViewMode {
-    SinglePage,       // 单页视图
-    ContinuousScroll  // 连续滚动视图
+    SinglePage,        // 单页视图
+    ContinuousScroll,  // 连续滚动视图
+    Reflow             // 文本重排视图（不渲染页面）
 };
 
 // 缩放类型枚举
@@ -69,6 +82,7 @@ class PDFPageWidget : public QLabel {
 
 public:
     PDFPageWidget(QWidget* parent = nullptr);
+    ~PDFPageWidget() override;
     void setPage(Poppler::Page* page, double scaleFactor = 1.0,
                  int rotation = 0);
     void setScaleFactor(double factor);
@@ -77,6 +91,18 @@ public:
     int getRotation() const { return currentRotation; }
     void renderPage();  // Make public for refresh functionality
 
+    // 渲染耗时按文档学习；key 仅用于区分文档
+    void setDocumentKey(const void* key) { m_documentKey = key; }
+    // 在 pool 中以补充渲染预算重新渲染受限页面，完成后替换位图；
+    // 渲染期间缩放、旋转或换页时结果被丢弃
+    void startRefine(std::shared_ptr<Poppler::Document> document,
+                     QThreadPool* pool);
+    // 取消尚未完成的补充渲染（如页面已滚出视口）
+    void cancelRefine();
+    bool isRefining() const { return m_refineCancelled != nullptr; }
+    bool isRenderCapped() const { return m_renderCapped; }
+    int renderedPageNumber() const { return m_renderedPageNumber; }
+
     // 快速缩放：只对已渲染的pixmap进行缩放，不重新渲染PDF
     void quickScale(double factor);
 
@@ -122,13 +148,36 @@ private:
     QColor m_normalHighlightColor;
     QColor m_currentHighlightColor;
 
+    // Adaptive DPI state
+    const void* m_documentKey = nullptr;
+    int m_renderedPageNumber = -1;
+    bool m_renderCapped = false;
+
+    // 补充渲染在工作线程中完成，结果连同参数一起交回 GUI 线程
+    struct RefineResult {
+        QImage image;
+        int pageNumber = -1;
+        double scaleFactor = 0.0;
+        int rotation = 0;
+        double pixelRatio = 1.0;
+        bool capped = false;
+    };
+    std::shared_ptr<std::atomic<bool>> m_refineCancelled;
+
     // Helper methods for highlighting
     void drawSearchHighlights(QPainter& painter);
     void updateSearchResultCoordinates();
+    void renderPage(RenderCostModel::Interaction interaction);
+    void showRenderedImage(const QImage& image, double pixelRatio);
+    void onRefineFinished(const RefineResult& result);
+
+    static constexpr qreal PAGE_CORNER_RADIUS = 8.0;
 
 signals:
     void scaleChanged(double scale);
     void pageClicked(QPoint position);
+    // 本次渲染因延迟预算低于理想 DPI
+    void renderCapped();
 };
 
 class PDFViewer : public QWidget {
@@ -139,8 +188,12 @@ public:
     ~PDFViewer() = default;
 
     // 文档操作
-    void setDocument(std::shared_ptr<Poppler::Document> document);
+    // 提供打开流水线时，首屏之外的初始化（连续视图其余占位页、搜索文本
+    // 预取）加入流水线的对应阶段，否则同步完成
+    void setDocument(std::shared_ptr<Poppler::Document> document,
+                     DocumentOpenPipeline* pipeline = nullptr);
     void clearDocument();
+    DocumentOpenPipeline* getOpenPipeline() const { return openPipeline; }
 
     // 页面导航
     void goToPage(int pageNumber);
@@ -170,6 +223,11 @@ public:
     void toggleTheme();
     void updateThemeUI();
 
+    // 演示模式
+    void startPresentation();
+    void stopPresentation();
+    bool isPresenting() const;
+
     // 搜索功能
     void showSearch();
     void hideSearch();
@@ -226,20 +284,35 @@ protected:
     void setupViewModes();
     void switchToSinglePageMode();
     void switchToContinuousMode();
+    void switchToReflowMode();
     void updateContinuousView();
     void updateContinuousViewRotation();
     void createContinuousPages();
+    // 在末尾追加最多 count 个占位页；返回是否仍有页面未创建
+    bool appendContinuousPages(int count);
+    QSizeF pageSizeAt(int pageNumber) const;
+    QSizeF placeholderSizeAt(int pageNumber, const QSizeF& fallback) const;
 
     // 虚拟化渲染方法
     void updateVisiblePages();
     void renderVisiblePages();
+    void refreshVisiblePageWidgets();
     void onScrollChanged();
     void scrollToPageInContinuousView(int pageNumber);
 
+    // 自适应 DPI：交互停止后补充渲染因预算受限的页面
+    void scheduleRefine(PDFPageWidget* pageWidget);
+    void refineCappedPages();
+    void cancelHiddenRefines();
+    void cancelAllRefines();
+
     // 缓存管理方法
     QPixmap getCachedPage(int pageNumber, double zoomFactor, int rotation);
     void setCachedPage(int pageNumber, const QPixmap& pixmap, double zoomFactor,
                        int rotation);
+
+    // 查看区域主题：替换查看区域显式设置的调色板
+    void applyViewAreaTheme();
     void clearPageCache();
     void cleanupCache();
 
@@ -285,6 +358,12 @@ private:
     QVBoxLayout* continuousLayout;
     bool isWidgetReady = false;
 
+    // 文本重排视图组件
+    PDFReflowView* reflowView = nullptr;
+
+    // 演示窗口，首次进入演示模式时创建
+    PDFPresentationView* presentationView = nullptr;
+
     // 工具栏组件
     QWidget* toolbar;
     QGroupBox* navGroup;
@@ -324,6 +403,8 @@ private:
 
     // 文档数据
     std::shared_ptr<Poppler::Document> document;
+    std::shared_ptr<PageMetadataTable> pageMetadata;  // 页面尺寸/标签等元数据
+    QPointer<DocumentOpenPipeline> openPipeline;  // 分阶段打开流水线
     int currentPageNumber;
     double currentZoomFactor;
     PDFViewMode currentViewMode;
@@ -346,6 +427,10 @@ private:
     int renderBuffer;                        // 预渲染缓冲区大小
     QTimer* scrollTimer;                     // 滚动防抖定时器
     QSet<QPair<int, double>> renderedPages;  // 已渲染的页面集合<页码, 缩放因子>
+    QTimer* refineTimer;                     // 受限页面补充渲染定时器
+    QList<QPointer<PDFPageWidget>> cappedPages;
+    QList<QPointer<PDFPageWidget>> refiningPages;  // 补充渲染进行中的页面
+    QThreadPool* refinePool;                 // 补充渲染工作线程
 
     // 动画效果
     QPropertyAnimation* fadeAnimation;
@@ -395,6 +480,11 @@ private:
     static constexpr double MAX_ZOOM = 5.0;
     static constexpr double DEFAULT_ZOOM = 1.0;
     static constexpr double ZOOM_STEP = 0.1;
+    static constexpr int REFINE_DELAY_MS = 400;
+    // 连续视图在当前页之后同步创建的占位页数，以及打开流水线每步追加的
+    // 页数
+    static constexpr int INITIAL_CONTINUOUS_PAGES = 8;
+    static constexpr int CONTINUOUS_PAGES_PER_STEP = 32;
 
 signals:
     void pageChanged(int pageNumber);
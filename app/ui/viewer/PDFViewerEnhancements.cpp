@@ -16,6 +16,7 @@
 #include <QtConcurrent/QtConcurrent>
 #include <QtGlobal>
 #include <cmath>
+#include "CompactRaster.h"
 
 // HighQualityPDFPageWidget Implementation
 HighQualityPDFPageWidget::HighQualityPDFPageWidget(QWidget* parent)
@@ -325,7 +326,8 @@ PDFRenderCache::PDFRenderCache()
 
 void PDFRenderCache::insert(const CacheKey& key, const QPixmap& pixmap) {
     QMutexLocker locker(&m_mutex);
-    int cost = pixmap.width() * pixmap.height() * 4;  // Estimate memory usage
+    // Cost by the pixmap's actual depth, not an assumed 32 bits per pixel
+    int cost = static_cast<int>(CompactRaster::pixmapBytes(pixmap));
     m_cache.insert(key, new QPixmap(pixmap), cost);
 }
 
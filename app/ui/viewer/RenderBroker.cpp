@@ -0,0 +1,117 @@
+#include "RenderBroker.h"
+#include <QMutexLocker>
+#include <QtMath>
+
+RenderBroker& RenderBroker::instance() {
+    static RenderBroker broker;
+    return broker;
+}
+
+QImage RenderBroker::render(const void* document, int pageNumber, double dpi,
+                            int rotation, const Renderer& renderer) {
+    if (!document) {
+        // 没有文档标识时无法判断是否同一页面，直接渲染
+        {
+            QMutexLocker locker(&m_mutex);
+            ++m_statistics.requests;
+            ++m_statistics.renders;
+        }
+        return renderer(dpi);
+    }
+
+    const JobKey key{document, pageNumber, ((rotation % 360) + 360) % 360};
+
+    QMutexLocker locker(&m_mutex);
+    ++m_statistics.requests;
+
+    if (std::shared_ptr<Job> job = findCompatibleLocked(key, dpi)) {
+        const bool exact = qAbs(job->dpi - dpi) <= dpi * DPI_TOLERANCE;
+        ++m_statistics.coalesced;
+        if (!exact) {
+            ++m_statistics.downscaled;
+        }
+        locker.unlock();
+
+        const QImage image = job->result.get();
+        return exact ? image : fitToDpi(image, job->dpi, dpi);
+    }
+
+    // 由当前线程渲染，登记后其他请求可以挂靠
+    std::promise<QImage> promise;
+    auto job = std::make_shared<Job>();
+    job->dpi = dpi;
+    job->result = promise.get_future().share();
+    m_inFlight[key].append(job);
+    ++m_statistics.renders;
+    locker.unlock();
+
+    QImage image;
+    try {
+        image = renderer(dpi);
+    } catch (...) {
+        // 等待者拿到空图像，异常留给调用方处理
+        promise.set_value(QImage());
+        locker.relock();
+        m_inFlight[key].removeOne(job);
+        if (m_inFlight[key].isEmpty()) {
+            m_inFlight.remove(key);
+        }
+        throw;
+    }
+
+    promise.set_value(image);
+
+    locker.relock();
+    auto jobs = m_inFlight.find(key);
+    if (jobs != m_inFlight.end()) {
+        jobs->removeOne(job);
+        if (jobs->isEmpty()) {
+            m_inFlight.erase(jobs);
+        }
+    }
+    return image;
+}
+
+std::shared_ptr<RenderBroker::Job> RenderBroker::findCompatibleLocked(
+    const JobKey& key, double dpi) const {
+    auto jobs = m_inFlight.constFind(key);
+    if (jobs == m_inFlight.cend()) {
+        return nullptr;
+    }
+
+    // 优先分辨率最接近的，缩小的代价最低
+    std::shared_ptr<Job> best;
+    for (const std::shared_ptr<Job>& job : *jobs) {
+        if (job->dpi < dpi * (1.0 - DPI_TOLERANCE) ||
+            job->dpi > dpi * MAX_DOWNSCALE_RATIO) {
+            continue;
+        }
+        if (!best || job->dpi < best->dpi) {
+            best = job;
+        }
+    }
+    return best;
+}
+
+QImage RenderBroker::fitToDpi(const QImage& image, double sourceDpi,
+                              double targetDpi) {
+    if (image.isNull() || sourceDpi <= 0.0) {
+        return image;
+    }
+
+    const double ratio = targetDpi / sourceDpi;
+    const QSize targetSize(qMax(1, qRound(image.width() * ratio)),
+                           qMax(1, qRound(image.height() * ratio)));
+    return image.scaled(targetSize, Qt::IgnoreAspectRatio,
+                        Qt::SmoothTransformation);
+}
+
+RenderBroker::Statistics RenderBroker::statistics() const {
+    QMutexLocker locker(&m_mutex);
+    return m_statistics;
+}
+
+void RenderBroker::resetStatistics() {
+    QMutexLocker locker(&m_mutex);
+    m_statistics = Statistics();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <functional>
+#include <future>
+#include <memory>
+
+/**
+ * @brief 单飞（single-flight）渲染代理
+ *
+ * 查看器、预渲染器、缩略图生成器和文档比较可能在几毫秒内先后请求
+ * 同一页面的相近分辨率，各自完整渲染一次是重复劳动。所有整页渲染都
+ * 经过此代理：
+ * - 同一（文档, 页码, 旋转）已有进行中的渲染且分辨率相同时，后到的请求
+ *   直接等待并共享其结果
+ * - 进行中的渲染分辨率更高（不超过 MAX_DOWNSCALE_RATIO 倍）时，等待后
+ *   缩小到请求的尺寸，而不是再渲染一次
+ * - 否则由调用线程自己渲染，并登记为进行中，供其他请求挂靠
+ *
+ * 只合并同时进行的请求，不缓存已完成的结果（缓存由各使用方负责）。
+ * 可从任意线程调用。
+ */
+class RenderBroker {
+public:
+    struct Statistics {
+        qint64 requests = 0;    // 总请求数
+        qint64 renders = 0;     // 实际执行的渲染数
+        qint64 coalesced = 0;   // 挂靠到进行中渲染的请求数
+        qint64 downscaled = 0;  // 其中由更高分辨率结果缩小得到的
+    };
+
+    // 实际渲染回调，参数为 DPI；只在当前请求需要自己渲染时调用
+    using Renderer = std::function<QImage(double dpi)>;
+
+    static RenderBroker& instance();
+
+    // document 仅作为键使用；rotation 为角度
+    QImage render(const void* document, int pageNumber, double dpi,
+                  int rotation, const Renderer& renderer);
+
+    Statistics statistics() const;
+    void resetStatistics();
+
+private:
+    struct JobKey {
+        const void* document;
+        int pageNumber;
+        int rotation;
+
+        bool operator==(const JobKey& other) const {
+            return document == other.document &&
+                   pageNumber == other.pageNumber &&
+                   rotation == other.rotation;
+        }
+        friend size_t qHash(const JobKey& key, size_t seed = 0) {
+            return qHashMulti(seed, key.document, key.pageNumber,
+                              key.rotation);
+        }
+    };
+
+    struct Job {
+        double dpi;
+        std::shared_future<QImage> result;
+    };
+
+    RenderBroker() = default;
+    RenderBroker(const RenderBroker&) = delete;
+    RenderBroker& operator=(const RenderBroker&) = delete;
+
+    // 调用时需持有 m_mutex；返回可复用的最小分辨率渲染
+    std::shared_ptr<Job> findCompatibleLocked(const JobKey& key,
+                                              double dpi) const;
+    static QImage fitToDpi(const QImage& image, double sourceDpi,
+                           double targetDpi);
+
+    mutable QMutex m_mutex;
+    QHash<JobKey, QList<std::shared_ptr<Job>>> m_inFlight;
+    Statistics m_statistics;
+
+    static constexpr double MAX_DOWNSCALE_RATIO = 2.0;
+    static constexpr double DPI_TOLERANCE = 0.01;
+};
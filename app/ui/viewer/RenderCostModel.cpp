@@ -0,0 +1,120 @@
+#include "RenderCostModel.h"
+#include <QMutexLocker>
+#include <QtMath>
+#include <iterator>
+
+RenderCostModel& RenderCostModel::instance() {
+    static RenderCostModel model;
+    return model;
+}
+
+RenderCostModel::RenderCostModel() {
+    // 默认预算：可见页约数帧，预渲染可稍长，缩略图需要成批快速完成
+    m_budgets[static_cast<int>(Interaction::Visible)] = 80.0;
+    m_budgets[static_cast<int>(Interaction::Prefetch)] = 200.0;
+    m_budgets[static_cast<int>(Interaction::Thumbnail)] = 30.0;
+    m_budgets[static_cast<int>(Interaction::Refine)] = 1500.0;
+}
+
+void RenderCostModel::Estimate::add(double sample) {
+    msPerMegapixel = samples == 0 ? sample
+                                  : msPerMegapixel * (1.0 - SMOOTHING) +
+                                        sample * SMOOTHING;
+    ++samples;
+}
+
+RenderCostModel::Decision RenderCostModel::chooseDpi(
+    const void* document, int pageNumber, const QSizeF& pageSizePoints,
+    double desiredDpi, Interaction interaction) const {
+    Decision decision;
+    decision.dpi = desiredDpi;
+    if (desiredDpi <= 0.0 || pageSizePoints.isEmpty()) {
+        return decision;
+    }
+
+    double cost;
+    double budgetMs;
+    {
+        QMutexLocker locker(&m_mutex);
+        cost = estimateLocked(document, pageNumber);
+        budgetMs = m_budgets[static_cast<int>(interaction)];
+    }
+
+    // 页面面积（平方英寸），1 pt = 1/72 英寸
+    const double area = pageSizePoints.width() * pageSizePoints.height() /
+                        (72.0 * 72.0);
+
+    const double budgetPixels = budgetMs / cost * 1000.0 * 1000.0;
+    const double budgetDpi = qSqrt(budgetPixels / area);
+
+    // 理想 DPI 即屏幕尺寸对应的分辨率，不会超过
+    double dpi = qMin(desiredDpi, budgetDpi);
+    // 预算再紧也不低于基本可读的分辨率
+    dpi = qMax(dpi, qMin(desiredDpi, MIN_DPI));
+
+    decision.dpi = dpi;
+    decision.capped = dpi < desiredDpi - 0.5;
+    return decision;
+}
+
+void RenderCostModel::recordRender(const void* document, int pageNumber,
+                                   const QSize& imageSize,
+                                   double milliseconds) {
+    const double megapixels =
+        static_cast<double>(imageSize.width()) * imageSize.height() / 1e6;
+    if (megapixels < MIN_SAMPLE_MEGAPIXELS || milliseconds < 0.0) {
+        return;
+    }
+    const double sample = milliseconds / megapixels;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_pages.size() >= MAX_PAGE_ENTRIES &&
+        !m_pages.contains(qMakePair(document, pageNumber))) {
+        // 页级样本只是细化，整体清空后由文档和全局平均值兜底
+        m_pages.clear();
+    }
+    m_pages[qMakePair(document, pageNumber)].add(sample);
+    m_documents[document].add(sample);
+    m_global.add(sample);
+}
+
+double RenderCostModel::costPerMegapixel(const void* document,
+                                         int pageNumber) const {
+    QMutexLocker locker(&m_mutex);
+    return estimateLocked(document, pageNumber);
+}
+
+double RenderCostModel::estimateLocked(const void* document,
+                                       int pageNumber) const {
+    auto page = m_pages.constFind(qMakePair(document, pageNumber));
+    if (page != m_pages.cend() && page->msPerMegapixel > 0.0) {
+        return page->msPerMegapixel;
+    }
+    auto documentEstimate = m_documents.constFind(document);
+    if (documentEstimate != m_documents.cend() &&
+        documentEstimate->msPerMegapixel > 0.0) {
+        return documentEstimate->msPerMegapixel;
+    }
+    if (m_global.msPerMegapixel > 0.0) {
+        return m_global.msPerMegapixel;
+    }
+    return DEFAULT_MS_PER_MEGAPIXEL;
+}
+
+void RenderCostModel::setBudget(Interaction interaction, double milliseconds) {
+    QMutexLocker locker(&m_mutex);
+    m_budgets[static_cast<int>(interaction)] = qMax(1.0, milliseconds);
+}
+
+double RenderCostModel::budget(Interaction interaction) const {
+    QMutexLocker locker(&m_mutex);
+    return m_budgets[static_cast<int>(interaction)];
+}
+
+void RenderCostModel::forgetDocument(const void* document) {
+    QMutexLocker locker(&m_mutex);
+    for (auto it = m_pages.begin(); it != m_pages.end();) {
+        it = it.key().first == document ? m_pages.erase(it) : std::next(it);
+    }
+    m_documents.remove(document);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QSize>
+#include <QSizeF>
+
+/**
+ * @brief 渲染耗时模型与自适应 DPI 选择
+ *
+ * 记录每次渲染的耗时，按页学习“每百万像素毫秒数”（指数滑动平均）。
+ * 没有该页样本时依次回退到同文档的平均值、全局平均值和默认值。
+ *
+ * 选择 DPI 时，在当前交互的延迟预算内取最高的 DPI：
+ *   像素数 = 页面面积（平方英寸）× DPI²，耗时 ≈ 像素数 × 每像素耗时
+ * 理想 DPI 由调用方按页面在屏幕上的尺寸 × devicePixelRatio 给出，同时
+ * 也是位图尺寸的上限：不会渲染比屏幕上能显示的更多的像素。结果低于
+ * 理想 DPI 时标记为受限，调用方可在交互结束后以 Refine 预算重新渲染。
+ *
+ * 可从任意线程调用。
+ */
+class RenderCostModel {
+public:
+    enum class Interaction {
+        Visible,    // 可见页面，用户正在等待
+        Prefetch,   // 后台预渲染
+        Thumbnail,  // 缩略图
+        Refine      // 交互停止后对受限页面的补充渲染
+    };
+
+    struct Decision {
+        double dpi = 0.0;
+        bool capped = false;  // 因延迟预算低于理想 DPI
+    };
+
+    static RenderCostModel& instance();
+
+    // document 仅作为键使用，不会被解引用
+    Decision chooseDpi(const void* document, int pageNumber,
+                       const QSizeF& pageSizePoints, double desiredDpi,
+                       Interaction interaction) const;
+    void recordRender(const void* document, int pageNumber,
+                      const QSize& imageSize, double milliseconds);
+
+    double costPerMegapixel(const void* document, int pageNumber) const;
+
+    void setBudget(Interaction interaction, double milliseconds);
+    double budget(Interaction interaction) const;
+
+    // 文档关闭后调用，避免指针复用时沿用旧样本
+    void forgetDocument(const void* document);
+
+private:
+    struct Estimate {
+        double msPerMegapixel = 0.0;
+        int samples = 0;
+
+        void add(double sample);
+    };
+
+    using PageKey = QPair<const void*, int>;
+
+    RenderCostModel();
+    RenderCostModel(const RenderCostModel&) = delete;
+    RenderCostModel& operator=(const RenderCostModel&) = delete;
+
+    // 调用时需持有 m_mutex
+    double estimateLocked(const void* document, int pageNumber) const;
+
+    mutable QMutex m_mutex;
+    QHash<PageKey, Estimate> m_pages;
+    QHash<const void*, Estimate> m_documents;
+    Estimate m_global;
+    double m_budgets[4];
+
+    static constexpr double DEFAULT_MS_PER_MEGAPIXEL = 25.0;
+    static constexpr double SMOOTHING = 0.3;
+    // 过小的渲染以固定开销为主，不用于学习
+    static constexpr double MIN_SAMPLE_MEGAPIXELS = 0.01;
+    static constexpr double MIN_DPI = 72.0;
+    static constexpr int MAX_PAGE_ENTRIES = 4096;
+};
@@ -122,12 +122,7 @@ DebugLogPanel::DebugLogPanel(QWidget* parent)
     connect(&LoggingManager::instance(), &LoggingManager::logMessageReceived,
             this, &DebugLogPanel::onLogMessageDetailed, Qt::QueuedConnection);
 
-    // Connect to theme changes
-    connect(&STYLE, &StyleManager::styleSheetApplied, this, [this]() {
-        applyTheme();
-    });
-
-    // Apply initial theme
+    // Apply the palette-driven sheets once
     applyTheme();
 }
 
@@ -1080,25 +1075,13 @@ void DebugLogPanel::showSettingsDialog() {
 }
 
 void DebugLogPanel::applyTheme() {
-    // Apply theme-based styling to the debug panel
-    Theme currentTheme = STYLE.currentTheme();
-
-    QString backgroundColor, textColor, borderColor, buttonColor,
-        highlightColor;
-
-    if (currentTheme == Theme::Dark) {
-        backgroundColor = "#2b2b2b";
-        textColor = "#ffffff";
-        borderColor = "#555555";
-        buttonColor = "#404040";
-        highlightColor = "#0078d4";
-    } else {
-        backgroundColor = "#ffffff";
-        textColor = "#000000";
-        borderColor = "#cccccc";
-        buttonColor = "#f0f0f0";
-        highlightColor = "#0078d4";
-    }
+    // Colours resolve through the application palette, so the sheets are
+    // set once and follow theme toggles without being re-applied
+    const QString backgroundColor = "palette(base)";
+    const QString textColor = "palette(text)";
+    const QString borderColor = "palette(mid)";
+    const QString buttonColor = "palette(button)";
+    const QString highlightColor = "palette(highlight)";
 
     // Apply styles to main components
     if (m_logDisplay) {
@@ -13,6 +13,7 @@
 #include <QTimer>
 #include <QVBoxLayout>
 #include "../../managers/FileTypeIconManager.h"
+#include "../../managers/RecentFilePreviewProvider.h"
 #include "../../managers/RecentFilesManager.h"
 #include "../../managers/StyleManager.h"
 
@@ -20,6 +21,9 @@
 const int RecentFileItemWidget::ITEM_HEIGHT;
 const int RecentFileItemWidget::PADDING;
 const int RecentFileItemWidget::SPACING;
+const int RecentFileItemWidget::ICON_SIZE;
+const int RecentFileItemWidget::PREVIEW_WIDTH;
+const int RecentFileItemWidget::PREVIEW_HEIGHT;
 
 const int RecentFileListWidget::MAX_VISIBLE_ITEMS;
 const int RecentFileListWidget::REFRESH_DELAY;
@@ -29,6 +33,7 @@ RecentFileItemWidget::RecentFileItemWidget(const RecentFileInfo& fileInfo,
                                            QWidget* parent)
     : QFrame(parent),
       m_fileInfo(fileInfo),
+      m_hasPreview(false),
       m_mainLayout(nullptr),
       m_infoLayout(nullptr),
       m_fileIconLabel(nullptr),
@@ -60,6 +65,28 @@ void RecentFileItemWidget::updateFileInfo(const RecentFileInfo& fileInfo) {
     updateDisplay();
 }
 
+void RecentFileItemWidget::setAvailability(
+    RecentFileInfo::Availability availability) {
+    if (m_fileInfo.availability == availability) {
+        return;
+    }
+
+    m_fileInfo.availability = availability;
+    updateDisplay();
+}
+
+void RecentFileItemWidget::setPreview(const QImage& preview) {
+    if (!m_fileIconLabel || preview.isNull()) {
+        return;
+    }
+
+    // 预览图到达后替换文件类型图标
+    m_hasPreview = true;
+    m_fileIconLabel->setScaledContents(false);
+    m_fileIconLabel->setFixedSize(PREVIEW_WIDTH, PREVIEW_HEIGHT);
+    m_fileIconLabel->setPixmap(QPixmap::fromImage(preview));
+}
+
 void RecentFileItemWidget::applyTheme() {
     StyleManager& styleManager = StyleManager::instance();
 
@@ -205,7 +232,7 @@ void RecentFileItemWidget::setupUI() {
     // 文件类型图标
     m_fileIconLabel = new QLabel();
     m_fileIconLabel->setObjectName("RecentFileIconLabel");
-    m_fileIconLabel->setFixedSize(32, 32);
+    m_fileIconLabel->setFixedSize(ICON_SIZE, ICON_SIZE);
     m_fileIconLabel->setScaledContents(true);
     m_fileIconLabel->setAlignment(Qt::AlignCenter);
 
@@ -256,9 +283,12 @@ void RecentFileItemWidget::updateDisplay() {
         !m_fileIconLabel)
         return;
 
-    // 更新文件类型图标
-    QIcon fileIcon = FILE_ICON_MANAGER.getFileTypeIcon(m_fileInfo.filePath, 32);
-    m_fileIconLabel->setPixmap(fileIcon.pixmap(32, 32));
+    // 更新文件类型图标（预览图到达前使用）
+    if (!m_hasPreview) {
+        QIcon fileIcon =
+            FILE_ICON_MANAGER.getFileTypeIcon(m_fileInfo.filePath, ICON_SIZE);
+        m_fileIconLabel->setPixmap(fileIcon.pixmap(ICON_SIZE, ICON_SIZE));
+    }
 
     // 更新文件名 - VSCode style: just the filename without extension for
     // display
@@ -324,12 +354,22 @@ void RecentFileItemWidget::updateDisplay() {
         timeText = m_fileInfo.lastOpened.toString("MMM dd");
     }
 
+    // 不可达的文件（如断开的网络路径）仍保留在列表中，但弱化显示
+    const bool unreachable = m_fileInfo.availability ==
+                             RecentFileInfo::Availability::Unreachable;
+    if (unreachable) {
+        timeText += " · " + tr("unavailable");
+    }
     m_lastOpenedLabel->setText(timeText);
+    m_fileNameLabel->setEnabled(!unreachable);
 
     // 设置工具提示
-    setToolTip(QString("%1\n%2\nLast opened: %3")
+    setToolTip(QString("%1\n%2\nLast opened: %3%4")
                    .arg(m_fileInfo.fileName, m_fileInfo.filePath,
-                        m_fileInfo.lastOpened.toString()));
+                        m_fileInfo.lastOpened.toString(),
+                        unreachable
+                            ? "\n" + tr("Location is not reachable")
+                            : QString()));
 }
 
 void RecentFileItemWidget::setHovered(bool hovered) {
@@ -373,6 +413,7 @@ void RecentFileItemWidget::startPressAnimation() {
 RecentFileListWidget::RecentFileListWidget(QWidget* parent)
     : QWidget(parent),
       m_recentFilesManager(nullptr),
+      m_previewProvider(nullptr),
       m_mainLayout(nullptr),
       m_scrollArea(nullptr),
       m_contentWidget(nullptr),
@@ -384,6 +425,14 @@ RecentFileListWidget::RecentFileListWidget(QWidget* parent)
 
     setupUI();
 
+    // 首页预览在后台生成，到达后逐个填充
+    m_previewProvider = new RecentFilePreviewProvider(this);
+    m_previewProvider->setPreviewSize(
+        QSize(RecentFileItemWidget::PREVIEW_WIDTH,
+              RecentFileItemWidget::PREVIEW_HEIGHT));
+    connect(m_previewProvider, &RecentFilePreviewProvider::previewReady, this,
+            &RecentFileListWidget::onPreviewReady);
+
     // 设置刷新定时器
     m_refreshTimer = new QTimer(this);
     m_refreshTimer->setSingleShot(true);
@@ -412,6 +461,11 @@ void RecentFileListWidget::setRecentFilesManager(RecentFilesManager* manager) {
     if (m_recentFilesManager) {
         connect(m_recentFilesManager, &RecentFilesManager::recentFilesChanged,
                 this, &RecentFileListWidget::onRecentFilesChanged);
+        connect(m_recentFilesManager,
+                &RecentFilesManager::fileAvailabilityChanged, this,
+                &RecentFileListWidget::onFileAvailabilityChanged);
+        connect(m_recentFilesManager, &RecentFilesManager::recentFileAdded,
+                m_previewProvider, &RecentFilePreviewProvider::invalidate);
     }
 
     // 刷新列表
@@ -435,16 +489,32 @@ void RecentFileListWidget::refreshList() {
     // 限制显示数量
     int maxItems = qMin(recentFiles.size(), MAX_VISIBLE_ITEMS);
 
-    // 添加文件条目
+    // 添加文件条目：立即显示，不在GUI线程访问文件系统
+    QStringList pathsToValidate;
     for (int i = 0; i < maxItems; ++i) {
         const RecentFileInfo& fileInfo = recentFiles[i];
-        if (fileInfo.isValid()) {
-            addFileItem(fileInfo);
+        switch (fileInfo.availability) {
+            case RecentFileInfo::Availability::Missing:
+                continue;
+            case RecentFileInfo::Availability::Unknown:
+                pathsToValidate.append(fileInfo.filePath);
+                break;
+            case RecentFileInfo::Availability::Available:
+                m_previewProvider->requestPreview(fileInfo.filePath);
+                break;
+            case RecentFileInfo::Availability::Unreachable:
+                break;
         }
+        addFileItem(fileInfo);
     }
 
     updateEmptyState();
 
+    // 校验结果与预览图稍后通过信号逐个更新条目
+    if (!pathsToValidate.isEmpty()) {
+        m_recentFilesManager->validateFilesAsync(pathsToValidate);
+    }
+
     qDebug() << "RecentFileListWidget: List refreshed with"
              << m_fileItems.size() << "items";
 }
@@ -553,6 +623,28 @@ void RecentFileListWidget::onItemRemoveRequested(const QString& filePath) {
 
 void RecentFileListWidget::onRefreshTimer() { refreshList(); }
 
+void RecentFileListWidget::onFileAvailabilityChanged(
+    const QString& filePath, RecentFileInfo::Availability availability) {
+    RecentFileItemWidget* item = findFileItem(filePath);
+    if (!item) {
+        return;
+    }
+
+    // 不存在的文件由管理器移除，随后的刷新会删除条目
+    item->setAvailability(availability);
+    if (availability == RecentFileInfo::Availability::Available) {
+        m_previewProvider->requestPreview(filePath);
+    }
+}
+
+void RecentFileListWidget::onPreviewReady(const QString& filePath,
+                                          const QImage& preview) {
+    RecentFileItemWidget* item = findFileItem(filePath);
+    if (item) {
+        item->setPreview(preview);
+    }
+}
+
 void RecentFileListWidget::setupUI() {
     m_mainLayout = new QVBoxLayout(this);
     m_mainLayout->setContentsMargins(0, 0, 0, 0);
@@ -629,6 +721,16 @@ void RecentFileListWidget::removeFileItem(const QString& filePath) {
     updateEmptyState();
 }
 
+RecentFileItemWidget* RecentFileListWidget::findFileItem(
+    const QString& filePath) const {
+    for (RecentFileItemWidget* item : m_fileItems) {
+        if (item && item->fileInfo().filePath == filePath) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
 void RecentFileListWidget::updateEmptyState() {
     bool isEmpty = m_fileItems.isEmpty();
 
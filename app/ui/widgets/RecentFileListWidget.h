@@ -5,6 +5,7 @@
 #include <QFrame>
 #include <QGraphicsOpacityEffect>
 #include <QHBoxLayout>
+#include <QImage>
 #include <QLabel>
 #include <QMouseEvent>
 #include <QPropertyAnimation>
@@ -15,6 +16,7 @@
 #include <QWidget>
 
 class RecentFilesManager;
+class RecentFilePreviewProvider;
 #include "../../managers/RecentFilesManager.h"
 
 /**
@@ -32,10 +34,16 @@ public:
     // 文件信息
     const RecentFileInfo& fileInfo() const { return m_fileInfo; }
     void updateFileInfo(const RecentFileInfo& fileInfo);
+    void setAvailability(RecentFileInfo::Availability availability);
+    void setPreview(const QImage& preview);
 
     // 主题支持
     void applyTheme();
 
+    // First-page preview thumbnail size
+    static const int PREVIEW_WIDTH = 48;
+    static const int PREVIEW_HEIGHT = 64;
+
 signals:
     void clicked(const QString& filePath);
     void removeRequested(const QString& filePath);
@@ -59,6 +67,7 @@ private:
     void startPressAnimation();
 
     RecentFileInfo m_fileInfo;
+    bool m_hasPreview;
 
     // UI组件
     QHBoxLayout* m_mainLayout;
@@ -84,6 +93,7 @@ private:
         108;  // Increased height for icon and better spacing
     static const int PADDING = 12;  // Enhanced padding for modern card look
     static const int SPACING = 4;   // Improved spacing between elements
+    static const int ICON_SIZE = 32;
 };
 
 /**
@@ -125,6 +135,9 @@ private slots:
     void onItemClicked(const QString& filePath);
     void onItemRemoveRequested(const QString& filePath);
     void onRefreshTimer();
+    void onFileAvailabilityChanged(const QString& filePath,
+                                   RecentFileInfo::Availability availability);
+    void onPreviewReady(const QString& filePath, const QImage& preview);
 
 private:
     void setupUI();
@@ -133,9 +146,11 @@ private:
     void removeFileItem(const QString& filePath);
     void updateEmptyState();
     void scheduleRefresh();
+    RecentFileItemWidget* findFileItem(const QString& filePath) const;
 
     // 管理器
     RecentFilesManager* m_recentFilesManager;
+    RecentFilePreviewProvider* m_previewProvider;
 
     // UI组件
     QVBoxLayout* m_mainLayout;
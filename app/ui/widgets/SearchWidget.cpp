@@ -72,10 +72,24 @@ void SearchWidget::setupUI() {
     m_regexCheck = new QCheckBox("正则表达式");
     m_searchBackwardCheck = new QCheckBox("向后搜索");
 
+    // 模糊匹配：容忍 OCR 识别错误，结果按编辑距离排序
+    m_fuzzyCheck = new QCheckBox("模糊匹配");
+    m_maxEditsSpin = new QSpinBox();
+    m_maxEditsSpin->setRange(1, 3);
+    m_maxEditsSpin->setValue(1);
+    m_maxEditsSpin->setEnabled(false);
+    m_maxEditsSpin->setToolTip("允许插入、删除或替换的字符数");
+    QHBoxLayout* fuzzyLayout = new QHBoxLayout();
+    fuzzyLayout->addWidget(m_fuzzyCheck);
+    fuzzyLayout->addWidget(new QLabel("最大编辑距离"));
+    fuzzyLayout->addWidget(m_maxEditsSpin);
+    fuzzyLayout->addStretch();
+
     optionsLayout->addWidget(m_caseSensitiveCheck);
     optionsLayout->addWidget(m_wholeWordsCheck);
     optionsLayout->addWidget(m_regexCheck);
     optionsLayout->addWidget(m_searchBackwardCheck);
+    optionsLayout->addLayout(fuzzyLayout);
 
     // Results view
     m_resultsView = new QListView();
@@ -109,6 +123,8 @@ void SearchWidget::setupConnections() {
             &SearchWidget::toggleSearchOptions);
     connect(m_closeButton, &QPushButton::clicked, this,
             &SearchWidget::searchClosed);
+    connect(m_fuzzyCheck, &QCheckBox::toggled, m_maxEditsSpin,
+            &QSpinBox::setEnabled);
 
     // Navigation
     connect(m_previousButton, &QPushButton::clicked, this,
@@ -350,6 +366,8 @@ SearchOptions SearchWidget::getSearchOptions() const {
     options.wholeWords = m_wholeWordsCheck->isChecked();
     options.useRegex = m_regexCheck->isChecked();
     options.searchBackward = m_searchBackwardCheck->isChecked();
+    options.fuzzy = m_fuzzyCheck->isChecked();
+    options.maxEditDistance = m_maxEditsSpin->value();
     return options;
 }
 
@@ -8,6 +8,7 @@
 #include <QListView>
 #include <QProgressBar>
 #include <QPushButton>
+#include <QSpinBox>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QWidget>
@@ -102,6 +103,8 @@ private:
     QCheckBox* m_wholeWordsCheck;
     QCheckBox* m_regexCheck;
     QCheckBox* m_searchBackwardCheck;
+    QCheckBox* m_fuzzyCheck;
+    QSpinBox* m_maxEditsSpin;
 
     // Results display
     QListView* m_resultsView;
@@ -222,6 +222,19 @@ void WelcomeWidget::resizeEvent(QResizeEvent* event) {
 void WelcomeWidget::showEvent(QShowEvent* event) {
     QWidget::showEvent(event);
 
+    // 之前不可达的路径（如网络挂载）可能已恢复，在后台重新校验
+    if (m_recentFilesManager) {
+        QStringList unreachablePaths;
+        for (const RecentFileInfo& info :
+             m_recentFilesManager->getRecentFiles()) {
+            if (info.availability ==
+                RecentFileInfo::Availability::Unreachable) {
+                unreachablePaths.append(info.filePath);
+            }
+        }
+        m_recentFilesManager->validateFilesAsync(unreachablePaths);
+    }
+
     if (!m_isVisible) {
         m_isVisible = true;
         startFadeInAnimation();
@@ -494,9 +507,12 @@ void WelcomeWidget::setupConnections() {
                 &WelcomeWidget::refreshContent);
     }
 
-    // 主题管理器连接
+    // 主题管理器连接：切换主题只发出 themeChanged，样式表不会重新应用；
+    // 最近文件列表的颜色也随 applyTheme 一起更新
     connect(&StyleManager::instance(), &StyleManager::styleSheetApplied, this,
             &WelcomeWidget::onThemeChanged);
+    connect(&StyleManager::instance(), &StyleManager::themeChanged, this,
+            &WelcomeWidget::onThemeChanged);
 }
 
 void WelcomeWidget::updateLayout() {
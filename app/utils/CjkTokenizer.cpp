@@ -0,0 +1,195 @@
+#include "CjkTokenizer.h"
+#include <QFile>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTextStream>
+#include <QThreadPool>
+#include <algorithm>
+#include "utils/LoggingMacros.h"
+
+namespace {
+
+// Common words of general and technical Chinese text. A few hundred
+// entries already split most running text into real words; larger
+// dictionaries go in the user dictionary file.
+const char BUILTIN_WORDS[] =
+    "我们 你们 他们 她们 它们 自己 大家 什么 怎么 为什么 这个 那个 这些 "
+    "那些 这样 那样 这里 那里 哪里 一个 一些 一样 一起 一直 一定 一般 "
+    "已经 现在 以后 以前 之后 之前 时候 时间 今天 明天 昨天 今年 去年 "
+    "可以 可能 能够 应该 需要 必须 希望 觉得 认为 知道 发现 开始 结束 "
+    "继续 进行 完成 实现 提供 支持 使用 利用 通过 根据 按照 由于 因为 "
+    "所以 但是 可是 不过 而且 并且 或者 还是 如果 虽然 即使 只要 只有 "
+    "然后 于是 因此 否则 以及 关于 对于 除了 没有 不是 就是 还有 只是 "
+    "非常 特别 比较 更加 最后 首先 其次 同时 另外 其他 其中 所有 每个 "
+    "许多 很多 部分 全部 问题 方法 方式 方面 方案 情况 结果 原因 目的 "
+    "目标 内容 过程 条件 影响 作用 意义 价值 关系 工作 学习 研究 分析 "
+    "设计 开发 测试 管理 系统 技术 科学 信息 数据 网络 计算 计算机 软件 "
+    "硬件 程序 应用 功能 性能 效率 质量 安全 标准 结构 模型 算法 理论 "
+    "实验 经济 社会 政治 文化 历史 教育 国家 中国 世界 政府 企业 公司 "
+    "市场 发展 建设 改革 生产 产品 服务 用户 客户 人民 学生 老师 教师 "
+    "学校 大学 学院 专业 课程 作业 考试 论文 报告 文章 文档 文件 资料 "
+    "书籍 图书 章节 目录 标题 正文 段落 句子 词语 文字 文本 字体 字符 "
+    "页面 页码 首页 封面 图片 图像 图表 表格 附录 参考 参考文献 摘要 "
+    "关键词 引言 结论 注释 批注 书签 大纲 缩略图 搜索 查找 替换 编辑 "
+    "修改 删除 添加 保存 打开 关闭 打印 导出 导入 复制 粘贴 选择 设置 "
+    "选项 配置 窗口 界面 菜单 按钮 工具 工具栏 状态栏 侧边栏 视图 显示 "
+    "隐藏 放大 缩小 缩放 旋转 滚动 翻页 全屏 阅读 阅读器 浏览 渲染 加载 "
+    "缓存 内存 存储 处理 处理器 线程 进程 任务 请求 响应 错误 警告 日志 "
+    "版本 更新 下载 上传 文件夹 路径 格式 编码 解码 压缩 加密 密码 权限 "
+    "语言 中文 英文 汉字 拼音 翻译 词典 字典 索引 检索 匹配 排序 统计 "
+    "数量 数字 数值 大小 长度 宽度 高度 位置 区域 范围 颜色 背景 主题 "
+    "样式 布局 对象 属性 参数 变量 函数 接口 类型 方法论 框架 平台 环境 "
+    "项目 团队 成员 用户名 账号 登录 注册 提交 审核 发布 评论 反馈 "
+    "帮助 说明 教程 示例 例子 练习 答案 定义 定理 证明 公式 "
+    "方程 变化 增加 减少 提高 降低 保持 控制 检查 确认 取消 "
+    "重要 主要 基本 简单 复杂 困难 容易 清楚 明确 正确 准确 有效 有用 "
+    "不同 相同 类似 相关 具体 一致 整体 个人 集体 生活 工作量 经验 能力 "
+    "水平 程度 阶段 步骤 流程 计划 安排 组织 机构 部门 领导 负责 参与 "
+    "合作 交流 沟通 讨论 会议 活动 事情 事件 现象 特点 特征 优点 缺点 "
+    "区别 联系 比较 选择题 判断 推理 思考 理解 记忆 注意 注意力 观察 "
+    "描述 表示 表达 说明书 介绍 解释 总结 概括 分类 归纳 组成 构成 "
+    "包括 包含 属于 存在 出现 产生 形成 成为 作为 表现 体现 反映 代表";
+
+QStringList loadDictionaryWords() {
+    QStringList words =
+        QString::fromUtf8(BUILTIN_WORDS).split(u' ', Qt::SkipEmptyParts);
+
+    QFile file(CjkTokenizer::userDictionaryPath());
+    if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        QTextStream in(&file);
+        QString line;
+        while (in.readLineInto(&line)) {
+            const QString word =
+                line.section(u' ', 0, 0, QString::SectionSkipEmpty).trimmed();
+            if (!word.isEmpty() && !word.startsWith(u'#')) {
+                words.append(word);
+            }
+        }
+        LOG_INFO("CjkTokenizer: Loaded user dictionary {}",
+                 file.fileName().toStdString());
+    }
+    return words;
+}
+
+bool isAsciiWordChar(QChar ch) {
+    const char16_t c = ch.unicode();
+    return c < 0x80 && ((c >= u'a' && c <= u'z') || (c >= u'A' && c <= u'Z') ||
+                        (c >= u'0' && c <= u'9') || c == u'_');
+}
+
+bool isHangul(QChar ch) {
+    const char16_t c = ch.unicode();
+    return (c >= 0xAC00 && c <= 0xD7AF) || (c >= 0x1100 && c <= 0x11FF) ||
+           (c >= 0x3130 && c <= 0x318F);
+}
+
+// Calls visit(run, isCjk) for every ASCII word run and CJK run of text
+template <typename Visit>
+void scanRuns(QStringView text, Visit visit) {
+    const qsizetype length = text.size();
+    qsizetype i = 0;
+    while (i < length) {
+        const QChar ch = text[i];
+        const qsizetype start = i;
+        if (isAsciiWordChar(ch)) {
+            while (i < length && isAsciiWordChar(text[i])) {
+                ++i;
+            }
+            visit(text.sliced(start, i - start), false);
+        } else if (CjkTokenizer::isCjk(ch)) {
+            // Hangul and Han/kana runs are kept apart; they split
+            // differently
+            const bool hangul = isHangul(ch);
+            while (i < length && CjkTokenizer::isCjk(text[i]) &&
+                   isHangul(text[i]) == hangul) {
+                ++i;
+            }
+            visit(text.sliced(start, i - start), true);
+        } else {
+            ++i;
+        }
+    }
+}
+
+}  // namespace
+
+bool CjkTokenizer::isCjk(QChar ch) {
+    const char16_t c = ch.unicode();
+    return (c >= 0x4E00 && c <= 0x9FFF) || (c >= 0x3400 && c <= 0x4DBF) ||
+           (c >= 0xF900 && c <= 0xFAFF) || (c >= 0x3040 && c <= 0x30FF) ||
+           (c >= 0x31F0 && c <= 0x31FF) || isHangul(ch);
+}
+
+bool CjkTokenizer::containsCjk(QStringView text) {
+    return std::any_of(text.begin(), text.end(),
+                       [](QChar ch) { return isCjk(ch); });
+}
+
+void CjkTokenizer::words(QStringView text,
+                         TextArena::Vector<QStringView>& out) {
+    scanRuns(text, [&out](QStringView run, bool cjk) {
+        if (cjk && !isHangul(run.front())) {
+            segment(run, out);
+        } else {
+            out.push_back(run);
+        }
+    });
+}
+
+void CjkTokenizer::indexTerms(QStringView text,
+                              TextArena::Vector<QStringView>& out) {
+    scanRuns(text, [&out](QStringView run, bool cjk) {
+        if (!cjk || run.size() == 1) {
+            out.push_back(run);
+            return;
+        }
+        for (qsizetype i = 0; i + 1 < run.size(); ++i) {
+            out.push_back(run.sliced(i, 2));
+        }
+    });
+}
+
+QBitArray CjkTokenizer::wordBoundaries(QStringView text) {
+    QBitArray boundaries(text.size() + 1);
+    TextArena arena;
+    auto spans = arena.makeVector<QStringView>();
+    words(text, spans);
+    for (QStringView word : spans) {
+        const qsizetype start = word.data() - text.data();
+        boundaries.setBit(start);
+        boundaries.setBit(start + word.size());
+    }
+    return boundaries;
+}
+
+void CjkTokenizer::segment(QStringView run,
+                           TextArena::Vector<QStringView>& out) {
+    const DoubleArrayTrie& trie = dictionary();
+    qsizetype i = 0;
+    while (i < run.size()) {
+        const qsizetype length = qMax<qsizetype>(
+            1, trie.longestPrefix(run.sliced(i)));
+        out.push_back(run.sliced(i, length));
+        i += length;
+    }
+}
+
+const DoubleArrayTrie& CjkTokenizer::dictionary() {
+    static const DoubleArrayTrie trie(loadDictionaryWords());
+    return trie;
+}
+
+void CjkTokenizer::preloadDictionary() {
+    // dictionary() holds a function-local static, whose initialization is
+    // already serialized across threads
+    QThreadPool::globalInstance()->start([] {
+        const DoubleArrayTrie& trie = dictionary();
+        LOG_DEBUG("CjkTokenizer: Dictionary ready, {} words in {} bytes",
+                  trie.keyCount(), trie.memoryBytes());
+    });
+}
+
+QString CjkTokenizer::userDictionaryPath() {
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) +
+           "/cjk_dictionary.txt";
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QBitArray>
+#include <QString>
+#include <QStringView>
+#include "DoubleArrayTrie.h"
+#include "TextArena.h"
+
+/**
+ * Word and index-term scanners that understand CJK text.
+ *
+ * Outside CJK runs both behave like TextSpans::words (ASCII word runs).
+ * Chinese and Japanese are written without spaces, so:
+ * - words() segments Han/kana runs by forward maximum matching against a
+ *   dictionary held in a DoubleArrayTrie; characters no entry covers
+ *   become one-character words. Hangul runs are words on their own, since
+ *   Korean separates words with spaces. This feeds word counts, keywords
+ *   and whole-word search.
+ * - indexTerms() emits overlapping bigrams of every CJK run (a lone
+ *   character stands for itself). Any occurrence of a query of two or
+ *   more CJK characters contains all of the query's bigrams, whatever the
+ *   segmentation, which is what the inverted index needs.
+ *
+ * The dictionary is a built-in list of common words, extended by
+ * userDictionaryPath() when that file exists (one word per line; further
+ * columns, as in jieba-style dictionaries, are ignored). The application
+ * builds it on a worker at startup (preloadDictionary()); otherwise the
+ * first segmentation builds it.
+ *
+ * Spans point into the scanned text, like those of TextSpans.
+ */
+class CjkTokenizer {
+public:
+    // Han, kana or Hangul; surrogate pairs (CJK extensions B and up) are
+    // not recognized
+    static bool isCjk(QChar ch);
+    static bool containsCjk(QStringView text);
+
+    static void words(QStringView text, TextArena::Vector<QStringView>& out);
+    static void indexTerms(QStringView text,
+                           TextArena::Vector<QStringView>& out);
+    // Bit i is set when a word of words() starts or ends at position i;
+    // text.size() + 1 bits
+    static QBitArray wordBoundaries(QStringView text);
+
+    static const DoubleArrayTrie& dictionary();
+    // Builds the dictionary on a pool thread; a segmentation that starts
+    // meanwhile waits for that build instead of running its own
+    static void preloadDictionary();
+    static QString userDictionaryPath();
+
+private:
+    static void segment(QStringView run, TextArena::Vector<QStringView>& out);
+};
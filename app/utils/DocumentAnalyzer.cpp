@@ -1,7 +1,6 @@
 #include "DocumentAnalyzer.h"
 #include <poppler-qt6.h>
 #include <QBuffer>
-#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDir>
 #include <QElapsedTimer>
@@ -11,13 +10,207 @@
 #include <QJsonDocument>
 #include <QRandomGenerator>
 #include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
 #include <QStringList>
 #include <QTextStream>
 #include <QTimer>
 #include <QtMath>
+#include <array>
+#include <limits>
 #include <memory>
+#include <numeric>
+#include "DocumentFingerprint.h"
+#include "DocumentMetadataExtractor.h"
+#include "LanguageDetector.h"
 #include "Logger.h"
 #include "PDFUtilities.h"
+#include "model/PageMetadataTable.h"
+
+namespace {
+
+// Numeric features shared by the statistics and correlation reports
+struct MetricSpec {
+    const char* name;
+    const char* section;  // Analysis section, nullptr for result fields
+    const char* key;
+};
+
+constexpr MetricSpec METRICS[] = {
+    {"pageCount", "structure", "pageCount"},
+    {"words", "text", "totalWords"},
+    {"characters", "text", "totalCharacters"},
+    {"images", "images", "totalImages"},
+    {"qualityScore", "quality", "qualityScore"},
+    {"accessibilityScore", "accessibility", "accessibilityScore"},
+    {"processingTimeMs", nullptr, nullptr}};
+
+constexpr int METRIC_COUNT = static_cast<int>(std::size(METRICS));
+
+/**
+ * Streaming aggregate of analysis results. Only running moments are kept,
+ * so the shard merge can fold hundreds of thousands of results one line at
+ * a time. Means and (co)moments are updated with Welford's method: the
+ * naive sum-of-squares form cancels catastrophically for large values such
+ * as character counts.
+ */
+class ResultAccumulator {
+public:
+    void add(const DocumentAnalyzer::AnalysisResult& result);
+    QJsonObject statistics() const;
+    QJsonObject correlations() const;
+
+private:
+    struct Moments {
+        qint64 count = 0;
+        double sum = 0.0;
+        double mean = 0.0;
+        double m2 = 0.0;  // Sum of squared deviations from the mean
+        double min = std::numeric_limits<double>::max();
+        double max = std::numeric_limits<double>::lowest();
+    };
+
+    struct PairMoments {
+        qint64 count = 0;
+        double meanX = 0.0;
+        double meanY = 0.0;
+        double m2X = 0.0;
+        double m2Y = 0.0;
+        double coMoment = 0.0;  // Sum of (x - meanX) * (y - meanY)
+    };
+
+    int m_documents = 0;
+    int m_failed = 0;
+    qint64 m_totalProcessingTime = 0;
+    QHash<QString, int> m_languages;
+    std::array<Moments, METRIC_COUNT> m_metrics;
+    std::array<PairMoments, METRIC_COUNT * METRIC_COUNT> m_pairs;
+};
+
+void ResultAccumulator::add(const DocumentAnalyzer::AnalysisResult& result) {
+    ++m_documents;
+    if (!result.success) {
+        ++m_failed;
+        return;
+    }
+    m_totalProcessingTime += result.processingTime;
+
+    const QString language = result.analysis.value("text")
+                                 .toObject()
+                                 .value("detectedLanguage")
+                                 .toString();
+    if (!language.isEmpty()) {
+        m_languages[language]++;
+    }
+
+    std::array<double, METRIC_COUNT> values;
+    std::array<bool, METRIC_COUNT> present;
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        const MetricSpec& metric = METRICS[i];
+        const QJsonValue value =
+            metric.section
+                ? result.analysis.value(QLatin1String(metric.section))
+                      .toObject()
+                      .value(QLatin1String(metric.key))
+                : QJsonValue(static_cast<double>(result.processingTime));
+        present[i] = value.isDouble();
+        values[i] = value.toDouble();
+        if (!present[i]) {
+            continue;
+        }
+
+        Moments& moments = m_metrics[i];
+        moments.count++;
+        moments.sum += values[i];
+        const double delta = values[i] - moments.mean;
+        moments.mean += delta / moments.count;
+        moments.m2 += delta * (values[i] - moments.mean);
+        moments.min = qMin(moments.min, values[i]);
+        moments.max = qMax(moments.max, values[i]);
+    }
+
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        for (int j = i + 1; j < METRIC_COUNT; ++j) {
+            if (!present[i] || !present[j]) {
+                continue;
+            }
+            PairMoments& pair = m_pairs[i * METRIC_COUNT + j];
+            pair.count++;
+            const double deltaX = values[i] - pair.meanX;
+            const double deltaY = values[j] - pair.meanY;
+            pair.meanX += deltaX / pair.count;
+            pair.meanY += deltaY / pair.count;
+            pair.m2X += deltaX * (values[i] - pair.meanX);
+            pair.m2Y += deltaY * (values[j] - pair.meanY);
+            pair.coMoment += deltaX * (values[j] - pair.meanY);
+        }
+    }
+}
+
+QJsonObject ResultAccumulator::statistics() const {
+    QJsonObject stats;
+    stats["totalDocuments"] = m_documents;
+    stats["successfulDocuments"] = m_documents - m_failed;
+    stats["failedDocuments"] = m_failed;
+    stats["totalProcessingTime"] = m_totalProcessingTime;
+
+    QJsonObject metrics;
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        const Moments& moments = m_metrics[i];
+        if (moments.count == 0) {
+            continue;
+        }
+        const double variance = moments.m2 / moments.count;
+
+        QJsonObject metric;
+        metric["count"] = moments.count;
+        metric["total"] = moments.sum;
+        metric["mean"] = moments.mean;
+        metric["min"] = moments.min;
+        metric["max"] = moments.max;
+        metric["standardDeviation"] = qSqrt(variance);
+        metrics[METRICS[i].name] = metric;
+    }
+    stats["metrics"] = metrics;
+
+    QJsonObject languages;
+    for (auto it = m_languages.cbegin(); it != m_languages.cend(); ++it) {
+        languages[it.key()] = it.value();
+    }
+    stats["languages"] = languages;
+
+    return stats;
+}
+
+QJsonObject ResultAccumulator::correlations() const {
+    QJsonArray pairs;
+    for (int i = 0; i < METRIC_COUNT; ++i) {
+        for (int j = i + 1; j < METRIC_COUNT; ++j) {
+            const PairMoments& pair = m_pairs[i * METRIC_COUNT + j];
+            if (pair.count < 2) {
+                continue;
+            }
+
+            QJsonObject entry;
+            entry["first"] = METRICS[i].name;
+            entry["second"] = METRICS[j].name;
+            entry["samples"] = pair.count;
+            // Constant metrics have no defined correlation
+            entry["pearson"] =
+                pair.m2X > 0.0 && pair.m2Y > 0.0
+                    ? QJsonValue(pair.coMoment / qSqrt(pair.m2X * pair.m2Y))
+                    : QJsonValue();
+            pairs.append(entry);
+        }
+    }
+
+    QJsonObject correlations;
+    correlations["pairs"] = pairs;
+    correlations["documents"] = m_documents - m_failed;
+    return correlations;
+}
+
+}  // namespace
 
 DocumentAnalyzer::DocumentAnalyzer(QObject* parent)
     : QObject(parent),
@@ -61,14 +254,18 @@ DocumentAnalyzer::AnalysisResult DocumentAnalyzer::analyzeDocument(
     result.timestamp = QDateTime::currentDateTime();
     result.success = false;
 
-    // Check cache first
-    if (m_cachingEnabled) {
-        QString cacheKey =
-            QCryptographicHash::hash(filePath.toUtf8(), QCryptographicHash::Md5)
-                .toHex();
-        if (hasCachedResult(cacheKey)) {
-            return getCachedResult(cacheKey);
-        }
+    // Check cache first; keyed by content so renamed or copied files hit
+    // and edited files miss. A file without a memoized fingerprint is
+    // hashed on the fingerprint pool while it is being analyzed
+    QString cacheKey =
+        m_cachingEnabled ? generateCacheKey(filePath, types) : QString();
+    if (m_cachingEnabled && cacheKey.isEmpty()) {
+        DocumentFingerprint::instance().requestFingerprint(filePath);
+    }
+    if (!cacheKey.isEmpty() && hasCachedResult(cacheKey)) {
+        AnalysisResult cached = getCachedResult(cacheKey);
+        cached.documentPath = filePath;
+        return cached;
     }
 
     // Load document
@@ -89,12 +286,15 @@ DocumentAnalyzer::AnalysisResult DocumentAnalyzer::analyzeDocument(
     result = performAnalysis(document.get(), filePath, types);
     result.processingTime = timer.elapsed();
 
-    // Cache result
+    // Cache result; a fingerprint requested above has usually landed by now,
+    // otherwise the next analysis of this file caches it
     if (m_cachingEnabled && result.success) {
-        QString cacheKey =
-            QCryptographicHash::hash(filePath.toUtf8(), QCryptographicHash::Md5)
-                .toHex();
-        cacheResult(cacheKey, result);
+        if (cacheKey.isEmpty()) {
+            cacheKey = generateCacheKey(filePath, types);
+        }
+        if (!cacheKey.isEmpty()) {
+            cacheResult(cacheKey, result);
+        }
     }
 
     return result;
@@ -247,15 +447,7 @@ bool DocumentAnalyzer::exportResultsToJson(const QString& filePath) const {
     QJsonArray resultsArray;
 
     for (const AnalysisResult& result : m_results) {
-        QJsonObject resultObj;
-        resultObj["documentPath"] = result.documentPath;
-        resultObj["analysis"] = result.analysis;
-        resultObj["processingTime"] = result.processingTime;
-        resultObj["success"] = result.success;
-        resultObj["errorMessage"] = result.errorMessage;
-        resultObj["timestamp"] = result.timestamp.toString(Qt::ISODate);
-
-        resultsArray.append(resultObj);
+        resultsArray.append(resultToJson(result));
     }
 
     root["results"] = resultsArray;
@@ -350,15 +542,15 @@ DocumentAnalyzer::AnalysisResult DocumentAnalyzer::performAnalysis(
 
     try {
         if (types & BasicAnalysis) {
-            analysis["basic"] =
-                QJsonObject{{"pageCount", document->numPages()},
-                            {"title", document->info("Title")},
-                            {"author", document->info("Author")},
-                            {"subject", document->info("Subject")},
-                            {"creator", document->info("Creator")},
-                            {"producer", document->info("Producer")},
-                            {"creationDate", document->info("CreationDate")},
-                            {"modificationDate", document->info("ModDate")}};
+            // Shares the fingerprint-keyed cache with the metadata dialog
+            QJsonObject basic =
+                DocumentMetadataExtractor::cachedBasicInfo(filePath, document);
+            QJsonObject statistics;
+            if (DocumentMetadataExtractor::cachedStatistics(filePath,
+                                                            statistics)) {
+                basic["statistics"] = statistics;
+            }
+            analysis["basic"] = basic;
         }
 
         if (types & TextAnalysis) {
@@ -386,6 +578,7 @@ DocumentAnalyzer::AnalysisResult DocumentAnalyzer::performAnalysis(
         }
 
         result.analysis = analysis;
+        result.features = DocumentClassifier::extract(analysis);
 
     } catch (const std::exception& e) {
         result.success = false;
@@ -447,6 +640,8 @@ QJsonObject DocumentAnalyzer::performTextAnalysis(Poppler::Document* document) {
     int totalWords = 0;
     int totalSentences = 0;
     int totalParagraphs = 0;
+    LanguageDetector::Distribution languages{};
+    QJsonArray pageLanguages;
 
     for (int i = 0; i < document->numPages(); ++i) {
         std::unique_ptr<Poppler::Page> page(document->page(i));
@@ -454,10 +649,19 @@ QJsonObject DocumentAnalyzer::performTextAnalysis(Poppler::Document* document) {
             QString pageText = page->text(QRectF());
             allText.append(pageText);
 
-            // Simple word counting
-            QStringList words =
-                pageText.split(QRegularExpression("\\W+"), Qt::SkipEmptyParts);
-            totalWords += words.size();
+            // Per page, so mixed documents keep their proportions; pages
+            // weigh by the amount of text on them
+            const LanguageDetector::Distribution pageLanguage =
+                LanguageDetector::detectPage(pageText);
+            for (int l = 0; l < LanguageDetector::LanguageCount; ++l) {
+                languages[l] += pageLanguage[l] * pageText.size();
+            }
+            pageLanguages.append(LanguageDetector::code(
+                LanguageDetector::dominant(pageLanguage)));
+
+            // Word counting segments CJK text instead of splitting on
+            // non-ASCII characters, which counted Chinese pages as empty
+            totalWords += PDFUtilities::countWords(pageText);
 
             // Simple sentence counting
             totalSentences += pageText.count(QRegularExpression("[.!?]+"));
@@ -479,16 +683,18 @@ QJsonObject DocumentAnalyzer::performTextAnalysis(Poppler::Document* document) {
     textAnalysis["estimatedReadingTime"] =
         totalWords / 200.0;  // 200 words per minute
 
-    // Simple language detection
-    QString language = "unknown";
-    if (fullText.contains(
-            QRegularExpression("\\b(the|and|that|have|for)\\b",
-                               QRegularExpression::CaseInsensitiveOption))) {
-        language = "english";
-    } else if (fullText.contains(QRegularExpression("[\\u4e00-\\u9fff]"))) {
-        language = "chinese";
+    const float languageTotal =
+        std::accumulate(languages.cbegin(), languages.cend(), 0.0f);
+    if (languageTotal > 0.0f) {
+        for (float& share : languages) {
+            share /= languageTotal;
+        }
     }
-    textAnalysis["detectedLanguage"] = language;
+    textAnalysis["detectedLanguage"] =
+        LanguageDetector::name(LanguageDetector::dominant(languages));
+    textAnalysis["languages"] = LanguageDetector::toJson(languages);
+    textAnalysis["mixedLanguage"] = LanguageDetector::isMixed(languages);
+    textAnalysis["pageLanguages"] = pageLanguages;
 
     return textAnalysis;
 }
@@ -551,10 +757,11 @@ QJsonObject DocumentAnalyzer::performStructureAnalysis(
     bool uniformSize = true;
     QSizeF firstPageSize;
 
+    // Page sizes come from the metadata table when the viewer has one for
+    // this document; otherwise each page is instantiated
     for (int i = 0; i < document->numPages(); ++i) {
-        std::unique_ptr<Poppler::Page> page(document->page(i));
-        if (page) {
-            QSizeF pageSize = page->pageSizeF();
+        QSizeF pageSize = PageMetadataTable::pageSize(document, i);
+        if (!pageSize.isEmpty()) {
             pageSizes.append(pageSize);
 
             if (i == 0) {
@@ -708,6 +915,18 @@ void DocumentAnalyzer::cacheResult(const QString& key,
     emit cacheUpdated(m_resultCache.size() * 1024);
 }
 
+QString DocumentAnalyzer::generateCacheKey(const QString& filePath,
+                                          AnalysisTypes types) const {
+    // Memo lookup only: analyzeDocument() also runs on the GUI thread, where
+    // hashing an unknown multi-GB file would block
+    const QString fingerprint =
+        DocumentFingerprint::instance().cachedFingerprint(filePath);
+    if (fingerprint.isEmpty()) {
+        return QString();
+    }
+    return fingerprint + ':' + QString::number(types.toInt(), 16);
+}
+
 DocumentAnalyzer::AnalysisResult DocumentAnalyzer::getCachedResult(
     const QString& key) const {
     return m_resultCache.value(key, AnalysisResult());
@@ -766,3 +985,491 @@ void DocumentAnalyzer::onDocumentAnalysisFinished() {
     Logger::instance().debug(
         "[utils] Analysis processing completed successfully");
 }
+
+QJsonObject DocumentAnalyzer::resultToJson(const AnalysisResult& result) {
+    QJsonObject resultObj;
+    resultObj["documentPath"] = result.documentPath;
+    resultObj["analysis"] = result.analysis;
+    resultObj["processingTime"] = result.processingTime;
+    resultObj["success"] = result.success;
+    resultObj["errorMessage"] = result.errorMessage;
+    resultObj["timestamp"] = result.timestamp.toString(Qt::ISODate);
+    QJsonArray features;
+    for (float value : result.features) {
+        features.append(value);
+    }
+    resultObj["features"] = features;
+    return resultObj;
+}
+
+DocumentAnalyzer::AnalysisResult DocumentAnalyzer::resultFromJson(
+    const QJsonObject& json) {
+    AnalysisResult result;
+    result.documentPath = json["documentPath"].toString();
+    result.analysis = json["analysis"].toObject();
+    result.processingTime =
+        static_cast<qint64>(json["processingTime"].toDouble());
+    result.success = json["success"].toBool();
+    result.errorMessage = json["errorMessage"].toString();
+    result.timestamp =
+        QDateTime::fromString(json["timestamp"].toString(), Qt::ISODate);
+
+    // Results written before feature vectors existed are re-derived
+    const QJsonArray features = json["features"].toArray();
+    if (features.size() == DocumentClassifier::FeatureCount) {
+        for (int i = 0; i < DocumentClassifier::FeatureCount; ++i) {
+            result.features[i] = static_cast<float>(features[i].toDouble());
+        }
+    } else {
+        result.features = DocumentClassifier::extract(result.analysis);
+    }
+    return result;
+}
+
+void DocumentAnalyzer::setAnalysisSettings(
+    const BatchAnalysisSettings& settings) {
+    m_settings = settings;
+}
+
+DocumentAnalyzer::BatchAnalysisSettings DocumentAnalyzer::getAnalysisSettings()
+    const {
+    return m_settings;
+}
+
+// Sharded batch processing
+QStringList DocumentAnalyzer::readManifest(const QString& manifestPath) {
+    QStringList entries;
+
+    QFile file(manifestPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        Logger::instance().warning(
+            QString("[utils] Cannot open manifest %1").arg(manifestPath));
+        return entries;
+    }
+
+    // One path per line; blank lines and # comments are ignored
+    QTextStream in(&file);
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (!line.isEmpty() && !line.startsWith('#')) {
+            entries.append(line);
+        }
+    }
+    return entries;
+}
+
+QStringList DocumentAnalyzer::shardEntries(const QStringList& entries,
+                                           int shardIndex, int shardCount) {
+    QStringList shard;
+    if (shardCount < 1 || shardIndex < 0 || shardIndex >= shardCount) {
+        return shard;
+    }
+
+    // Hash the entry as written, not a resolved path: nodes may mount the
+    // shared filesystem at different locations
+    for (const QString& entry : entries) {
+        const QByteArray bytes = entry.toUtf8();
+        const quint64 hash =
+            DocumentFingerprint::hashBytes(bytes.constData(), bytes.size());
+        if (hash % static_cast<quint64>(shardCount) ==
+            static_cast<quint64>(shardIndex)) {
+            shard.append(entry);
+        }
+    }
+    return shard;
+}
+
+QString DocumentAnalyzer::shardResultPath(const QString& outputDirectory,
+                                          int shardIndex, int shardCount) {
+    return QDir(outputDirectory)
+        .filePath(QString("shard-%1-of-%2.jsonl")
+                      .arg(shardIndex + 1, 4, 10, QChar('0'))
+                      .arg(shardCount, 4, 10, QChar('0')));
+}
+
+QString DocumentAnalyzer::shardDonePath(const QString& outputDirectory,
+                                        int shardIndex, int shardCount) {
+    return shardResultPath(outputDirectory, shardIndex, shardCount) + ".done";
+}
+
+QHash<QString, bool> DocumentAnalyzer::loadShardCheckpoint(
+    const QString& resultPath) {
+    QHash<QString, bool> completed;
+
+    QFile file(resultPath);
+    if (!file.open(QIODevice::ReadWrite)) {
+        return completed;
+    }
+
+    // A node that died mid-write leaves a partial last line; keep only
+    // complete, parseable lines and cut the file after the last of them
+    qint64 validSize = 0;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (!line.endsWith('\n')) {
+            break;
+        }
+        const QJsonObject json = QJsonDocument::fromJson(line).object();
+        if (json.isEmpty()) {
+            break;
+        }
+        completed.insert(json["documentPath"].toString(),
+                         json["success"].toBool());
+        validSize = file.pos();
+    }
+
+    if (validSize < file.size()) {
+        Logger::instance().warning(
+            QString("[utils] Dropping incomplete tail of %1").arg(resultPath));
+        file.resize(validSize);
+    }
+    return completed;
+}
+
+bool DocumentAnalyzer::runShard(const QString& manifestPath, int shardIndex,
+                                int shardCount,
+                                const QString& outputDirectory) {
+    if (shardCount < 1 || shardIndex < 0 || shardIndex >= shardCount) {
+        Logger::instance().warning(QString("[utils] Invalid shard %1 of %2")
+                                       .arg(shardIndex)
+                                       .arg(shardCount));
+        return false;
+    }
+    if (m_batchRunning) {
+        Logger::instance().warning("[utils] Batch analysis already running");
+        return false;
+    }
+    if (!QDir().mkpath(outputDirectory)) {
+        Logger::instance().warning(
+            QString("[utils] Cannot create %1").arg(outputDirectory));
+        return false;
+    }
+
+    const QDir manifestDir = QFileInfo(manifestPath).absoluteDir();
+    const QStringList entries =
+        shardEntries(readManifest(manifestPath), shardIndex, shardCount);
+
+    const QString resultPath =
+        shardResultPath(outputDirectory, shardIndex, shardCount);
+    QHash<QString, bool> completed = loadShardCheckpoint(resultPath);
+
+    QFile output(resultPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        Logger::instance().warning(
+            QString("[utils] Cannot open %1 for writing").arg(resultPath));
+        return false;
+    }
+
+    // Results go to disk instead of m_results, and a corpus run would only
+    // fill the result cache
+    const bool cachingEnabled = m_cachingEnabled;
+    m_cachingEnabled = false;
+
+    m_results.clear();
+    m_failedPaths.clear();
+    m_totalDocuments = entries.size();
+    m_processedDocuments = 0;
+    m_failedDocuments = 0;
+    m_batchRunning = true;
+    m_batchTimer.start();
+
+    emit batchAnalysisStarted(m_totalDocuments);
+
+    // Documents analyzed by this run, so duplicate manifest entries of a
+    // failed document are not retried twice
+    QSet<QString> attempted;
+
+    bool writeFailed = false;
+    for (const QString& entry : entries) {
+        if (!m_batchRunning) {
+            break;  // Analysis was stopped
+        }
+
+        // Relative entries are relative to the manifest
+        const QString filePath = QDir::cleanPath(manifestDir.filePath(entry));
+        // Failures recorded by an earlier run are retried; a transient
+        // error (file share offline, node out of memory) is not final
+        auto previous = completed.constFind(filePath);
+        if (previous != completed.cend() &&
+            (previous.value() || attempted.contains(filePath))) {
+            if (!previous.value()) {
+                m_failedPaths.append(filePath);
+                m_failedDocuments++;
+            }
+            m_processedDocuments++;
+            continue;
+        }
+
+        const AnalysisResult result =
+            analyzeDocument(filePath, m_settings.analysisTypes);
+        completed.insert(filePath, result.success);
+        attempted.insert(filePath);
+
+        // One line per document, flushed right away: the file is the
+        // checkpoint
+        const QByteArray line =
+            QJsonDocument(resultToJson(result)).toJson(QJsonDocument::Compact);
+        if (output.write(line + '\n') < 0 || !output.flush()) {
+            Logger::instance().error(
+                QString("[utils] Failed to write %1").arg(resultPath));
+            writeFailed = true;
+            break;
+        }
+
+        if (result.success) {
+            emit documentAnalyzed(filePath, result);
+        } else {
+            m_failedPaths.append(filePath);
+            m_failedDocuments++;
+            emit documentAnalysisFailed(filePath, result.errorMessage);
+        }
+
+        m_processedDocuments++;
+        updateBatchProgress();
+    }
+    output.close();
+
+    const bool finished = m_batchRunning && !writeFailed;
+    m_batchRunning = false;
+    m_cachingEnabled = cachingEnabled;
+
+    if (finished) {
+        QJsonObject marker;
+        marker["shardIndex"] = shardIndex;
+        marker["shardCount"] = shardCount;
+        marker["documents"] = m_processedDocuments;
+        marker["failedDocuments"] = m_failedDocuments;
+        marker["finishedAt"] =
+            QDateTime::currentDateTime().toString(Qt::ISODate);
+
+        QSaveFile done(shardDonePath(outputDirectory, shardIndex, shardCount));
+        if (!done.open(QIODevice::WriteOnly) ||
+            done.write(QJsonDocument(marker).toJson()) < 0 || !done.commit()) {
+            Logger::instance().error("[utils] Failed to mark shard finished");
+            emit batchAnalysisFinished();
+            return false;
+        }
+    }
+
+    Logger::instance().info(
+        QString("[utils] Shard %1/%2: %3 documents, %4 failed, %5")
+            .arg(shardIndex + 1)
+            .arg(shardCount)
+            .arg(m_processedDocuments)
+            .arg(m_failedDocuments)
+            .arg(formatAnalysisTime(m_batchTimer.elapsed())));
+
+    emit batchAnalysisFinished();
+    return finished;
+}
+
+bool DocumentAnalyzer::mergeShardResults(const QString& outputDirectory,
+                                         int shardCount,
+                                         const QString& reportPath) {
+    if (shardCount < 1) {
+        return false;
+    }
+
+    // Merging before every shard is done would silently under-report
+    QStringList unfinished;
+    for (int i = 0; i < shardCount; ++i) {
+        if (!QFile::exists(shardDonePath(outputDirectory, i, shardCount))) {
+            unfinished.append(QString::number(i + 1));
+        }
+    }
+    if (!unfinished.isEmpty()) {
+        Logger::instance().warning(
+            QString("[utils] Shards not finished: %1")
+                .arg(unfinished.join(", ")));
+        return false;
+    }
+
+    const auto pathHash = [](const QString& path) {
+        const QByteArray bytes = path.toUtf8();
+        return DocumentFingerprint::hashBytes(bytes.constData(), bytes.size());
+    };
+
+    ResultAccumulator accumulator;
+    QSet<quint64> succeeded;
+    QSet<quint64> failed;
+    QStringList failedCandidates;
+    int skippedLines = 0;
+
+    for (int i = 0; i < shardCount; ++i) {
+        const QString resultPath =
+            shardResultPath(outputDirectory, i, shardCount);
+        QFile file(resultPath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            Logger::instance().warning(
+                QString("[utils] Cannot read %1").arg(resultPath));
+            return false;
+        }
+
+        while (!file.atEnd()) {
+            const QJsonObject json =
+                QJsonDocument::fromJson(file.readLine()).object();
+            if (json.isEmpty()) {
+                skippedLines++;
+                continue;
+            }
+
+            const AnalysisResult result = resultFromJson(json);
+
+            // Duplicate manifest entries and retried failures end up in
+            // the same shard; count each document once
+            const quint64 hash = pathHash(result.documentPath);
+            if (result.success) {
+                if (!succeeded.contains(hash)) {
+                    succeeded.insert(hash);
+                    accumulator.add(result);
+                }
+            } else if (!failed.contains(hash)) {
+                failed.insert(hash);
+                failedCandidates.append(result.documentPath);
+            }
+        }
+    }
+
+    // A failure only counts when no later retry of it succeeded
+    QStringList failedPaths;
+    for (const QString& path : failedCandidates) {
+        if (succeeded.contains(pathHash(path))) {
+            continue;
+        }
+        AnalysisResult failure;
+        failure.documentPath = path;
+        failure.processingTime = 0;
+        failure.success = false;
+        accumulator.add(failure);
+        failedPaths.append(path);
+    }
+
+    QJsonObject report;
+    report["shardCount"] = shardCount;
+    report["statistics"] = accumulator.statistics();
+    report["correlations"] = accumulator.correlations();
+    report["failedPaths"] = QJsonArray::fromStringList(failedPaths);
+    report["skippedLines"] = skippedLines;
+    report["mergedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+
+    QSaveFile file(reportPath);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(QJsonDocument(report).toJson()) < 0 || !file.commit()) {
+        Logger::instance().error(
+            QString("[utils] Failed to write report %1").arg(reportPath));
+        return false;
+    }
+
+    emit reportGenerated(reportPath);
+    return true;
+}
+
+QJsonObject DocumentAnalyzer::generateDocumentStatistics(
+    const QList<AnalysisResult>& results) {
+    ResultAccumulator accumulator;
+    for (const AnalysisResult& result : results) {
+        accumulator.add(result);
+    }
+    return accumulator.statistics();
+}
+
+QJsonObject DocumentAnalyzer::generateCorrelationAnalysis(
+    const QList<AnalysisResult>& results) {
+    ResultAccumulator accumulator;
+    for (const AnalysisResult& result : results) {
+        accumulator.add(result);
+    }
+    return accumulator.correlations();
+}
+
+// Machine learning utilities
+QJsonObject DocumentAnalyzer::trainDocumentClassifier(
+    const QList<AnalysisResult>& trainingData) {
+    QHash<QString, QString> labelsByPath;
+    for (const AnalysisResult& result : trainingData) {
+        const QString label = result.analysis.value("label").toString();
+        if (!label.isEmpty()) {
+            labelsByPath.insert(result.documentPath, label);
+        }
+    }
+    return trainDocumentClassifier(trainingData, labelsByPath);
+}
+
+QJsonObject DocumentAnalyzer::trainDocumentClassifier(
+    const QList<AnalysisResult>& trainingData,
+    const QHash<QString, QString>& labelsByPath) {
+    DocumentClassifier::FeatureMatrix samples;
+    samples.reserve(trainingData.size());
+    QList<int> labels;
+    QStringList classNames;
+    QHash<QString, int> classIndex;
+
+    for (const AnalysisResult& result : trainingData) {
+        const QString label = labelsByPath.value(result.documentPath);
+        if (!result.success || label.isEmpty()) {
+            continue;
+        }
+        auto it = classIndex.constFind(label);
+        if (it == classIndex.cend()) {
+            it = classIndex.insert(label, classNames.size());
+            classNames.append(label);
+        }
+        samples.append(result.features);
+        labels.append(it.value());
+    }
+
+    DocumentClassifier classifier;
+    if (!classifier.train(samples, labels, classNames)) {
+        emit analysisError("No labelled documents to train a classifier on");
+        return QJsonObject();
+    }
+    return classifier.toJson();
+}
+
+QString DocumentAnalyzer::classifyDocument(const AnalysisResult& result,
+                                           const QJsonObject& classifier) {
+    DocumentClassifier model;
+    if (!model.fromJson(classifier)) {
+        return QString();
+    }
+    const int index = model.predict(result.features);
+    return index >= 0 ? model.classNames().at(index) : QString();
+}
+
+QStringList DocumentAnalyzer::classifyDocuments(
+    const QList<AnalysisResult>& results, const QJsonObject& classifier) {
+    QStringList labels;
+    DocumentClassifier model;
+    if (!model.fromJson(classifier)) {
+        return labels;
+    }
+
+    DocumentClassifier::FeatureMatrix samples;
+    samples.reserve(results.size());
+    for (const AnalysisResult& result : results) {
+        samples.append(result.features);
+    }
+
+    const QStringList classNames = model.classNames();
+    const QList<int> predictions = model.predictBatch(samples);
+    labels.reserve(predictions.size());
+    for (int index : predictions) {
+        labels.append(index >= 0 ? classNames.at(index) : QString());
+    }
+    return labels;
+}
+
+QStringList DocumentAnalyzer::extractFeatures(const AnalysisResult& result) {
+    QStringList features;
+    for (int i = 0; i < DocumentClassifier::FeatureCount; ++i) {
+        features.append(QString("%1=%2")
+                            .arg(DocumentClassifier::featureName(i))
+                            .arg(result.features[i]));
+    }
+    return features;
+}
+
+double DocumentAnalyzer::calculateDocumentSimilarity(
+    const AnalysisResult& result1, const AnalysisResult& result2) {
+    return DocumentClassifier::similarity(result1.features, result2.features);
+}
@@ -4,12 +4,14 @@
 #include <QElapsedTimer>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QObject>
 #include <QString>
 #include <QStringList>
 #include <QTimer>
+#include "DocumentClassifier.h"
 
 /**
  * Advanced document analyzer with batch processing capabilities
@@ -37,6 +39,9 @@ public:
         bool success;
         QString errorMessage;
         QDateTime timestamp;
+        // Dense form of the analysis for classification and similarity,
+        // filled when the analysis is produced
+        DocumentClassifier::FeatureVector features{};
     };
 
     struct BatchAnalysisSettings {
@@ -78,6 +83,25 @@ public:
     void stopBatchAnalysis();
     bool isBatchAnalysisRunning() const;
 
+    // Sharded batch processing for corpus runs spread over several
+    // machines that share a filesystem. Every node reads the same manifest
+    // and picks its documents by a hash of the manifest entry, so the
+    // partition needs no coordination. Each shard streams one JSON line
+    // per document to its own result file, which doubles as a checkpoint:
+    // a restarted shard skips documents already analyzed there and retries
+    // the ones that failed. Shard indices are 0-based.
+    static QStringList readManifest(const QString& manifestPath);
+    static QStringList shardEntries(const QStringList& entries, int shardIndex,
+                                    int shardCount);
+    static QString shardResultPath(const QString& outputDirectory,
+                                   int shardIndex, int shardCount);
+    bool runShard(const QString& manifestPath, int shardIndex, int shardCount,
+                  const QString& outputDirectory);
+    // Combines finished shard outputs into the global JSON report without
+    // holding all results in memory
+    bool mergeShardResults(const QString& outputDirectory, int shardCount,
+                           const QString& reportPath);
+
     // Progress and status
     int getTotalDocuments() const;
     int getProcessedDocuments() const;
@@ -119,11 +143,22 @@ public:
     QStringList identifyOutliers(const QList<AnalysisResult>& results);
     QJsonObject generateTrendAnalysis(const QList<AnalysisResult>& results);
 
-    // Machine learning utilities
+    // Machine learning utilities. Classifiers are DocumentClassifier::toJson()
+    // objects. Analysis never assigns classes itself: the caller supplies
+    // them, keyed by document path, or writes each class name into
+    // analysis["label"] of the training results. Unlabelled and failed
+    // results are skipped.
     QJsonObject trainDocumentClassifier(
         const QList<AnalysisResult>& trainingData);
+    QJsonObject trainDocumentClassifier(
+        const QList<AnalysisResult>& trainingData,
+        const QHash<QString, QString>& labelsByPath);
     QString classifyDocument(const AnalysisResult& result,
                              const QJsonObject& classifier);
+    // Batch path: one model load and one pass over a feature matrix
+    QStringList classifyDocuments(const QList<AnalysisResult>& results,
+                                  const QJsonObject& classifier);
+    // "name=value" for each entry of the feature vector
     QStringList extractFeatures(const AnalysisResult& result);
     double calculateDocumentSimilarity(const AnalysisResult& result1,
                                        const AnalysisResult& result2);
@@ -186,13 +221,23 @@ private:
     void updateBatchProgress();
     void finalizeBatchAnalysis();
 
+    // Shard result files
+    static QJsonObject resultToJson(const AnalysisResult& result);
+    static AnalysisResult resultFromJson(const QJsonObject& json);
+    static QString shardDonePath(const QString& outputDirectory,
+                                 int shardIndex, int shardCount);
+    static QHash<QString, bool> loadShardCheckpoint(const QString& resultPath);
+
     // Helper functions
     QString generateAnalysisId() const;
     QJsonObject createErrorResult(const QString& error) const;
     bool isValidDocument(Poppler::Document* document) const;
     QString formatAnalysisTime(qint64 milliseconds) const;
 
-    // Cache management
+    // Cache management (keys are content fingerprints plus analysis types;
+    // empty until the file's fingerprint has been memoized)
+    QString generateCacheKey(const QString& filePath,
+                             AnalysisTypes types) const;
     void cacheResult(const QString& key, const AnalysisResult& result);
     AnalysisResult getCachedResult(const QString& key) const;
     bool hasCachedResult(const QString& key) const;
@@ -0,0 +1,752 @@
+#include "DocumentBundle.h"
+#include <poppler-qt6.h>
+#include <QBuffer>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRectF>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <climits>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <string_view>
+#include <utility>
+#include "model/PageMetadataTable.h"
+#include "utils/CjkTokenizer.h"
+#include "utils/DocumentFingerprint.h"
+#include "utils/LoggingMacros.h"
+#include "utils/TextArena.h"
+
+QHash<const Poppler::Document*, DocumentBundle::RegistryEntry>
+    DocumentBundle::s_registry;
+QMutex DocumentBundle::s_registryMutex;
+
+namespace {
+
+void appendUInt32(QByteArray& out, quint32 value) {
+    const quint32 le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+void appendUInt64(QByteArray& out, quint64 value) {
+    const quint64 le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+void appendFloat(QByteArray& out, float value) {
+    quint32 bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendUInt32(out, bits);
+}
+
+void appendUtf16(QByteArray& out, QStringView text) {
+    const qsizetype offset = out.size();
+    out.resize(offset + text.size() * 2);
+    qToLittleEndian<quint16>(text.utf16(), text.size(), out.data() + offset);
+}
+
+quint32 readUInt32(QByteArrayView data, qint64 offset) {
+    return qFromLittleEndian<quint32>(data.data() + offset);
+}
+
+quint64 readUInt64(QByteArrayView data, qint64 offset) {
+    return qFromLittleEndian<quint64>(data.data() + offset);
+}
+
+float readFloat(QByteArrayView data, qint64 offset) {
+    const quint32 bits = readUInt32(data, offset);
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+QString readUtf16(QByteArrayView data, qint64 offset, qint64 units) {
+    QString text(units, Qt::Uninitialized);
+    qFromLittleEndian<quint16>(data.data() + offset, units, text.data());
+    return text;
+}
+
+QByteArray encodeThumbnail(const QImage& image, int quality) {
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::WriteOnly);
+    if (!image.save(&buffer, "JPEG", quality)) {
+        // Builds without the JPEG plugin still produce usable bundles
+        encoded.clear();
+        buffer.seek(0);
+        image.save(&buffer, "PNG");
+    }
+    return encoded;
+}
+
+}  // namespace
+
+DocumentBundle::~DocumentBundle() {
+    if (m_map) {
+        m_file.unmap(m_map);
+    }
+    m_file.close();
+}
+
+std::shared_ptr<DocumentBundle> DocumentBundle::open(
+    const QString& bundlePath, const QString& fingerprint) {
+    if (fingerprint.isEmpty()) {
+        return nullptr;
+    }
+
+    std::shared_ptr<DocumentBundle> bundle(new DocumentBundle());
+    if (!bundle->map(bundlePath)) {
+        LOG_WARNING("DocumentBundle: {} is not a valid bundle",
+                    bundlePath.toStdString());
+        return nullptr;
+    }
+
+    bundle->m_fingerprint =
+        QString::fromUtf8(bundle->section(SectionType::Fingerprint));
+    if (bundle->m_fingerprint != fingerprint) {
+        LOG_DEBUG("DocumentBundle: {} was built for different contents",
+                  bundlePath.toStdString());
+        return nullptr;
+    }
+
+    LOG_INFO("DocumentBundle: Using {} ({} pages)", bundlePath.toStdString(),
+             bundle->m_pageCount);
+    return bundle;
+}
+
+std::shared_ptr<DocumentBundle> DocumentBundle::openFor(
+    const QString& pdfPath) {
+    const QString fingerprint =
+        DocumentFingerprint::instance().cachedFingerprint(pdfPath);
+    if (fingerprint.isEmpty()) {
+        return openTrustedSidecar(pdfPath);
+    }
+    return openFor(pdfPath, fingerprint);
+}
+
+std::shared_ptr<DocumentBundle> DocumentBundle::openTrustedSidecar(
+    const QString& pdfPath) {
+    const QString sidecar = sidecarPath(pdfPath);
+    if (!QFileInfo::exists(sidecar)) {
+        return nullptr;
+    }
+
+    std::shared_ptr<DocumentBundle> bundle(new DocumentBundle());
+    if (!bundle->map(sidecar)) {
+        return nullptr;
+    }
+
+    // Bundles without the section, or a PDF replaced or touched since the
+    // build, wait for the hashed fingerprint instead
+    const QByteArrayView identity =
+        bundle->section(SectionType::SourceIdentity);
+    const QFileInfo info(pdfPath);
+    if (identity.size() != 16 ||
+        readUInt64(identity, 0) != static_cast<quint64>(info.size()) ||
+        static_cast<qint64>(readUInt64(identity, 8)) !=
+            info.lastModified().toMSecsSinceEpoch()) {
+        return nullptr;
+    }
+
+    bundle->m_fingerprint =
+        QString::fromUtf8(bundle->section(SectionType::Fingerprint));
+    if (bundle->m_fingerprint.isEmpty()) {
+        return nullptr;
+    }
+
+    LOG_INFO("DocumentBundle: Using {} ({} pages, matched by size and mtime)",
+             sidecar.toStdString(), bundle->m_pageCount);
+    return bundle;
+}
+
+std::shared_ptr<DocumentBundle> DocumentBundle::openFor(
+    const QString& pdfPath, const QString& fingerprint) {
+    if (fingerprint.isEmpty()) {
+        return nullptr;
+    }
+
+    const QString sidecar = sidecarPath(pdfPath);
+    const bool hasSidecar = QFileInfo::exists(sidecar);
+    const QDir cacheDir(cacheDirectory());
+    const bool hasCached = cacheDir.exists() && !cacheDir.isEmpty();
+    if (!hasSidecar && !hasCached) {
+        return nullptr;
+    }
+
+    if (hasSidecar) {
+        if (std::shared_ptr<DocumentBundle> bundle =
+                open(sidecar, fingerprint)) {
+            return bundle;
+        }
+    }
+
+    const QString cached = cachePath(fingerprint);
+    if (hasCached && QFileInfo::exists(cached)) {
+        return open(cached, fingerprint);
+    }
+    return nullptr;
+}
+
+QString DocumentBundle::sidecarPath(const QString& pdfPath) {
+    return pdfPath + QLatin1String(FILE_SUFFIX);
+}
+
+QString DocumentBundle::cachePath(const QString& fingerprint) {
+    return cacheDirectory() + "/" + fingerprint + QLatin1String(FILE_SUFFIX);
+}
+
+QString DocumentBundle::cacheDirectory() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+           "/bundles";
+}
+
+bool DocumentBundle::map(const QString& bundlePath) {
+    m_path = bundlePath;
+    m_file.setFileName(bundlePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 size = m_file.size();
+    m_map = size >= HEADER_SIZE ? m_file.map(0, size) : nullptr;
+    if (!m_map) {
+        return false;
+    }
+    m_mapSize = size;
+
+    const quint32 magic = qFromLittleEndian<quint32>(m_map);
+    const quint32 version = qFromLittleEndian<quint32>(m_map + 4);
+    const quint32 pageCount = qFromLittleEndian<quint32>(m_map + 8);
+    const quint32 sectionCount = qFromLittleEndian<quint32>(m_map + 12);
+    if (magic != MAGIC || version != VERSION || pageCount > INT_MAX ||
+        sectionCount > MAX_SECTIONS ||
+        HEADER_SIZE + sectionCount * SECTION_ENTRY_SIZE > size) {
+        return false;
+    }
+    m_pageCount = static_cast<int>(pageCount);
+
+    for (quint32 i = 0; i < sectionCount; ++i) {
+        const uchar* entry = m_map + HEADER_SIZE + i * SECTION_ENTRY_SIZE;
+        const quint32 type = qFromLittleEndian<quint32>(entry);
+        const quint64 offset = qFromLittleEndian<quint64>(entry + 8);
+        const quint64 length = qFromLittleEndian<quint64>(entry + 16);
+        if (offset > static_cast<quint64>(size) ||
+            length > static_cast<quint64>(size) - offset) {
+            return false;
+        }
+        if (type == 0 || type >= std::size(m_sections)) {
+            continue;
+        }
+
+        Section& section = m_sections[type];
+        section.present = true;
+        section.offset = offset;
+        section.length = length;
+        section.checksum = qFromLittleEndian<quint64>(entry + 24);
+    }
+    return m_sections[static_cast<int>(SectionType::Fingerprint)].present;
+}
+
+QByteArrayView DocumentBundle::section(SectionType type) const {
+    const Section& entry = m_sections[static_cast<int>(type)];
+    if (!entry.present) {
+        return QByteArrayView();
+    }
+
+    const QByteArrayView data(reinterpret_cast<const char*>(m_map) +
+                                  entry.offset,
+                              static_cast<qsizetype>(entry.length));
+    quint8 state = entry.state.load(std::memory_order_acquire);
+    if (state == Unchecked) {
+        // Racing first readers hash the same bytes and agree on the result
+        const bool valid = DocumentFingerprint::hashBytes(
+                               data.data(), data.size()) == entry.checksum;
+        state = valid ? Valid : Damaged;
+        entry.state.store(state, std::memory_order_release);
+        if (!valid) {
+            LOG_WARNING("DocumentBundle: Ignoring damaged section {} of {}",
+                        static_cast<quint32>(type), m_path.toStdString());
+        }
+    }
+    return state == Valid ? data : QByteArrayView();
+}
+
+bool DocumentBundle::hasPageMetadata() const {
+    return !section(SectionType::PageMetadata).isEmpty();
+}
+
+bool DocumentBundle::readPageMetadata(QList<PageMetadata>* pages) const {
+    const QByteArrayView data = section(SectionType::PageMetadata);
+    const qint64 count = m_pageCount;
+
+    // Columns: fingerprints, widths, heights, label offsets (count + 1, in
+    // UTF-16 units), orientations, flags, then the label characters
+    const qint64 widthsAt = count * 8;
+    const qint64 heightsAt = widthsAt + count * 4;
+    const qint64 labelOffsetsAt = heightsAt + count * 4;
+    const qint64 orientationsAt = labelOffsetsAt + (count + 1) * 4;
+    const qint64 flagsAt = orientationsAt + count;
+    const qint64 labelsAt = flagsAt + count;
+    if (data.isEmpty() || data.size() < labelsAt) {
+        return false;
+    }
+    const qint64 labelUnits = (data.size() - labelsAt) / 2;
+
+    QList<PageMetadata> result;
+    result.reserve(count);
+    for (qint64 i = 0; i < count; ++i) {
+        const qint64 labelStart = readUInt32(data, labelOffsetsAt + i * 4);
+        const qint64 labelEnd = readUInt32(data, labelOffsetsAt + i * 4 + 4);
+        if (labelStart > labelEnd || labelEnd > labelUnits) {
+            return false;
+        }
+
+        PageMetadata page;
+        page.contentFingerprint = readUInt64(data, i * 8);
+        page.width = readFloat(data, widthsAt + i * 4);
+        page.height = readFloat(data, heightsAt + i * 4);
+        page.orientation = static_cast<quint8>(data[orientationsAt + i]);
+        page.flags = static_cast<quint8>(data[flagsAt + i]);
+        page.label = readUtf16(data, labelsAt + labelStart * 2,
+                               labelEnd - labelStart);
+        result.append(page);
+    }
+
+    *pages = std::move(result);
+    return true;
+}
+
+bool DocumentBundle::hasTextLayer() const {
+    return !section(SectionType::TextLayer).isEmpty();
+}
+
+QString DocumentBundle::pageText(int pageNumber) const {
+    const QByteArrayView data = section(SectionType::TextLayer);
+    const qint64 textAt = (static_cast<qint64>(m_pageCount) + 1) * 4;
+    if (pageNumber < 0 || pageNumber >= m_pageCount || data.size() < textAt) {
+        return QString();
+    }
+
+    const qint64 start = readUInt32(data, pageNumber * 4);
+    const qint64 end = readUInt32(data, pageNumber * 4 + 4);
+    if (start > end || end > (data.size() - textAt) / 2) {
+        return QString();
+    }
+    return readUtf16(data, textAt + start * 2, end - start);
+}
+
+bool DocumentBundle::hasSearchIndex() const {
+    return !section(SectionType::SearchIndex).isEmpty();
+}
+
+QList<int> DocumentBundle::pagesWithWord(QStringView word) const {
+    QList<int> pages;
+    const QByteArrayView data = section(SectionType::SearchIndex);
+    if (data.size() < 8 || word.isEmpty() || word.size() > MAX_TERM_LENGTH) {
+        return pages;
+    }
+
+    // Terms are the index terms of the lowercased text, stored as UTF-8
+    const QByteArray key = word.toString().toLower().toUtf8();
+
+    const qint64 termCount = readUInt32(data, 0);
+    const qint64 postingCount = readUInt32(data, 4);
+    const qint64 termOffsetsAt = 8;
+    const qint64 postingOffsetsAt = termOffsetsAt + (termCount + 1) * 4;
+    const qint64 postingsAt = postingOffsetsAt + (termCount + 1) * 4;
+    const qint64 termsAt = postingsAt + postingCount * 4;
+    if (termsAt > data.size()) {
+        return pages;
+    }
+    const qint64 termBytes = data.size() - termsAt;
+
+    auto termAt = [&](qint64 index) {
+        const qint64 begin = readUInt32(data, termOffsetsAt + index * 4);
+        const qint64 end = readUInt32(data, termOffsetsAt + index * 4 + 4);
+        if (begin > end || end > termBytes) {
+            return std::string_view();
+        }
+        return std::string_view(data.data() + termsAt + begin,
+                                static_cast<std::size_t>(end - begin));
+    };
+    const std::string_view target(key.constData(),
+                                  static_cast<std::size_t>(key.size()));
+
+    // Binary search over the sorted term table, straight on the mapping
+    qint64 low = 0;
+    qint64 high = termCount;
+    while (low < high) {
+        const qint64 middle = low + (high - low) / 2;
+        if (termAt(middle) < target) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low == termCount || termAt(low) != target) {
+        return pages;
+    }
+
+    const qint64 begin = readUInt32(data, postingOffsetsAt + low * 4);
+    const qint64 end = readUInt32(data, postingOffsetsAt + low * 4 + 4);
+    if (begin > end || end > postingCount) {
+        return pages;
+    }
+    pages.reserve(end - begin);
+    for (qint64 i = begin; i < end; ++i) {
+        const quint32 page = readUInt32(data, postingsAt + i * 4);
+        if (page < static_cast<quint32>(m_pageCount)) {
+            pages.append(static_cast<int>(page));
+        }
+    }
+    return pages;
+}
+
+bool DocumentBundle::hasOutline() const {
+    return !section(SectionType::Outline).isEmpty();
+}
+
+QList<DocumentBundle::OutlineEntry> DocumentBundle::outline() const {
+    QList<OutlineEntry> entries;
+    const QByteArrayView data = section(SectionType::Outline);
+    if (data.size() < 4) {
+        return entries;
+    }
+
+    // Pre-order entries: level, page, title length, title characters
+    const quint32 count = readUInt32(data, 0);
+    qint64 at = 4;
+    int previousLevel = -1;
+    for (quint32 i = 0; i < count; ++i) {
+        if (data.size() - at < 12) {
+            return {};
+        }
+        OutlineEntry entry;
+        entry.level = static_cast<int>(readUInt32(data, at));
+        entry.pageNumber = static_cast<qint32>(readUInt32(data, at + 4));
+        const qint64 units = readUInt32(data, at + 8);
+        at += 12;
+        if ((data.size() - at) / 2 < units ||
+            entry.level > previousLevel + 1) {
+            return {};
+        }
+        entry.title = readUtf16(data, at, units);
+        at += units * 2;
+        previousLevel = entry.level;
+        entries.append(entry);
+    }
+    return entries;
+}
+
+bool DocumentBundle::hasThumbnails() const {
+    return !section(SectionType::Thumbnails).isEmpty();
+}
+
+QImage DocumentBundle::thumbnail(int pageNumber) const {
+    const QByteArrayView data = section(SectionType::Thumbnails);
+    const qint64 imagesAt = 8 + (static_cast<qint64>(m_pageCount) + 1) * 8;
+    if (pageNumber < 0 || pageNumber >= m_pageCount ||
+        data.size() < imagesAt) {
+        return QImage();
+    }
+
+    const quint64 begin = readUInt64(data, 8 + pageNumber * 8);
+    const quint64 end = readUInt64(data, 16 + pageNumber * 8);
+    if (begin >= end || end > static_cast<quint64>(data.size() - imagesAt)) {
+        return QImage();
+    }
+    return QImage::fromData(data.sliced(imagesAt + begin, end - begin));
+}
+
+bool DocumentBundle::build(const QString& pdfPath, const QString& bundlePath,
+                           const BuildOptions& options) {
+    // Taken before reading, so a PDF modified during the build never
+    // matches the recorded identity
+    const QFileInfo source(pdfPath);
+    const qint64 sourceSize = source.size();
+    const qint64 sourceModified = source.lastModified().toMSecsSinceEpoch();
+    std::unique_ptr<Poppler::Document> document(
+        Poppler::Document::load(pdfPath));
+    if (!document || document->isLocked()) {
+        LOG_WARNING("DocumentBundle: Cannot open {}", pdfPath.toStdString());
+        return false;
+    }
+
+    const QString fingerprint =
+        DocumentFingerprint::instance().fingerprint(pdfPath);
+    if (fingerprint.isEmpty()) {
+        return false;
+    }
+
+    document->setRenderHint(Poppler::Document::Antialiasing);
+    document->setRenderHint(Poppler::Document::TextAntialiasing);
+
+    const int pageCount = document->numPages();
+    QList<PageMetadata> pages(pageCount);
+    QByteArray labels;
+    QByteArray text;
+    QList<quint32> labelOffsets = {0};
+    QList<quint32> textOffsets = {0};
+    QList<QByteArray> thumbnails(pageCount);
+    std::map<QByteArray, QList<quint32>> postings;
+
+    for (int i = 0; i < pageCount; ++i) {
+        std::unique_ptr<Poppler::Page> page(document->page(i));
+        if (page) {
+            PageMetadata& metadata = pages[i];
+            const QSizeF size = page->pageSizeF();
+            const QString pageText = page->text(QRectF());
+            metadata.width = static_cast<float>(size.width());
+            metadata.height = static_cast<float>(size.height());
+            metadata.orientation = static_cast<quint8>(page->orientation());
+            metadata.label = page->label();
+
+            // Same flags and fingerprint as PageMetadataTable::fill
+            const double area = size.width() * size.height();
+            if (!pageText.trimmed().isEmpty()) {
+                metadata.flags |= PageMetadataTable::HasText;
+            }
+            if (pageText.length() < area / 1000.0) {
+                metadata.flags |= PageMetadataTable::HasImages;
+            }
+            metadata.contentFingerprint =
+                DocumentFingerprint::pageContentHash(
+                    pageText, metadata.width, metadata.height);
+
+            if (options.textLayer) {
+                appendUtf16(text, pageText);
+            }
+
+            if (options.searchIndex) {
+                const QString lowered = pageText.toLower();
+                TextArena arena;
+                auto words = arena.makeVector<QStringView>();
+                CjkTokenizer::indexTerms(lowered, words);
+                for (QStringView word : words) {
+                    if (word.size() > MAX_TERM_LENGTH) {
+                        continue;
+                    }
+                    QList<quint32>& list = postings[word.toUtf8()];
+                    if (list.isEmpty() || list.last() != quint32(i)) {
+                        list.append(static_cast<quint32>(i));
+                    }
+                }
+            }
+
+            const double longestEdge = qMax(size.width(), size.height());
+            if (options.thumbnailEdge > 0 && longestEdge > 0) {
+                const double dpi = 72.0 * options.thumbnailEdge / longestEdge;
+                const QImage image = page->renderToImage(dpi, dpi);
+                if (!image.isNull()) {
+                    thumbnails[i] =
+                        encodeThumbnail(image, options.thumbnailQuality);
+                }
+            }
+        }
+
+        appendUtf16(labels, pages[i].label);
+        labelOffsets.append(static_cast<quint32>(labels.size() / 2));
+        textOffsets.append(static_cast<quint32>(text.size() / 2));
+    }
+
+    QList<std::pair<SectionType, QByteArray>> sections;
+    sections.append({SectionType::Fingerprint, fingerprint.toUtf8()});
+
+    QByteArray identity;
+    appendUInt64(identity, static_cast<quint64>(sourceSize));
+    appendUInt64(identity, static_cast<quint64>(sourceModified));
+    sections.append({SectionType::SourceIdentity, identity});
+
+    QByteArray metadata;
+    for (const PageMetadata& page : pages) {
+        appendUInt64(metadata, page.contentFingerprint);
+    }
+    for (const PageMetadata& page : pages) {
+        appendFloat(metadata, page.width);
+    }
+    for (const PageMetadata& page : pages) {
+        appendFloat(metadata, page.height);
+    }
+    for (quint32 offset : labelOffsets) {
+        appendUInt32(metadata, offset);
+    }
+    for (const PageMetadata& page : pages) {
+        metadata.append(static_cast<char>(page.orientation));
+    }
+    for (const PageMetadata& page : pages) {
+        metadata.append(static_cast<char>(page.flags));
+    }
+    metadata.append(labels);
+    sections.append({SectionType::PageMetadata, metadata});
+
+    if (options.textLayer) {
+        QByteArray layer;
+        for (quint32 offset : textOffsets) {
+            appendUInt32(layer, offset);
+        }
+        layer.append(text);
+        sections.append({SectionType::TextLayer, layer});
+    }
+
+    if (options.searchIndex) {
+        QByteArray termOffsets;
+        QByteArray postingOffsets;
+        QByteArray postingList;
+        QByteArray terms;
+        quint32 postingCount = 0;
+        for (const auto& [term, termPages] : postings) {
+            appendUInt32(termOffsets, static_cast<quint32>(terms.size()));
+            appendUInt32(postingOffsets, postingCount);
+            terms.append(term);
+            for (quint32 page : termPages) {
+                appendUInt32(postingList, page);
+            }
+            postingCount += static_cast<quint32>(termPages.size());
+        }
+        appendUInt32(termOffsets, static_cast<quint32>(terms.size()));
+        appendUInt32(postingOffsets, postingCount);
+
+        QByteArray index;
+        appendUInt32(index, static_cast<quint32>(postings.size()));
+        appendUInt32(index, postingCount);
+        index.append(termOffsets);
+        index.append(postingOffsets);
+        index.append(postingList);
+        index.append(terms);
+        sections.append({SectionType::SearchIndex, index});
+    }
+
+    // Flatten the outline in pre-order; levels rebuild the tree
+    QByteArray outlineData;
+    quint32 outlineCount = 0;
+    std::function<void(const QList<Poppler::OutlineItem>&, int)> flatten =
+        [&](const QList<Poppler::OutlineItem>& items, int level) {
+            for (const Poppler::OutlineItem& item : items) {
+                const QString title = item.name();
+                if (title.isEmpty()) {
+                    continue;
+                }
+                int pageNumber = -1;
+                if (auto destination = item.destination()) {
+                    if (destination->pageNumber() > 0) {
+                        pageNumber = destination->pageNumber() - 1;
+                    }
+                }
+                appendUInt32(outlineData, static_cast<quint32>(level));
+                appendUInt32(outlineData, static_cast<quint32>(pageNumber));
+                appendUInt32(outlineData, static_cast<quint32>(title.size()));
+                appendUtf16(outlineData, title);
+                ++outlineCount;
+                if (item.hasChildren()) {
+                    flatten(item.children(), level + 1);
+                }
+            }
+        };
+    flatten(document->outline(), 0);
+    QByteArray outline;
+    appendUInt32(outline, outlineCount);
+    outline.append(outlineData);
+    sections.append({SectionType::Outline, outline});
+
+    if (options.thumbnailEdge > 0) {
+        QByteArray images;
+        QByteArray imageOffsets;
+        appendUInt64(imageOffsets, 0);
+        for (const QByteArray& image : thumbnails) {
+            images.append(image);
+            appendUInt64(imageOffsets, static_cast<quint64>(images.size()));
+        }
+        QByteArray thumbnailData;
+        appendUInt32(thumbnailData,
+                     static_cast<quint32>(options.thumbnailEdge));
+        appendUInt32(thumbnailData, 0);
+        thumbnailData.append(imageOffsets);
+        thumbnailData.append(images);
+        sections.append({SectionType::Thumbnails, thumbnailData});
+    }
+
+    // Header and section table, then each section padded to 8 bytes
+    QByteArray header;
+    appendUInt32(header, MAGIC);
+    appendUInt32(header, VERSION);
+    appendUInt32(header, static_cast<quint32>(pageCount));
+    appendUInt32(header, static_cast<quint32>(sections.size()));
+    quint64 offset = HEADER_SIZE + sections.size() * SECTION_ENTRY_SIZE;
+    for (const auto& [type, data] : sections) {
+        appendUInt32(header, static_cast<quint32>(type));
+        appendUInt32(header, 0);
+        appendUInt64(header, offset);
+        appendUInt64(header, static_cast<quint64>(data.size()));
+        appendUInt64(header, DocumentFingerprint::hashBytes(data.constData(),
+                                                            data.size()));
+        offset += (data.size() + 7) & ~qint64(7);
+    }
+
+    if (!QDir().mkpath(QFileInfo(bundlePath).absolutePath())) {
+        LOG_WARNING("DocumentBundle: Cannot create directory for {}",
+                    bundlePath.toStdString());
+        return false;
+    }
+
+    QSaveFile file(bundlePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_WARNING("DocumentBundle: Cannot write {}",
+                    bundlePath.toStdString());
+        return false;
+    }
+    file.write(header);
+    for (const auto& [type, data] : sections) {
+        file.write(data);
+        file.write(QByteArray((8 - data.size() % 8) % 8, '\0'));
+    }
+    if (!file.commit()) {
+        LOG_WARNING("DocumentBundle: Cannot write {}",
+                    bundlePath.toStdString());
+        return false;
+    }
+
+    LOG_INFO("DocumentBundle: Built {} ({} pages, {} terms, {} bytes)",
+             bundlePath.toStdString(), pageCount, postings.size(), offset);
+    return true;
+}
+
+void DocumentBundle::attach(const std::shared_ptr<Poppler::Document>& document,
+                            const std::shared_ptr<DocumentBundle>& bundle) {
+    if (!document || !bundle) {
+        return;
+    }
+
+    QMutexLocker locker(&s_registryMutex);
+    for (auto entry = s_registry.begin(); entry != s_registry.end();) {
+        if (entry->document.expired()) {
+            entry = s_registry.erase(entry);
+        } else {
+            ++entry;
+        }
+    }
+    s_registry.insert(document.get(), {document, bundle});
+}
+
+void DocumentBundle::detach(const Poppler::Document* document) {
+    QMutexLocker locker(&s_registryMutex);
+    s_registry.remove(document);
+}
+
+std::shared_ptr<DocumentBundle> DocumentBundle::find(
+    const Poppler::Document* document) {
+    if (!document) {
+        return nullptr;
+    }
+
+    QMutexLocker locker(&s_registryMutex);
+    auto it = s_registry.find(document);
+    if (it == s_registry.end() || it->document.expired()) {
+        return nullptr;
+    }
+    return it->bundle;
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <QByteArrayView>
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QMutex>
+#include <QSizeF>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+namespace Poppler {
+class Document;
+}
+
+/**
+ * Precomputed per-document data shipped next to a PDF.
+ *
+ * A bundle is produced offline (sast-readium --build-bundle) and holds
+ * what the viewer otherwise derives on first open: page metadata, the text
+ * layer, a word index for search, the outline and encoded thumbnails. The
+ * viewer looks for it as a sidecar (file.pdf.readium) or in the cache
+ * directory under the document fingerprint, memory-maps it and checks the
+ * fingerprint recorded inside against the PDF, so a bundle never applies
+ * to any other bytes than the ones it was built from. A sidecar also
+ * records the size and modification time of its PDF; while both still
+ * match, its fingerprint is trusted without hashing the document, so the
+ * first open of a file benefits from its sidecar too.
+ *
+ * Layout (little-endian): a 16-byte header, a section table and the
+ * sections, each 8-byte aligned. Only the header and section table are
+ * read on open; each section's checksum is verified on its first use and
+ * a damaged section is ignored on its own, so callers fall back to Poppler
+ * for that data only.
+ *
+ * Accessors are thread-safe.
+ */
+class DocumentBundle {
+public:
+    struct PageMetadata {
+        float width = 0.0f;
+        float height = 0.0f;
+        quint8 orientation = 0;
+        quint8 flags = 0;
+        quint64 contentFingerprint = 0;
+        QString label;
+    };
+
+    struct OutlineEntry {
+        QString title;
+        int pageNumber = -1;  // 0-based, -1 without destination
+        int level = 0;
+    };
+
+    struct BuildOptions {
+        int thumbnailEdge = 256;  // longest edge in pixels, 0 to skip
+        int thumbnailQuality = 80;
+        bool textLayer = true;
+        bool searchIndex = true;
+    };
+
+    ~DocumentBundle();
+
+    DocumentBundle(const DocumentBundle&) = delete;
+    DocumentBundle& operator=(const DocumentBundle&) = delete;
+
+    // Maps the bundle at bundlePath; null when missing, malformed or built
+    // for a different fingerprint
+    static std::shared_ptr<DocumentBundle> open(const QString& bundlePath,
+                                                const QString& fingerprint);
+    // Looks for the sidecar first, then the cache directory. Never hashes
+    // the document: without a memoized fingerprint only a sidecar whose
+    // recorded size and modification time match the PDF is used.
+    static std::shared_ptr<DocumentBundle> openFor(const QString& pdfPath);
+    static std::shared_ptr<DocumentBundle> openFor(const QString& pdfPath,
+                                                   const QString& fingerprint);
+
+    static QString sidecarPath(const QString& pdfPath);
+    static QString cachePath(const QString& fingerprint);
+    static QString cacheDirectory();
+
+    static bool build(const QString& pdfPath, const QString& bundlePath,
+                      const BuildOptions& options = BuildOptions());
+
+    // Per-document registry, populated when a document is opened
+    static void attach(const std::shared_ptr<Poppler::Document>& document,
+                       const std::shared_ptr<DocumentBundle>& bundle);
+    static void detach(const Poppler::Document* document);
+    static std::shared_ptr<DocumentBundle> find(
+        const Poppler::Document* document);
+
+    QString path() const { return m_path; }
+    QString fingerprint() const { return m_fingerprint; }
+    int pageCount() const { return m_pageCount; }
+
+    bool hasPageMetadata() const;
+    // Fills every page at once; false when the section is unusable
+    bool readPageMetadata(QList<PageMetadata>* pages) const;
+
+    bool hasTextLayer() const;
+    QString pageText(int pageNumber) const;
+
+    bool hasSearchIndex() const;
+    // Sorted pages whose text contains the term; terms are those of
+    // CjkTokenizer::indexTerms on the lowercased text (ASCII word runs and
+    // CJK bigrams)
+    QList<int> pagesWithWord(QStringView word) const;
+
+    bool hasOutline() const;
+    QList<OutlineEntry> outline() const;
+
+    bool hasThumbnails() const;
+    QImage thumbnail(int pageNumber) const;
+
+    static constexpr char FILE_SUFFIX[] = ".readium";
+    // Longer terms are left out of the search index
+    static constexpr int MAX_TERM_LENGTH = 64;
+
+private:
+    enum class SectionType : quint32 {
+        Fingerprint = 1,
+        PageMetadata = 2,
+        TextLayer = 3,
+        SearchIndex = 4,
+        Outline = 5,
+        Thumbnails = 6,
+        SourceIdentity = 7  // size and mtime of the PDF at build time
+    };
+
+    enum SectionState : quint8 { Unchecked = 0, Valid = 1, Damaged = 2 };
+
+    struct Section {
+        bool present = false;
+        quint64 offset = 0;
+        quint64 length = 0;
+        quint64 checksum = 0;
+        mutable std::atomic<quint8> state{Unchecked};
+    };
+
+    DocumentBundle() = default;
+
+    // Sidecar whose recorded source identity matches the PDF on disk
+    static std::shared_ptr<DocumentBundle> openTrustedSidecar(
+        const QString& pdfPath);
+    bool map(const QString& bundlePath);
+    // Verified view of a section, empty when absent or damaged
+    QByteArrayView section(SectionType type) const;
+
+    QString m_path;
+    QString m_fingerprint;
+    int m_pageCount = 0;
+
+    QFile m_file;
+    uchar* m_map = nullptr;
+    qint64 m_mapSize = 0;
+    // Indexed by SectionType; unknown types in newer files are skipped
+    Section m_sections[static_cast<int>(SectionType::SourceIdentity) + 1];
+
+    struct RegistryEntry {
+        std::weak_ptr<Poppler::Document> document;
+        std::shared_ptr<DocumentBundle> bundle;
+    };
+    static QHash<const Poppler::Document*, RegistryEntry> s_registry;
+    static QMutex s_registryMutex;
+
+    static constexpr quint32 MAGIC = 0x42445253;  // "SRDB"
+    // 2: CJK bigram terms in the search index, terms stored as UTF-8
+    static constexpr quint32 VERSION = 2;
+    static constexpr qint64 HEADER_SIZE = 16;
+    static constexpr qint64 SECTION_ENTRY_SIZE = 32;
+    static constexpr int MAX_SECTIONS = 16;
+};
@@ -0,0 +1,321 @@
+#include "DocumentClassifier.h"
+#include <QDataStream>
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include "utils/LoggingMacros.h"
+
+namespace {
+
+// Where each feature comes from in the analysis JSON
+struct FeatureSpec {
+    const char* name;
+    const char* section;
+    const char* key;
+    bool logScale;  // Counts and sizes; booleans and scores are used as-is
+};
+
+constexpr FeatureSpec FEATURES[] = {
+    {"pageCount", "structure", "pageCount", true},
+    {"words", "text", "totalWords", true},
+    {"characters", "text", "totalCharacters", true},
+    {"sentences", "text", "totalSentences", true},
+    {"paragraphs", "text", "totalParagraphs", true},
+    {"wordsPerPage", "text", "averageWordsPerPage", true},
+    {"images", "images", "totalImages", true},
+    {"imagesPerPage", "images", "imagesPerPage", true},
+    {"imageBytes", "images", "estimatedTotalSize", true},
+    {"pageWidth", "structure", "pageWidth", true},
+    {"pageHeight", "structure", "pageHeight", true},
+    {"uniformPageSize", "structure", "uniformPageSize", false},
+    {"encrypted", "security", "isEncrypted", false},
+    {"qualityScore", "quality", "qualityScore", false},
+    {"hasText", "quality", "hasText", false},
+    {"accessibilityScore", "accessibility", "accessibilityScore", false},
+    {"hasTitle", "accessibility", "hasTitle", false},
+    {"hasAuthor", "accessibility", "hasAuthor", false}};
+
+static_assert(std::size(FEATURES) == DocumentClassifier::FeatureCount,
+              "FEATURES must follow DocumentClassifier::Feature");
+
+}  // namespace
+
+void DocumentClassifier::FeatureMatrix::append(const FeatureVector& features) {
+    const qsizetype offset = m_values.size();
+    m_values.resize(offset + FeatureCount);
+    std::copy(features.begin(), features.end(), m_values.begin() + offset);
+}
+
+DocumentClassifier::FeatureVector DocumentClassifier::extract(
+    const QJsonObject& analysis) {
+    FeatureVector features{};
+    for (int i = 0; i < FeatureCount; ++i) {
+        const FeatureSpec& spec = FEATURES[i];
+        const QJsonValue value = analysis.value(QLatin1String(spec.section))
+                                     .toObject()
+                                     .value(QLatin1String(spec.key));
+        double number = value.isBool() ? (value.toBool() ? 1.0 : 0.0)
+                                       : qMax(0.0, value.toDouble());
+        if (spec.logScale) {
+            number = std::log1p(number);
+        }
+        features[i] = static_cast<float>(number);
+    }
+    return features;
+}
+
+QString DocumentClassifier::featureName(int feature) {
+    return feature >= 0 && feature < FeatureCount
+               ? QString::fromLatin1(FEATURES[feature].name)
+               : QString();
+}
+
+double DocumentClassifier::similarity(const FeatureVector& first,
+                                      const FeatureVector& second) {
+    double dot = 0.0;
+    double firstNorm = 0.0;
+    double secondNorm = 0.0;
+    for (int i = 0; i < FeatureCount; ++i) {
+        dot += double(first[i]) * second[i];
+        firstNorm += double(first[i]) * first[i];
+        secondNorm += double(second[i]) * second[i];
+    }
+    if (firstNorm == 0.0 || secondNorm == 0.0) {
+        return firstNorm == secondNorm ? 1.0 : 0.0;
+    }
+    return dot / qSqrt(firstNorm * secondNorm);
+}
+
+bool DocumentClassifier::train(const FeatureMatrix& samples,
+                               const QList<int>& labels,
+                               const QStringList& classNames) {
+    const qsizetype classCount = classNames.size();
+    const qsizetype rows = qMin(samples.rows(), labels.size());
+
+    // Two passes in double: means, then variances around them
+    std::vector<qint64> counts(classCount, 0);
+    std::vector<double> means(classCount * FeatureCount, 0.0);
+    std::vector<double> variances(classCount * FeatureCount, 0.0);
+    qint64 total = 0;
+
+    for (qsizetype r = 0; r < rows; ++r) {
+        const int label = labels[r];
+        if (label < 0 || label >= classCount) {
+            continue;
+        }
+        const float* row = samples.row(r);
+        double* mean = means.data() + label * FeatureCount;
+        for (int j = 0; j < FeatureCount; ++j) {
+            mean[j] += row[j];
+        }
+        ++counts[label];
+        ++total;
+    }
+    if (total == 0) {
+        LOG_WARNING("DocumentClassifier: No labelled samples to train on");
+        return false;
+    }
+
+    for (qsizetype c = 0; c < classCount; ++c) {
+        for (int j = 0; j < FeatureCount && counts[c] > 0; ++j) {
+            means[c * FeatureCount + j] /= counts[c];
+        }
+    }
+    for (qsizetype r = 0; r < rows; ++r) {
+        const int label = labels[r];
+        if (label < 0 || label >= classCount) {
+            continue;
+        }
+        const float* row = samples.row(r);
+        const double* mean = means.data() + label * FeatureCount;
+        double* variance = variances.data() + label * FeatureCount;
+        for (int j = 0; j < FeatureCount; ++j) {
+            const double delta = row[j] - mean[j];
+            variance[j] += delta * delta;
+        }
+    }
+
+    m_classNames.clear();
+    m_linear.clear();
+    m_quadratic.clear();
+    m_bias.clear();
+
+    // Classes without samples are dropped rather than scored with an
+    // undefined distribution
+    for (qsizetype c = 0; c < classCount; ++c) {
+        if (counts[c] == 0) {
+            continue;
+        }
+        double bias = std::log(double(counts[c]) / total);
+        for (int j = 0; j < FeatureCount; ++j) {
+            const double mean = means[c * FeatureCount + j];
+            const double variance =
+                variances[c * FeatureCount + j] / counts[c] + VARIANCE_FLOOR;
+            // log N(x; mean, variance) =
+            //   x * mean/variance - x^2 / (2 variance)
+            //   - mean^2 / (2 variance) - log(2 pi variance) / 2
+            m_linear.append(static_cast<float>(mean / variance));
+            m_quadratic.append(static_cast<float>(-0.5 / variance));
+            bias -= mean * mean / (2.0 * variance) +
+                    0.5 * std::log(2.0 * M_PI * variance);
+        }
+        m_bias.append(static_cast<float>(bias));
+        m_classNames.append(classNames[c]);
+    }
+
+    LOG_DEBUG("DocumentClassifier: Trained {} classes on {} samples",
+              m_classNames.size(), total);
+    return true;
+}
+
+int DocumentClassifier::predict(const FeatureVector& features) const {
+    int best = -1;
+    float bestScore = -std::numeric_limits<float>::infinity();
+    for (qsizetype c = 0; c < m_classNames.size(); ++c) {
+        const float* linear = m_linear.constData() + c * FeatureCount;
+        const float* quadratic = m_quadratic.constData() + c * FeatureCount;
+        float score = m_bias[c];
+        for (int j = 0; j < FeatureCount; ++j) {
+            score += features[j] * (linear[j] + quadratic[j] * features[j]);
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            best = static_cast<int>(c);
+        }
+    }
+    return best;
+}
+
+QList<int> DocumentClassifier::predictBatch(
+    const FeatureMatrix& samples) const {
+    QList<int> predictions;
+    const qsizetype rows = samples.rows();
+    if (!isValid()) {
+        predictions.fill(-1, rows);
+        return predictions;
+    }
+    predictions.reserve(rows);
+
+    // Feature-major copy of one block: columns[j * BLOCK_ROWS + r]
+    std::vector<float> columns(FeatureCount * BLOCK_ROWS);
+    std::array<float, BLOCK_ROWS> scores;
+    std::array<float, BLOCK_ROWS> bestScores;
+    std::array<int, BLOCK_ROWS> bestClasses;
+
+    for (qsizetype start = 0; start < rows; start += BLOCK_ROWS) {
+        const qsizetype count = qMin(BLOCK_ROWS, rows - start);
+        std::fill(columns.begin(), columns.end(), 0.0f);
+        for (qsizetype r = 0; r < count; ++r) {
+            const float* row = samples.row(start + r);
+            for (int j = 0; j < FeatureCount; ++j) {
+                columns[j * BLOCK_ROWS + r] = row[j];
+            }
+        }
+
+        bestScores.fill(-std::numeric_limits<float>::infinity());
+        bestClasses.fill(0);
+        for (qsizetype c = 0; c < m_classNames.size(); ++c) {
+            scores.fill(m_bias[c]);
+            for (int j = 0; j < FeatureCount; ++j) {
+                const float linear = m_linear[c * FeatureCount + j];
+                const float quadratic = m_quadratic[c * FeatureCount + j];
+                const float* x = columns.data() + j * BLOCK_ROWS;
+                for (qsizetype r = 0; r < BLOCK_ROWS; ++r) {
+                    scores[r] += x[r] * (linear + quadratic * x[r]);
+                }
+            }
+            // Selects instead of branches, so this loop vectorizes too
+            const int classIndex = static_cast<int>(c);
+            for (qsizetype r = 0; r < BLOCK_ROWS; ++r) {
+                const bool better = scores[r] > bestScores[r];
+                bestScores[r] = better ? scores[r] : bestScores[r];
+                bestClasses[r] = better ? classIndex : bestClasses[r];
+            }
+        }
+
+        for (qsizetype r = 0; r < count; ++r) {
+            predictions.append(bestClasses[r]);
+        }
+    }
+    return predictions;
+}
+
+QByteArray DocumentClassifier::serialize() const {
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    out << MAGIC << VERSION << static_cast<qint32>(FeatureCount)
+        << m_classNames;
+    for (qsizetype c = 0; c < m_classNames.size(); ++c) {
+        out << m_bias[c];
+        for (int j = 0; j < FeatureCount; ++j) {
+            out << m_linear[c * FeatureCount + j]
+                << m_quadratic[c * FeatureCount + j];
+        }
+    }
+    return data;
+}
+
+bool DocumentClassifier::deserialize(const QByteArray& data) {
+    QDataStream in(data);
+    in.setVersion(QDataStream::Qt_6_0);
+    in.setFloatingPointPrecision(QDataStream::SinglePrecision);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 featureCount = 0;
+    QStringList classNames;
+    in >> magic >> version >> featureCount >> classNames;
+    if (in.status() != QDataStream::Ok || magic != MAGIC ||
+        version != VERSION || featureCount != FeatureCount) {
+        LOG_WARNING("DocumentClassifier: Ignoring incompatible model");
+        return false;
+    }
+
+    QList<float> linear;
+    QList<float> quadratic;
+    QList<float> bias;
+    linear.reserve(classNames.size() * FeatureCount);
+    quadratic.reserve(classNames.size() * FeatureCount);
+    for (qsizetype c = 0; c < classNames.size(); ++c) {
+        float value = 0.0f;
+        in >> value;
+        bias.append(value);
+        for (int j = 0; j < FeatureCount; ++j) {
+            float weight = 0.0f;
+            in >> weight >> value;
+            linear.append(weight);
+            quadratic.append(value);
+        }
+    }
+    if (in.status() != QDataStream::Ok) {
+        LOG_WARNING("DocumentClassifier: Truncated model");
+        return false;
+    }
+
+    m_classNames = classNames;
+    m_linear = linear;
+    m_quadratic = quadratic;
+    m_bias = bias;
+    return true;
+}
+
+QJsonObject DocumentClassifier::toJson() const {
+    QJsonObject json;
+    json["type"] = "gaussianNaiveBayes";
+    json["classes"] = QJsonArray::fromStringList(m_classNames);
+    json["model"] = QString::fromLatin1(serialize().toBase64());
+    return json;
+}
+
+bool DocumentClassifier::fromJson(const QJsonObject& json) {
+    return deserialize(
+        QByteArray::fromBase64(json.value("model").toString().toLatin1()));
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <array>
+
+/**
+ * Gaussian naive Bayes over dense document feature vectors.
+ *
+ * Analysis results are reduced once, while the document is analyzed, to a
+ * fixed-layout float vector (see Feature); counts are log-scaled so that
+ * page and character totals do not swamp the ratios. Classification then
+ * never touches JSON.
+ *
+ * The per-class Gaussian log-likelihood is quadratic in each feature, so a
+ * trained model is stored as a linear model over [x, x^2]: one weight row
+ * per class for x, one for x^2 and a bias. predictBatch() evaluates it over
+ * a row-major matrix in blocks that are transposed to feature-major order,
+ * which turns the inner loop into a contiguous multiply-add over rows that
+ * the compiler vectorizes.
+ */
+class DocumentClassifier {
+public:
+    // The order is part of the model format; append only
+    enum Feature {
+        PageCount,
+        Words,
+        Characters,
+        Sentences,
+        Paragraphs,
+        WordsPerPage,
+        Images,
+        ImagesPerPage,
+        ImageBytes,
+        PageWidth,
+        PageHeight,
+        UniformPageSize,
+        Encrypted,
+        QualityScore,
+        HasText,
+        AccessibilityScore,
+        HasTitle,
+        HasAuthor,
+        FeatureCount
+    };
+
+    using FeatureVector = std::array<float, FeatureCount>;
+
+    // Row-major, FeatureCount floats per row
+    class FeatureMatrix {
+    public:
+        void reserve(qsizetype rows) { m_values.reserve(rows * FeatureCount); }
+        void append(const FeatureVector& features);
+        qsizetype rows() const { return m_values.size() / FeatureCount; }
+        const float* row(qsizetype index) const {
+            return m_values.constData() + index * FeatureCount;
+        }
+
+    private:
+        QList<float> m_values;
+    };
+
+    static FeatureVector extract(const QJsonObject& analysis);
+    static QString featureName(int feature);
+    // Cosine similarity; features are non-negative, so the result is in
+    // [0, 1]
+    static double similarity(const FeatureVector& first,
+                             const FeatureVector& second);
+
+    // labels[i] indexes classNames; rows with out-of-range labels are
+    // ignored. Fails without any usable row.
+    bool train(const FeatureMatrix& samples, const QList<int>& labels,
+               const QStringList& classNames);
+
+    bool isValid() const { return !m_classNames.isEmpty(); }
+    QStringList classNames() const { return m_classNames; }
+
+    // Class index, -1 for an untrained model
+    int predict(const FeatureVector& features) const;
+    QList<int> predictBatch(const FeatureMatrix& samples) const;
+
+    QByteArray serialize() const;
+    bool deserialize(const QByteArray& data);
+    // The serialized model wrapped for JSON reports
+    QJsonObject toJson() const;
+    bool fromJson(const QJsonObject& json);
+
+private:
+    QStringList m_classNames;
+    // classes x FeatureCount, row-major
+    QList<float> m_linear;
+    QList<float> m_quadratic;
+    QList<float> m_bias;
+
+    static constexpr quint32 MAGIC = 0x43445253;  // "SRDC"
+    static constexpr quint32 VERSION = 1;
+    static constexpr qsizetype BLOCK_ROWS = 64;
+    // Keeps constant features (e.g. every sample unencrypted) from
+    // producing infinite weights
+    static constexpr double VARIANCE_FLOOR = 1e-3;
+};
@@ -0,0 +1,428 @@
+#include "DocumentFingerprint.h"
+#include <poppler-qt6.h>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QRectF>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include "model/PageMetadataTable.h"
+#include "utils/LoggingMacros.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+// XXH64, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+constexpr quint64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+constexpr quint64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr quint64 PRIME64_3 = 0x165667B19E3779F9ULL;
+constexpr quint64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr quint64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+inline quint64 rotl64(quint64 value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
+}
+
+inline quint64 xxhRound(quint64 acc, quint64 input) {
+    acc += input * PRIME64_2;
+    acc = rotl64(acc, 31);
+    return acc * PRIME64_1;
+}
+
+inline quint64 xxhMergeRound(quint64 acc, quint64 value) {
+    acc ^= xxhRound(0, value);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+quint64 xxh64(const uchar* p, qint64 length, quint64 seed) {
+    const uchar* const end = p + length;
+    quint64 h;
+
+    if (length >= 32) {
+        const uchar* const limit = end - 32;
+        quint64 v1 = seed + PRIME64_1 + PRIME64_2;
+        quint64 v2 = seed + PRIME64_2;
+        quint64 v3 = seed;
+        quint64 v4 = seed - PRIME64_1;
+
+        do {
+            v1 = xxhRound(v1, qFromLittleEndian<quint64>(p));
+            v2 = xxhRound(v2, qFromLittleEndian<quint64>(p + 8));
+            v3 = xxhRound(v3, qFromLittleEndian<quint64>(p + 16));
+            v4 = xxhRound(v4, qFromLittleEndian<quint64>(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxhMergeRound(h, v1);
+        h = xxhMergeRound(h, v2);
+        h = xxhMergeRound(h, v3);
+        h = xxhMergeRound(h, v4);
+    } else {
+        h = seed + PRIME64_5;
+    }
+
+    h += static_cast<quint64>(length);
+
+    while (p + 8 <= end) {
+        h ^= xxhRound(0, qFromLittleEndian<quint64>(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+        p += 8;
+    }
+
+    if (p + 4 <= end) {
+        h ^= static_cast<quint64>(qFromLittleEndian<quint32>(p)) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+
+    while (p < end) {
+        h ^= static_cast<quint64>(*p) * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+}  // namespace
+
+DocumentFingerprint& DocumentFingerprint::instance() {
+    static DocumentFingerprint instance;
+    return instance;
+}
+
+DocumentFingerprint::DocumentFingerprint() : m_pool(new QThreadPool(this)) {
+    // Hashing is I/O bound; two workers keep one file streaming while the
+    // other is being mapped
+    m_pool->setMaxThreadCount(2);
+}
+
+DocumentFingerprint::~DocumentFingerprint() {
+    m_pool->clear();
+    m_pool->waitForDone();
+}
+
+QString DocumentFingerprint::fingerprint(const QString& filePath) {
+    const FileIdentity identity = identityOf(filePath);
+    if (!identity.isValid()) {
+        return QString();
+    }
+
+    QString digest = lookup(identity);
+    if (!digest.isEmpty()) {
+        return digest;
+    }
+
+    digest = computeDigest(filePath, identity.size);
+    if (!digest.isEmpty()) {
+        remember(identity, digest);
+    }
+    return digest;
+}
+
+QString DocumentFingerprint::cachedFingerprint(const QString& filePath) {
+    const FileIdentity identity = identityOf(filePath);
+    return identity.isValid() ? lookup(identity) : QString();
+}
+
+void DocumentFingerprint::requestFingerprint(const QString& filePath) {
+    {
+        QMutexLocker locker(&m_mutex);
+        if (filePath.isEmpty() || m_pending.contains(filePath)) {
+            return;
+        }
+        m_pending.insert(filePath);
+    }
+
+    m_pool->start([this, filePath]() {
+        const QString digest = fingerprint(filePath);
+        {
+            QMutexLocker locker(&m_mutex);
+            m_pending.remove(filePath);
+        }
+        emit fingerprintReady(filePath, digest);
+    });
+}
+
+QString DocumentFingerprint::pageKey(const QString& documentFingerprint,
+                                     int pageNumber) {
+    if (documentFingerprint.isEmpty() || pageNumber < 0) {
+        return QString();
+    }
+    return documentFingerprint + QStringLiteral("#p") +
+           QString::number(pageNumber);
+}
+
+quint64 DocumentFingerprint::pageContentHash(Poppler::Document* document,
+                                             int pageNumber) {
+    if (!document) {
+        return 0;
+    }
+
+    std::shared_ptr<PageMetadataTable> table =
+        PageMetadataTable::find(document);
+    if (table && table->hasContent(pageNumber)) {
+        return table->contentFingerprint(pageNumber);
+    }
+
+    std::unique_ptr<Poppler::Page> page(document->page(pageNumber));
+    if (!page) {
+        return 0;
+    }
+
+    const QSizeF size = page->pageSizeF();
+    return pageContentHash(page->text(QRectF()),
+                           static_cast<float>(size.width()),
+                           static_cast<float>(size.height()));
+}
+
+quint64 DocumentFingerprint::pageContentHash(const QString& text, float width,
+                                             float height) {
+    // Poppler does not expose raw content streams; extracted text plus page
+    // geometry is the closest stable proxy
+    const float dimensions[2] = {width, height};
+    const quint64 seed = hashBytes(dimensions, sizeof(dimensions));
+    return hashBytes(text.utf16(),
+                     static_cast<qint64>(text.size()) * sizeof(char16_t),
+                     seed);
+}
+
+quint64 DocumentFingerprint::hashBytes(const void* data, qint64 length,
+                                       quint64 seed) {
+    if (!data || length <= 0) {
+        return xxh64(nullptr, 0, seed);
+    }
+    return xxh64(static_cast<const uchar*>(data), length, seed);
+}
+
+void DocumentFingerprint::clearMemo() {
+    QMutexLocker locker(&m_mutex);
+    m_memo.clear();
+    m_loaded = true;
+    QFile::remove(tablePath());
+}
+
+DocumentFingerprint::FileIdentity DocumentFingerprint::identityOf(
+    const QString& filePath) {
+    FileIdentity identity;
+
+    QFileInfo info(filePath);
+    if (filePath.isEmpty() || !info.exists() || !info.isFile()) {
+        return identity;
+    }
+
+#ifdef Q_OS_UNIX
+    struct stat status;
+    if (::stat(QFile::encodeName(filePath).constData(), &status) != 0) {
+        return identity;
+    }
+    identity.device = static_cast<quint64>(status.st_dev);
+    identity.inode = static_cast<quint64>(status.st_ino);
+#else
+    // No portable inode; the canonical path stands in for it
+    const QString canonical = info.canonicalFilePath();
+    identity.inode = hashBytes(
+        canonical.utf16(),
+        static_cast<qint64>(canonical.size()) * sizeof(char16_t));
+#endif
+
+    identity.size = info.size();
+    identity.mtime = info.lastModified().toMSecsSinceEpoch();
+    return identity;
+}
+
+QList<QPair<qint64, qint64>> DocumentFingerprint::hashRanges(qint64 size) {
+    QList<QPair<qint64, qint64>> ranges;
+
+    if (size <= SAMPLED_THRESHOLD) {
+        // Full mode: fixed blocks, so mapped and streamed reads agree
+        for (qint64 offset = 0; offset < size; offset += BLOCK_SIZE) {
+            ranges.append({offset, qMin(BLOCK_SIZE, size - offset)});
+        }
+        return ranges;
+    }
+
+    // Sampled mode: the head holds the header and linearization data, the
+    // tail holds the xref table and trailer that every save rewrites
+    ranges.append({0, SAMPLE_EDGE_SIZE});
+
+    const qint64 middleStart = SAMPLE_EDGE_SIZE;
+    const qint64 middleLength = size - 2 * SAMPLE_EDGE_SIZE;
+    const qint64 stride = middleLength / SAMPLE_BLOCKS;
+    for (int i = 0; i < SAMPLE_BLOCKS; ++i) {
+        ranges.append({middleStart + i * stride,
+                       qMin(SAMPLE_BLOCK_SIZE, stride)});
+    }
+
+    ranges.append({size - SAMPLE_EDGE_SIZE, SAMPLE_EDGE_SIZE});
+    return ranges;
+}
+
+QString DocumentFingerprint::computeDigest(const QString& filePath,
+                                           qint64 size) {
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_WARNING("DocumentFingerprint: Cannot open {}",
+                    filePath.toStdString());
+        return QString();
+    }
+
+    const bool sampled = size > SAMPLED_THRESHOLD;
+    const QList<QPair<qint64, qint64>> ranges = hashRanges(size);
+
+    // Seeding with the size keeps truncated files apart from their prefix
+    quint64 digest = hashBytes(&size, sizeof(size));
+
+    uchar* mapped = size > 0 ? file.map(0, size) : nullptr;
+    if (mapped) {
+        for (const auto& range : ranges) {
+            digest = hashBytes(mapped + range.first, range.second, digest);
+        }
+        file.unmap(mapped);
+    } else {
+        // Mapping can fail on some filesystems or for huge files on 32-bit
+        // builds; stream the same ranges instead
+        for (const auto& range : ranges) {
+            if (!file.seek(range.first)) {
+                return QString();
+            }
+            const QByteArray block = file.read(range.second);
+            if (block.size() != range.second) {
+                return QString();
+            }
+            digest = hashBytes(block.constData(), block.size(), digest);
+        }
+    }
+
+    return QString("%1%2-%3")
+        .arg(sampled ? QChar('s') : QChar('f'))
+        .arg(digest, 16, 16, QChar('0'))
+        .arg(size, 0, 16);
+}
+
+QString DocumentFingerprint::lookup(const FileIdentity& identity) {
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+
+    auto it = m_memo.find(identity);
+    if (it == m_memo.end()) {
+        return QString();
+    }
+
+    it->lastUsed = QDateTime::currentSecsSinceEpoch();
+    return it->fingerprint;
+}
+
+void DocumentFingerprint::remember(const FileIdentity& identity,
+                                   const QString& fingerprint) {
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+
+    m_memo.insert(identity,
+                  {fingerprint, QDateTime::currentSecsSinceEpoch()});
+
+    if (m_memo.size() > MAX_MEMO_ENTRIES) {
+        // Drop the least recently used quarter in one go
+        QList<qint64> ages;
+        ages.reserve(m_memo.size());
+        for (const MemoEntry& entry : std::as_const(m_memo)) {
+            ages.append(entry.lastUsed);
+        }
+        const int cut = m_memo.size() / 4;
+        std::nth_element(ages.begin(), ages.begin() + cut, ages.end());
+        const qint64 threshold = ages.at(cut);
+
+        for (auto it = m_memo.begin(); it != m_memo.end();) {
+            it = it->lastUsed <= threshold ? m_memo.erase(it) : std::next(it);
+        }
+    }
+
+    saveTable();
+}
+
+void DocumentFingerprint::ensureLoaded() {
+    // Called with m_mutex held
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+
+    QFile file(tablePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+    if (magic != TABLE_MAGIC || version != TABLE_VERSION || count < 0) {
+        LOG_WARNING("DocumentFingerprint: Ignoring incompatible table {}",
+                    tablePath().toStdString());
+        return;
+    }
+
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        FileIdentity identity;
+        MemoEntry entry;
+        in >> identity.device >> identity.inode >> identity.size >>
+            identity.mtime >> entry.fingerprint >> entry.lastUsed;
+        if (in.status() == QDataStream::Ok) {
+            m_memo.insert(identity, entry);
+        }
+    }
+
+    LOG_DEBUG("DocumentFingerprint: Loaded {} memoized fingerprints",
+              m_memo.size());
+}
+
+void DocumentFingerprint::saveTable() {
+    // Called with m_mutex held
+    const QString path = tablePath();
+    if (!QDir().mkpath(QFileInfo(path).absolutePath())) {
+        return;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_WARNING("DocumentFingerprint: Cannot write {}", path.toStdString());
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << TABLE_MAGIC << TABLE_VERSION << static_cast<qint32>(m_memo.size());
+    for (auto it = m_memo.cbegin(); it != m_memo.cend(); ++it) {
+        out << it.key().device << it.key().inode << it.key().size
+            << it.key().mtime << it->fingerprint << it->lastUsed;
+    }
+
+    if (!file.commit()) {
+        LOG_WARNING("DocumentFingerprint: Failed to commit {}",
+                    path.toStdString());
+    }
+}
+
+QString DocumentFingerprint::tablePath() {
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+           "/fingerprints.dat";
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QString>
+#include <QThreadPool>
+
+namespace Poppler {
+class Document;
+}
+
+/**
+ * Content fingerprints shared by every persistent cache.
+ *
+ * A document fingerprint is an XXH64 digest of the file contents, read
+ * through a memory mapping. Files above SAMPLED_THRESHOLD are hashed in a
+ * sampled mode (head, tail and evenly spaced blocks) so that multi-GB files
+ * cost a few MB of I/O. Digests are memoized by file identity (device,
+ * inode, size, mtime) in a small table persisted in the cache directory, so
+ * reopening an unchanged file never touches its contents again.
+ *
+ * Unlike a path, a fingerprint survives renames and moves and changes
+ * whenever the bytes change, which makes it the right key for analysis
+ * results, bookmarks and rendered pages.
+ */
+class DocumentFingerprint : public QObject {
+    Q_OBJECT
+
+public:
+    static DocumentFingerprint& instance();
+
+    // Memoized digest; computes on the calling thread when unknown.
+    // Returns an empty string for missing or unreadable files.
+    QString fingerprint(const QString& filePath);
+    // Memo lookup only, never reads file contents
+    QString cachedFingerprint(const QString& filePath);
+    // Computes on a worker thread and emits fingerprintReady
+    void requestFingerprint(const QString& filePath);
+
+    // Stable per-page cache key derived from a document fingerprint
+    static QString pageKey(const QString& documentFingerprint,
+                           int pageNumber);
+    // Hash of a page's extracted content and geometry; uses the page
+    // metadata table when it has already been filled
+    static quint64 pageContentHash(Poppler::Document* document,
+                                   int pageNumber);
+    static quint64 pageContentHash(const QString& text, float width,
+                                   float height);
+
+    // Raw hashing, also used for the per-page hashes in PageMetadataTable
+    static quint64 hashBytes(const void* data, qint64 length,
+                             quint64 seed = 0);
+
+    void clearMemo();
+
+signals:
+    void fingerprintReady(const QString& filePath,
+                          const QString& fingerprint);
+
+private:
+    struct FileIdentity {
+        quint64 device = 0;
+        quint64 inode = 0;
+        qint64 size = -1;
+        qint64 mtime = 0;
+
+        bool isValid() const { return size >= 0; }
+        bool operator==(const FileIdentity& other) const {
+            return device == other.device && inode == other.inode &&
+                   size == other.size && mtime == other.mtime;
+        }
+        friend size_t qHash(const FileIdentity& identity, size_t seed = 0) {
+            return qHashMulti(seed, identity.device, identity.inode,
+                              identity.size, identity.mtime);
+        }
+    };
+
+    struct MemoEntry {
+        QString fingerprint;
+        qint64 lastUsed = 0;
+    };
+
+    DocumentFingerprint();
+    ~DocumentFingerprint() override;
+    DocumentFingerprint(const DocumentFingerprint&) = delete;
+    DocumentFingerprint& operator=(const DocumentFingerprint&) = delete;
+
+    static FileIdentity identityOf(const QString& filePath);
+    static QString computeDigest(const QString& filePath, qint64 size);
+    // (offset, length) ranges hashed for a file of the given size
+    static QList<QPair<qint64, qint64>> hashRanges(qint64 size);
+
+    QString lookup(const FileIdentity& identity);
+    void remember(const FileIdentity& identity, const QString& fingerprint);
+
+    void ensureLoaded();
+    void saveTable();
+    static QString tablePath();
+
+    QThreadPool* m_pool;
+    QMutex m_mutex;
+    QHash<FileIdentity, MemoEntry> m_memo;
+    QSet<QString> m_pending;
+    bool m_loaded = false;
+
+    static constexpr qint64 SAMPLED_THRESHOLD = 256LL * 1024 * 1024;
+    static constexpr qint64 BLOCK_SIZE = 4 * 1024 * 1024;
+    static constexpr qint64 SAMPLE_EDGE_SIZE = 1024 * 1024;
+    static constexpr qint64 SAMPLE_BLOCK_SIZE = 64 * 1024;
+    static constexpr int SAMPLE_BLOCKS = 32;
+    static constexpr int MAX_MEMO_ENTRIES = 2048;
+    static constexpr quint32 TABLE_MAGIC = 0x53524650;  // "SRFP"
+    static constexpr quint32 TABLE_VERSION = 1;
+};
@@ -0,0 +1,227 @@
+#include "DocumentMetadataExtractor.h"
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QtConcurrent/QtConcurrent>
+#include "DocumentFingerprint.h"
+#include "PDFUtilities.h"
+#include "utils/LoggingMacros.h"
+
+QCache<QString, DocumentMetadataExtractor::CacheEntry>
+    DocumentMetadataExtractor::s_cache(MAX_CACHED_DOCUMENTS);
+QMutex DocumentMetadataExtractor::s_cacheMutex;
+
+DocumentMetadataExtractor::DocumentMetadataExtractor(QObject* parent)
+    : QObject(parent) {}
+
+DocumentMetadataExtractor::~DocumentMetadataExtractor() {
+    cancel();
+    if (m_future.isRunning()) {
+        m_future.waitForFinished();
+    }
+}
+
+void DocumentMetadataExtractor::start(const QString& filePath) {
+    // A cancelled job stops at the next page boundary
+    cancel();
+    if (m_future.isRunning()) {
+        m_future.waitForFinished();
+    }
+
+    if (!QFileInfo::exists(filePath)) {
+        emit extractionFailed(tr("Document file is not accessible"));
+        return;
+    }
+
+    // An unknown digest is computed by the worker before it stores results
+    const QString fingerprint = documentFingerprint(filePath);
+    QJsonObject statistics;
+    if (!fingerprint.isEmpty() && cachedStatistics(filePath, statistics)) {
+        emit statisticsReady(statistics);
+        return;
+    }
+
+    // Each job gets its own flag so a late-finishing old job cannot observe
+    // the reset performed for the next one
+    m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    auto cancelled = m_cancelled;
+
+    m_future = QtConcurrent::run([this, filePath, fingerprint, cancelled]() {
+        runExtraction(filePath, fingerprint, cancelled);
+    });
+}
+
+void DocumentMetadataExtractor::cancel() {
+    if (m_cancelled) {
+        m_cancelled->store(true);
+    }
+}
+
+bool DocumentMetadataExtractor::isRunning() const {
+    return m_future.isRunning();
+}
+
+void DocumentMetadataExtractor::runExtraction(
+    const QString& filePath, const QString& fingerprint,
+    std::shared_ptr<std::atomic<bool>> cancelled) {
+    QElapsedTimer timer;
+    timer.start();
+
+    // Poppler documents are not thread-safe, so the worker opens its own
+    // instance instead of sharing the viewer's
+    std::unique_ptr<Poppler::Document> document(
+        Poppler::Document::load(filePath));
+    if (!document || document->isLocked()) {
+        emit extractionFailed(tr("Document could not be opened for analysis"));
+        return;
+    }
+
+    const int pageCount = document->numPages();
+    QJsonObject statistics;
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+
+    for (int i = 0; i < pageCount; ++i) {
+        if (cancelled->load()) {
+            LOG_DEBUG("Metadata extraction cancelled for {} at page {}",
+                      filePath.toStdString(), i);
+            return;
+        }
+
+        std::unique_ptr<Poppler::Page> page(document->page(i));
+        if (page) {
+            PDFUtilities::accumulatePageStatistics(
+                statistics, PDFUtilities::generatePageStatistics(page.get()));
+        }
+
+        if ((i + 1) % PROGRESS_INTERVAL_PAGES == 0 ||
+            progressTimer.elapsed() > 100) {
+            QJsonObject partial = statistics;
+            PDFUtilities::finalizeDocumentStatistics(partial, pageCount);
+            emit statisticsProgress(i + 1, pageCount, partial);
+            progressTimer.restart();
+        }
+    }
+
+    PDFUtilities::finalizeDocumentStatistics(statistics, pageCount);
+    const QString digest =
+        fingerprint.isEmpty()
+            ? DocumentFingerprint::instance().fingerprint(filePath)
+            : fingerprint;
+    if (!digest.isEmpty()) {
+        storeStatistics(digest, statistics);
+    }
+
+    if (cancelled->load()) {
+        return;
+    }
+
+    LOG_DEBUG("Extracted statistics for {} pages in {} ms", pageCount,
+              timer.elapsed());
+    emit statisticsReady(statistics);
+}
+
+QJsonObject DocumentMetadataExtractor::extractBasicInfo(
+    Poppler::Document* document) {
+    QJsonObject basic;
+
+    if (!document) {
+        return basic;
+    }
+
+    basic["pageCount"] = document->numPages();
+    basic["title"] = document->info("Title");
+    basic["author"] = document->info("Author");
+    basic["subject"] = document->info("Subject");
+    basic["keywords"] = document->info("Keywords");
+    basic["creator"] = document->info("Creator");
+    basic["producer"] = document->info("Producer");
+    basic["creationDate"] = document->info("CreationDate");
+    basic["modificationDate"] = document->info("ModDate");
+
+    return basic;
+}
+
+QJsonObject DocumentMetadataExtractor::extractSecurityInfo(
+    Poppler::Document* document) {
+    return PDFUtilities::getDocumentSecurity(document);
+}
+
+QString DocumentMetadataExtractor::documentFingerprint(
+    const QString& filePath) {
+    DocumentFingerprint& fingerprints = DocumentFingerprint::instance();
+    const QString fingerprint = fingerprints.cachedFingerprint(filePath);
+    if (fingerprint.isEmpty()) {
+        fingerprints.requestFingerprint(filePath);
+    }
+    return fingerprint;
+}
+
+QJsonObject DocumentMetadataExtractor::cachedBasicInfo(
+    const QString& filePath, Poppler::Document* document) {
+    const QString fingerprint = documentFingerprint(filePath);
+
+    if (!fingerprint.isEmpty()) {
+        QMutexLocker locker(&s_cacheMutex);
+        CacheEntry* entry = s_cache.object(fingerprint);
+        if (entry && !entry->basic.isEmpty()) {
+            return entry->basic;
+        }
+    }
+
+    QJsonObject basic = extractBasicInfo(document);
+    if (!fingerprint.isEmpty() && !basic.isEmpty()) {
+        storeBasicInfo(fingerprint, basic);
+    }
+    return basic;
+}
+
+bool DocumentMetadataExtractor::cachedStatistics(const QString& filePath,
+                                                 QJsonObject& statistics) {
+    const QString fingerprint = documentFingerprint(filePath);
+    if (fingerprint.isEmpty()) {
+        return false;
+    }
+
+    QMutexLocker locker(&s_cacheMutex);
+    CacheEntry* entry = s_cache.object(fingerprint);
+    if (!entry || entry->statistics.isEmpty()) {
+        return false;
+    }
+
+    statistics = entry->statistics;
+    return true;
+}
+
+void DocumentMetadataExtractor::clearCache() {
+    QMutexLocker locker(&s_cacheMutex);
+    s_cache.clear();
+}
+
+void DocumentMetadataExtractor::storeBasicInfo(const QString& fingerprint,
+                                               const QJsonObject& basic) {
+    QMutexLocker locker(&s_cacheMutex);
+    CacheEntry* entry = s_cache.object(fingerprint);
+    if (entry) {
+        entry->basic = basic;
+        return;
+    }
+
+    entry = new CacheEntry;
+    entry->basic = basic;
+    s_cache.insert(fingerprint, entry);
+}
+
+void DocumentMetadataExtractor::storeStatistics(const QString& fingerprint,
+                                                const QJsonObject& statistics) {
+    QMutexLocker locker(&s_cacheMutex);
+    CacheEntry* entry = s_cache.object(fingerprint);
+    if (entry) {
+        entry->statistics = statistics;
+        return;
+    }
+
+    entry = new CacheEntry;
+    entry->statistics = statistics;
+    s_cache.insert(fingerprint, entry);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <poppler-qt6.h>
+#include <QCache>
+#include <QFuture>
+#include <QJsonObject>
+#include <QMutex>
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <memory>
+
+/**
+ * Background extraction of document metadata and statistics.
+ *
+ * Cheap fields (file info, info dictionary, security flags) are read
+ * synchronously. Per-page statistics are collected on a worker thread from a
+ * private Poppler::Document instance and reported progressively. Results are
+ * cached per document fingerprint and shared with DocumentAnalyzer.
+ */
+class DocumentMetadataExtractor : public QObject {
+    Q_OBJECT
+
+public:
+    explicit DocumentMetadataExtractor(QObject* parent = nullptr);
+    ~DocumentMetadataExtractor() override;
+
+    // Asynchronous statistics extraction
+    void start(const QString& filePath);
+    void cancel();
+    bool isRunning() const;
+
+    // Cheap, synchronous metadata
+    static QJsonObject extractBasicInfo(Poppler::Document* document);
+    static QJsonObject extractSecurityInfo(Poppler::Document* document);
+
+    // Shared cache keyed by DocumentFingerprint content digest. Only the
+    // memoized digest is used; an unknown one is requested in the
+    // background and the lookups miss until it arrives.
+    static QString documentFingerprint(const QString& filePath);
+    static QJsonObject cachedBasicInfo(const QString& filePath,
+                                       Poppler::Document* document);
+    static bool cachedStatistics(const QString& filePath,
+                                 QJsonObject& statistics);
+    static void clearCache();
+
+signals:
+    void statisticsProgress(int processedPages, int totalPages,
+                            const QJsonObject& partialStatistics);
+    void statisticsReady(const QJsonObject& statistics);
+    void extractionFailed(const QString& error);
+
+private:
+    struct CacheEntry {
+        QJsonObject basic;
+        QJsonObject statistics;
+    };
+
+    void runExtraction(const QString& filePath, const QString& fingerprint,
+                       std::shared_ptr<std::atomic<bool>> cancelled);
+
+    static void storeBasicInfo(const QString& fingerprint,
+                               const QJsonObject& basic);
+    static void storeStatistics(const QString& fingerprint,
+                                const QJsonObject& statistics);
+
+    QFuture<void> m_future;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+
+    static QCache<QString, CacheEntry> s_cache;
+    static QMutex s_cacheMutex;
+
+    static constexpr int MAX_CACHED_DOCUMENTS = 64;
+    static constexpr int PROGRESS_INTERVAL_PAGES = 16;
+};
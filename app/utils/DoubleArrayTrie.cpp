@@ -0,0 +1,152 @@
+#include "DoubleArrayTrie.h"
+#include <algorithm>
+
+DoubleArrayTrie::DoubleArrayTrie(QStringList keys) {
+    keys.removeAll(QString());
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    if (keys.isEmpty()) {
+        return;
+    }
+    m_keyCount = keys.size();
+
+    // Alphabet codes in code unit order, so sorted keys list their
+    // children in ascending code order, after END_CODE
+    m_codes.assign(0x10000, 0);
+    for (const QString& key : keys) {
+        for (QChar ch : key) {
+            m_codes[ch.unicode()] = 1;
+        }
+    }
+    quint16 next = END_CODE + 1;
+    for (quint16& code : m_codes) {
+        if (code != 0) {
+            code = next++;
+        }
+    }
+
+    m_base.assign(1, 0);
+    m_check.assign(1, 0);  // Root; never a child since bases start at 1
+
+    // Breadth-first over ranges of keys sharing a prefix of length depth
+    struct Pending {
+        qint32 node;
+        qsizetype low;
+        qsizetype high;
+        qsizetype depth;
+    };
+    std::vector<Pending> queue = {{0, 0, keys.size(), 0}};
+    std::vector<int> codes;
+    std::vector<std::pair<qsizetype, qsizetype>> ranges;
+
+    for (std::size_t q = 0; q < queue.size(); ++q) {
+        const Pending pending = queue[q];
+
+        codes.clear();
+        ranges.clear();
+        for (qsizetype i = pending.low; i < pending.high;) {
+            const int code = codeAt(keys[i], pending.depth);
+            qsizetype j = i + 1;
+            while (j < pending.high && codeAt(keys[j], pending.depth) == code) {
+                ++j;
+            }
+            codes.push_back(code);
+            ranges.emplace_back(i, j);
+            i = j;
+        }
+
+        const qint32 base = findBase(codes);
+        m_base[pending.node] = base;
+        for (std::size_t c = 0; c < codes.size(); ++c) {
+            const qint32 child = base + codes[c];
+            m_check[child] = pending.node;
+            if (codes[c] != END_CODE) {
+                queue.push_back({child, ranges[c].first, ranges[c].second,
+                                 pending.depth + 1});
+            }
+        }
+        while (m_firstFree < qint64(m_check.size()) &&
+               m_check[m_firstFree] != FREE) {
+            ++m_firstFree;
+        }
+    }
+
+    m_base.shrink_to_fit();
+    m_check.shrink_to_fit();
+}
+
+int DoubleArrayTrie::codeAt(const QString& key, qsizetype depth) const {
+    return depth == key.size() ? END_CODE : m_codes[key[depth].unicode()];
+}
+
+qint32 DoubleArrayTrie::findBase(const std::vector<int>& codes) {
+    // Place the first child on a free slot, starting from the lowest one,
+    // and take the first base where every child fits
+    qint64 slot = m_firstFree;
+    for (;;) {
+        ensureSize(slot + 1);
+        if (m_check[slot] == FREE && slot - codes.front() >= 1) {
+            const qint64 base = slot - codes.front();
+            ensureSize(base + codes.back() + 1);
+            bool fits = true;
+            for (int code : codes) {
+                if (m_check[base + code] != FREE) {
+                    fits = false;
+                    break;
+                }
+            }
+            if (fits) {
+                return static_cast<qint32>(base);
+            }
+        }
+        ++slot;
+    }
+}
+
+void DoubleArrayTrie::ensureSize(qint64 size) {
+    if (size > qint64(m_check.size())) {
+        // Grow geometrically; slots past the children of one node are
+        // cheap and keep findBase from reallocating per node
+        const std::size_t grown =
+            std::max<std::size_t>(size, m_check.size() * 3 / 2);
+        m_base.resize(grown, 0);
+        m_check.resize(grown, FREE);
+    }
+}
+
+qint64 DoubleArrayTrie::memoryBytes() const {
+    return qint64(m_codes.size() * sizeof(quint16) +
+                  m_base.size() * sizeof(qint32) +
+                  m_check.size() * sizeof(qint32));
+}
+
+bool DoubleArrayTrie::contains(QStringView key) const {
+    return !key.isEmpty() && longestPrefix(key) == key.size();
+}
+
+qsizetype DoubleArrayTrie::longestPrefix(QStringView text) const {
+    if (isEmpty()) {
+        return 0;
+    }
+
+    const qint64 size = qint64(m_check.size());
+    qint32 node = 0;
+    qsizetype longest = 0;
+    for (qsizetype i = 0; i < text.size(); ++i) {
+        const int code = m_codes[text[i].unicode()];
+        if (code == 0) {
+            break;
+        }
+        const qint64 child = qint64(m_base[node]) + code;
+        if (child >= size || m_check[child] != node) {
+            break;
+        }
+        node = static_cast<qint32>(child);
+
+        const qint64 end = qint64(m_base[node]) + END_CODE;
+        if (end < size && m_check[end] == node) {
+            longest = i + 1;
+        }
+    }
+    return longest;
+}
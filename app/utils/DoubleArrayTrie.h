@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QStringList>
+#include <QStringView>
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * Immutable trie over UTF-16 keys in double-array form (Aoe 1989).
+ *
+ * Node s has its child for code c at base[s] + c, valid when
+ * check[base[s] + c] == s, so following an edge is two array reads and no
+ * pointer chasing. Code units are first mapped to a dense alphabet of the
+ * characters that occur in keys, which keeps the arrays close to the
+ * number of trie nodes even for CJK keys spread over 20k code points.
+ * A key ends where a node has a child for END_CODE.
+ *
+ * Built once from the complete key set; lookups are thread-safe.
+ */
+class DoubleArrayTrie {
+public:
+    DoubleArrayTrie() = default;
+    // Empty keys are ignored, duplicates collapse
+    explicit DoubleArrayTrie(QStringList keys);
+
+    bool isEmpty() const { return m_keyCount == 0; }
+    qsizetype keyCount() const { return m_keyCount; }
+    qint64 memoryBytes() const;
+
+    bool contains(QStringView key) const;
+    // Length of the longest key that is a prefix of text, 0 if none
+    qsizetype longestPrefix(QStringView text) const;
+
+private:
+    int codeAt(const QString& key, qsizetype depth) const;
+    qint32 findBase(const std::vector<int>& codes);
+    void ensureSize(qint64 size);
+
+    // Code unit -> alphabet code, 0 for characters no key contains
+    std::vector<quint16> m_codes;
+    std::vector<qint32> m_base;
+    std::vector<qint32> m_check;  // Parent node, FREE for unused slots
+    qsizetype m_keyCount = 0;
+    qint64 m_firstFree = 1;
+
+    static constexpr int END_CODE = 1;
+    static constexpr qint32 FREE = -1;
+};
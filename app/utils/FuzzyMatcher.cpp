@@ -0,0 +1,160 @@
+#include "FuzzyMatcher.h"
+#include <algorithm>
+#include <climits>
+
+namespace {
+
+char16_t foldChar(char16_t c) {
+    const char32_t folded = QChar::toCaseFolded(char32_t(c));
+    return folded <= 0xFFFF ? char16_t(folded) : c;
+}
+
+}  // namespace
+
+FuzzyMatcher::FuzzyMatcher(QStringView pattern, int maxDistance,
+                           Qt::CaseSensitivity caseSensitivity)
+    : m_fold(caseSensitivity == Qt::CaseInsensitive) {
+    if (pattern.isEmpty() || pattern.size() > MAX_PATTERN_LENGTH) {
+        return;
+    }
+
+    m_length = static_cast<int>(pattern.size());
+    // At least half of the pattern has to match, otherwise nearly every
+    // position in the text would qualify
+    m_maxDistance = qBound(0, maxDistance, (m_length - 1) / 2);
+
+    QString reversed = pattern.toString();
+    std::reverse(reversed.begin(), reversed.end());
+    m_forward = buildMasks(pattern, m_fold);
+    m_reverse = buildMasks(reversed, m_fold);
+}
+
+FuzzyMatcher::CharMasks FuzzyMatcher::buildMasks(QStringView pattern,
+                                                 bool fold) {
+    CharMasks masks;
+    for (qsizetype i = 0; i < pattern.size(); ++i) {
+        const char16_t c =
+            fold ? foldChar(pattern[i].unicode()) : pattern[i].unicode();
+        masks.other[c] |= quint64(1) << i;
+    }
+
+    // Precompute the Latin-1 range, folding each text character once here
+    // instead of once per scanned character
+    for (int c = 0; c < 256; ++c) {
+        const char16_t key = fold ? foldChar(char16_t(c)) : char16_t(c);
+        masks.latin1[c] = masks.other.value(key);
+    }
+    return masks;
+}
+
+quint64 FuzzyMatcher::CharMasks::lookup(char16_t c, bool fold) const {
+    if (c < 256) {
+        return latin1[c];
+    }
+    return other.value(fold ? foldChar(c) : c);
+}
+
+QList<FuzzyMatcher::Match> FuzzyMatcher::findAll(QStringView text,
+                                                 int maxMatches) const {
+    QList<Match> matches;
+    if (!isValid() || text.isEmpty()) {
+        return matches;
+    }
+
+    const quint64 high = quint64(1) << (m_length - 1);
+    quint64 pv = ~quint64(0);
+    quint64 mv = 0;
+    int score = m_length;
+
+    int bestEnd = -1;
+    int bestScore = INT_MAX;
+    int lastEnd = -1;
+
+    auto emitBest = [&]() {
+        const int start = findStart(text, bestEnd, bestScore);
+        if (start > lastEnd) {
+            matches.append({start, bestEnd - start + 1, bestScore});
+            lastEnd = bestEnd;
+        }
+        bestEnd = -1;
+        bestScore = INT_MAX;
+    };
+
+    const int length = static_cast<int>(text.size());
+    for (int j = 0; j < length; ++j) {
+        // One column of the edit-distance matrix (Myers 1999, with free
+        // start positions in the text)
+        const quint64 eq = m_forward.lookup(text[j].unicode(), m_fold);
+        const quint64 xv = eq | mv;
+        const quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        quint64 ph = mv | ~(xh | pv);
+        quint64 mh = pv & xh;
+        if (ph & high) {
+            ++score;
+        } else if (mh & high) {
+            --score;
+        }
+        ph <<= 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        if (score <= m_maxDistance) {
+            if (score < bestScore) {
+                bestScore = score;
+                bestEnd = j;
+            }
+        } else if (bestEnd >= 0) {
+            emitBest();
+            if (maxMatches >= 0 && matches.size() >= maxMatches) {
+                return matches;
+            }
+        }
+    }
+
+    if (bestEnd >= 0 && (maxMatches < 0 || matches.size() < maxMatches)) {
+        emitBest();
+    }
+    return matches;
+}
+
+int FuzzyMatcher::findStart(QStringView text, int end, int distance) const {
+    // Scan backwards with the reversed pattern, anchored at the match end,
+    // and take the nearest start that reaches the forward distance
+    const quint64 high = quint64(1) << (m_length - 1);
+    quint64 pv = ~quint64(0);
+    quint64 mv = 0;
+    int score = m_length;
+
+    const int limit = qMax(0, end - m_length - m_maxDistance + 1);
+    int bestStart = qMax(limit, end - m_length + 1);
+    int bestScore = INT_MAX;
+
+    for (int i = end; i >= limit; --i) {
+        const quint64 eq = m_reverse.lookup(text[i].unicode(), m_fold);
+        const quint64 xv = eq | mv;
+        const quint64 xh = (((eq & pv) + pv) ^ pv) | eq;
+        quint64 ph = mv | ~(xh | pv);
+        quint64 mh = pv & xh;
+        if (ph & high) {
+            ++score;
+        } else if (mh & high) {
+            --score;
+        }
+        // Shifting in a 1 makes the top row grow with the text: the
+        // alignment has to start at the match end
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        if (score < bestScore) {
+            bestScore = score;
+            bestStart = i;
+            if (score <= distance) {
+                break;
+            }
+        }
+    }
+    return bestStart;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringView>
+#include <QtGlobal>
+
+/**
+ * Approximate substring matcher using Myers' bit-parallel algorithm.
+ *
+ * Finds every place in a text where the pattern occurs with at most k
+ * edits (insertions, deletions, substitutions). The dynamic-programming
+ * column is packed into one 64-bit word, so each text character costs a
+ * constant number of word operations regardless of k, which keeps
+ * search-as-you-type fast on large OCR'd text layers.
+ *
+ * Patterns are limited to MAX_PATTERN_LENGTH UTF-16 code units. A matcher
+ * is immutable after construction and can be shared between threads.
+ */
+class FuzzyMatcher {
+public:
+    struct Match {
+        int start = 0;
+        int length = 0;
+        int distance = 0;
+    };
+
+    FuzzyMatcher(QStringView pattern, int maxDistance,
+                 Qt::CaseSensitivity caseSensitivity = Qt::CaseInsensitive);
+
+    // False for empty or overlong patterns; findAll() then finds nothing
+    bool isValid() const { return m_length > 0; }
+    int maxDistance() const { return m_maxDistance; }
+
+    // Non-overlapping matches in text order. Each match is the best
+    // (lowest distance) end position of a run of candidate ends, extended
+    // back to the closest start with that distance.
+    QList<Match> findAll(QStringView text, int maxMatches = -1) const;
+
+    static constexpr int MAX_PATTERN_LENGTH = 64;
+
+private:
+    // Pattern-equality bit masks per character
+    struct CharMasks {
+        quint64 latin1[256] = {};
+        QHash<char16_t, quint64> other;
+
+        quint64 lookup(char16_t c, bool fold) const;
+    };
+
+    static CharMasks buildMasks(QStringView pattern, bool fold);
+    int findStart(QStringView text, int end, int distance) const;
+
+    int m_length = 0;
+    int m_maxDistance = 0;
+    bool m_fold = true;
+    CharMasks m_forward;
+    CharMasks m_reverse;
+};
@@ -0,0 +1,590 @@
+#include "KeyedRecordStore.h"
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <utility>
+#include "utils/DocumentFingerprint.h"
+#include "utils/LoggingMacros.h"
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+namespace {
+
+void appendUInt16(QByteArray& out, quint16 value) {
+    const quint16 le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+void appendUInt32(QByteArray& out, quint32 value) {
+    const quint32 le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+void appendUInt64(QByteArray& out, quint64 value) {
+    const quint64 le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char*>(&le), sizeof(le));
+}
+
+// Splits an encoded record (see encodeRecord) that starts at data; returns
+// the encoded size, or 0 when it does not fit in the available bytes
+qint64 decodeRecord(const uchar* data, qint64 available, QByteArrayView* key,
+                    QByteArrayView* id, QByteArrayView* payload) {
+    if (available < 8) {
+        return 0;
+    }
+    const qint64 keyLength = qFromLittleEndian<quint16>(data);
+    const qint64 idLength = qFromLittleEndian<quint16>(data + 2);
+    const qint64 payloadLength = qFromLittleEndian<quint32>(data + 4);
+    const qint64 size = 8 + keyLength + idLength + payloadLength;
+    if (size > available) {
+        return 0;
+    }
+
+    const char* bytes = reinterpret_cast<const char*>(data + 8);
+    *key = QByteArrayView(bytes, keyLength);
+    *id = QByteArrayView(bytes + keyLength, idLength);
+    *payload = QByteArrayView(bytes + keyLength + idLength, payloadLength);
+    return size;
+}
+
+}  // namespace
+
+KeyedRecordStore::KeyedRecordStore(const QString& snapshotPath)
+    : m_snapshotPath(snapshotPath) {}
+
+KeyedRecordStore::~KeyedRecordStore() { close(); }
+
+bool KeyedRecordStore::open() {
+    close();
+
+    if (!QDir().mkpath(QFileInfo(m_snapshotPath).absolutePath())) {
+        LOG_WARNING("KeyedRecordStore: Cannot create directory for {}",
+                    m_snapshotPath.toStdString());
+        return false;
+    }
+
+    if (!mapSnapshot()) {
+        // A damaged snapshot is set aside rather than overwritten, so the
+        // data can still be recovered by hand
+        const QString damaged = m_snapshotPath + ".damaged";
+        QFile::remove(damaged);
+        QFile::rename(m_snapshotPath, damaged);
+        LOG_WARNING("KeyedRecordStore: Moved unreadable snapshot to {}",
+                    damaged.toStdString());
+    }
+    m_count = static_cast<int>(m_snapshotCount);
+
+    if (!replayLog()) {
+        unmapSnapshot();
+        return false;
+    }
+
+    m_open = true;
+    LOG_DEBUG("KeyedRecordStore: Opened {} ({} records, {} log bytes)",
+              m_snapshotPath.toStdString(), m_count, m_logSize);
+    return true;
+}
+
+void KeyedRecordStore::close() {
+    if (m_logFile.isOpen()) {
+        m_logFile.close();
+    }
+    unmapSnapshot();
+
+    m_overlay.clear();
+    m_snapshotCleared = false;
+    m_count = 0;
+    m_logSize = 0;
+    m_open = false;
+}
+
+bool KeyedRecordStore::mapSnapshot() {
+    m_snapshotFile.setFileName(m_snapshotPath);
+    if (!m_snapshotFile.exists()) {
+        return true;  // First run
+    }
+    if (!m_snapshotFile.open(QIODevice::ReadOnly)) {
+        LOG_WARNING("KeyedRecordStore: Cannot open {}",
+                    m_snapshotPath.toStdString());
+        return false;
+    }
+
+    const qint64 size = m_snapshotFile.size();
+    uchar* map = size >= SNAPSHOT_HEADER_SIZE ? m_snapshotFile.map(0, size)
+                                              : nullptr;
+    if (!map) {
+        m_snapshotFile.close();
+        return false;
+    }
+
+    const quint32 magic = qFromLittleEndian<quint32>(map);
+    const quint32 version = qFromLittleEndian<quint32>(map + 4);
+    const quint32 count = qFromLittleEndian<quint32>(map + 8);
+    const quint64 indexOffset = qFromLittleEndian<quint64>(map + 16);
+
+    const bool valid =
+        magic == SNAPSHOT_MAGIC && version == SNAPSHOT_VERSION &&
+        indexOffset >= static_cast<quint64>(SNAPSHOT_HEADER_SIZE) &&
+        indexOffset <= static_cast<quint64>(size) &&
+        (static_cast<quint64>(size) - indexOffset) / 8 >= count;
+    if (!valid) {
+        m_snapshotFile.unmap(map);
+        m_snapshotFile.close();
+        return false;
+    }
+
+    m_map = map;
+    m_mapSize = size;
+    m_snapshotCount = count;
+    m_indexOffset = static_cast<qint64>(indexOffset);
+    return true;
+}
+
+void KeyedRecordStore::unmapSnapshot() {
+    if (m_map) {
+        m_snapshotFile.unmap(m_map);
+    }
+    if (m_snapshotFile.isOpen()) {
+        m_snapshotFile.close();
+    }
+    m_map = nullptr;
+    m_mapSize = 0;
+    m_snapshotCount = 0;
+    m_indexOffset = 0;
+}
+
+bool KeyedRecordStore::replayLog() {
+    m_logFile.setFileName(logPath());
+    if (!m_logFile.open(QIODevice::ReadWrite)) {
+        LOG_WARNING("KeyedRecordStore: Cannot open log {}",
+                    logPath().toStdString());
+        return false;
+    }
+
+    const QByteArray log = m_logFile.readAll();
+    const uchar* data = reinterpret_cast<const uchar*>(log.constData());
+    qint64 offset = 0;
+    int replayed = 0;
+
+    while (log.size() - offset >= LOG_ENTRY_HEADER_SIZE) {
+        const qint64 bodyLength = qFromLittleEndian<quint32>(data + offset);
+        const quint64 checksum = qFromLittleEndian<quint64>(data + offset + 4);
+        const uchar* body = data + offset + LOG_ENTRY_HEADER_SIZE;
+        if (bodyLength < 1 ||
+            bodyLength > log.size() - offset - LOG_ENTRY_HEADER_SIZE ||
+            DocumentFingerprint::hashBytes(body, bodyLength) != checksum) {
+            break;
+        }
+
+        QByteArrayView key, id, payload;
+        if (decodeRecord(body + 1, bodyLength - 1, &key, &id, &payload) !=
+            bodyLength - 1) {
+            break;
+        }
+        applyLog(static_cast<LogOp>(body[0]), key.toByteArray(),
+                 id.toByteArray(), payload.toByteArray());
+
+        offset += LOG_ENTRY_HEADER_SIZE + bodyLength;
+        ++replayed;
+    }
+
+    if (offset < log.size()) {
+        // Torn tail from an interrupted write; later appends must not end
+        // up behind it
+        LOG_WARNING("KeyedRecordStore: Dropping {} bytes of incomplete log",
+                    log.size() - offset);
+        m_logFile.resize(offset);
+    }
+
+    m_logSize = offset;
+    m_logFile.seek(offset);
+
+    if (replayed > 0) {
+        LOG_DEBUG("KeyedRecordStore: Replayed {} log entries", replayed);
+    }
+    return true;
+}
+
+bool KeyedRecordStore::appendLog(LogOp op, const QByteArray& key,
+                                 const QByteArray& id,
+                                 const QByteArray& payload) {
+    if (!m_open) {
+        return false;
+    }
+    if (key.size() > MAX_FIELD_SIZE || id.size() > MAX_FIELD_SIZE) {
+        LOG_WARNING("KeyedRecordStore: Key or id too long ({} / {} bytes)",
+                    key.size(), id.size());
+        return false;
+    }
+
+    QByteArray body;
+    body.reserve(1 + RECORD_HEADER_SIZE + key.size() + id.size() +
+                 payload.size());
+    body.append(static_cast<char>(op));
+    body.append(encodeRecord(key, id, payload));
+
+    QByteArray entry;
+    entry.reserve(LOG_ENTRY_HEADER_SIZE + body.size());
+    appendUInt32(entry, static_cast<quint32>(body.size()));
+    appendUInt64(entry,
+                 DocumentFingerprint::hashBytes(body.constData(), body.size()));
+    entry.append(body);
+
+    if (m_logFile.write(entry) != entry.size() || !m_logFile.flush()) {
+        LOG_WARNING("KeyedRecordStore: Failed to append to {}",
+                    logPath().toStdString());
+        // Drop whatever part made it out so the log stays replayable
+        m_logFile.resize(m_logSize);
+        m_logFile.seek(m_logSize);
+        return false;
+    }
+#ifdef Q_OS_UNIX
+    ::fsync(m_logFile.handle());
+#endif
+
+    m_logSize += entry.size();
+    return true;
+}
+
+void KeyedRecordStore::applyLog(LogOp op, const QByteArray& key,
+                                const QByteArray& id,
+                                const QByteArray& payload) {
+    switch (op) {
+        case LogOp::Put:
+            if (!contains(key, id)) {
+                ++m_count;
+            }
+            m_overlay[key].insert(id, payload);
+            break;
+        case LogOp::Remove:
+            if (contains(key, id)) {
+                --m_count;
+            }
+            m_overlay[key].insert(id, std::nullopt);
+            break;
+        case LogOp::Clear:
+            m_overlay.clear();
+            m_snapshotCleared = true;
+            m_count = 0;
+            break;
+    }
+}
+
+QList<KeyedRecordStore::Record> KeyedRecordStore::values(
+    const QByteArray& key) const {
+    QMap<QByteArray, QByteArray> merged;
+
+    if (snapshotVisible()) {
+        RecordView record;
+        for (quint32 slot = lowerBound(key, QByteArrayView());
+             slot < m_snapshotCount && snapshotRecord(slot, &record) &&
+             compareBytes(record.key, key) == 0;
+             ++slot) {
+            merged.insert(record.id.toByteArray(),
+                          record.payload.toByteArray());
+        }
+    }
+
+    auto overlay = m_overlay.constFind(key);
+    if (overlay != m_overlay.cend()) {
+        for (auto it = overlay->cbegin(); it != overlay->cend(); ++it) {
+            if (it.value()) {
+                merged.insert(it.key(), *it.value());
+            } else {
+                merged.remove(it.key());
+            }
+        }
+    }
+
+    QList<Record> result;
+    result.reserve(merged.size());
+    for (auto it = merged.cbegin(); it != merged.cend(); ++it) {
+        result.append({key, it.key(), it.value()});
+    }
+    return result;
+}
+
+std::optional<QByteArray> KeyedRecordStore::value(const QByteArray& key,
+                                                  const QByteArray& id) const {
+    auto overlay = m_overlay.constFind(key);
+    if (overlay != m_overlay.cend()) {
+        auto it = overlay->constFind(id);
+        if (it != overlay->cend()) {
+            return it.value();
+        }
+    }
+
+    if (snapshotVisible()) {
+        RecordView record;
+        const quint32 slot = lowerBound(key, id);
+        if (slot < m_snapshotCount && snapshotRecord(slot, &record) &&
+            compareBytes(record.key, key) == 0 &&
+            compareBytes(record.id, id) == 0) {
+            return record.payload.toByteArray();
+        }
+    }
+    return std::nullopt;
+}
+
+bool KeyedRecordStore::contains(const QByteArray& key,
+                                const QByteArray& id) const {
+    auto overlay = m_overlay.constFind(key);
+    if (overlay != m_overlay.cend()) {
+        auto it = overlay->constFind(id);
+        if (it != overlay->cend()) {
+            return it.value().has_value();
+        }
+    }
+    return snapshotVisible() && snapshotContains(key, id);
+}
+
+void KeyedRecordStore::forEach(
+    const std::function<void(const Record&)>& visitor) const {
+    for (const Record& record : records()) {
+        visitor(record);
+    }
+}
+
+QList<KeyedRecordStore::Record> KeyedRecordStore::records() const {
+    std::map<std::pair<QByteArray, QByteArray>, QByteArray> merged;
+
+    if (snapshotVisible()) {
+        RecordView record;
+        for (quint32 slot = 0; slot < m_snapshotCount; ++slot) {
+            if (snapshotRecord(slot, &record)) {
+                merged.emplace(std::make_pair(record.key.toByteArray(),
+                                              record.id.toByteArray()),
+                               record.payload.toByteArray());
+            }
+        }
+    }
+
+    for (auto key = m_overlay.cbegin(); key != m_overlay.cend(); ++key) {
+        for (auto it = key->cbegin(); it != key->cend(); ++it) {
+            auto recordKey = std::make_pair(key.key(), it.key());
+            if (it.value()) {
+                merged[recordKey] = *it.value();
+            } else {
+                merged.erase(recordKey);
+            }
+        }
+    }
+
+    QList<Record> result;
+    result.reserve(static_cast<qsizetype>(merged.size()));
+    for (const auto& [recordKey, payload] : merged) {
+        result.append({recordKey.first, recordKey.second, payload});
+    }
+    return result;
+}
+
+bool KeyedRecordStore::put(const QByteArray& key, const QByteArray& id,
+                           const QByteArray& payload) {
+    if (!appendLog(LogOp::Put, key, id, payload)) {
+        return false;
+    }
+    applyLog(LogOp::Put, key, id, payload);
+    compactIfNeeded();
+    return true;
+}
+
+bool KeyedRecordStore::remove(const QByteArray& key, const QByteArray& id) {
+    if (!contains(key, id)) {
+        return false;
+    }
+    if (!appendLog(LogOp::Remove, key, id, QByteArray())) {
+        return false;
+    }
+    applyLog(LogOp::Remove, key, id, QByteArray());
+    compactIfNeeded();
+    return true;
+}
+
+bool KeyedRecordStore::clear() {
+    if (!appendLog(LogOp::Clear, QByteArray(), QByteArray(), QByteArray())) {
+        return false;
+    }
+    applyLog(LogOp::Clear, QByteArray(), QByteArray(), QByteArray());
+    return compact();
+}
+
+void KeyedRecordStore::compactIfNeeded() {
+    if (m_logSize >= qMax(MIN_COMPACT_LOG_SIZE, m_mapSize)) {
+        compact();
+    }
+}
+
+bool KeyedRecordStore::replaceAll(const QList<Record>& records) {
+    if (!m_open) {
+        return false;
+    }
+
+    // Sorted and deduplicated like records(); later entries win
+    std::map<std::pair<QByteArray, QByteArray>, QByteArray> sorted;
+    for (const Record& record : records) {
+        if (record.key.size() > MAX_FIELD_SIZE ||
+            record.id.size() > MAX_FIELD_SIZE) {
+            LOG_WARNING("KeyedRecordStore: Key or id too long ({} / {} bytes)",
+                        record.key.size(), record.id.size());
+            return false;
+        }
+        sorted[{record.key, record.id}] = record.payload;
+    }
+
+    QList<Record> replacement;
+    replacement.reserve(static_cast<qsizetype>(sorted.size()));
+    for (const auto& [recordKey, payload] : sorted) {
+        replacement.append({recordKey.first, recordKey.second, payload});
+    }
+
+    // A pending log would be replayed on top of the replacement after a
+    // crash; fold it into the current snapshot first so it is empty
+    if (!compact()) {
+        return false;
+    }
+    return writeSnapshot(replacement);
+}
+
+bool KeyedRecordStore::compact() {
+    if (!m_open) {
+        return false;
+    }
+    if (m_logSize == 0) {
+        return true;
+    }
+    return writeSnapshot(records());
+}
+
+bool KeyedRecordStore::writeSnapshot(const QList<Record>& merged) {
+    QByteArray snapshot;
+    appendUInt32(snapshot, SNAPSHOT_MAGIC);
+    appendUInt32(snapshot, SNAPSHOT_VERSION);
+    appendUInt32(snapshot, static_cast<quint32>(merged.size()));
+    appendUInt32(snapshot, 0);
+    appendUInt64(snapshot, 0);  // Index offset, patched below
+
+    QList<quint64> offsets;
+    offsets.reserve(merged.size());
+    for (const Record& record : merged) {
+        offsets.append(static_cast<quint64>(snapshot.size()));
+        snapshot.append(encodeRecord(record.key, record.id, record.payload));
+    }
+
+    const quint64 indexOffset = qToLittleEndian<quint64>(snapshot.size());
+    std::memcpy(snapshot.data() + 16, &indexOffset, sizeof(indexOffset));
+    for (quint64 offset : offsets) {
+        appendUInt64(snapshot, offset);
+    }
+
+    // The old mapping has to go before the rename on platforms that refuse
+    // to replace a mapped file
+    unmapSnapshot();
+
+    QSaveFile file(m_snapshotPath);
+    if (!file.open(QIODevice::WriteOnly) ||
+        file.write(snapshot) != snapshot.size() || !file.commit()) {
+        LOG_WARNING("KeyedRecordStore: Failed to write snapshot {}",
+                    m_snapshotPath.toStdString());
+        // Keep serving from the old snapshot and the log
+        mapSnapshot();
+        return false;
+    }
+
+    if (!mapSnapshot()) {
+        LOG_WARNING("KeyedRecordStore: Cannot map new snapshot {}",
+                    m_snapshotPath.toStdString());
+        return false;
+    }
+
+    // Only now is the log redundant; a crash before this point replays it
+    // on top of the new snapshot, which is idempotent
+    m_logFile.resize(0);
+    m_logFile.seek(0);
+    m_logSize = 0;
+    m_overlay.clear();
+    m_snapshotCleared = false;
+    m_count = static_cast<int>(m_snapshotCount);
+
+    LOG_DEBUG("KeyedRecordStore: Wrote {} records into {} ({} bytes)",
+              m_count, m_snapshotPath.toStdString(), snapshot.size());
+    return true;
+}
+
+bool KeyedRecordStore::snapshotRecord(quint32 slot,
+                                      RecordView* record) const {
+    const uchar* entry = m_map + m_indexOffset + qint64(slot) * 8;
+    const quint64 offset = qFromLittleEndian<quint64>(entry);
+    if (offset < static_cast<quint64>(SNAPSHOT_HEADER_SIZE) ||
+        offset >= static_cast<quint64>(m_indexOffset)) {
+        return false;
+    }
+
+    const qint64 start = static_cast<qint64>(offset);
+    return decodeRecord(m_map + start, m_indexOffset - start, &record->key,
+                        &record->id, &record->payload) > 0;
+}
+
+quint32 KeyedRecordStore::lowerBound(QByteArrayView key,
+                                     QByteArrayView id) const {
+    // First slot whose (key, id) is not less than the given pair; an empty
+    // id finds the first record of the key
+    quint32 low = 0;
+    quint32 high = m_snapshotCount;
+    RecordView record;
+    while (low < high) {
+        const quint32 middle = low + (high - low) / 2;
+        if (!snapshotRecord(middle, &record)) {
+            return m_snapshotCount;
+        }
+
+        int order = compareBytes(record.key, key);
+        if (order == 0) {
+            order = compareBytes(record.id, id);
+        }
+        if (order < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+bool KeyedRecordStore::snapshotContains(QByteArrayView key,
+                                        QByteArrayView id) const {
+    RecordView record;
+    const quint32 slot = lowerBound(key, id);
+    return slot < m_snapshotCount && snapshotRecord(slot, &record) &&
+           compareBytes(record.key, key) == 0 &&
+           compareBytes(record.id, id) == 0;
+}
+
+int KeyedRecordStore::compareBytes(QByteArrayView a, QByteArrayView b) {
+    // Byte-wise, matching the QByteArray ordering used when compacting
+    const qsizetype length = qMin(a.size(), b.size());
+    const int order = length > 0 ? std::memcmp(a.data(), b.data(), length) : 0;
+    if (order != 0) {
+        return order;
+    }
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+QByteArray KeyedRecordStore::encodeRecord(const QByteArray& key,
+                                          const QByteArray& id,
+                                          const QByteArray& payload) {
+    QByteArray out;
+    out.reserve(RECORD_HEADER_SIZE + key.size() + id.size() + payload.size());
+    appendUInt16(out, static_cast<quint16>(key.size()));
+    appendUInt16(out, static_cast<quint16>(id.size()));
+    appendUInt32(out, static_cast<quint32>(payload.size()));
+    out.append(key);
+    out.append(id);
+    out.append(payload);
+    return out;
+}
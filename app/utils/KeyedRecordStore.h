@@ -0,0 +1,134 @@
+#pragma once
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QFile>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <functional>
+#include <optional>
+
+/**
+ * Small embedded store for (key, id) -> payload records.
+ *
+ * Records live in two files:
+ * - A snapshot, memory-mapped on open and never parsed up front. It holds
+ *   the records back to back followed by a sorted index of record offsets,
+ *   so all records under a key are found with a binary search over the
+ *   mapping.
+ * - A write-ahead log next to it. Every change is appended as a checksummed
+ *   entry and flushed before the call returns; on open the log is replayed
+ *   into a small in-memory overlay. A torn entry at the tail (crash during
+ *   a write) fails its checksum and is dropped together with anything after
+ *   it, so a crash loses at most the change being written.
+ *
+ * Once the log outgrows the snapshot, compact() merges both into a new
+ * snapshot written atomically and truncates the log.
+ *
+ * Keys group records (e.g. all bookmarks of one document); ids tell records
+ * under the same key apart. Not thread-safe.
+ */
+class KeyedRecordStore {
+public:
+    struct Record {
+        QByteArray key;
+        QByteArray id;
+        QByteArray payload;
+    };
+
+    explicit KeyedRecordStore(const QString& snapshotPath);
+    ~KeyedRecordStore();
+
+    KeyedRecordStore(const KeyedRecordStore&) = delete;
+    KeyedRecordStore& operator=(const KeyedRecordStore&) = delete;
+
+    // Maps the snapshot and replays the log; cheap regardless of size
+    bool open();
+    void close();
+    bool isOpen() const { return m_open; }
+
+    QString snapshotPath() const { return m_snapshotPath; }
+    QString logPath() const { return m_snapshotPath + ".wal"; }
+
+    // O(log n + k) lookups; results are ordered by id
+    QList<Record> values(const QByteArray& key) const;
+    std::optional<QByteArray> value(const QByteArray& key,
+                                    const QByteArray& id) const;
+    bool contains(const QByteArray& key, const QByteArray& id) const;
+    int count() const { return m_count; }
+
+    // Full scan in (key, id) order; decodes every record
+    void forEach(const std::function<void(const Record&)>& visitor) const;
+    QList<Record> records() const;
+
+    // Each change is durable once the call returns true
+    bool put(const QByteArray& key, const QByteArray& id,
+             const QByteArray& payload);
+    bool remove(const QByteArray& key, const QByteArray& id);
+    bool clear();
+
+    // Swaps the whole content for records in one atomic snapshot write, so
+    // bulk loads cost a single sync instead of one per record
+    bool replaceAll(const QList<Record>& records);
+
+    bool compact();
+    qint64 logSize() const { return m_logSize; }
+
+private:
+    enum class LogOp : quint8 { Put = 1, Remove = 2, Clear = 3 };
+
+    struct RecordView {
+        QByteArrayView key;
+        QByteArrayView id;
+        QByteArrayView payload;
+    };
+
+    // Overlay entry; std::nullopt marks a removed record
+    using OverlayRecords = QMap<QByteArray, std::optional<QByteArray>>;
+
+    bool mapSnapshot();
+    void unmapSnapshot();
+    bool replayLog();
+    bool appendLog(LogOp op, const QByteArray& key, const QByteArray& id,
+                   const QByteArray& payload);
+    void applyLog(LogOp op, const QByteArray& key, const QByteArray& id,
+                  const QByteArray& payload);
+    void compactIfNeeded();
+    // Writes sorted, unique records as the new snapshot and empties the log
+    bool writeSnapshot(const QList<Record>& merged);
+
+    // Snapshot access; slots index the sorted offset table
+    bool snapshotRecord(quint32 slot, RecordView* record) const;
+    quint32 lowerBound(QByteArrayView key, QByteArrayView id) const;
+    bool snapshotContains(QByteArrayView key, QByteArrayView id) const;
+    bool snapshotVisible() const { return m_map && !m_snapshotCleared; }
+
+    static int compareBytes(QByteArrayView a, QByteArrayView b);
+    static QByteArray encodeRecord(const QByteArray& key, const QByteArray& id,
+                                   const QByteArray& payload);
+
+    QString m_snapshotPath;
+    bool m_open = false;
+
+    QFile m_snapshotFile;
+    uchar* m_map = nullptr;
+    qint64 m_mapSize = 0;
+    quint32 m_snapshotCount = 0;
+    qint64 m_indexOffset = 0;
+
+    QFile m_logFile;
+    qint64 m_logSize = 0;
+
+    QMap<QByteArray, OverlayRecords> m_overlay;
+    bool m_snapshotCleared = false;  // a logged clear() hides the snapshot
+    int m_count = 0;
+
+    static constexpr quint32 SNAPSHOT_MAGIC = 0x534B5253;  // "SRKS"
+    static constexpr quint32 SNAPSHOT_VERSION = 1;
+    static constexpr qint64 SNAPSHOT_HEADER_SIZE = 24;
+    static constexpr qint64 RECORD_HEADER_SIZE = 8;
+    static constexpr qint64 LOG_ENTRY_HEADER_SIZE = 12;
+    static constexpr qint64 MIN_COMPACT_LOG_SIZE = 256 * 1024;
+    static constexpr int MAX_FIELD_SIZE = 0xFFFF;
+};
@@ -0,0 +1,315 @@
+#include "LanguageDetector.h"
+#include <QChar>
+#include <QStringList>
+#include <QtGlobal>
+#include <algorithm>
+
+namespace {
+
+// Symbols below LatinSymbols take part in trigrams (5 bits each)
+enum Symbol : quint8 {
+    Separator = 0,
+    // 1..26 are the folded letters a..z
+    GermanMark = 27,   // ä ö ü ß
+    AcuteE = 28,       // é, shared by French and Spanish
+    FrenchMark = 29,   // à â ç è ê ë î ï ô ù û œ
+    SpanishMark = 30,  // á í ñ ó ú
+    OtherLatin = 31,
+    LatinSymbols = 32,
+    HanScript = LatinSymbols,
+    KanaScript,
+    HangulScript,
+    CyrillicScript,
+    OtherScript,
+    SymbolCount
+};
+
+constexpr int SCRIPT_COUNT = SymbolCount - LatinSymbols;
+constexpr int TRIGRAM_COUNT = LatinSymbols * LatinSymbols * LatinSymbols;
+
+// Latin languages in nibble order of the trigram table
+constexpr LanguageDetector::Language LATIN_LANGUAGES[] = {
+    LanguageDetector::English, LanguageDetector::French,
+    LanguageDetector::German, LanguageDetector::Spanish};
+constexpr int LATIN_COUNT = static_cast<int>(std::size(LATIN_LANGUAGES));
+
+// Most frequent trigrams per language, most frequent first; '_' stands for
+// a word boundary. Earlier entries weigh more.
+const char* const PROFILES[LATIN_COUNT] = {
+    // English
+    "_th the he_ _an and nd_ ing ng_ _of of_ _to to_ _in ion in_ ed_ tio "
+    "ent er_ is_ _is hat tha at_ for _fo or_ es_ _be ate ter ere his _co "
+    "con as_ on_ re_ ly_ wit ith th_ you _yo was _wa _wh _a_ all",
+    // French
+    "_de de_ es_ ent _le le_ nt_ les _la la_ ion _et et_ re_ _co des _pa "
+    "que _qu ue_ ons on_ _un une ne_ _es est st_ _en en_ men tio our _po "
+    "par ait _l_ _d_ aux ux_ eur té_ ée_ _dé ère _à_ _pr ous _so",
+    // German
+    "en_ er_ _de der ch_ ie_ ich ein sch _di die che nd_ und _un cht _ei "
+    "ine den gen _da te_ ten _in in_ es_ _be ung ng_ ber _ge ter _zu zu_ "
+    "ist _is st_ auf _au nen _mi mit it_ ges sie _si ver _ve eit hen das",
+    // Spanish
+    "_de de_ os_ _la la_ el_ es_ _el _qu que ue_ _en en_ as_ _co ent con "
+    "_lo los _se ado _pr ón_ ión _po por or_ _es est ra_ nte _un una _su "
+    "ara _pa par do_ ien ero res ida aci cio _y_ _ca ndo"};
+
+// Nibble weights: ranked profile entries span MAX..MIN, accent classes
+// vote for their language wherever they appear
+constexpr int MAX_WEIGHT = 15;
+constexpr int MIN_WEIGHT = 4;
+constexpr int ACCENT_WEIGHT = 8;
+constexpr int SHARED_ACCENT_WEIGHT = 3;
+
+Symbol classify(QChar ch) {
+    const char16_t u = ch.unicode();
+    if ((u >= 0x3400 && u <= 0x4DBF) || (u >= 0x4E00 && u <= 0x9FFF) ||
+        (u >= 0xF900 && u <= 0xFAFF)) {
+        return HanScript;
+    }
+    if ((u >= 0x3040 && u <= 0x30FF) || (u >= 0x31F0 && u <= 0x31FF) ||
+        (u >= 0xFF66 && u <= 0xFF9F)) {
+        return KanaScript;
+    }
+    if ((u >= 0xAC00 && u <= 0xD7AF) || (u >= 0x1100 && u <= 0x11FF) ||
+        (u >= 0x3130 && u <= 0x318F)) {
+        return HangulScript;
+    }
+    if (!ch.isLetter()) {
+        return Separator;
+    }
+    if (ch.script() == QChar::Script_Cyrillic) {
+        return CyrillicScript;
+    }
+
+    char16_t folded = ch.toLower().unicode();
+    if (folded >= 0xFF41 && folded <= 0xFF5A) {  // Fullwidth a..z
+        folded = static_cast<char16_t>(folded - 0xFF41 + u'a');
+    }
+    if (folded >= u'a' && folded <= u'z') {
+        return static_cast<Symbol>(folded - u'a' + 1);
+    }
+    switch (folded) {
+        case 0x00E4:  // ä
+        case 0x00F6:  // ö
+        case 0x00FC:  // ü
+        case 0x00DF:  // ß
+            return GermanMark;
+        case 0x00E9:  // é
+            return AcuteE;
+        case 0x00E0:  // à
+        case 0x00E2:  // â
+        case 0x00E7:  // ç
+        case 0x00E8:  // è
+        case 0x00EA:  // ê
+        case 0x00EB:  // ë
+        case 0x00EE:  // î
+        case 0x00EF:  // ï
+        case 0x00F4:  // ô
+        case 0x00F9:  // ù
+        case 0x00FB:  // û
+        case 0x0153:  // œ
+            return FrenchMark;
+        case 0x00E1:  // á
+        case 0x00ED:  // í
+        case 0x00F1:  // ñ
+        case 0x00F3:  // ó
+        case 0x00FA:  // ú
+            return SpanishMark;
+        default:
+            break;
+    }
+    return ch.script() == QChar::Script_Latin ? OtherLatin : OtherScript;
+}
+
+struct Tables {
+    std::array<quint8, 0x10000> symbols;
+    // 4-bit weight per Latin language, indexed by three 5-bit symbols
+    std::array<quint16, TRIGRAM_COUNT> trigrams;
+
+    Tables();
+    void raise(int index, int language, int weight);
+};
+
+Tables::Tables() {
+    for (int c = 0; c < 0x10000; ++c) {
+        const QChar ch(static_cast<char16_t>(c));
+        symbols[c] = ch.isSurrogate() ? Separator : classify(ch);
+    }
+
+    trigrams.fill(0);
+    for (int language = 0; language < LATIN_COUNT; ++language) {
+        const QStringList entries = QString::fromUtf8(PROFILES[language])
+                                        .split(u' ', Qt::SkipEmptyParts);
+        for (qsizetype rank = 0; rank < entries.size(); ++rank) {
+            int index = 0;
+            for (QChar ch : entries[rank]) {
+                const int symbol =
+                    ch == u'_' ? Separator : symbols[ch.unicode()];
+                index = (index << 5) | qMin(symbol, int(OtherLatin));
+            }
+            raise(index, language,
+                  MAX_WEIGHT - static_cast<int>(rank *
+                                                (MAX_WEIGHT - MIN_WEIGHT) /
+                                                entries.size()));
+        }
+    }
+
+    for (int index = 0; index < TRIGRAM_COUNT; ++index) {
+        for (int shift = 0; shift < 15; shift += 5) {
+            switch ((index >> shift) & 0x1F) {
+                case GermanMark:
+                    raise(index, 2, ACCENT_WEIGHT);
+                    break;
+                case FrenchMark:
+                    raise(index, 1, ACCENT_WEIGHT);
+                    break;
+                case SpanishMark:
+                    raise(index, 3, ACCENT_WEIGHT);
+                    break;
+                case AcuteE:
+                    raise(index, 1, SHARED_ACCENT_WEIGHT);
+                    raise(index, 3, SHARED_ACCENT_WEIGHT);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
+
+void Tables::raise(int index, int language, int weight) {
+    const int shift = language * 4;
+    const int current = (trigrams[index] >> shift) & 0xF;
+    if (weight > current) {
+        trigrams[index] = static_cast<quint16>(
+            (trigrams[index] & ~(0xF << shift)) | (weight << shift));
+    }
+}
+
+const Tables& tables() {
+    static const Tables instance;
+    return instance;
+}
+
+// Adds the span's letters, weighted as documented on Distribution
+void addSpan(QStringView span, const Tables& t,
+             LanguageDetector::Distribution& weights) {
+    int latinLetters = 0;
+    std::array<int, SCRIPT_COUNT> scripts{};
+    std::array<int, LATIN_COUNT> scores{};
+
+    int context = 0;  // Last three symbols, 5 bits each
+    for (QChar ch : span) {
+        const int symbol = t.symbols[ch.unicode()];
+        if (symbol < LatinSymbols) {
+            latinLetters += symbol != Separator;
+            context = ((context << 5) | symbol) & (TRIGRAM_COUNT - 1);
+            const int entry = t.trigrams[context];
+            scores[0] += entry & 0xF;
+            scores[1] += (entry >> 4) & 0xF;
+            scores[2] += (entry >> 8) & 0xF;
+            scores[3] += (entry >> 12) & 0xF;
+        } else {
+            // Other scripts end the Latin word
+            ++scripts[symbol - LatinSymbols];
+            context = (context << 5) & (TRIGRAM_COUNT - 1);
+        }
+    }
+
+    constexpr float ideograph = LanguageDetector::ALPHABETIC_PER_IDEOGRAPH;
+    const int han = scripts[HanScript - LatinSymbols];
+    const int kana = scripts[KanaScript - LatinSymbols];
+    // Japanese mixes kanji with kana; Chinese text has (almost) no kana
+    if (kana > 0 && kana * 10 >= han + kana) {
+        weights[LanguageDetector::Japanese] += (han + kana) * ideograph;
+    } else {
+        weights[LanguageDetector::Chinese] += han * ideograph;
+        weights[LanguageDetector::Japanese] += kana * ideograph;
+    }
+    weights[LanguageDetector::Korean] +=
+        scripts[HangulScript - LatinSymbols] * ideograph;
+    weights[LanguageDetector::Russian] +=
+        scripts[CyrillicScript - LatinSymbols];
+    weights[LanguageDetector::Unknown] += scripts[OtherScript - LatinSymbols];
+
+    if (latinLetters > 0) {
+        const auto best = std::max_element(scores.cbegin(), scores.cend());
+        weights[*best > 0 ? LATIN_LANGUAGES[best - scores.cbegin()]
+                          : LanguageDetector::Unknown] += latinLetters;
+    }
+}
+
+}  // namespace
+
+LanguageDetector::Distribution LanguageDetector::detectPage(QStringView text) {
+    Distribution weights{};
+    const Tables& t = tables();
+
+    const qsizetype length = text.size();
+    const qsizetype budget = qsizetype(SPAN_LENGTH) * SAMPLE_SPANS;
+    if (length <= budget) {
+        for (qsizetype start = 0; start < length; start += SPAN_LENGTH) {
+            addSpan(text.mid(start, SPAN_LENGTH), t, weights);
+        }
+    } else {
+        const qsizetype stride = length / SAMPLE_SPANS;
+        for (int i = 0; i < SAMPLE_SPANS; ++i) {
+            addSpan(text.sliced(i * stride, SPAN_LENGTH), t, weights);
+        }
+    }
+
+    float total = 0.0f;
+    for (float weight : weights) {
+        total += weight;
+    }
+    if (total > 0.0f) {
+        for (float& weight : weights) {
+            weight /= total;
+        }
+    }
+    return weights;
+}
+
+LanguageDetector::Language LanguageDetector::dominant(
+    const Distribution& distribution) {
+    const auto best =
+        std::max_element(distribution.cbegin(), distribution.cend());
+    return *best > 0.0f
+               ? static_cast<Language>(best - distribution.cbegin())
+               : Unknown;
+}
+
+bool LanguageDetector::isMixed(const Distribution& distribution) {
+    int languages = 0;
+    for (int i = Unknown + 1; i < LanguageCount; ++i) {
+        languages += distribution[i] >= MIXED_SHARE;
+    }
+    return languages >= 2;
+}
+
+bool LanguageDetector::isCjk(Language language) {
+    return language == Chinese || language == Japanese || language == Korean;
+}
+
+QString LanguageDetector::code(Language language) {
+    static const char* const codes[LanguageCount] = {
+        "und", "zh", "ja", "ko", "ru", "en", "fr", "de", "es"};
+    return QString::fromLatin1(codes[language]);
+}
+
+QString LanguageDetector::name(Language language) {
+    static const char* const names[LanguageCount] = {
+        "unknown", "chinese", "japanese", "korean", "russian",
+        "english", "french",  "german",   "spanish"};
+    return QString::fromLatin1(names[language]);
+}
+
+QJsonObject LanguageDetector::toJson(const Distribution& distribution) {
+    QJsonObject json;
+    for (int i = 0; i < LanguageCount; ++i) {
+        if (distribution[i] > 0.0f) {
+            json[code(static_cast<Language>(i))] = double(distribution[i]);
+        }
+    }
+    return json;
+}
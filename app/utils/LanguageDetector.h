@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringView>
+#include <array>
+
+/**
+ * Per-page language identification from character statistics.
+ *
+ * Every UTF-16 code unit goes through one 64K lookup table that yields
+ * either a Latin trigram symbol (26 folded letters, four accent classes,
+ * other Latin letters, separator) or a script class (Han, kana, Hangul,
+ * Cyrillic, other letters). Scripts decide CJK and Russian directly;
+ * Latin runs are scored with a compact trigram table holding a 4-bit weight
+ * per Latin language, so detection is two table lookups per character and
+ * allocates nothing.
+ *
+ * Text is scored in spans of SPAN_LENGTH characters, each span assigning
+ * its Latin letters to its best Latin language, which keeps the English
+ * parts of a Chinese page apart from the Chinese ones. Long pages are
+ * sampled with SAMPLE_SPANS evenly spaced spans.
+ */
+class LanguageDetector {
+public:
+    enum Language {
+        Unknown,
+        Chinese,
+        Japanese,
+        Korean,
+        Russian,
+        English,
+        French,
+        German,
+        Spanish,
+        LanguageCount
+    };
+
+    // Share of the text per language, summing to 1; all zero for text
+    // without letters. Shares count an ideograph or syllable as
+    // ALPHABETIC_PER_IDEOGRAPH letters, so they follow the amount of
+    // content rather than the number of characters.
+    using Distribution = std::array<float, LanguageCount>;
+
+    static Distribution detectPage(QStringView text);
+    static Language dominant(const Distribution& distribution);
+    // True when at least two languages each hold MIXED_SHARE of the text
+    static bool isMixed(const Distribution& distribution);
+    static bool isCjk(Language language);
+
+    // ISO 639-1 code ("und" for Unknown) and the lowercase English name
+    // used in analysis reports
+    static QString code(Language language);
+    static QString name(Language language);
+    // {code: share} for the languages present
+    static QJsonObject toJson(const Distribution& distribution);
+
+    static constexpr int SPAN_LENGTH = 256;
+    static constexpr int SAMPLE_SPANS = 8;
+    static constexpr float ALPHABETIC_PER_IDEOGRAPH = 3.0f;
+    static constexpr float MIXED_SHARE = 0.2f;
+};
@@ -18,11 +18,64 @@
 #include <QtGlobal>
 #include <QtMath>
 #include <algorithm>
+#include <cmath>
 #include <exception>
 #include <memory>
 #include <vector>
 #include "../model/AnnotationModel.h"
+#include "../model/PageMetadataTable.h"
+#include "CjkTokenizer.h"
+#include "LanguageDetector.h"
 #include "Logger.h"
+#include "TextArena.h"
+
+namespace {
+
+struct TextCounts {
+    int words = 0;
+    int sentences = 0;
+    int paragraphs = 0;
+};
+
+using SpanScanner = void (*)(QStringView, TextArena::Vector<QStringView>&);
+
+int countSpans(QStringView text, SpanScanner scan) {
+    TextArena arena;
+    auto spans = arena.makeVector<QStringView>();
+    scan(text, spans);
+    return static_cast<int>(spans.size());
+}
+
+// One arena per job: the three passes reuse the same span buffer
+TextCounts countTextSpans(QStringView text) {
+    TextCounts counts;
+    if (text.isEmpty()) {
+        return counts;
+    }
+
+    TextArena arena;
+    auto spans = arena.makeVector<QStringView>();
+    CjkTokenizer::words(text, spans);
+    counts.words = static_cast<int>(spans.size());
+    spans.clear();
+    TextSpans::sentences(text, spans);
+    counts.sentences = static_cast<int>(spans.size());
+    spans.clear();
+    TextSpans::paragraphs(text, spans);
+    counts.paragraphs = static_cast<int>(spans.size());
+    return counts;
+}
+
+QStringList toStringList(const TextArena::Vector<QStringView>& spans) {
+    QStringList list;
+    list.reserve(static_cast<qsizetype>(spans.size()));
+    for (QStringView span : spans) {
+        list.append(span.toString());
+    }
+    return list;
+}
+
+}  // namespace
 
 QJsonObject PDFUtilities::analyzeDocument(Poppler::Document* document) {
     QJsonObject analysis;
@@ -50,10 +103,11 @@ QJsonObject PDFUtilities::analyzeDocument(Poppler::Document* document) {
     QStringList allText = extractAllText(document);
     QString fullText = allText.join(" ");
 
-    analysis["textStatistics"] = generateTextStatistics(fullText);
-    analysis["totalWords"] = countWords(fullText);
-    analysis["totalSentences"] = countSentences(fullText);
-    analysis["totalParagraphs"] = countParagraphs(fullText);
+    const QJsonObject textStatistics = generateTextStatistics(fullText);
+    analysis["textStatistics"] = textStatistics;
+    analysis["totalWords"] = textStatistics["wordCount"];
+    analysis["totalSentences"] = textStatistics["sentenceCount"];
+    analysis["totalParagraphs"] = textStatistics["paragraphCount"];
     analysis["estimatedReadingTime"] = calculateReadingTime(fullText);
     analysis["detectedLanguage"] = detectLanguage(fullText);
 
@@ -190,9 +244,10 @@ QJsonObject PDFUtilities::analyzePage(Poppler::Page* page, int pageNumber) {
     // Text analysis
     QString pageText = extractPageText(page);
     pageInfo["textLength"] = pageText.length();
-    pageInfo["wordCount"] = countWords(pageText);
-    pageInfo["sentenceCount"] = countSentences(pageText);
-    pageInfo["paragraphCount"] = countParagraphs(pageText);
+    const TextCounts counts = countTextSpans(pageText);
+    pageInfo["wordCount"] = counts.words;
+    pageInfo["sentenceCount"] = counts.sentences;
+    pageInfo["paragraphCount"] = counts.paragraphs;
 
     // Image analysis
     QList<QPixmap> pageImages = extractPageImages(page);
@@ -267,8 +322,7 @@ int PDFUtilities::countWords(const QString& text) {
         return 0;
     }
 
-    QStringList words = tokenizeText(text);
-    return words.size();
+    return countSpans(text, CjkTokenizer::words);
 }
 
 int PDFUtilities::countSentences(const QString& text) {
@@ -276,8 +330,7 @@ int PDFUtilities::countSentences(const QString& text) {
         return 0;
     }
 
-    QStringList sentences = extractSentences(text);
-    return sentences.size();
+    return countSpans(text, TextSpans::sentences);
 }
 
 int PDFUtilities::countParagraphs(const QString& text) {
@@ -285,8 +338,7 @@ int PDFUtilities::countParagraphs(const QString& text) {
         return 0;
     }
 
-    QStringList paragraphs = extractParagraphs(text);
-    return paragraphs.size();
+    return countSpans(text, TextSpans::paragraphs);
 }
 
 QStringList PDFUtilities::extractKeywords(const QString& text,
@@ -297,37 +349,55 @@ QStringList PDFUtilities::extractKeywords(const QString& text,
         return keywords;
     }
 
-    // Simple keyword extraction based on word frequency
-    QStringList words = tokenizeText(text.toLower());
-    QHash<QString, int> wordCount;
-
-    // Common stop words to filter out
-    QStringList stopWords = {
-        "the",   "a",      "an",  "and",   "or",  "but",  "in",
-        "on",    "at",     "to",  "for",   "of",  "with", "by",
-        "is",    "are",    "was", "were",  "be",  "been", "have",
-        "has",   "had",    "do",  "does",  "did", "will", "would",
-        "could", "should", "may", "might", "can", "this", "that",
-        "these", "those",  "i",   "you",   "he",  "she",  "it",
-        "we",    "they",   "me",  "him",   "her", "us",   "them"};
-
-    for (const QString& word : words) {
-        if (word.length() > 3 && !stopWords.contains(word)) {
-            wordCount[word]++;
+    // Simple keyword extraction based on word frequency. Words are views
+    // into the lowered text; only the selected keywords are copied out.
+    const QString lowered = text.toLower();
+    TextArena arena;
+    auto words = arena.makeVector<QStringView>();
+    CjkTokenizer::words(lowered, words);
+
+    // Common stop words to filter out (only those longer than three
+    // characters, or two for CJK words, can survive the length filter)
+    static constexpr QStringView stopWords[] = {
+        u"with",   u"were",  u"been",  u"have",  u"does",  u"will",
+        u"would",  u"could", u"should", u"might", u"this", u"that",
+        u"these",  u"those", u"they",  u"them",  u"我们",  u"你们",
+        u"他们",   u"自己",  u"这个",  u"那个",  u"这些",  u"那些",
+        u"一个",   u"可以",  u"没有",  u"因为",  u"所以",  u"但是",
+        u"如果",   u"就是"};
+
+    auto wordCount = arena.makeViewMap<int>();
+    for (QStringView word : words) {
+        const qsizetype minimumLength =
+            CjkTokenizer::isCjk(word.front()) ? 2 : 4;
+        if (word.length() >= minimumLength &&
+            std::find(std::begin(stopWords), std::end(stopWords), word) ==
+                std::end(stopWords)) {
+            ++wordCount[word];
         }
     }
 
-    // Sort by frequency and take top keywords
-    QList<QPair<int, QString>> sortedWords;
-    for (auto it = wordCount.begin(); it != wordCount.end(); ++it) {
-        sortedWords.append(qMakePair(it.value(), it.key()));
+    // Sort by frequency and take top keywords; ties by descending word as
+    // before
+    auto sortedWords = arena.makeVector<std::pair<int, QStringView>>();
+    sortedWords.reserve(wordCount.size());
+    for (const auto& entry : wordCount) {
+        sortedWords.emplace_back(entry.second, entry.first);
     }
 
     std::sort(sortedWords.begin(), sortedWords.end(),
-              std::greater<QPair<int, QString>>());
+              [](const auto& a, const auto& b) {
+                  if (a.first != b.first) {
+                      return a.first > b.first;
+                  }
+                  return a.second.compare(b.second) > 0;
+              });
 
-    for (int i = 0; i < qMin(maxKeywords, sortedWords.size()); ++i) {
-        keywords.append(sortedWords[i].second);
+    const qsizetype keywordCount =
+        qMin<qsizetype>(maxKeywords, sortedWords.size());
+    keywords.reserve(qMax<qsizetype>(0, keywordCount));
+    for (qsizetype i = 0; i < keywordCount; ++i) {
+        keywords.append(sortedWords[i].second.toString());
     }
 
     return keywords;
@@ -340,35 +410,8 @@ double PDFUtilities::calculateReadingTime(const QString& text,
 }
 
 QString PDFUtilities::detectLanguage(const QString& text) {
-    // Simplified language detection based on common words
-    // In a real implementation, you would use a proper language detection
-    // library
-
-    if (text.isEmpty()) {
-        return "unknown";
-    }
-
-    QString lowerText = text.toLower();
-
-    // English indicators
-    QStringList englishWords = {"the", "and",  "that", "have", "for",
-                                "not", "with", "you",  "this", "but"};
-    int englishCount = 0;
-    for (const QString& word : englishWords) {
-        englishCount += lowerText.count(word);
-    }
-
-    // Chinese indicators (simplified check)
-    QRegularExpression chineseRegex("[\\u4e00-\\u9fff]");
-    int chineseCount = lowerText.count(chineseRegex);
-
-    if (chineseCount > englishCount) {
-        return "chinese";
-    } else if (englishCount > 0) {
-        return "english";
-    }
-
-    return "unknown";
+    return LanguageDetector::name(
+        LanguageDetector::dominant(LanguageDetector::detectPage(text)));
 }
 
 QJsonObject PDFUtilities::analyzeImage(const QPixmap& image) {
@@ -476,47 +519,47 @@ QString PDFUtilities::cleanText(const QString& text) {
 }
 
 QStringList PDFUtilities::tokenizeText(const QString& text) {
-    QString cleaned = cleanText(text);
-    QRegularExpression wordRegex("\\b\\w+\\b");
-    QRegularExpressionMatchIterator matches = wordRegex.globalMatch(cleaned);
-
-    QStringList words;
-    while (matches.hasNext()) {
-        QRegularExpressionMatch match = matches.next();
-        words.append(match.captured(0));
-    }
-
-    return words;
+    // Whitespace cleanup cannot change word boundaries, so scan the
+    // original text instead of a cleaned copy
+    TextArena arena;
+    auto words = arena.makeVector<QStringView>();
+    CjkTokenizer::words(text, words);
+    return toStringList(words);
 }
 
 QStringList PDFUtilities::extractSentences(const QString& text) {
-    QStringList sentences;
-    QRegularExpression sentenceRegex("[.!?]+");
-    QStringList parts = text.split(sentenceRegex, Qt::SkipEmptyParts);
-
-    for (const QString& part : parts) {
-        QString sentence = part.trimmed();
-        if (!sentence.isEmpty()) {
-            sentences.append(sentence);
-        }
-    }
-
-    return sentences;
+    TextArena arena;
+    auto sentences = arena.makeVector<QStringView>();
+    TextSpans::sentences(text, sentences);
+    return toStringList(sentences);
 }
 
 QStringList PDFUtilities::extractParagraphs(const QString& text) {
-    QStringList paragraphs;
-    QStringList parts =
-        text.split(QRegularExpression("\\n\\s*\\n"), Qt::SkipEmptyParts);
-
-    for (const QString& part : parts) {
-        QString paragraph = part.trimmed();
-        if (!paragraph.isEmpty()) {
-            paragraphs.append(paragraph);
-        }
+    TextArena arena;
+    auto paragraphs = arena.makeVector<QStringView>();
+    TextSpans::paragraphs(text, paragraphs);
+    return toStringList(paragraphs);
+}
+
+double PDFUtilities::calculateEntropy(const QString& text) {
+    // Shannon entropy of the UTF-16 code units, in bits per character
+    if (text.isEmpty()) {
+        return 0.0;
+    }
+
+    TextArena arena;
+    std::pmr::unordered_map<char16_t, int> frequencies(arena.resource());
+    for (QChar ch : text) {
+        ++frequencies[ch.unicode()];
     }
 
-    return paragraphs;
+    double entropy = 0.0;
+    const double length = text.length();
+    for (const auto& entry : frequencies) {
+        const double probability = entry.second / length;
+        entropy -= probability * std::log2(probability);
+    }
+    return entropy;
 }
 
 double PDFUtilities::calculateLevenshteinDistance(const QString& str1,
@@ -989,14 +1032,14 @@ QJsonObject PDFUtilities::generateTextStatistics(const QString& text) {
         return stats;
     }
 
-    stats["wordCount"] = countWords(text);
+    const TextCounts counts = countTextSpans(text);
+    stats["wordCount"] = counts.words;
     stats["characterCount"] = text.length();
-    stats["sentenceCount"] = countSentences(text);
-    stats["paragraphCount"] = countParagraphs(text);
+    stats["sentenceCount"] = counts.sentences;
+    stats["paragraphCount"] = counts.paragraphs;
     stats["averageWordsPerSentence"] =
-        stats["sentenceCount"].toInt() > 0
-            ? static_cast<double>(stats["wordCount"].toInt()) /
-                  stats["sentenceCount"].toInt()
+        counts.sentences > 0
+            ? static_cast<double>(counts.words) / counts.sentences
             : 0.0;
 
     return stats;
@@ -1032,6 +1075,103 @@ QJsonObject PDFUtilities::generateImageStatistics(
     return stats;
 }
 
+QJsonObject PDFUtilities::generatePageStatistics(Poppler::Page* page) {
+    QJsonObject stats;
+
+    if (!page) {
+        stats["error"] = "Invalid page";
+        return stats;
+    }
+
+    // Only cheap per-page data: no rendering, no image extraction
+    QSizeF pageSize = getPageSize(page);
+    stats["width"] = pageSize.width();
+    stats["height"] = pageSize.height();
+    stats["landscape"] = pageSize.width() > pageSize.height();
+
+    QString pageText = extractPageText(page);
+    stats["characterCount"] = pageText.length();
+    stats["wordCount"] = countWords(pageText);
+    stats["annotationCount"] = static_cast<int>(page->annotations().size());
+
+    return stats;
+}
+
+QJsonObject PDFUtilities::generateDocumentStatistics(
+    Poppler::Document* document) {
+    QJsonObject stats;
+
+    if (!document) {
+        stats["error"] = "Invalid document";
+        return stats;
+    }
+
+    const int pageCount = document->numPages();
+    for (int i = 0; i < pageCount; ++i) {
+        std::unique_ptr<Poppler::Page> page(document->page(i));
+        if (page) {
+            accumulatePageStatistics(stats,
+                                     generatePageStatistics(page.get()));
+        }
+    }
+
+    finalizeDocumentStatistics(stats, pageCount);
+    return stats;
+}
+
+void PDFUtilities::accumulatePageStatistics(QJsonObject& documentStats,
+                                            const QJsonObject& pageStats) {
+    if (pageStats.contains("error")) {
+        return;
+    }
+
+    const int words = pageStats["wordCount"].toInt();
+
+    documentStats["processedPages"] =
+        documentStats["processedPages"].toInt() + 1;
+    documentStats["totalCharacters"] =
+        documentStats["totalCharacters"].toInteger() +
+        pageStats["characterCount"].toInt();
+    documentStats["totalWords"] =
+        documentStats["totalWords"].toInteger() + words;
+    documentStats["totalAnnotations"] =
+        documentStats["totalAnnotations"].toInt() +
+        pageStats["annotationCount"].toInt();
+    documentStats["pagesWithText"] =
+        documentStats["pagesWithText"].toInt() + (words > 0 ? 1 : 0);
+    documentStats["landscapePages"] =
+        documentStats["landscapePages"].toInt() +
+        (pageStats["landscape"].toBool() ? 1 : 0);
+    documentStats["totalPageWidth"] =
+        documentStats["totalPageWidth"].toDouble() +
+        pageStats["width"].toDouble();
+    documentStats["totalPageHeight"] =
+        documentStats["totalPageHeight"].toDouble() +
+        pageStats["height"].toDouble();
+}
+
+void PDFUtilities::finalizeDocumentStatistics(QJsonObject& documentStats,
+                                              int pageCount) {
+    const int processed = documentStats["processedPages"].toInt();
+
+    documentStats["pageCount"] = pageCount;
+    documentStats["complete"] = processed >= pageCount;
+
+    if (processed > 0) {
+        documentStats["averageWordsPerPage"] =
+            static_cast<double>(documentStats["totalWords"].toInteger()) /
+            processed;
+        documentStats["averagePageWidth"] =
+            documentStats["totalPageWidth"].toDouble() / processed;
+        documentStats["averagePageHeight"] =
+            documentStats["totalPageHeight"].toDouble() / processed;
+    } else {
+        documentStats["averageWordsPerPage"] = 0.0;
+        documentStats["averagePageWidth"] = 0.0;
+        documentStats["averagePageHeight"] = 0.0;
+    }
+}
+
 QJsonObject PDFUtilities::assessDocumentQuality(Poppler::Document* document) {
     QJsonObject quality;
 
@@ -1158,7 +1298,18 @@ QJsonObject PDFUtilities::suggestOptimizations(Poppler::Document* document) {
 
     // Check for images and suggest optimization
     bool hasImages = false;
+    std::shared_ptr<PageMetadataTable> pageMetadata =
+        PageMetadataTable::find(document);
     for (int i = 0; i < qMin(5, pageCount); ++i) {
+        // The metadata table already holds this heuristic per page
+        if (pageMetadata && pageMetadata->hasContent(i)) {
+            if (pageMetadata->hasImages(i)) {
+                hasImages = true;
+                break;
+            }
+            continue;
+        }
+
         std::unique_ptr<Poppler::Page> page(document->page(i));
         if (page) {
             // Simple heuristic: check if page has significant non-text content
@@ -144,6 +144,13 @@ public:
     static QJsonObject generateTextStatistics(const QString& text);
     static QJsonObject generateImageStatistics(const QList<QPixmap>& images);
 
+    // Incremental statistics: fold page statistics into a running document
+    // total so callers can report partial results while walking pages
+    static void accumulatePageStatistics(QJsonObject& documentStats,
+                                         const QJsonObject& pageStats);
+    static void finalizeDocumentStatistics(QJsonObject& documentStats,
+                                           int pageCount);
+
 private:
     // Helper functions
     static QString cleanText(const QString& text);
@@ -0,0 +1,112 @@
+#include "TextArena.h"
+
+TextArena::TextArena() : m_resource(m_inline, INLINE_SIZE, &m_upstream) {}
+
+void TextArena::reset() { m_resource.release(); }
+
+void* TextArena::CountingResource::do_allocate(std::size_t size,
+                                               std::size_t alignment) {
+    ++blocks;
+    bytes += static_cast<qint64>(size);
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void TextArena::CountingResource::do_deallocate(void* pointer,
+                                                std::size_t size,
+                                                std::size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(pointer, size, alignment);
+}
+
+namespace {
+
+bool isWordChar(QChar ch) {
+    const char16_t c = ch.unicode();
+    return c < 0x80 && ((c >= u'a' && c <= u'z') || (c >= u'A' && c <= u'Z') ||
+                        (c >= u'0' && c <= u'9') || c == u'_');
+}
+
+bool isSentenceEnd(QChar ch) {
+    const char16_t c = ch.unicode();
+    return c == u'.' || c == u'!' || c == u'?';
+}
+
+// \s without Unicode properties: space, \t, \n, \v, \f, \r
+bool isAsciiSpace(QChar ch) {
+    const char16_t c = ch.unicode();
+    return c == u' ' || (c >= u'\t' && c <= u'\r');
+}
+
+void appendTrimmed(QStringView part, TextArena::Vector<QStringView>& out) {
+    part = part.trimmed();
+    if (!part.isEmpty()) {
+        out.push_back(part);
+    }
+}
+
+}  // namespace
+
+void TextSpans::words(QStringView text, TextArena::Vector<QStringView>& out) {
+    const qsizetype length = text.size();
+    qsizetype i = 0;
+    while (i < length) {
+        while (i < length && !isWordChar(text[i])) {
+            ++i;
+        }
+        const qsizetype start = i;
+        while (i < length && isWordChar(text[i])) {
+            ++i;
+        }
+        if (i > start) {
+            out.push_back(text.sliced(start, i - start));
+        }
+    }
+}
+
+void TextSpans::sentences(QStringView text,
+                          TextArena::Vector<QStringView>& out) {
+    const qsizetype length = text.size();
+    qsizetype start = 0;
+    qsizetype i = 0;
+    while (i < length) {
+        if (!isSentenceEnd(text[i])) {
+            ++i;
+            continue;
+        }
+        appendTrimmed(text.sliced(start, i - start), out);
+        while (i < length && isSentenceEnd(text[i])) {
+            ++i;
+        }
+        start = i;
+    }
+    appendTrimmed(text.sliced(start), out);
+}
+
+void TextSpans::paragraphs(QStringView text,
+                           TextArena::Vector<QStringView>& out) {
+    const qsizetype length = text.size();
+    qsizetype start = 0;
+    qsizetype i = 0;
+    while (i < length) {
+        if (text[i] != u'\n') {
+            ++i;
+            continue;
+        }
+        // The separator runs to the last newline of the whitespace run,
+        // like the greedy \s* of the old pattern
+        qsizetype lastNewline = -1;
+        qsizetype k = i + 1;
+        while (k < length && isAsciiSpace(text[k])) {
+            if (text[k] == u'\n') {
+                lastNewline = k;
+            }
+            ++k;
+        }
+        if (lastNewline < 0) {
+            i = k;
+            continue;
+        }
+        appendTrimmed(text.sliced(start, i - start), out);
+        start = i = lastNewline + 1;
+    }
+    appendTrimmed(text.sliced(start), out);
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <QHashFunctions>
+#include <QStringView>
+#include <QtGlobal>
+#include <cstddef>
+#include <functional>
+#include <memory_resource>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Monotonic arena for the scratch data of one text analysis job.
+ *
+ * Allocations are bump-pointer carves from an inline buffer first and then
+ * from geometrically growing heap blocks; nothing is freed individually,
+ * everything goes at once when the arena is reset or destroyed. Token
+ * lists built from QStringView spans into the source text therefore cost
+ * a handful of blocks per page instead of one allocation per token.
+ *
+ * Spans point into the analysed string, which must outlive them. Not
+ * thread-safe; use one arena per job.
+ */
+class TextArena {
+public:
+    template <typename T>
+    using Vector = std::pmr::vector<T>;
+
+    struct ViewHash {
+        std::size_t operator()(QStringView view) const { return qHash(view); }
+    };
+    template <typename T>
+    using ViewMap =
+        std::pmr::unordered_map<QStringView, T, ViewHash,
+                                std::equal_to<QStringView>>;
+
+    TextArena();
+    TextArena(const TextArena&) = delete;
+    TextArena& operator=(const TextArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &m_resource; }
+
+    template <typename T>
+    Vector<T> makeVector(std::size_t capacity = 0) {
+        Vector<T> vector(&m_resource);
+        vector.reserve(capacity);
+        return vector;
+    }
+
+    template <typename T>
+    ViewMap<T> makeViewMap() {
+        return ViewMap<T>(&m_resource);
+    }
+
+    // Frees every block; containers made from the arena must be gone
+    void reset();
+
+    // Heap blocks requested beyond the inline buffer since construction
+    int blockCount() const { return m_upstream.blocks; }
+    qint64 heapBytes() const { return m_upstream.bytes; }
+
+private:
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        int blocks = 0;
+        qint64 bytes = 0;
+
+    private:
+        void* do_allocate(std::size_t size, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t size,
+                           std::size_t alignment) override;
+        bool do_is_equal(
+            const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    static constexpr std::size_t INLINE_SIZE = 16 * 1024;
+
+    alignas(std::max_align_t) std::byte m_inline[INLINE_SIZE];
+    CountingResource m_upstream;
+    std::pmr::monotonic_buffer_resource m_resource;
+};
+
+/**
+ * Span scanners for word, sentence and paragraph analysis.
+ *
+ * Each appends views into @p text to @p out without copying characters.
+ * Boundaries match the regular expressions PDFUtilities used before, with
+ * the default ASCII classes of QRegularExpression:
+ * - words: runs of [A-Za-z0-9_] (\b\w+\b)
+ * - sentences: text between runs of [.!?], trimmed, empty parts dropped
+ * - paragraphs: text between \n\s*\n, trimmed, empty parts dropped
+ */
+namespace TextSpans {
+
+void words(QStringView text, TextArena::Vector<QStringView>& out);
+void sentences(QStringView text, TextArena::Vector<QStringView>& out);
+void paragraphs(QStringView text, TextArena::Vector<QStringView>& out);
+
+}  // namespace TextSpans
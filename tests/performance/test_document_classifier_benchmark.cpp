@@ -0,0 +1,131 @@
+#include <QElapsedTimer>
+#include <QList>
+#include <QStringList>
+#include <QtTest/QtTest>
+#include <algorithm>
+#include "../../app/utils/DocumentClassifier.h"
+
+/**
+ * Classification throughput of DocumentClassifier.
+ *
+ * "Before" classifies one feature vector at a time with predict(), the
+ * way classifyDocument() is called per result; "after" runs predictBatch()
+ * over the whole matrix, which classifyDocuments() uses. Both must agree
+ * on every row.
+ */
+class TestDocumentClassifierBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testThroughput_data();
+    void testThroughput();
+
+private:
+    struct Result {
+        qsizetype rows;
+        double rowMs;
+        double batchMs;
+    };
+
+    static DocumentClassifier::FeatureMatrix makeSamples(qsizetype rows,
+                                                         int classes);
+
+    DocumentClassifier m_classifier;
+    QList<Result> m_results;
+
+    static constexpr int CLASS_COUNT = 8;
+    static constexpr int REPEATS = 5;
+};
+
+DocumentClassifier::FeatureMatrix
+TestDocumentClassifierBenchmark::makeSamples(qsizetype rows, int classes) {
+    DocumentClassifier::FeatureMatrix samples;
+    samples.reserve(rows);
+    quint32 state = 12345u;
+    for (qsizetype r = 0; r < rows; ++r) {
+        const int label = static_cast<int>(r % classes);
+        DocumentClassifier::FeatureVector features{};
+        for (int j = 0; j < DocumentClassifier::FeatureCount; ++j) {
+            state = state * 1664525u + 1013904223u;
+            const float noise = static_cast<float>(state >> 8) / (1u << 24);
+            features[j] = 1.0f + ((label * 7 + j) % classes) + 2.0f * noise;
+        }
+        samples.append(features);
+    }
+    return samples;
+}
+
+void TestDocumentClassifierBenchmark::initTestCase() {
+    QStringList classNames;
+    QList<int> labels;
+    for (int c = 0; c < CLASS_COUNT; ++c) {
+        classNames.append(QString("class%1").arg(c));
+    }
+    const qsizetype trainingRows = 4000;
+    for (qsizetype r = 0; r < trainingRows; ++r) {
+        labels.append(static_cast<int>(r % CLASS_COUNT));
+    }
+    QVERIFY(m_classifier.train(makeSamples(trainingRows, CLASS_COUNT),
+                               labels, classNames));
+}
+
+void TestDocumentClassifierBenchmark::cleanupTestCase() {
+    qDebug() << "=== Document Classification Throughput ===";
+    for (const Result& result : m_results) {
+        const double rowRate = result.rows / result.rowMs * 1000.0;
+        const double batchRate = result.rows / result.batchMs * 1000.0;
+        qDebug().noquote()
+            << QString("%1 documents: predict %2 ms (%3/s), predictBatch "
+                       "%4 ms (%5/s)")
+                   .arg(result.rows)
+                   .arg(result.rowMs, 0, 'f', 2)
+                   .arg(rowRate, 0, 'f', 0)
+                   .arg(result.batchMs, 0, 'f', 2)
+                   .arg(batchRate, 0, 'f', 0);
+    }
+}
+
+void TestDocumentClassifierBenchmark::testThroughput_data() {
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("1000 documents") << 1000;
+    QTest::newRow("100000 documents") << 100000;
+}
+
+void TestDocumentClassifierBenchmark::testThroughput() {
+    QFETCH(int, rows);
+
+    const DocumentClassifier::FeatureMatrix samples =
+        makeSamples(rows, CLASS_COUNT);
+    QList<int> rowPredictions(rows);
+    QList<int> batchPredictions;
+
+    // Best of several runs, so a scheduling hiccup does not decide
+    Result result{rows, 0.0, 0.0};
+    QElapsedTimer timer;
+    for (int repeat = 0; repeat < REPEATS; ++repeat) {
+        timer.start();
+        for (qsizetype r = 0; r < rows; ++r) {
+            DocumentClassifier::FeatureVector features;
+            std::copy_n(samples.row(r), features.size(), features.begin());
+            rowPredictions[r] = m_classifier.predict(features);
+        }
+        const double rowMs = timer.nsecsElapsed() / 1e6;
+
+        timer.restart();
+        batchPredictions = m_classifier.predictBatch(samples);
+        const double batchMs = timer.nsecsElapsed() / 1e6;
+
+        result.rowMs = repeat == 0 ? rowMs : qMin(result.rowMs, rowMs);
+        result.batchMs = repeat == 0 ? batchMs : qMin(result.batchMs, batchMs);
+    }
+    m_results.append(result);
+
+    QCOMPARE(batchPredictions, rowPredictions);
+}
+
+QTEST_MAIN(TestDocumentClassifierBenchmark)
+#include "test_document_classifier_benchmark.moc"
@@ -0,0 +1,210 @@
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QtTest/QtTest>
+#include "../../app/utils/LanguageDetector.h"
+
+/**
+ * Accuracy and throughput of per-page language detection.
+ *
+ * "Before" is the whole-text heuristic PDFUtilities::detectLanguage used
+ * (English keyword counting against a Han-character regex); "after" is
+ * LanguageDetector::detectPage on every page.
+ */
+class TestLanguageDetectorBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void cleanupTestCase();
+
+    void testDetection_data();
+    void testDetection();
+    void testMixedPage();
+    void testThroughput_data();
+    void testThroughput();
+
+private:
+    struct Result {
+        int pages;
+        double megabytes;
+        double beforeMs;
+        double afterMs;
+    };
+
+    static QString makePage(int seed);
+    static QString detectLegacy(const QString& text);
+
+    QList<Result> m_results;
+};
+
+void TestLanguageDetectorBenchmark::cleanupTestCase() {
+    qDebug() << "=== Language Detection Throughput ===";
+    for (const Result& result : m_results) {
+        qDebug().noquote()
+            << QString("%1 pages (%2 MB): before %3 ms, after %4 ms "
+                       "(%5 MB/s)")
+                   .arg(result.pages)
+                   .arg(result.megabytes, 0, 'f', 2)
+                   .arg(result.beforeMs, 0, 'f', 1)
+                   .arg(result.afterMs, 0, 'f', 1)
+                   .arg(result.megabytes / qMax(result.afterMs, 0.001) * 1000,
+                        0, 'f', 0);
+    }
+}
+
+QString TestLanguageDetectorBenchmark::makePage(int seed) {
+    // Chinese prose with English terms, the common case for our users
+    static const QStringList chinese = {
+        QString::fromUtf8("本文介绍了文档渲染的基本原理"),
+        QString::fromUtf8("在阅读器中，页面按需加载并缓存"),
+        QString::fromUtf8("搜索功能支持全文检索和模糊匹配"),
+        QString::fromUtf8("缩略图在后台线程中生成")};
+    static const QStringList english = {
+        "the rendering pipeline", "with a shared cache for each page",
+        "and the search index", "that the viewer builds on open"};
+
+    QString page;
+    int state = seed * 7919 + 17;
+    for (int sentence = 0; sentence < 40; ++sentence) {
+        state = (state * 1103515245 + 12345) & 0x7fffffff;
+        page += chinese[state % chinese.size()];
+        page += ' ';
+        page += english[(state >> 8) % english.size()];
+        page += QString::fromUtf8("。");
+    }
+    return page;
+}
+
+QString TestLanguageDetectorBenchmark::detectLegacy(const QString& text) {
+    if (text.isEmpty()) {
+        return "unknown";
+    }
+
+    QString lowerText = text.toLower();
+    QStringList englishWords = {"the", "and",  "that", "have", "for",
+                                "not", "with", "you",  "this", "but"};
+    int englishCount = 0;
+    for (const QString& word : englishWords) {
+        englishCount += lowerText.count(word);
+    }
+
+    QRegularExpression chineseRegex("[\\u4e00-\\u9fff]");
+    int chineseCount = lowerText.count(chineseRegex);
+
+    if (chineseCount > englishCount) {
+        return "chinese";
+    } else if (englishCount > 0) {
+        return "english";
+    }
+    return "unknown";
+}
+
+void TestLanguageDetectorBenchmark::testDetection_data() {
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("language");
+
+    QTest::newRow("english")
+        << "The viewer renders each page on demand and keeps the most "
+           "recent ones in a cache that is shared with the thumbnails."
+        << int(LanguageDetector::English);
+    QTest::newRow("french")
+        << QString::fromUtf8(
+               "Le lecteur affiche chaque page à la demande et conserve les "
+               "plus récentes dans un cache partagé avec les vignettes.")
+        << int(LanguageDetector::French);
+    QTest::newRow("german")
+        << QString::fromUtf8(
+               "Der Betrachter zeichnet jede Seite bei Bedarf und behält die "
+               "letzten in einem Zwischenspeicher für die Vorschaubilder.")
+        << int(LanguageDetector::German);
+    QTest::newRow("spanish")
+        << QString::fromUtf8(
+               "El visor muestra cada página cuando se necesita y guarda las "
+               "más recientes en una caché que comparte con las miniaturas.")
+        << int(LanguageDetector::Spanish);
+    QTest::newRow("chinese")
+        << QString::fromUtf8("阅读器按需渲染每一页，并将最近的页面缓存起来。")
+        << int(LanguageDetector::Chinese);
+    QTest::newRow("japanese")
+        << QString::fromUtf8(
+               "ビューアは各ページを必要に応じて描画し、最近のページを"
+               "キャッシュします。")
+        << int(LanguageDetector::Japanese);
+    QTest::newRow("korean")
+        << QString::fromUtf8("뷰어는 각 페이지를 필요할 때 렌더링합니다.")
+        << int(LanguageDetector::Korean);
+    QTest::newRow("russian")
+        << QString::fromUtf8(
+               "Программа отображает каждую страницу по мере необходимости.")
+        << int(LanguageDetector::Russian);
+    QTest::newRow("empty") << QString() << int(LanguageDetector::Unknown);
+}
+
+void TestLanguageDetectorBenchmark::testDetection() {
+    QFETCH(QString, text);
+    QFETCH(int, language);
+
+    const LanguageDetector::Distribution distribution =
+        LanguageDetector::detectPage(text);
+    QCOMPARE(int(LanguageDetector::dominant(distribution)), language);
+}
+
+void TestLanguageDetectorBenchmark::testMixedPage() {
+    const LanguageDetector::Distribution distribution =
+        LanguageDetector::detectPage(makePage(1));
+
+    // The old heuristic can only name one language: Han characters
+    // outnumber its English keyword hits, so the English half of the page
+    // is lost. Per-span detection reports both languages.
+    QCOMPARE(detectLegacy(makePage(1)), QString("chinese"));
+    QVERIFY(LanguageDetector::isMixed(distribution));
+    QVERIFY(distribution[LanguageDetector::Chinese] >=
+            LanguageDetector::MIXED_SHARE);
+    QVERIFY(distribution[LanguageDetector::English] >=
+            LanguageDetector::MIXED_SHARE);
+}
+
+void TestLanguageDetectorBenchmark::testThroughput_data() {
+    QTest::addColumn<int>("pages");
+
+    QTest::newRow("100 pages") << 100;
+    QTest::newRow("1000 pages") << 1000;
+}
+
+void TestLanguageDetectorBenchmark::testThroughput() {
+    QFETCH(int, pages);
+
+    QStringList texts;
+    qint64 bytes = 0;
+    for (int i = 0; i < pages; ++i) {
+        texts.append(makePage(i));
+        bytes += texts.last().size() * qint64(sizeof(QChar));
+    }
+
+    Result result{pages, bytes / (1024.0 * 1024.0), 0.0, 0.0};
+
+    QElapsedTimer timer;
+    timer.start();
+    int legacyChinese = 0;
+    for (const QString& text : texts) {
+        legacyChinese += detectLegacy(text) == "chinese";
+    }
+    result.beforeMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    int mixedPages = 0;
+    for (const QString& text : texts) {
+        mixedPages +=
+            LanguageDetector::isMixed(LanguageDetector::detectPage(text));
+    }
+    result.afterMs = timer.nsecsElapsed() / 1e6;
+
+    m_results.append(result);
+
+    Q_UNUSED(legacyChinese);
+    QCOMPARE(mixedPages, pages);
+    QVERIFY(result.afterMs < result.beforeMs);
+}
+
+QTEST_MAIN(TestLanguageDetectorBenchmark)
+#include "test_language_detector_benchmark.moc"
@@ -0,0 +1,187 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QListView>
+#include <QStandardItemModel>
+#include <QtTest/QtTest>
+#include "../../app/model/ModelUpdateCoalescer.h"
+
+/**
+ * Measures how a burst of per-item model updates reaches a list view.
+ *
+ * Each update is delivered in its own event-loop iteration, the way
+ * results arrive from a background generator. Two strategies are compared:
+ * - Direct: every item emits its own dataChanged.
+ * - Coalesced: items go through ModelUpdateCoalescer, which merges them
+ *   into range-merged batches with at most one flush per frame.
+ *
+ * Reported per burst: wall time, dataChanged signals seen by the view and
+ * viewport paint events.
+ */
+class TestModelUpdateBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testBurst_data();
+    void testBurst();
+    void testRangeMerging();
+
+private:
+    struct Counts {
+        double ms = 0.0;
+        int signalCount = 0;
+        int paintCount = 0;
+    };
+
+    struct Result {
+        int burstSize;
+        Counts direct;
+        Counts coalesced;
+    };
+
+    Counts runBurst(int burstSize, bool coalesce);
+
+    QStandardItemModel* m_model = nullptr;
+    QListView* m_view = nullptr;
+    QList<Result> m_results;
+
+    static constexpr int ROW_COUNT = 1000;
+};
+
+namespace {
+
+class PaintCounter : public QObject {
+public:
+    int paints = 0;
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override {
+        if (event->type() == QEvent::Paint) {
+            ++paints;
+        }
+        return QObject::eventFilter(watched, event);
+    }
+};
+
+}  // namespace
+
+void TestModelUpdateBenchmark::initTestCase() {
+    m_model = new QStandardItemModel(this);
+    for (int row = 0; row < ROW_COUNT; ++row) {
+        m_model->appendRow(new QStandardItem(QString("Page %1").arg(row + 1)));
+    }
+
+    m_view = new QListView();
+    m_view->setModel(m_model);
+    m_view->resize(200, 800);
+    m_view->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_view));
+}
+
+void TestModelUpdateBenchmark::cleanupTestCase() {
+    delete m_view;
+
+    qDebug() << "=== Burst of item updates: direct vs coalesced ===";
+    qDebug() << "items | direct ms/signals/paints"
+             << "| coalesced ms/signals/paints";
+    for (const Result& r : m_results) {
+        qDebug().noquote() << QString("%1 | %2 / %3 / %4 | %5 / %6 / %7")
+                                  .arg(r.burstSize, 5)
+                                  .arg(r.direct.ms, 0, 'f', 2)
+                                  .arg(r.direct.signalCount)
+                                  .arg(r.direct.paintCount)
+                                  .arg(r.coalesced.ms, 0, 'f', 2)
+                                  .arg(r.coalesced.signalCount)
+                                  .arg(r.coalesced.paintCount);
+    }
+}
+
+void TestModelUpdateBenchmark::testBurst_data() {
+    QTest::addColumn<int>("burstSize");
+
+    QTest::newRow("10 items") << 10;
+    QTest::newRow("50 items") << 50;
+    QTest::newRow("200 items") << 200;
+}
+
+void TestModelUpdateBenchmark::testBurst() {
+    QFETCH(int, burstSize);
+
+    const Counts direct = runBurst(burstSize, false);
+    const Counts coalesced = runBurst(burstSize, true);
+
+    qDebug() << burstSize << "items - direct:" << direct.ms << "ms,"
+             << direct.signalCount << "signals, coalesced:" << coalesced.ms
+             << "ms," << coalesced.signalCount << "signals";
+
+    m_results.append({burstSize, direct, coalesced});
+
+    QCOMPARE(direct.signalCount, burstSize);
+    QVERIFY(coalesced.signalCount <= direct.signalCount);
+}
+
+void TestModelUpdateBenchmark::testRangeMerging() {
+    ModelUpdateCoalescer coalescer(m_model);
+
+    QList<QPair<int, int>> ranges;
+    QMetaObject::Connection connection = connect(
+        m_model, &QAbstractItemModel::dataChanged, this,
+        [&ranges](const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+            ranges.append({topLeft.row(), bottomRight.row()});
+        });
+
+    for (int row : {5, 3, 4, 10, 11, 20, 5}) {
+        coalescer.markChanged(row, {Qt::DisplayRole});
+    }
+    coalescer.flush();
+    disconnect(connection);
+
+    QCOMPARE(ranges.size(), 3);
+    QCOMPARE(ranges.at(0), qMakePair(3, 5));
+    QCOMPARE(ranges.at(1), qMakePair(10, 11));
+    QCOMPARE(ranges.at(2), qMakePair(20, 20));
+    QCOMPARE(coalescer.requestedUpdates(), 7);
+    QCOMPARE(coalescer.emittedBatches(), 1);
+}
+
+TestModelUpdateBenchmark::Counts TestModelUpdateBenchmark::runBurst(
+    int burstSize, bool coalesce) {
+    Counts counts;
+
+    PaintCounter counter;
+    m_view->viewport()->installEventFilter(&counter);
+    QMetaObject::Connection connection =
+        connect(m_model, &QAbstractItemModel::dataChanged, this,
+                [&counts]() { ++counts.signalCount; });
+
+    ModelUpdateCoalescer coalescer(m_model);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Visible rows first, in the order a generator would finish them
+    for (int i = 0; i < burstSize; ++i) {
+        const int row = i % ROW_COUNT;
+        if (coalesce) {
+            coalescer.markChanged(row, {Qt::DisplayRole});
+        } else {
+            const QModelIndex index = m_model->index(row, 0);
+            emit m_model->dataChanged(index, index, {Qt::DisplayRole});
+        }
+        QCoreApplication::processEvents();
+    }
+    coalescer.flush();
+    QCoreApplication::processEvents();
+
+    counts.ms = static_cast<double>(timer.nsecsElapsed()) / 1e6;
+    counts.paintCount = counter.paints;
+
+    disconnect(connection);
+    m_view->viewport()->removeEventFilter(&counter);
+    return counts;
+}
+
+QTEST_MAIN(TestModelUpdateBenchmark)
+#include "test_model_update_benchmark.moc"
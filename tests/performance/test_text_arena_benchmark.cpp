@@ -0,0 +1,266 @@
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QtTest/QtTest>
+#include <atomic>
+#include <cstdlib>
+#include "../../app/utils/TextArena.h"
+
+/**
+ * Counts heap allocations of per-page text analysis.
+ *
+ * "Before" is the regex/QStringList pipeline PDFUtilities used for word,
+ * sentence and paragraph counting; "after" scans QStringView spans into a
+ * single TextArena per page, the way the rewritten PDFUtilities does.
+ *
+ * Allocations are counted by interposing malloc on glibc. Elsewhere the
+ * counters stay at zero and only timings and result parity are checked.
+ */
+
+namespace {
+
+std::atomic<bool> g_counting{false};
+std::atomic<long> g_allocations{0};
+
+}  // namespace
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+
+void* malloc(size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    if (g_counting.load(std::memory_order_relaxed)) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    return __libc_realloc(pointer, size);
+}
+}
+static constexpr bool ALLOCATIONS_COUNTED = true;
+#else
+static constexpr bool ALLOCATIONS_COUNTED = false;
+#endif
+
+class TestTextArenaBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testParity();
+    void testPageAnalysis_data();
+    void testPageAnalysis();
+
+private:
+    struct Counts {
+        int words = 0;
+        int sentences = 0;
+        int paragraphs = 0;
+
+        bool operator==(const Counts& other) const {
+            return words == other.words && sentences == other.sentences &&
+                   paragraphs == other.paragraphs;
+        }
+    };
+
+    struct Result {
+        int pages;
+        long beforeAllocations;
+        long afterAllocations;
+        double beforeMs;
+        double afterMs;
+    };
+
+    static QString makePage(int seed);
+    static Counts analyzeLegacy(const QString& text);
+    static Counts analyzeSpans(const QString& text);
+
+    QList<Result> m_results;
+};
+
+void TestTextArenaBenchmark::initTestCase() {
+    qDebug() << "Allocation counting:"
+             << (ALLOCATIONS_COUNTED ? "enabled" : "unavailable");
+}
+
+void TestTextArenaBenchmark::cleanupTestCase() {
+    qDebug() << "=== Text Analysis Allocation Summary ===";
+    for (const Result& result : m_results) {
+        qDebug().noquote()
+            << QString("%1 pages: before %2 allocs / %3 ms, after %4 allocs "
+                       "/ %5 ms")
+                   .arg(result.pages)
+                   .arg(result.beforeAllocations)
+                   .arg(result.beforeMs, 0, 'f', 1)
+                   .arg(result.afterAllocations)
+                   .arg(result.afterMs, 0, 'f', 1);
+    }
+}
+
+QString TestTextArenaBenchmark::makePage(int seed) {
+    static const QStringList vocabulary = {
+        "document", "render", "viewer",  "page", "layout",   "annotation",
+        "search",   "index",  "glyph",   "font", "outline",  "thumbnail",
+        "cache",    "zoom",   "rotate",  "text", "paragraph", "sentence"};
+
+    QString page;
+    int state = seed * 7919 + 17;
+    for (int paragraph = 0; paragraph < 6; ++paragraph) {
+        for (int sentence = 0; sentence < 5; ++sentence) {
+            for (int word = 0; word < 12; ++word) {
+                state = (state * 1103515245 + 12345) & 0x7fffffff;
+                page += vocabulary[state % vocabulary.size()];
+                page += word == 11 ? QStringLiteral(". ")
+                                   : QStringLiteral(" ");
+            }
+        }
+        page += QStringLiteral("\n\n");
+    }
+    return page;
+}
+
+TestTextArenaBenchmark::Counts TestTextArenaBenchmark::analyzeLegacy(
+    const QString& text) {
+    Counts counts;
+
+    QString cleaned = text;
+    cleaned = cleaned.replace(QRegularExpression("\\s+"), " ").trimmed();
+    QRegularExpression wordRegex("\\b\\w+\\b");
+    QRegularExpressionMatchIterator matches = wordRegex.globalMatch(cleaned);
+    QStringList words;
+    while (matches.hasNext()) {
+        words.append(matches.next().captured(0));
+    }
+    counts.words = words.size();
+
+    QStringList sentences;
+    for (const QString& part :
+         text.split(QRegularExpression("[.!?]+"), Qt::SkipEmptyParts)) {
+        QString sentence = part.trimmed();
+        if (!sentence.isEmpty()) {
+            sentences.append(sentence);
+        }
+    }
+    counts.sentences = sentences.size();
+
+    QStringList paragraphs;
+    for (const QString& part : text.split(QRegularExpression("\\n\\s*\\n"),
+                                          Qt::SkipEmptyParts)) {
+        QString paragraph = part.trimmed();
+        if (!paragraph.isEmpty()) {
+            paragraphs.append(paragraph);
+        }
+    }
+    counts.paragraphs = paragraphs.size();
+
+    return counts;
+}
+
+TestTextArenaBenchmark::Counts TestTextArenaBenchmark::analyzeSpans(
+    const QString& text) {
+    Counts counts;
+
+    TextArena arena;
+    auto spans = arena.makeVector<QStringView>();
+    TextSpans::words(text, spans);
+    counts.words = static_cast<int>(spans.size());
+    spans.clear();
+    TextSpans::sentences(text, spans);
+    counts.sentences = static_cast<int>(spans.size());
+    spans.clear();
+    TextSpans::paragraphs(text, spans);
+    counts.paragraphs = static_cast<int>(spans.size());
+
+    return counts;
+}
+
+void TestTextArenaBenchmark::testParity() {
+    const QStringList samples = {
+        QString(),
+        "Hello, world! How are you?",
+        "  One.  Two... Three?!  ",
+        "First paragraph.\n\nSecond\n \t\nparagraph.\n\n\n",
+        "snake_case words and 42 numbers\nsplit\nacross lines",
+        QString::fromUtf8("Caf\xc3\xa9 na\xc3\xafve r\xc3\xa9sum\xc3\xa9."),
+        makePage(1)};
+
+    for (const QString& sample : samples) {
+        const Counts legacy = analyzeLegacy(sample);
+        const Counts spans = analyzeSpans(sample);
+        QCOMPARE(spans.words, legacy.words);
+        QCOMPARE(spans.sentences, legacy.sentences);
+        QCOMPARE(spans.paragraphs, legacy.paragraphs);
+    }
+}
+
+void TestTextArenaBenchmark::testPageAnalysis_data() {
+    QTest::addColumn<int>("pages");
+
+    QTest::newRow("10 pages") << 10;
+    QTest::newRow("100 pages") << 100;
+}
+
+void TestTextArenaBenchmark::testPageAnalysis() {
+    QFETCH(int, pages);
+
+    QStringList texts;
+    for (int i = 0; i < pages; ++i) {
+        texts.append(makePage(i));
+    }
+
+    Result result{pages, 0, 0, 0.0, 0.0};
+    QList<Counts> legacyCounts;
+    QList<Counts> spanCounts;
+    legacyCounts.reserve(pages);
+    spanCounts.reserve(pages);
+
+    QElapsedTimer timer;
+    g_allocations = 0;
+    timer.start();
+    g_counting = true;
+    for (const QString& text : texts) {
+        legacyCounts.append(analyzeLegacy(text));
+    }
+    g_counting = false;
+    result.beforeMs = timer.nsecsElapsed() / 1e6;
+    result.beforeAllocations = g_allocations;
+
+    g_allocations = 0;
+    timer.restart();
+    g_counting = true;
+    for (const QString& text : texts) {
+        spanCounts.append(analyzeSpans(text));
+    }
+    g_counting = false;
+    result.afterMs = timer.nsecsElapsed() / 1e6;
+    result.afterAllocations = g_allocations;
+
+    m_results.append(result);
+
+    QVERIFY(spanCounts == legacyCounts);
+    if (ALLOCATIONS_COUNTED) {
+        // Each page fits the arena's inline buffer, so the span pipeline
+        // should allocate at most a few blocks per page
+        QVERIFY(result.afterAllocations <= pages * 2);
+        QVERIFY(result.afterAllocations < result.beforeAllocations);
+    }
+}
+
+QTEST_MAIN(TestTextArenaBenchmark)
+#include "test_text_arena_benchmark.moc"
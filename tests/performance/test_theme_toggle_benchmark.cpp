@@ -0,0 +1,148 @@
+#include <poppler-qt6.h>
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMainWindow>
+#include <QPageSize>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+#include <memory>
+#include "../../app/managers/StyleManager.h"
+#include "../../app/ui/viewer/PDFViewer.h"
+
+/**
+ * Measures how long a theme toggle takes as the number of page widgets in
+ * the continuous view grows.
+ *
+ * The widget tree is the real one: a main window carrying the application
+ * stylesheet, applied once as MainWindow does at startup, around a styled
+ * PDFViewer showing a generated document in continuous mode. Each toggle
+ * goes through StyleManager::toggleTheme, so the timing covers the palette
+ * swap, the re-polish of the stylesheet-styled widgets (page widgets opt
+ * out), every themeChanged handler (PDFViewer::updateThemeUI) and the
+ * resulting repaint.
+ */
+class TestThemeToggleBenchmark : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void testToggleTime_data();
+    void testToggleTime();
+
+private:
+    struct Result {
+        int pageCount;
+        double toggleMs;
+    };
+
+    std::shared_ptr<Poppler::Document> createDocument(int pageCount);
+
+    QTemporaryDir m_tempDir;
+    QString m_styleSheet;
+    QList<Result> m_results;
+
+    static constexpr int TOGGLES_PER_MEASUREMENT = 4;  // even: ends on start
+};
+
+void TestThemeToggleBenchmark::initTestCase() {
+    QVERIFY(m_tempDir.isValid());
+    STYLE.setTheme(Theme::Light);
+
+    // The same stylesheet MainWindow loads; fall back to the generated one
+    // when the assets are not next to the test sources
+    QFile file(QFINDTESTDATA("../../assets/styles/app.qss"));
+    if (file.open(QFile::ReadOnly)) {
+        m_styleSheet = QString::fromUtf8(file.readAll());
+    }
+    if (m_styleSheet.isEmpty()) {
+        m_styleSheet = STYLE.getApplicationStyleSheet();
+    }
+}
+
+void TestThemeToggleBenchmark::cleanupTestCase() {
+    STYLE.setTheme(Theme::Light);
+
+    qDebug() << "=== Theme toggle time vs page count ===";
+    qDebug() << "pages | toggle (ms)";
+    for (const Result& result : m_results) {
+        qDebug().noquote() << QString("%1 | %2")
+                                  .arg(result.pageCount, 5)
+                                  .arg(result.toggleMs, 11, 'f', 2);
+    }
+}
+
+void TestThemeToggleBenchmark::testToggleTime_data() {
+    QTest::addColumn<int>("pageCount");
+
+    QTest::newRow("10 pages") << 10;
+    QTest::newRow("100 pages") << 100;
+    QTest::newRow("500 pages") << 500;
+    QTest::newRow("1000 pages") << 1000;
+}
+
+void TestThemeToggleBenchmark::testToggleTime() {
+    QFETCH(int, pageCount);
+
+    std::shared_ptr<Poppler::Document> document = createDocument(pageCount);
+    QVERIFY(document);
+    QCOMPARE(document->numPages(), pageCount);
+
+    QMainWindow window;
+    window.resize(1024, 768);
+    PDFViewer* viewer = new PDFViewer(&window);
+    window.setCentralWidget(viewer);
+    STYLE.forceApplyTheme(&window, m_styleSheet);
+
+    viewer->setDocument(document);
+    viewer->setViewMode(PDFViewMode::ContinuousScroll);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+    QCoreApplication::processEvents();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < TOGGLES_PER_MEASUREMENT; ++i) {
+        STYLE.toggleTheme();
+        QCoreApplication::processEvents();
+    }
+
+    const double toggleMs = static_cast<double>(timer.nsecsElapsed()) / 1e6 /
+                            TOGGLES_PER_MEASUREMENT;
+
+    qDebug() << pageCount << "pages - toggle:" << toggleMs << "ms";
+    m_results.append({pageCount, toggleMs});
+
+    // A toggle must not touch any stylesheet
+    QCOMPARE(window.styleSheet(), m_styleSheet);
+    QCOMPARE(STYLE.currentTheme(), Theme::Light);
+}
+
+std::shared_ptr<Poppler::Document> TestThemeToggleBenchmark::createDocument(
+    int pageCount) {
+    const QString path =
+        m_tempDir.filePath(QString("toggle_%1.pdf").arg(pageCount));
+
+    {
+        QPdfWriter writer(path);
+        writer.setPageSize(QPageSize(QPageSize::A4));
+        QPainter painter(&writer);
+        for (int i = 0; i < pageCount; ++i) {
+            if (i > 0) {
+                writer.newPage();
+            }
+            painter.drawText(100, 100, QString("Page %1").arg(i + 1));
+        }
+    }
+
+    return std::shared_ptr<Poppler::Document>(
+        Poppler::Document::load(path).release());
+}
+
+QTEST_MAIN(TestThemeToggleBenchmark)
+#include "test_theme_toggle_benchmark.moc"
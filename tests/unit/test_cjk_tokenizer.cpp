@@ -0,0 +1,172 @@
+#include <QBitArray>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QtTest/QtTest>
+#include <utility>
+#include "../../app/model/SearchModel.h"
+#include "../../app/utils/CjkTokenizer.h"
+
+/**
+ * CjkTokenizer on mixed Chinese, ASCII and Hangul text, and the whole-word
+ * search it drives in SearchModel.
+ *
+ * Segmentation uses the built-in dictionary only: test mode moves
+ * userDictionaryPath() away from the user's own dictionary.
+ */
+class TestCjkTokenizer : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testWords_data();
+    void testWords();
+    void testIndexTerms_data();
+    void testIndexTerms();
+    void testWordBoundaries();
+
+    void testWholeWordSearch_data();
+    void testWholeWordSearch();
+
+private:
+    static QStringList words(const QString& text);
+    static QStringList indexTerms(const QString& text);
+};
+
+QStringList TestCjkTokenizer::words(const QString& text) {
+    TextArena arena;
+    auto spans = arena.makeVector<QStringView>();
+    CjkTokenizer::words(text, spans);
+    QStringList result;
+    for (QStringView span : spans) {
+        result.append(span.toString());
+    }
+    return result;
+}
+
+QStringList TestCjkTokenizer::indexTerms(const QString& text) {
+    TextArena arena;
+    auto spans = arena.makeVector<QStringView>();
+    CjkTokenizer::indexTerms(text, spans);
+    QStringList result;
+    for (QStringView span : spans) {
+        result.append(span.toString());
+    }
+    return result;
+}
+
+void TestCjkTokenizer::initTestCase() {
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(!CjkTokenizer::dictionary().isEmpty());
+}
+
+void TestCjkTokenizer::testWords_data() {
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("chinese")
+        << QString::fromUtf8("我们使用计算机")
+        << QString::fromUtf8("我们 使用 计算机").split(u' ');
+    QTest::newRow("longest dictionary word wins")
+        << QString::fromUtf8("阅读器缩略图")
+        << QString::fromUtf8("阅读器 缩略图").split(u' ');
+    QTest::newRow("characters outside the dictionary")
+        << QString::fromUtf8("龘和计算")
+        << QString::fromUtf8("龘 和 计算").split(u' ');
+    QTest::newRow("mixed chinese and ascii")
+        << QString::fromUtf8("用PDF阅读器打开report_v2.pdf")
+        << QString::fromUtf8("用 PDF 阅读器 打开 report_v2 pdf").split(u' ');
+    QTest::newRow("hangul words are space separated")
+        << QString::fromUtf8("한국어 텍스트와 中文")
+        << QString::fromUtf8("한국어 텍스트와 中文").split(u' ');
+    QTest::newRow("hangul next to han")
+        << QString::fromUtf8("한국中国")
+        << QString::fromUtf8("한국 中国").split(u' ');
+    QTest::newRow("punctuation only")
+        << QString::fromUtf8("，。 - ！") << QStringList();
+}
+
+void TestCjkTokenizer::testWords() {
+    QFETCH(QString, text);
+    QFETCH(QStringList, expected);
+
+    QCOMPARE(words(text), expected);
+}
+
+void TestCjkTokenizer::testIndexTerms_data() {
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("bigrams of a run")
+        << QString::fromUtf8("阅读器")
+        << QString::fromUtf8("阅读 读器").split(u' ');
+    QTest::newRow("lone character")
+        << QString::fromUtf8("龘 a") << QString::fromUtf8("龘 a").split(u' ');
+    QTest::newRow("mixed chinese, ascii and hangul")
+        << QString::fromUtf8("中文PDF 한국어")
+        << QString::fromUtf8("中文 PDF 한국 국어").split(u' ');
+}
+
+void TestCjkTokenizer::testIndexTerms() {
+    QFETCH(QString, text);
+    QFETCH(QStringList, expected);
+
+    QCOMPARE(indexTerms(text), expected);
+}
+
+void TestCjkTokenizer::testWordBoundaries() {
+    // 我们|使用|计算机| |PDF| |한국어
+    const QString text = QString::fromUtf8("我们使用计算机 PDF 한국어");
+    const QBitArray boundaries = CjkTokenizer::wordBoundaries(text);
+    QCOMPARE(boundaries.size(), text.size() + 1);
+
+    QList<int> set;
+    for (int i = 0; i < boundaries.size(); ++i) {
+        if (boundaries.testBit(i)) {
+            set.append(i);
+        }
+    }
+    QCOMPARE(set, (QList<int>{0, 2, 4, 7, 8, 11, 12, 15}));
+}
+
+void TestCjkTokenizer::testWholeWordSearch_data() {
+    QTest::addColumn<QString>("query");
+    QTest::addColumn<bool>("wholeWords");
+    QTest::addColumn<QList<int>>("starts");
+
+    // 计算机|和|计算|阅读|文档| |viewer
+    QTest::newRow("cjk word")
+        << QString::fromUtf8("计算机") << true << QList<int>{0};
+    QTest::newRow("cjk word inside a longer word")
+        << QString::fromUtf8("计算") << true << QList<int>{4};
+    QTest::newRow("cjk query across two words")
+        << QString::fromUtf8("阅读文档") << true << QList<int>{6};
+    QTest::newRow("cjk query ending inside a word")
+        << QString::fromUtf8("阅读文") << true << QList<int>();
+    QTest::newRow("cjk substring without whole words")
+        << QString::fromUtf8("计算") << false << QList<int>{0, 4};
+    QTest::newRow("ascii word") << QString("viewer") << true << QList<int>{11};
+    QTest::newRow("ascii word inside a longer word")
+        << QString("view") << true << QList<int>();
+}
+
+void TestCjkTokenizer::testWholeWordSearch() {
+    QFETCH(QString, query);
+    QFETCH(bool, wholeWords);
+    QFETCH(QList<int>, starts);
+
+    const QString text = QString::fromUtf8("计算机和计算阅读文档 viewer");
+    SearchOptions options;
+    options.wholeWords = wholeWords;
+
+    QList<int> found;
+    for (const auto& [start, length] :
+         SearchModel::findMatches(text, query, options)) {
+        QCOMPARE(length, static_cast<int>(query.size()));
+        found.append(start);
+    }
+    QCOMPARE(found, starts);
+}
+
+QTEST_MAIN(TestCjkTokenizer)
+#include "test_cjk_tokenizer.moc"
@@ -0,0 +1,196 @@
+#include <QByteArray>
+#include <QDataStream>
+#include <QIODevice>
+#include <QJsonObject>
+#include <QtTest/QtTest>
+#include <algorithm>
+#include "../../app/utils/DocumentClassifier.h"
+
+/**
+ * DocumentClassifier training, batch prediction and the serialized model
+ * format, on synthetic feature vectors drawn around per-class centres.
+ */
+class TestDocumentClassifier : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void testTrainSeparatesClasses();
+    void testTrainWithoutLabelledRows();
+    void testPredictBatchMatchesPredict_data();
+    void testPredictBatchMatchesPredict();
+    void testUntrainedModel();
+
+    void testSerializeRoundTrip();
+    void testJsonRoundTrip();
+    void testRejectsIncompatibleModel_data();
+    void testRejectsIncompatibleModel();
+    void testRejectsTruncatedModel();
+
+private:
+    static constexpr int CLASS_COUNT = 3;
+
+    // Deterministic samples; label i % CLASS_COUNT for row i
+    static DocumentClassifier::FeatureMatrix makeSamples(qsizetype rows,
+                                                         int seed);
+    static DocumentClassifier::FeatureVector makeSample(int label,
+                                                        quint32& state);
+    static QList<int> makeLabels(qsizetype rows);
+
+    DocumentClassifier m_classifier;
+};
+
+DocumentClassifier::FeatureVector TestDocumentClassifier::makeSample(
+    int label, quint32& state) {
+    DocumentClassifier::FeatureVector features{};
+    for (int j = 0; j < DocumentClassifier::FeatureCount; ++j) {
+        state = state * 1664525u + 1013904223u;
+        const float noise = static_cast<float>(state >> 8) / (1u << 24);
+        // Class centres 2 apart with noise in [0, 1)
+        features[j] = 1.0f + 2.0f * ((label + j) % CLASS_COUNT) + noise;
+    }
+    return features;
+}
+
+DocumentClassifier::FeatureMatrix TestDocumentClassifier::makeSamples(
+    qsizetype rows, int seed) {
+    DocumentClassifier::FeatureMatrix samples;
+    samples.reserve(rows);
+    quint32 state = static_cast<quint32>(seed) * 2654435761u + 1u;
+    for (qsizetype r = 0; r < rows; ++r) {
+        samples.append(makeSample(static_cast<int>(r % CLASS_COUNT), state));
+    }
+    return samples;
+}
+
+QList<int> TestDocumentClassifier::makeLabels(qsizetype rows) {
+    QList<int> labels;
+    for (qsizetype r = 0; r < rows; ++r) {
+        labels.append(static_cast<int>(r % CLASS_COUNT));
+    }
+    return labels;
+}
+
+void TestDocumentClassifier::initTestCase() {
+    QVERIFY(m_classifier.train(makeSamples(300, 1), makeLabels(300),
+                               {"report", "slides", "scan"}));
+    QVERIFY(m_classifier.isValid());
+}
+
+void TestDocumentClassifier::testTrainSeparatesClasses() {
+    QCOMPARE(m_classifier.classNames(),
+             (QStringList{"report", "slides", "scan"}));
+
+    const qsizetype rows = 200;
+    const QList<int> predictions =
+        m_classifier.predictBatch(makeSamples(rows, 2));
+    QCOMPARE(predictions, makeLabels(rows));
+}
+
+void TestDocumentClassifier::testTrainWithoutLabelledRows() {
+    DocumentClassifier classifier;
+    QVERIFY(!classifier.train(makeSamples(10, 3), QList<int>(10, -1),
+                              {"report"}));
+    QVERIFY(!classifier.isValid());
+
+    // Classes without samples are dropped
+    QVERIFY(classifier.train(makeSamples(10, 3), QList<int>(10, 1),
+                             {"report", "slides"}));
+    QCOMPARE(classifier.classNames(), QStringList{"slides"});
+}
+
+void TestDocumentClassifier::testPredictBatchMatchesPredict_data() {
+    QTest::addColumn<int>("rows");
+
+    QTest::newRow("empty") << 0;
+    QTest::newRow("one row") << 1;
+    QTest::newRow("partial block") << 63;
+    QTest::newRow("one block and a row") << 65;
+    QTest::newRow("several blocks and a tail") << 3 * 64 + 37;
+}
+
+void TestDocumentClassifier::testPredictBatchMatchesPredict() {
+    QFETCH(int, rows);
+
+    const DocumentClassifier::FeatureMatrix samples = makeSamples(rows, 4);
+    const QList<int> batch = m_classifier.predictBatch(samples);
+    QCOMPARE(batch.size(), qsizetype(rows));
+
+    for (qsizetype r = 0; r < rows; ++r) {
+        DocumentClassifier::FeatureVector features;
+        std::copy_n(samples.row(r), features.size(), features.begin());
+        QCOMPARE(batch[r], m_classifier.predict(features));
+    }
+}
+
+void TestDocumentClassifier::testUntrainedModel() {
+    const DocumentClassifier classifier;
+    QCOMPARE(classifier.predict(DocumentClassifier::FeatureVector{}), -1);
+    QCOMPARE(classifier.predictBatch(makeSamples(70, 5)), QList<int>(70, -1));
+}
+
+void TestDocumentClassifier::testSerializeRoundTrip() {
+    const QByteArray data = m_classifier.serialize();
+
+    DocumentClassifier restored;
+    QVERIFY(restored.deserialize(data));
+    QCOMPARE(restored.classNames(), m_classifier.classNames());
+    QCOMPARE(restored.serialize(), data);
+
+    const DocumentClassifier::FeatureMatrix samples = makeSamples(150, 6);
+    QCOMPARE(restored.predictBatch(samples),
+             m_classifier.predictBatch(samples));
+}
+
+void TestDocumentClassifier::testJsonRoundTrip() {
+    const QJsonObject json = m_classifier.toJson();
+    QCOMPARE(json.value("type").toString(), QString("gaussianNaiveBayes"));
+
+    DocumentClassifier restored;
+    QVERIFY(restored.fromJson(json));
+    QCOMPARE(restored.serialize(), m_classifier.serialize());
+}
+
+void TestDocumentClassifier::testRejectsIncompatibleModel_data() {
+    // Header fields in stream order: magic, version, feature count
+    QTest::addColumn<int>("offset");
+    QTest::addColumn<quint32>("value");
+
+    QTest::newRow("wrong magic") << 0 << 0x50444653u;
+    QTest::newRow("newer version") << 4 << 2u;
+    QTest::newRow("fewer features")
+        << 8 << quint32(DocumentClassifier::FeatureCount - 1);
+    QTest::newRow("more features")
+        << 8 << quint32(DocumentClassifier::FeatureCount + 1);
+}
+
+void TestDocumentClassifier::testRejectsIncompatibleModel() {
+    QFETCH(int, offset);
+    QFETCH(quint32, value);
+
+    QByteArray data = m_classifier.serialize();
+    QByteArray field;
+    QDataStream out(&field, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << value;
+    data.replace(offset, field.size(), field);
+
+    // A rejected model leaves the current one in place
+    DocumentClassifier classifier = m_classifier;
+    QVERIFY(!classifier.deserialize(data));
+    QCOMPARE(classifier.serialize(), m_classifier.serialize());
+}
+
+void TestDocumentClassifier::testRejectsTruncatedModel() {
+    const QByteArray data = m_classifier.serialize();
+
+    DocumentClassifier classifier;
+    QVERIFY(!classifier.deserialize(data.left(data.size() - 1)));
+    QVERIFY(!classifier.deserialize(data.left(6)));
+    QVERIFY(!classifier.deserialize(QByteArray()));
+    QVERIFY(!classifier.isValid());
+}
+
+QTEST_MAIN(TestDocumentClassifier)
+#include "test_document_classifier.moc"
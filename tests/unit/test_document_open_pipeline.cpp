@@ -0,0 +1,230 @@
+#include <QPointer>
+#include <QStringList>
+#include <QtTest/QtTest>
+#include <memory>
+#include "../../app/ui/core/DocumentOpenPipeline.h"
+
+/**
+ * Phase sequencing of DocumentOpenPipeline: steps run phase by phase in
+ * time slices, steps added late join the current phase, and the pipeline
+ * can be cancelled or destroyed from inside its own callbacks.
+ */
+class TestDocumentOpenPipeline : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testPhaseOrder();
+    void testStepsShareAPhase();
+    void testStepForPassedPhaseJoinsCurrentPhase();
+    void testAddStepAfterFinish();
+    void testCancelFromInsideStep();
+    void testDeleteFromPhaseSignal();
+
+private:
+    // Records phase signals into log as "started:<phase>" and
+    // "finished:<phase>", and the finished() signal as "finished"
+    static void recordSignals(DocumentOpenPipeline* pipeline,
+                              QStringList* log);
+    static QString name(DocumentOpenPipeline::Phase phase);
+
+    static constexpr int SETTLE_MS = 50;
+};
+
+QString TestDocumentOpenPipeline::name(DocumentOpenPipeline::Phase phase) {
+    return DocumentOpenPipeline::phaseName(phase);
+}
+
+void TestDocumentOpenPipeline::recordSignals(DocumentOpenPipeline* pipeline,
+                                             QStringList* log) {
+    connect(pipeline, &DocumentOpenPipeline::phaseStarted, pipeline,
+            [log](DocumentOpenPipeline::Phase phase) {
+                log->append("started:" + name(phase));
+            });
+    connect(pipeline, &DocumentOpenPipeline::phaseFinished, pipeline,
+            [log](DocumentOpenPipeline::Phase phase, qint64) {
+                log->append("finished:" + name(phase));
+            });
+    connect(pipeline, &DocumentOpenPipeline::finished, pipeline,
+            [log]() { log->append("finished"); });
+}
+
+void TestDocumentOpenPipeline::testPhaseOrder() {
+    DocumentOpenPipeline pipeline;
+    QStringList log;
+    recordSignals(&pipeline, &log);
+
+    // Added out of order; each runs in its own phase
+    const DocumentOpenPipeline::Phase phases[] = {
+        DocumentOpenPipeline::BackgroundIndexing,
+        DocumentOpenPipeline::FirstPage,
+        DocumentOpenPipeline::VisibleThumbnails,
+        DocumentOpenPipeline::NavigationChrome};
+    for (DocumentOpenPipeline::Phase phase : phases) {
+        pipeline.addStep(phase, [&log, phase]() {
+            log.append("step:" + name(phase));
+            return false;
+        });
+    }
+
+    QTest::qWait(SETTLE_MS);
+    QVERIFY2(log.isEmpty(), "Nothing runs before start()");
+
+    pipeline.start();
+    QCOMPARE(pipeline.currentPhase(), DocumentOpenPipeline::FirstPage);
+    QTRY_VERIFY(log.contains("finished"));
+
+    QStringList expected;
+    for (int i = 0; i < DocumentOpenPipeline::PhaseCount; ++i) {
+        const auto phase = static_cast<DocumentOpenPipeline::Phase>(i);
+        expected << "started:" + name(phase) << "step:" + name(phase)
+                 << "finished:" + name(phase);
+    }
+    expected << "finished";
+    QCOMPARE(log, expected);
+
+    QCOMPARE(pipeline.currentPhase(), DocumentOpenPipeline::PhaseCount);
+    QVERIFY(pipeline.isPhaseDone(DocumentOpenPipeline::BackgroundIndexing));
+}
+
+void TestDocumentOpenPipeline::testStepsShareAPhase() {
+    DocumentOpenPipeline pipeline;
+    QStringList log;
+
+    // A step with work left is requeued behind the phase's other steps
+    auto remaining = std::make_shared<int>(3);
+    pipeline.addStep(DocumentOpenPipeline::NavigationChrome,
+                     [&log, remaining]() {
+                         log.append("long");
+                         return --*remaining > 0;
+                     });
+    pipeline.addStep(DocumentOpenPipeline::NavigationChrome, [&log]() {
+        log.append("short");
+        return false;
+    });
+    pipeline.addStep(DocumentOpenPipeline::VisibleThumbnails, [&log]() {
+        log.append("next phase");
+        return false;
+    });
+
+    QSignalSpy finished(&pipeline, &DocumentOpenPipeline::finished);
+    pipeline.start();
+    QTRY_COMPARE(finished.count(), 1);
+
+    QCOMPARE(log,
+             (QStringList{"long", "short", "long", "long", "next phase"}));
+}
+
+void TestDocumentOpenPipeline::testStepForPassedPhaseJoinsCurrentPhase() {
+    DocumentOpenPipeline pipeline;
+    QStringList log;
+    recordSignals(&pipeline, &log);
+
+    pipeline.addStep(DocumentOpenPipeline::VisibleThumbnails,
+                     [&log, &pipeline]() {
+                         log.append("thumbnails");
+                         pipeline.addStep(DocumentOpenPipeline::FirstPage,
+                                          [&log]() {
+                                              log.append("late");
+                                              return false;
+                                          });
+                         return false;
+                     });
+
+    pipeline.start();
+    QTRY_VERIFY(log.contains("finished"));
+
+    const QString thumbnailsDone =
+        "finished:" + name(DocumentOpenPipeline::VisibleThumbnails);
+    QVERIFY(log.indexOf("thumbnails") < log.indexOf("late"));
+    QVERIFY(log.indexOf("late") < log.indexOf(thumbnailsDone));
+}
+
+void TestDocumentOpenPipeline::testAddStepAfterFinish() {
+    DocumentOpenPipeline pipeline;
+    QStringList log;
+    recordSignals(&pipeline, &log);
+
+    pipeline.start();
+    QTRY_VERIFY(log.contains("finished"));
+    const QStringList signalsBefore = log;
+
+    // E.g. switching to continuous view after the document has opened
+    auto remaining = std::make_shared<int>(2);
+    pipeline.addStep(DocumentOpenPipeline::NavigationChrome,
+                     [&log, remaining]() {
+                         log.append("late step");
+                         return --*remaining > 0;
+                     });
+    QTRY_COMPARE(log.count("late step"), qsizetype(2));
+    QTest::qWait(SETTLE_MS);
+
+    // Runs in slices, without replaying any phase signal
+    QCOMPARE(log, signalsBefore + QStringList{"late step", "late step"});
+    QCOMPARE(pipeline.currentPhase(), DocumentOpenPipeline::PhaseCount);
+}
+
+void TestDocumentOpenPipeline::testCancelFromInsideStep() {
+    DocumentOpenPipeline pipeline;
+    QStringList log;
+    recordSignals(&pipeline, &log);
+
+    pipeline.addStep(DocumentOpenPipeline::NavigationChrome,
+                     [&log, &pipeline]() {
+                         log.append("cancelling");
+                         pipeline.cancel();
+                         return true;  // Must not be requeued
+                     });
+    pipeline.addStep(DocumentOpenPipeline::NavigationChrome, [&log]() {
+        log.append("same phase");
+        return false;
+    });
+    pipeline.addStep(DocumentOpenPipeline::BackgroundIndexing, [&log]() {
+        log.append("later phase");
+        return false;
+    });
+
+    pipeline.start();
+    QTRY_VERIFY(log.contains("cancelling"));
+    QTest::qWait(SETTLE_MS);
+
+    const QString navigation = name(DocumentOpenPipeline::NavigationChrome);
+    QCOMPARE(log.count("cancelling"), qsizetype(1));
+    QVERIFY(!log.contains("same phase"));
+    QVERIFY(!log.contains("later phase"));
+    QVERIFY(!log.contains("finished:" + navigation));
+    QVERIFY(!log.contains("finished"));
+
+    // A cancelled pipeline does not pick up new steps
+    pipeline.addStep(DocumentOpenPipeline::BackgroundIndexing, [&log]() {
+        log.append("after cancel");
+        return false;
+    });
+    QTest::qWait(SETTLE_MS);
+    QVERIFY(!log.contains("after cancel"));
+}
+
+void TestDocumentOpenPipeline::testDeleteFromPhaseSignal() {
+    // Closing the document from a phase handler destroys the pipeline
+    QPointer<DocumentOpenPipeline> pipeline = new DocumentOpenPipeline();
+    bool laterStepRan = false;
+
+    connect(pipeline, &DocumentOpenPipeline::phaseFinished, this,
+            [pipeline](DocumentOpenPipeline::Phase phase, qint64) {
+                if (phase == DocumentOpenPipeline::FirstPage) {
+                    delete pipeline.data();
+                }
+            });
+    pipeline->addStep(DocumentOpenPipeline::NavigationChrome,
+                      [&laterStepRan]() {
+                          laterStepRan = true;
+                          return false;
+                      });
+
+    pipeline->start();
+    QTRY_VERIFY(pipeline.isNull());
+    QTest::qWait(SETTLE_MS);
+    QVERIFY(!laterStepRan);
+}
+
+QTEST_MAIN(TestDocumentOpenPipeline)
+#include "test_document_open_pipeline.moc"
@@ -0,0 +1,145 @@
+#include <QSet>
+#include <QStringList>
+#include <QtTest/QtTest>
+#include "../../app/utils/DoubleArrayTrie.h"
+
+/**
+ * Lookups in DoubleArrayTrie: exact membership and longest-prefix
+ * matching, with keys nested in one another and characters the key set
+ * never uses.
+ */
+class TestDoubleArrayTrie : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testEmptyTrie();
+    void testKeyCount();
+    void testContains_data();
+    void testContains();
+    void testLongestPrefix_data();
+    void testLongestPrefix();
+    void testManyKeys();
+
+private:
+    static DoubleArrayTrie nestedKeys();
+};
+
+DoubleArrayTrie TestDoubleArrayTrie::nestedKeys() {
+    // "计算" is a prefix of "计算机", "ab" of "abc"
+    return DoubleArrayTrie(
+        {QString::fromUtf8("计算机"), QString::fromUtf8("计算"),
+         QString::fromUtf8("机器"), "abc", "ab"});
+}
+
+void TestDoubleArrayTrie::testEmptyTrie() {
+    const DoubleArrayTrie trie;
+    QVERIFY(trie.isEmpty());
+    QVERIFY(!trie.contains(u"a"));
+    QVERIFY(!trie.contains(QStringView()));
+    QCOMPARE(trie.longestPrefix(u"abc"), qsizetype(0));
+
+    const DoubleArrayTrie onlyEmptyKeys(QStringList{QString(), ""});
+    QVERIFY(onlyEmptyKeys.isEmpty());
+    QVERIFY(!onlyEmptyKeys.contains(QStringView()));
+}
+
+void TestDoubleArrayTrie::testKeyCount() {
+    const DoubleArrayTrie trie({"ab", "ab", "", "abc", "b"});
+    QCOMPARE(trie.keyCount(), qsizetype(3));
+    QVERIFY(trie.memoryBytes() > 0);
+}
+
+void TestDoubleArrayTrie::testContains_data() {
+    QTest::addColumn<QString>("key");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("key") << QString::fromUtf8("计算机") << true;
+    QTest::newRow("key that prefixes another")
+        << QString::fromUtf8("计算") << true;
+    QTest::newRow("prefix of a key") << QString::fromUtf8("计") << false;
+    QTest::newRow("key plus a character")
+        << QString::fromUtf8("计算机器") << false;
+    QTest::newRow("ascii key") << QString("ab") << true;
+    QTest::newRow("ascii prefix") << QString("a") << false;
+    QTest::newRow("outside the alphabet") << QString("xyz") << false;
+    QTest::newRow("key then outside the alphabet")
+        << QString("abz") << false;
+    QTest::newRow("han outside the alphabet")
+        << QString::fromUtf8("科学") << false;
+    QTest::newRow("empty") << QString() << false;
+}
+
+void TestDoubleArrayTrie::testContains() {
+    QFETCH(QString, key);
+    QFETCH(bool, expected);
+
+    QCOMPARE(nestedKeys().contains(key), expected);
+}
+
+void TestDoubleArrayTrie::testLongestPrefix_data() {
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("expected");
+
+    QTest::newRow("longer of two nested keys")
+        << QString::fromUtf8("计算机科学") << 3;
+    QTest::newRow("shorter of two nested keys")
+        << QString::fromUtf8("计算方法") << 2;
+    QTest::newRow("whole text is a key") << QString::fromUtf8("计算") << 2;
+    QTest::newRow("prefix of a key only") << QString::fromUtf8("计") << 0;
+    QTest::newRow("no key starts here") << QString::fromUtf8("算机") << 0;
+    QTest::newRow("outside the alphabet")
+        << QString::fromUtf8("科学计算") << 0;
+    QTest::newRow("ascii nested keys") << QString("abcd") << 3;
+    QTest::newRow("ascii then outside the alphabet")
+        << QString("abz") << 2;
+    QTest::newRow("empty") << QString() << 0;
+}
+
+void TestDoubleArrayTrie::testLongestPrefix() {
+    QFETCH(QString, text);
+    QFETCH(int, expected);
+
+    QCOMPARE(nestedKeys().longestPrefix(text), qsizetype(expected));
+}
+
+void TestDoubleArrayTrie::testManyKeys() {
+    // Keys spread over the CJK block, so the dense alphabet and base
+    // placement are exercised well beyond a handful of nodes
+    QStringList keys;
+    QSet<QString> keySet;
+    quint32 state = 7;
+    while (keys.size() < 3000) {
+        QString key;
+        const int length = 1 + static_cast<int>(state % 4);
+        for (int i = 0; i < length; ++i) {
+            state = state * 1664525u + 1013904223u;
+            const int offset = static_cast<int>((state >> 8) % 2000);
+            key.append(QChar(0x4E00 + offset));
+        }
+        if (!keySet.contains(key)) {
+            keySet.insert(key);
+            keys.append(key);
+        }
+    }
+
+    const DoubleArrayTrie trie(keys);
+    QCOMPARE(trie.keyCount(), keys.size());
+    for (const QString& key : keys) {
+        QVERIFY2(trie.contains(key), qPrintable(key));
+        QVERIFY(trie.longestPrefix(key + QChar(0x3002)) >= key.size());
+    }
+
+    // Strings that are not keys
+    int checked = 0;
+    for (const QString& key : keys) {
+        const QString longer = key + key;
+        if (!keySet.contains(longer)) {
+            QVERIFY(!trie.contains(longer));
+            ++checked;
+        }
+    }
+    QVERIFY(checked > 0);
+}
+
+QTEST_MAIN(TestDoubleArrayTrie)
+#include "test_double_array_trie.moc"
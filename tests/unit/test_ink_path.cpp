@@ -0,0 +1,194 @@
+#include <QByteArray>
+#include <QList>
+#include <QPointF>
+#include <QtTest/QtTest>
+#include "../../app/model/AnnotationModel.h"
+
+/**
+ * Ink stroke capture and persistence on PDFAnnotation: simplification of
+ * captured points, the cached painter path and the compact varint
+ * encoding, including malformed input.
+ */
+class TestInkPath : public QObject {
+    Q_OBJECT
+
+private slots:
+    void testRoundTrip_data();
+    void testRoundTrip();
+    void testSmallDeltasTakeOneByte();
+    void testTruncatedBuffer();
+    void testOversizedCount();
+    void testUnknownVersion();
+
+    void testSimplifyDropsCollinearPoints();
+    void testSimplifyKeepsStrokeThatDoublesBack();
+    void testToleranceFollowsZoom();
+
+    void testPainterPathFollowsInkPath();
+
+private:
+    // Coordinates as stored: fixed point at INK_COORDINATE_SCALE
+    static QList<QPointF> quantized(const QList<QPointF>& points);
+};
+
+QList<QPointF> TestInkPath::quantized(const QList<QPointF>& points) {
+    QList<QPointF> result;
+    for (const QPointF& point : points) {
+        const double scale = PDFAnnotation::INK_COORDINATE_SCALE;
+        result.append(QPointF(qRound64(point.x() * scale) / scale,
+                              qRound64(point.y() * scale) / scale));
+    }
+    return result;
+}
+
+void TestInkPath::testRoundTrip_data() {
+    QTest::addColumn<QList<QPointF>>("points");
+
+    QTest::newRow("empty") << QList<QPointF>();
+    QTest::newRow("single point") << QList<QPointF>{{12.5, 40.25}};
+    QTest::newRow("stroke") << QList<QPointF>{
+        {10.0, 10.0}, {10.5, 11.25}, {11.75, 12.0}, {13.0, 12.5}};
+    QTest::newRow("negative deltas") << QList<QPointF>{
+        {300.0, 500.0}, {250.5, 480.25}, {100.0, 20.0}, {-15.75, -3.5}};
+    QTest::newRow("large coordinates") << QList<QPointF>{
+        {1.0e9, -1.0e9}, {-1.0e9, 1.0e9}, {12345678.91, 0.0}};
+    QTest::newRow("sub-resolution fractions") << QList<QPointF>{
+        {0.001, 0.004}, {0.126, 0.994}, {-0.005, -0.0049}};
+}
+
+void TestInkPath::testRoundTrip() {
+    QFETCH(QList<QPointF>, points);
+
+    const QByteArray encoded = PDFAnnotation::encodeInkPath(points);
+    QCOMPARE(static_cast<quint8>(encoded[0]),
+             PDFAnnotation::INK_ENCODING_VERSION);
+    QCOMPARE(PDFAnnotation::decodeInkPath(encoded), quantized(points));
+}
+
+void TestInkPath::testSmallDeltasTakeOneByte() {
+    QList<QPointF> points;
+    for (int i = 0; i < 100; ++i) {
+        points.append(QPointF(50.0 + i * 0.1, 50.0 - i * 0.2));
+    }
+    points[0] = QPointF(0.0, 0.0);
+
+    // Version, a one-byte count, then one byte per coordinate delta
+    const QByteArray encoded = PDFAnnotation::encodeInkPath(points);
+    QCOMPARE(PDFAnnotation::decodeInkPath(encoded), quantized(points));
+    QCOMPARE(encoded.size(), 2 + 2 * points.size());
+}
+
+void TestInkPath::testTruncatedBuffer() {
+    const QList<QPointF> points = {
+        {0.0, 0.0}, {1000.0, -1000.0}, {2500.5, 30.25}, {-10.0, 7.0}};
+    const QByteArray encoded = PDFAnnotation::encodeInkPath(points);
+
+    // Cut after the count, inside a varint and before the last coordinate
+    for (qsizetype size = 2; size < encoded.size(); ++size) {
+        QVERIFY2(PDFAnnotation::decodeInkPath(encoded.left(size)).isEmpty(),
+                 qPrintable(QString("truncated to %1 bytes").arg(size)));
+    }
+    QVERIFY(PDFAnnotation::decodeInkPath(encoded.left(1)).isEmpty());
+    QCOMPARE(PDFAnnotation::decodeInkPath(encoded).size(), points.size());
+}
+
+void TestInkPath::testOversizedCount() {
+    // Claims a million points with data for two
+    QByteArray data;
+    data.append(static_cast<char>(PDFAnnotation::INK_ENCODING_VERSION));
+    data.append(static_cast<char>(0xC0));
+    data.append(static_cast<char>(0x84));
+    data.append(static_cast<char>(0x3D));
+    data.append(QByteArray(4, '\x02'));
+    QVERIFY(PDFAnnotation::decodeInkPath(data).isEmpty());
+
+    // A count varint that never terminates
+    QByteArray endless(1, static_cast<char>(
+                              PDFAnnotation::INK_ENCODING_VERSION));
+    endless.append(QByteArray(12, '\xFF'));
+    QVERIFY(PDFAnnotation::decodeInkPath(endless).isEmpty());
+}
+
+void TestInkPath::testUnknownVersion() {
+    QByteArray encoded =
+        PDFAnnotation::encodeInkPath({{1.0, 2.0}, {3.0, 4.0}});
+    encoded[0] = static_cast<char>(PDFAnnotation::INK_ENCODING_VERSION + 1);
+    QVERIFY(PDFAnnotation::decodeInkPath(encoded).isEmpty());
+    QVERIFY(PDFAnnotation::decodeInkPath(QByteArray()).isEmpty());
+}
+
+void TestInkPath::testSimplifyDropsCollinearPoints() {
+    QList<QPointF> line;
+    for (int i = 0; i <= 50; ++i) {
+        line.append(QPointF(i, 2.0 * i));
+    }
+
+    const QList<QPointF> simplified =
+        PDFAnnotation::simplifyInkPath(line, 0.5);
+    QCOMPARE(simplified, (QList<QPointF>{line.first(), line.last()}));
+
+    // A corner survives
+    line.append(QPointF(80.0, 0.0));
+    QCOMPARE(PDFAnnotation::simplifyInkPath(line, 0.5),
+             (QList<QPointF>{{0.0, 0.0}, {50.0, 100.0}, {80.0, 0.0}}));
+}
+
+void TestInkPath::testSimplifyKeepsStrokeThatDoublesBack() {
+    // Every point lies on the line through the endpoints, but the stroke
+    // runs out to x = 10 and comes back; measuring against the infinite
+    // line would reduce it to its endpoints
+    const QList<QPointF> stroke = {
+        {0.0, 0.0}, {5.0, 0.0}, {10.0, 0.0}, {6.0, 0.0}, {2.0, 0.0}};
+
+    const QList<QPointF> simplified =
+        PDFAnnotation::simplifyInkPath(stroke, 0.5);
+    QVERIFY(simplified.contains(QPointF(10.0, 0.0)));
+    QCOMPARE(simplified.first(), stroke.first());
+    QCOMPARE(simplified.last(), stroke.last());
+
+    // A stroke returning to its start has a zero-length chord
+    const QList<QPointF> loop = {
+        {0.0, 0.0}, {4.0, 0.0}, {4.0, 4.0}, {0.0, 0.0}};
+    QVERIFY(PDFAnnotation::simplifyInkPath(loop, 0.5).contains(
+        QPointF(4.0, 4.0)));
+}
+
+void TestInkPath::testToleranceFollowsZoom() {
+    // A wobble of 0.3 page units is 0.3 pixels at 100% and 1.2 at 400%
+    const QList<QPointF> stroke = {{0.0, 0.0}, {5.0, 0.3}, {10.0, 0.0}};
+
+    PDFAnnotation atFullSize;
+    atFullSize.type = AnnotationType::Ink;
+    atFullSize.setInkPath(stroke, 1.0);
+    QCOMPARE(atFullSize.inkPath.size(), qsizetype(2));
+
+    PDFAnnotation zoomedIn;
+    zoomedIn.type = AnnotationType::Ink;
+    zoomedIn.setInkPath(stroke, 4.0);
+    QCOMPARE(zoomedIn.inkPath, stroke);
+    QCOMPARE(zoomedIn.boundingRect, QRectF(0.0, 0.0, 10.0, 0.3));
+}
+
+void TestInkPath::testPainterPathFollowsInkPath() {
+    PDFAnnotation annotation;
+    annotation.type = AnnotationType::Ink;
+    annotation.inkPath = {{0.0, 0.0}, {10.0, 5.0}, {20.0, 0.0}};
+
+    const QPainterPath& path = annotation.inkPainterPath();
+    QCOMPARE(path.elementCount(), 3);
+    QCOMPARE(path.currentPosition(), QPointF(20.0, 0.0));
+
+    // Copies share the cached path until one of them changes its stroke
+    PDFAnnotation copy = annotation;
+    QCOMPARE(&copy.inkPainterPath(), &annotation.inkPainterPath());
+
+    copy.inkPath.append(QPointF(30.0, 10.0));
+    QCOMPARE(copy.inkPainterPath().elementCount(), 4);
+    QCOMPARE(annotation.inkPainterPath().elementCount(), 3);
+
+    copy.inkPath.clear();
+    QVERIFY(copy.inkPainterPath().isEmpty());
+}
+
+QTEST_MAIN(TestInkPath)
+#include "test_ink_path.moc"
@@ -0,0 +1,183 @@
+#include <QByteArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+#include <memory>
+#include "../../app/utils/KeyedRecordStore.h"
+
+/**
+ * Crash recovery in KeyedRecordStore: changes that only reached the
+ * write-ahead log are replayed on open, on their own and on top of a
+ * snapshot, and a torn entry at the log's tail is cut off so later appends
+ * stay replayable.
+ */
+class TestKeyedRecordStore : public QObject {
+    Q_OBJECT
+
+private slots:
+    void init();
+
+    void testReplayWithoutSnapshot();
+    void testReplayOnTopOfSnapshot();
+    void testTornTailIsTruncated();
+    void testCorruptEntryDropsTheRest();
+
+private:
+    QString storePath() const { return m_tempDir->filePath("store.bin"); }
+    static QByteArray readFile(const QString& path);
+    static bool appendFile(const QString& path, const QByteArray& bytes);
+    static bool writeFile(const QString& path, const QByteArray& bytes);
+
+    std::unique_ptr<QTemporaryDir> m_tempDir;
+};
+
+QByteArray TestKeyedRecordStore::readFile(const QString& path) {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+bool TestKeyedRecordStore::appendFile(const QString& path,
+                                      const QByteArray& bytes) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Append) &&
+           file.write(bytes) == bytes.size();
+}
+
+bool TestKeyedRecordStore::writeFile(const QString& path,
+                                     const QByteArray& bytes) {
+    QFile file(path);
+    return file.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+           file.write(bytes) == bytes.size();
+}
+
+void TestKeyedRecordStore::init() {
+    m_tempDir = std::make_unique<QTemporaryDir>();
+    QVERIFY(m_tempDir->isValid());
+}
+
+void TestKeyedRecordStore::testReplayWithoutSnapshot() {
+    qint64 logSize = 0;
+    {
+        KeyedRecordStore store(storePath());
+        QVERIFY(store.open());
+        QVERIFY(store.put("doc1", "a", "first"));
+        QVERIFY(store.put("doc1", "b", "second"));
+        QVERIFY(store.put("doc2", "a", "third"));
+        QVERIFY(store.put("doc1", "a", "first, edited"));
+        QVERIFY(store.remove("doc2", "a"));
+        logSize = store.logSize();
+        QVERIFY(logSize > 0);
+        // Closed without compact(): everything lives in the log
+    }
+    QVERIFY(!QFileInfo::exists(storePath()));
+
+    KeyedRecordStore store(storePath());
+    QVERIFY(store.open());
+    QCOMPARE(store.logSize(), logSize);
+    QCOMPARE(store.count(), 2);
+    QCOMPARE(store.value("doc1", "a").value_or(""),
+             QByteArray("first, edited"));
+    QCOMPARE(store.value("doc1", "b").value_or(""), QByteArray("second"));
+    QVERIFY(!store.contains("doc2", "a"));
+    QVERIFY(store.values("doc2").isEmpty());
+}
+
+void TestKeyedRecordStore::testReplayOnTopOfSnapshot() {
+    {
+        KeyedRecordStore store(storePath());
+        QVERIFY(store.open());
+        QVERIFY(store.put("doc1", "a", "snapshot a"));
+        QVERIFY(store.put("doc1", "b", "snapshot b"));
+        QVERIFY(store.compact());
+        QCOMPARE(store.logSize(), qint64(0));
+
+        QVERIFY(store.put("doc1", "b", "logged b"));
+        QVERIFY(store.remove("doc1", "a"));
+        QVERIFY(store.put("doc1", "c", "logged c"));
+    }
+    QVERIFY(QFileInfo::exists(storePath()));
+
+    KeyedRecordStore store(storePath());
+    QVERIFY(store.open());
+    QVERIFY(store.logSize() > 0);
+    QCOMPARE(store.count(), 2);
+
+    const QList<KeyedRecordStore::Record> records = store.values("doc1");
+    QCOMPARE(records.size(), qsizetype(2));
+    QCOMPARE(records[0].id, QByteArray("b"));
+    QCOMPARE(records[0].payload, QByteArray("logged b"));
+    QCOMPARE(records[1].id, QByteArray("c"));
+    QCOMPARE(records[1].payload, QByteArray("logged c"));
+}
+
+void TestKeyedRecordStore::testTornTailIsTruncated() {
+    QByteArray lastEntry;
+    qint64 logSize = 0;
+    {
+        KeyedRecordStore store(storePath());
+        QVERIFY(store.open());
+        QVERIFY(store.put("doc1", "a", "complete"));
+        const qint64 firstEntrySize = store.logSize();
+        QVERIFY(store.put("doc1", "b", "also complete"));
+        logSize = store.logSize();
+        lastEntry = readFile(store.logPath()).mid(firstEntrySize);
+        QCOMPARE(qint64(lastEntry.size()), logSize - firstEntrySize);
+    }
+
+    // A crash halfway through writing the next entry
+    const QString logPath = storePath() + ".wal";
+    QVERIFY(appendFile(logPath, lastEntry.left(lastEntry.size() / 2)));
+    QVERIFY(QFileInfo(logPath).size() > logSize);
+
+    {
+        KeyedRecordStore store(storePath());
+        QVERIFY(store.open());
+        QCOMPARE(store.logSize(), logSize);
+        QCOMPARE(QFileInfo(logPath).size(), logSize);
+        QCOMPARE(store.count(), 2);
+        QCOMPARE(store.value("doc1", "b").value_or(""),
+                 QByteArray("also complete"));
+
+        // Appended right after the last complete entry, not the torn bytes
+        QVERIFY(store.put("doc1", "c", "after recovery"));
+    }
+
+    KeyedRecordStore store(storePath());
+    QVERIFY(store.open());
+    QCOMPARE(store.count(), 3);
+    QCOMPARE(store.value("doc1", "c").value_or(""),
+             QByteArray("after recovery"));
+}
+
+void TestKeyedRecordStore::testCorruptEntryDropsTheRest() {
+    qint64 firstEntrySize = 0;
+    {
+        KeyedRecordStore store(storePath());
+        QVERIFY(store.open());
+        QVERIFY(store.put("doc1", "a", "kept"));
+        firstEntrySize = store.logSize();
+        QVERIFY(store.put("doc1", "b", "damaged"));
+        QVERIFY(store.put("doc1", "c", "after the damage"));
+    }
+
+    // Flip the last payload byte of the second entry; its checksum fails
+    const QString logPath = storePath() + ".wal";
+    QByteArray log = readFile(logPath);
+    const qsizetype damaged =
+        log.indexOf("damaged", firstEntrySize) + qsizetype(6);
+    QVERIFY(damaged > firstEntrySize);
+    log[damaged] = static_cast<char>(log[damaged] ^ 0x20);
+    QVERIFY(writeFile(logPath, log));
+
+    KeyedRecordStore store(storePath());
+    QVERIFY(store.open());
+    QCOMPARE(store.logSize(), firstEntrySize);
+    QCOMPARE(store.count(), 1);
+    QCOMPARE(store.value("doc1", "a").value_or(""), QByteArray("kept"));
+    QVERIFY(!store.contains("doc1", "b"));
+    QVERIFY(!store.contains("doc1", "c"));
+}
+
+QTEST_MAIN(TestKeyedRecordStore)
+#include "test_keyed_record_store.moc"
@@ -0,0 +1,135 @@
+#include <QApplication>
+#include <QFile>
+#include <QLabel>
+#include <QMainWindow>
+#include <QToolBar>
+#include <QtTest/QtTest>
+#include <memory>
+#include "../../app/managers/StyleManager.h"
+
+/**
+ * Checks that a theme toggle recolours widgets styled by the application
+ * stylesheet.
+ *
+ * The stylesheet only refers to palette roles and is never re-applied on a
+ * toggle; StyleManager swaps the application palette and re-polishes the
+ * styled widgets. Each case renders a styled widget, toggles, renders again
+ * and compares the pixels with the palette of the new theme.
+ */
+class TestThemePalette : public QObject {
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanupTestCase();
+
+    void testMainWindowBackgroundFollowsTheme();
+    void testToolBarBackgroundFollowsTheme();
+    void testLabelTextFollowsTheme();
+
+private:
+    // Window carrying the application stylesheet, as MainWindow sets it up
+    QMainWindow* createStyledWindow();
+    static QColor pixelAt(QWidget* widget, const QPoint& point);
+
+    QString m_styleSheet;
+};
+
+void TestThemePalette::initTestCase() {
+    QFile file(QFINDTESTDATA("../../assets/styles/app.qss"));
+    if (file.open(QFile::ReadOnly)) {
+        m_styleSheet = QString::fromUtf8(file.readAll());
+    }
+    if (m_styleSheet.isEmpty()) {
+        m_styleSheet = STYLE.getApplicationStyleSheet();
+    }
+
+    // The cases compare two distinct themes
+    QVERIFY(STYLE.palette(Theme::Light).color(QPalette::Window) !=
+            STYLE.palette(Theme::Dark).color(QPalette::Window));
+    QVERIFY(STYLE.palette(Theme::Light).color(QPalette::AlternateBase) !=
+            STYLE.palette(Theme::Dark).color(QPalette::AlternateBase));
+}
+
+void TestThemePalette::init() { STYLE.setTheme(Theme::Light); }
+
+void TestThemePalette::cleanupTestCase() { STYLE.setTheme(Theme::Light); }
+
+QMainWindow* TestThemePalette::createStyledWindow() {
+    auto* window = new QMainWindow();
+    window->resize(400, 300);
+    window->setCentralWidget(new QWidget(window));
+    STYLE.forceApplyTheme(window, m_styleSheet);
+    window->show();
+    if (!QTest::qWaitForWindowExposed(window)) {
+        qWarning() << "Window was not exposed";
+    }
+    QCoreApplication::processEvents();
+    return window;
+}
+
+QColor TestThemePalette::pixelAt(QWidget* widget, const QPoint& point) {
+    const QImage image = widget->grab().toImage();
+    const QPoint scaled(qRound(point.x() * image.devicePixelRatio()),
+                        qRound(point.y() * image.devicePixelRatio()));
+    return image.pixelColor(scaled);
+}
+
+void TestThemePalette::testMainWindowBackgroundFollowsTheme() {
+    std::unique_ptr<QMainWindow> window(createStyledWindow());
+    const QPoint center = window->centralWidget()->geometry().center();
+
+    QCOMPARE(pixelAt(window.get(), center),
+             STYLE.palette(Theme::Light).color(QPalette::Window));
+
+    STYLE.toggleTheme();
+    QCoreApplication::processEvents();
+
+    QCOMPARE(pixelAt(window.get(), center),
+             STYLE.palette(Theme::Dark).color(QPalette::Window));
+    QCOMPARE(window->styleSheet(), m_styleSheet);
+}
+
+void TestThemePalette::testToolBarBackgroundFollowsTheme() {
+    std::unique_ptr<QMainWindow> window(createStyledWindow());
+    QToolBar* toolBar = window->addToolBar("probe");
+    toolBar->setMovable(false);
+    toolBar->setFixedHeight(40);
+    QCoreApplication::processEvents();
+
+    const QPoint center = toolBar->rect().center();
+    QCOMPARE(pixelAt(toolBar, center),
+             STYLE.palette(Theme::Light).color(QPalette::AlternateBase));
+
+    STYLE.toggleTheme();
+    QCoreApplication::processEvents();
+
+    QCOMPARE(pixelAt(toolBar, center),
+             STYLE.palette(Theme::Dark).color(QPalette::AlternateBase));
+
+    STYLE.toggleTheme();
+    QCoreApplication::processEvents();
+
+    QCOMPARE(pixelAt(toolBar, center),
+             STYLE.palette(Theme::Light).color(QPalette::AlternateBase));
+}
+
+void TestThemePalette::testLabelTextFollowsTheme() {
+    std::unique_ptr<QMainWindow> window(createStyledWindow());
+    auto* label = new QLabel("probe", window->centralWidget());
+    label->show();
+    QCoreApplication::processEvents();
+
+    QCOMPARE(label->palette().color(QPalette::WindowText),
+             STYLE.palette(Theme::Light).color(QPalette::WindowText));
+
+    STYLE.toggleTheme();
+    QCoreApplication::processEvents();
+
+    QCOMPARE(label->palette().color(QPalette::WindowText),
+             STYLE.palette(Theme::Dark).color(QPalette::WindowText));
+}
+
+QTEST_MAIN(TestThemePalette)
+#include "test_theme_palette.moc"